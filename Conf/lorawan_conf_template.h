@@ -174,6 +174,126 @@ extern "C" {
  */
 #define DISABLE_LORAWAN_RX_WINDOW                       0
 
+/*!
+ * @brief Enable the LoRaMac processing time probes (see LoRaMacProfiling.h)
+ * @note  Probes compile to nothing when disabled. By default the timestamps are taken
+ *        with TimerGetCurrentTime (ms); LORAMAC_PROFILING_GET_TIMESTAMP can be redefined
+ *        here to a finer source such as the DWT cycle counter.
+ */
+#define LORAMAC_PROFILING_ENABLED                       0
+
+/*!
+ * @brief Size in bytes of the free stack painted below the profiling probes to measure the stack usage
+ * @note  0 disables the stack measurement. The painted area must stay within the stack and be larger
+ *        than the deepest usage to measure. Painting adds to the measured durations.
+ */
+#define LORAMAC_PROFILING_STACK_PAINT_SIZE              0
+
+/*!
+ * @brief Skip the radio channel and modem configurations identical to the last applied ones
+ * @note  Counters are available with RegionCommonRadioShadowGetStats.
+ *        Requires a radio driver which retains its configuration in sleep mode (warm start).
+ *        The application must call RegionCommonRadioShadowInvalidate when it accesses the radio directly.
+ */
+#define LORAMAC_RADIO_SHADOW_ENABLED                    0
+
+/*!
+ * @brief Size the RX1/RX2 windows from the downlink timing error observed per slot and data rate
+ * @note  The windows never exceed the ones computed with SystemMaxRxError. A learned error is only
+ *        used with LORAMAC_RX_ERROR_LEARNING_MARGIN ms added. When a downlink expected in RX1 or RX2
+ *        (acknowledgement, ADRACKReq, MAC command answer, pending data) is missed, the learned values are
+ *        doubled, up to SystemMaxRxError. Uplinks which expect no answer leave them unchanged.
+ */
+#define LORAMAC_RX_ERROR_LEARNING_ENABLED               0
+
+/*!
+ * @brief Maximum delay in ms added to a LoRaWAN 1.1.1 rejoin cycle timer to expire together with
+ *        another running rejoin cycle timer
+ * @note  0 disables the coalescing. Only the Rejoin0, Rejoin1 and ForceRejoinReq cycle timers are
+ *        coalesced, and only with each other. The delayed transmission, RX windows, acknowledgement,
+ *        Class B and package timers are never delayed: an uplink moved on a Class B slot would collide
+ *        with it. They stay independent UTIL_TIMER objects: the MAC does not multiplex its timers on a
+ *        single alarm, the UTIL_TIMER list already programs the RTC for the earliest deadline only.
+ */
+#define LORAMAC_TIMER_COALESCING_SLACK                  0
+
+/*!
+ * @brief Account the time the radio spends in each state driven by the LoRaMac (see LoRaMacEnergy.h)
+ * @note  The energy is obtained by weighting the reported times with the board currents of each state.
+ *        McpsConfirm.RadioActiveTime reports the radio active time of each uplink request.
+ */
+#define LORAMAC_ENERGY_STATS_ENABLED                    0
+
+/*!
+ * @brief Record the acknowledgement success of the confirmed uplinks per channel
+ * @note  Enables RegionCommonChannelSelectorQualityAware, the default channel selection of the regions.
+ *        The selection stays random among all enabled channels, poor channels are only picked less often.
+ */
+#define LORAMAC_CHANNEL_QUALITY_ENABLED                 0
+
+/*!
+ * @brief Cache the region PHY parameters depending only on the data rate and the dwell time
+ * @note  Turns the frequent PHY_MAX_PAYLOAD, PHY_MAX_PAYLOAD_REPEATER, PHY_MIN_TX_DR, PHY_SF_FROM_DR
+ *        and PHY_BW_FROM_DR queries into array loads, for about 100 bytes of RAM.
+ *        Disabled by default: the regions then answer every query as before.
+ */
+#define REGION_PHY_PARAM_CACHE_ENABLED                  0
+
+/*!
+ * @brief Keep the band credits of a joined end-device with the duty cycle enabled in a model sorted by ready time
+ * @note  The bands are then only resynchronized by the transmissions, and the next channel search reads
+ *        the first bands of the model instead of updating the credits of every band.
+ *        The end-device behaves as with the full synchronization, for about 210 bytes of RAM.
+ */
+#define REGION_DUTY_CYCLE_INCREMENTAL_ENABLED           0
+
+/*!
+ * @brief Serve the uplink time on air from a table indexed by datarate and frame length
+ * @note  The table is filled on demand for the frames up to REGION_TIME_ON_AIR_TABLE_MAX_LEN bytes
+ *        (64 by default) and costs 2 bytes per entry. Longer frames are computed.
+ */
+#define REGION_TIME_ON_AIR_TABLE_ENABLED                0
+
+/*!
+ * @brief Size the region NVM contexts (channels, bands, channels masks) for the regions listed above only
+ * @note  Saves about 1 KB of RAM and NVM for a single EU868 build. The contexts get a layout tag:
+ *        a context stored by a build with another set of regions or another REGION_JOIN_SWEEP_PLAN_ENABLED
+ *        setting is refused by the restore.
+ *        The contexts stored with the fixed size layout are not migrated: the first firmware update
+ *        enabling this setting starts from a fresh context, so the end-device must join again
+ *        (an ABP end-device restarts its frame counters).
+ */
+#define REGION_NVM_SIZED_BY_REGIONS                     0
+
+/*!
+ * @brief Sense first the channels least often found busy by the listen before talk (AS923 Japan, KR920)
+ * @note  The busy history of a channel fades out in a few minutes without carrier sense.
+ *        Statistics are available with RegionCommonLbtGetStats.
+ */
+#define LORAMAC_LBT_ADAPTIVE_ENABLED                    0
+
+/*!
+ * @brief Probe the sub-bands in a random order planned for each join sweep (AU915, US915)
+ * @note  The order is stored in the region NVM context. The 125 kHz / 500 kHz datarate alternation is unchanged.
+ *        REGION_JOIN_SWEEP_PREFERRED_SUB_BAND (1 to 8, 0 for none) is always probed first, it can be
+ *        changed with RegionBaseUSSetJoinPreferredSubBand for the next sweeps.
+ */
+#define REGION_JOIN_SWEEP_PLAN_ENABLED                  0
+#define REGION_JOIN_SWEEP_PREFERRED_SUB_BAND            0
+
+/*!
+ * @brief Switch the region of a running MAC with LoRaMacRegionSwitch / LmHandlerSetActiveRegion, keeping the session
+ * @note  The state of the LORAMAC_REGION_SWITCH_NB_SLOTS (3 by default) last regions left is kept in RAM,
+ *        the size of a slot is about the size of the region NVM contexts (see REGION_NVM_SIZED_BY_REGIONS).
+ */
+#define LORAMAC_REGION_SWITCH_ENABLED                   0
+
+/*!
+ * @brief Read the CN470 RX1 frequencies from constant tables instead of computing them
+ * @note  Costs about 700 bytes of flash for the four channel plans.
+ */
+#define REGION_CN470_FREQUENCY_TABLES_ENABLED           0
+
 /* USER CODE BEGIN EC */
 
 /* USER CODE END EC */
@@ -101,6 +101,16 @@ extern "C" {
   */
 #define TimerGetElapsedTime UTIL_TIMER_GetElapsedTime
 
+/**
+  * @brief return a non-zero value if the timer object is running
+  */
+#define TimerIsStarted UTIL_TIMER_IsRunning
+
+/**
+  * @brief return the remaining time before the timer object expires
+  */
+#define TimerGetRemainingTime UTIL_TIMER_GetRemainingTime
+
 /* USER CODE BEGIN EM */
 
 /* USER CODE END EM */
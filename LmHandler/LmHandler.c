@@ -584,6 +584,31 @@ void LmHandlerProcess( void )
 #endif /* LORAMAC_VERSION */
 }
 
+LmHandlerErrorStatus_t LmHandlerGetNextWakeup( TimerTime_t *nextWakeup )
+{
+    TimerTime_t packageWakeup;
+
+    if( LoRaMacGetNextWakeup( nextWakeup ) != LORAMAC_STATUS_OK )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+
+    for( int8_t i = 0; i < PKG_MAX_NUMBER; i++ )
+    {
+        if( ( LmHandlerPackages[i] != NULL ) &&
+            ( LmHandlerPackages[i]->GetNextWakeup != NULL ) &&
+            ( LmHandlerPackageIsInitialized( i ) != false ) )
+        {
+            packageWakeup = LmHandlerPackages[i]->GetNextWakeup( );
+            if( packageWakeup < *nextWakeup )
+            {
+                *nextWakeup = packageWakeup;
+            }
+        }
+    }
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
 TimerTime_t LmHandlerGetDutyCycleWaitTime( void )
 {
     return DutyCycleWaitTime;
@@ -1012,6 +1037,15 @@ LmHandlerErrorStatus_t LmHandlerGetActiveRegion( LoRaMacRegion_t *region )
     return LORAMAC_HANDLER_SUCCESS;
 }
 
+LmHandlerErrorStatus_t LmHandlerGetStatusSnapshot( LoRaMacStatusSnapshot_t *snapshot )
+{
+    if( LoRaMacGetStatusSnapshot( snapshot ) != LORAMAC_STATUS_OK )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+    return LORAMAC_HANDLER_SUCCESS;
+}
+
 LmHandlerErrorStatus_t LmHandlerSetSystemMaxRxError( uint32_t maxErrorInMs )
 {
     MibRequestConfirm_t mibReq;
@@ -1696,6 +1730,22 @@ LmHandlerErrorStatus_t LmHandlerSetDevAddr( uint32_t devAddr )
 
 LmHandlerErrorStatus_t LmHandlerSetActiveRegion( LoRaMacRegion_t region )
 {
+#if (defined( LORAMAC_REGION_SWITCH_ENABLED ) && ( LORAMAC_REGION_SWITCH_ENABLED == 1 ))
+    /* Fast switch keeping the session, allowed in running state */
+    if( LoRaMacRegionSwitch( region ) != LORAMAC_STATUS_OK )
+    {
+        return LORAMAC_HANDLER_ERROR;
+    }
+    LmHandlerParams.ActiveRegion = region;
+
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    getPhy.Attribute = PHY_DUTY_CYCLE;
+    phyParam = RegionGetPhyParam( LmHandlerParams.ActiveRegion, &getPhy );
+    LmHandlerParams.DutyCycleEnabled = ( bool ) phyParam.Value;
+    LoRaMacTestSetDutyCycleOn( LmHandlerParams.DutyCycleEnabled );
+    return LORAMAC_HANDLER_SUCCESS;
+#else
     /* Not yet joined */
     if( LmHandlerJoinStatus() != LORAMAC_HANDLER_SET )
     {
@@ -1707,6 +1757,7 @@ LmHandlerErrorStatus_t LmHandlerSetActiveRegion( LoRaMacRegion_t region )
         /* Cannot change Region in running state */
         return LORAMAC_HANDLER_ERROR;
     }
+#endif /* LORAMAC_REGION_SWITCH_ENABLED */
 }
 
 LmHandlerErrorStatus_t LmHandlerGetAdrEnable( bool *adrEnable )
@@ -338,6 +338,18 @@ bool LmHandlerIsBusy( void );
  */
 void LmHandlerProcess( void );
 
+/*!
+ * Gets the time until LmHandlerProcess has to be called again.
+ * Includes the MAC layer deadlines and the timers of the registered packages.
+ *
+ * \param [out] nextWakeup Time in ms before the next deadline, 0 when events
+ *                         are pending and TIMERTIME_T_MAX when no deadline is scheduled
+ *
+ * \retval status Returns \ref LORAMAC_HANDLER_SUCCESS if request has been
+ *                processed else \ref LORAMAC_HANDLER_ERROR
+ */
+LmHandlerErrorStatus_t LmHandlerGetNextWakeup( TimerTime_t *nextWakeup );
+
 /*!
  * Instructs the MAC layer to send a ClassA uplink
  *
@@ -428,6 +440,16 @@ LmHandlerErrorStatus_t LmHandlerGetTxDatarate( int8_t *txDatarate );
  */
 LmHandlerErrorStatus_t LmHandlerGetActiveRegion( LoRaMacRegion_t *region );
 
+/*!
+ * \brief Gets the commonly read MAC parameters in a single call
+ *
+ * \param [out] snapshot MAC parameters snapshot
+ *
+ * \retval -1 LORAMAC_HANDLER_ERROR
+ *          0 LORAMAC_HANDLER_SUCCESS
+ */
+LmHandlerErrorStatus_t LmHandlerGetStatusSnapshot( LoRaMacStatusSnapshot_t *snapshot );
+
 /*!
  * Set system maximum tolerated rx error in milliseconds
  *
@@ -553,6 +575,13 @@ LmHandlerErrorStatus_t LmHandlerSetDevAddr( uint32_t devAddr );
 /*!
  * \brief Sets the current active region
  *
+ * \note  With LORAMAC_REGION_SWITCH_ENABLED, the region is switched with
+ *        LoRaMacRegionSwitch: the session is kept and the device may be joined.
+ *        Before the join too, LmHandlerConfigure is no longer called: the
+ *        LoRaMac is not initialized again and the NVM contexts are not
+ *        restored. Only the duty cycle of the new region is applied, the
+ *        other settings of LmHandlerConfigure are kept.
+ *
  * \param [in] region New active region requested
  *
  * \retval -1 LORAMAC_HANDLER_ERROR
@@ -88,6 +88,13 @@ typedef struct LmhPackage_s
      * Processes the internal package events.
      */
     void ( *Process )( void );
+    /*!
+     * Returns the time until the next package timer expires.
+     * May be NULL when the package does not use any timer.
+     *
+     * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+     */
+    TimerTime_t ( *GetNextWakeup )( void );
     /*!
      * Notify the LmHandler process through an event
      */
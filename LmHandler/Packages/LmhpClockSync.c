@@ -123,6 +123,13 @@ static bool LmhpClockSyncIsTxPending( void );
  */
 static void LmhpClockSyncProcess( void );
 
+/*!
+ * Returns the time until the next package timer expires.
+ *
+ * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+ */
+static TimerTime_t LmhpClockSyncGetNextWakeup( void );
+
 /*!
  * Processes the MCSP Confirm
  *
@@ -160,6 +167,7 @@ static LmhPackage_t LmhpClockSyncPackage =
     .IsInitialized = LmhpClockSyncIsInitialized,
     .IsTxPending = LmhpClockSyncIsTxPending,
     .Process = LmhpClockSyncProcess,
+    .GetNextWakeup = LmhpClockSyncGetNextWakeup,
     .OnMcpsConfirmProcess = LmhpClockSyncOnMcpsConfirm,
     .OnMcpsIndicationProcess = LmhpClockSyncOnMcpsIndication,
     .OnMlmeConfirmProcess = NULL,                              /* Not used in this package */
@@ -217,6 +225,17 @@ static void LmhpClockSyncProcess( void )
     }
 }
 
+static TimerTime_t LmhpClockSyncGetNextWakeup( void )
+{
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+
+    if( TimerIsStarted( &PeriodicTimeStartTimer ) != 0U )
+    {
+        TimerGetRemainingTime( &PeriodicTimeStartTimer, &nextWakeup );
+    }
+    return nextWakeup;
+}
+
 static void LmhpClockSyncOnMcpsConfirm( McpsConfirm_t *mcpsConfirm )
 {
     MibRequestConfirm_t mibReq;
@@ -132,6 +132,13 @@ static bool LmhpComplianceIsRunning( void );
  */
 static void LmhpComplianceProcess( void );
 
+/*!
+ * Returns the time until the next package timer expires.
+ *
+ * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+ */
+static TimerTime_t LmhpComplianceGetNextWakeup( void );
+
 /*!
  * Processes the MCPS Confirm
  *
@@ -174,6 +181,7 @@ static LmhPackage_t LmhpCompliancePackage =
     .IsInitialized = LmhpComplianceIsInitialized,
     .IsRunning = LmhpComplianceIsRunning,
     .Process = LmhpComplianceProcess,
+    .GetNextWakeup = LmhpComplianceGetNextWakeup,
     .OnMcpsConfirmProcess =       LmhpComplianceOnMcpsConfirm,
     .OnMcpsIndicationProcess = LmhpComplianceOnMcpsIndication,
     .OnMlmeConfirmProcess = LmhpComplianceOnMlmeConfirm,
@@ -528,6 +536,17 @@ static void LmhpComplianceProcess( void )
     /* Nothing to process */
 }
 
+static TimerTime_t LmhpComplianceGetNextWakeup( void )
+{
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+
+    if( TimerIsStarted( &ComplianceTxNextPacketTimer ) != 0U )
+    {
+        TimerGetRemainingTime( &ComplianceTxNextPacketTimer, &nextWakeup );
+    }
+    return nextWakeup;
+}
+
 static void OnComplianceTxNextPacketTimerEvent( void *context )
 {
     LmhpComplianceTxProcess( );
@@ -666,6 +685,13 @@ static bool LmhpComplianceIsTxPending( void );
  */
 static void LmhpComplianceProcess( void );
 
+/*!
+ * Returns the time until the next package timer expires.
+ *
+ * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+ */
+static TimerTime_t LmhpComplianceGetNextWakeup( void );
+
 /*!
  * Processes the MCPS Indication
  *
@@ -709,6 +735,7 @@ LmhPackage_t CompliancePackage =
     .IsInitialized           = LmhpComplianceIsInitialized,
     .IsTxPending             = LmhpComplianceIsTxPending,
     .Process                 = LmhpComplianceProcess,
+    .GetNextWakeup           = LmhpComplianceGetNextWakeup,
     .OnPackageProcessEvent   = NULL,  /* To be initialized by LmHandler */
     .OnMcpsConfirmProcess    = NULL,  /* Not used in this package */
     .OnMcpsIndicationProcess = LmhpComplianceOnMcpsIndication,
@@ -815,6 +842,17 @@ static void LmhpComplianceProcess( void )
     }
 }
 
+static TimerTime_t LmhpComplianceGetNextWakeup( void )
+{
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+
+    if( TimerIsStarted( &ProcessTimer ) != 0U )
+    {
+        TimerGetRemainingTime( &ProcessTimer, &nextWakeup );
+    }
+    return nextWakeup;
+}
+
 static void LmhpComplianceOnMcpsIndication( McpsIndication_t *mcpsIndication )
 {
     uint8_t cmdIndex        = 0;
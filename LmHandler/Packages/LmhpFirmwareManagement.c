@@ -106,6 +106,13 @@ static bool LmhpFirmwareManagementIsTxPending( void );
  */
 static void LmhpFirmwareManagementProcess( void );
 
+/*!
+ * Returns the time until the next package timer expires.
+ *
+ * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+ */
+static TimerTime_t LmhpFirmwareManagementGetNextWakeup( void );
+
 /*!
  * Processes the MCPS Indication
  *
@@ -129,6 +136,7 @@ static LmhPackage_t LmhpFirmwareManagementPackage =
     .IsInitialized = LmhpFirmwareManagementIsInitialized,
     .IsTxPending = LmhpFirmwareManagementIsTxPending,
     .Process = LmhpFirmwareManagementProcess,
+    .GetNextWakeup = LmhpFirmwareManagementGetNextWakeup,
     .OnPackageProcessEvent = NULL,                             /* To be initialized by LmHandler */
     .OnMcpsConfirmProcess = NULL,                              /* Not used in this package */
     .OnMcpsIndicationProcess =    LmhpFirmwareManagementOnMcpsIndication,
@@ -186,6 +194,17 @@ static void LmhpFirmwareManagementProcess( void )
     /* Not yet implemented */
 }
 
+static TimerTime_t LmhpFirmwareManagementGetNextWakeup( void )
+{
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+
+    if( TimerIsStarted( &RebootTimer ) != 0U )
+    {
+        TimerGetRemainingTime( &RebootTimer, &nextWakeup );
+    }
+    return nextWakeup;
+}
+
 static void LmhpFirmwareManagementOnMcpsIndication( McpsIndication_t *mcpsIndication )
 {
     uint8_t cmdIndex = 0;
@@ -126,6 +126,13 @@ static bool LmhpFragmentationIsTxPending( void );
  */
 static void LmhpFragmentationProcess( void );
 
+/*!
+ * Returns the time until the next package timer expires.
+ *
+ * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+ */
+static TimerTime_t LmhpFragmentationGetNextWakeup( void );
+
 /*!
  * Processes the MCPS Indication
  *
@@ -204,6 +211,7 @@ static LmhPackage_t LmhpFragmentationPackage =
     .IsInitialized = LmhpFragmentationIsInitialized,
     .IsTxPending = LmhpFragmentationIsTxPending,
     .Process = LmhpFragmentationProcess,
+    .GetNextWakeup = LmhpFragmentationGetNextWakeup,
     .OnPackageProcessEvent = NULL,                             /* To be initialized by LmHandler */
     .OnMcpsConfirmProcess = NULL,                              /* Not used in this package */
     .OnMcpsIndicationProcess = LmhpFragmentationOnMcpsIndication,
@@ -317,6 +325,17 @@ static void LmhpFragmentationProcess( void )
     }
 }
 
+static TimerTime_t LmhpFragmentationGetNextWakeup( void )
+{
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+
+    if( TimerIsStarted( &FragmentProcessTimer ) != 0U )
+    {
+        TimerGetRemainingTime( &FragmentProcessTimer, &nextWakeup );
+    }
+    return nextWakeup;
+}
+
 static void LmhpFragmentationOnMcpsIndication( McpsIndication_t *mcpsIndication )
 {
     uint8_t cmdIndex = 0;
@@ -119,6 +119,13 @@ static bool LmhpRemoteMcastSetupIsTxPending( void );
  */
 static void LmhpRemoteMcastSetupProcess( void );
 
+/*!
+ * Returns the time until the next package timer expires.
+ *
+ * \retval time Time in ms, TIMERTIME_T_MAX if no timer is running
+ */
+static TimerTime_t LmhpRemoteMcastSetupGetNextWakeup( void );
+
 /*!
  * Processes the MCPS Indication
  *
@@ -203,6 +210,7 @@ static LmhPackage_t LmhpRemoteMcastSetupPackage =
     .IsInitialized = LmhpRemoteMcastSetupIsInitialized,
     .IsTxPending = LmhpRemoteMcastSetupIsTxPending,
     .Process = LmhpRemoteMcastSetupProcess,
+    .GetNextWakeup = LmhpRemoteMcastSetupGetNextWakeup,
     .OnPackageProcessEvent = NULL,                             /* To be initialized by LmHandler */
     .OnMcpsConfirmProcess = NULL,                              /* Not used in this package */
     .OnMcpsIndicationProcess = LmhpRemoteMcastSetupOnMcpsIndication,
@@ -344,6 +352,35 @@ static void LmhpRemoteMcastSetupProcess( void )
     }
 }
 
+static TimerTime_t LmhpRemoteMcastSetupGetNextWakeup( void )
+{
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+    TimerTime_t remainingTime;
+
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+    {
+        if( TimerIsStarted( &SessionStartTimer[i] ) != 0U )
+        {
+            remainingTime = TIMERTIME_T_MAX;
+            TimerGetRemainingTime( &SessionStartTimer[i], &remainingTime );
+            if( remainingTime < nextWakeup )
+            {
+                nextWakeup = remainingTime;
+            }
+        }
+        if( TimerIsStarted( &SessionStopTimer[i] ) != 0U )
+        {
+            remainingTime = TIMERTIME_T_MAX;
+            TimerGetRemainingTime( &SessionStopTimer[i], &remainingTime );
+            if( remainingTime < nextWakeup )
+            {
+                nextWakeup = remainingTime;
+            }
+        }
+    }
+    return nextWakeup;
+}
+
 static void LmhpRemoteMcastSetupOnMcpsIndication( McpsIndication_t *mcpsIndication )
 {
     uint8_t cmdIndex = 0;
@@ -52,6 +52,8 @@
 #include "LoRaMacAdr.h"
 #include "LoRaMacSerializer.h"
 #include "LoRaMacVersion.h"
+#include "LoRaMacProfiling.h"
+#include "LoRaMacEnergy.h"
 #include "radio.h"
 
 #include "LoRaMac.h"
@@ -96,6 +98,32 @@
  */
 #define ABP_JOIN_PENDING_DELAY_MS                   10
 
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+#ifndef LORAMAC_RX_ERROR_LEARNING_MARGIN
+/*!
+ * Margin in ms added to the learned RX timing error
+ */
+#define LORAMAC_RX_ERROR_LEARNING_MARGIN            3
+#endif /* LORAMAC_RX_ERROR_LEARNING_MARGIN */
+
+/*!
+ * Number of data rates tracked by the RX timing error learning
+ */
+#define LORAMAC_RX_ERROR_LEARNING_NB_DR             16
+
+/*!
+ * Learned RX timing error value of a slot / data rate without observation
+ */
+#define LORAMAC_RX_ERROR_UNKNOWN                    0xFF
+
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+
+/*!
+ * Number of slots of the multicast address lookup table, power of 2 and at
+ * least twice LORAMAC_MAX_MC_CTX to keep the probe sequences short
+ */
+#define LORAMAC_MC_ADDR_TABLE_SIZE                  8
+
 #if defined(__ICCARM__)
 #ifndef __NO_INIT
 #define __NO_INIT __no_init
@@ -141,6 +169,57 @@ typedef enum eLoRaMacRequestHandling
     LORAMAC_REQUEST_HANDLING_ON = !LORAMAC_REQUEST_HANDLING_OFF
 }LoRaMacRequestHandling_t;
 
+/*!
+ * Memoised maximum payload size reported by LoRaMacQueryTxPossible
+ */
+typedef struct sLoRaMacTxInfoCache
+{
+    /*!
+     * Set when the fields below hold a valid result
+     */
+    bool IsValid;
+    /*
+     * Parameters the cached result has been computed with
+     */
+    LoRaMacRegion_t Region;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    uint32_t Version;
+    int8_t ChannelsDatarateDefault;
+#endif /* LORAMAC_VERSION */
+    bool AdrCtrlOn;
+    int8_t ChannelsDatarate;
+    uint8_t UplinkDwellTime;
+    bool RepeaterSupport;
+    /*!
+     * Maximum application payload size without FOpts
+     */
+    uint8_t CurrentPossiblePayloadSize;
+}LoRaMacTxInfoCache_t;
+
+/*!
+ * Data uplink secured for the previous transmission, reused by the repetitions
+ */
+typedef struct sLoRaMacSecuredFrameCache
+{
+    /*!
+     * Set when PktBuffer holds the secured frame of the current data message
+     */
+    bool IsValid;
+    /*!
+     * Uplink frame counter the frame has been secured with
+     */
+    uint32_t FCntUp;
+    /*!
+     * Data rate and channel the MIC has been computed for
+     */
+    uint8_t Datarate;
+    uint8_t Channel;
+    /*!
+     * Length of the secured frame
+     */
+    uint16_t BufSize;
+}LoRaMacSecuredFrameCache_t;
+
 typedef struct sLoRaMacCtx
 {
     /*!
@@ -326,6 +405,41 @@ typedef struct sLoRaMacCtx
      * Buffer containing the MAC layer commands
      */
     uint8_t MacCommandsBuffer[LORA_MAC_COMMAND_MAX_LENGTH];
+    /*!
+     * Last result of LoRaMacQueryTxPossible
+     */
+    LoRaMacTxInfoCache_t TxInfoCache;
+    /*!
+     * Secured frame of the ongoing data uplink
+     */
+    LoRaMacSecuredFrameCache_t SecuredFrameCache;
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+    /*!
+     * Downlink timing error in ms observed in RX1 [0] and RX2 [1], per data rate
+     */
+    uint8_t RxErrorLearned[2][LORAMAC_RX_ERROR_LEARNING_NB_DR];
+    /*!
+     * Set when the network is expected to answer the ongoing data uplink
+     */
+    bool RxErrorDownlinkExpected;
+    /*!
+     * Set when the last downlink announced more pending data (FPending)
+     */
+    bool RxErrorFramePending;
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+    /*!
+     * Radio active time when the pending MCPS request has been accepted
+     */
+    TimerTime_t McpsRadioActiveTimeStart;
+    /*!
+     * Multicast address lookup table, holds the index + 1 of the enabled
+     * multicast contexts, 0 for an empty slot
+     */
+    uint8_t McAddrTable[LORAMAC_MC_ADDR_TABLE_SIZE];
+    /*!
+     * Counters of the received frames rejected before their processing
+     */
+    LoRaMacRxFilterStats_t RxFilterStats;
 }LoRaMacCtx_t;
 
 /*!
@@ -357,10 +471,211 @@ __NO_INIT __ROOT static LoRaMacNvmData_t NvmBackup;
 static LoRaMacNvmData_t Nvm;
 #endif /* CONTEXT_MANAGEMENT_ENABLED */
 
+/*!
+ * LoRaMac timers. Used to compute the next wakeup
+ */
+static TimerEvent_t* const MacTimers[] =
+{
+    &MacCtx.TxDelayedTimer,
+    &MacCtx.RxWindowTimer1,
+    &MacCtx.RxWindowTimer2,
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    &MacCtx.AckTimeoutTimer,
+#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    &MacCtx.RetransmitTimeoutTimer,
+    &MacCtx.AbpJoinPendingTimer,
+#endif /* LORAMAC_VERSION */
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    &MacCtx.Rejoin0CycleTimer,
+    &MacCtx.Rejoin1CycleTimer,
+    &MacCtx.ForceRejoinReqCycleTimer,
+#endif /* LORAMAC_VERSION */
+};
+
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+#if (defined( LORAMAC_TIMER_COALESCING_SLACK ) && ( LORAMAC_TIMER_COALESCING_SLACK > 0 ))
+/*!
+ * Rejoin cycle timers. Only these timers are aligned on each other by
+ * StartCoalescedTimer, the other MAC timers are started on their exact deadline
+ */
+static TimerEvent_t* const RejoinTimers[] =
+{
+    &MacCtx.Rejoin0CycleTimer,
+    &MacCtx.Rejoin1CycleTimer,
+    &MacCtx.ForceRejoinReqCycleTimer,
+};
+#endif /* LORAMAC_TIMER_COALESCING_SLACK */
+#endif /* LORAMAC_VERSION */
+
 #if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
 static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
 #endif /* LORAMAC_VERSION */
 
+#if (defined( LORAMAC_REGION_SWITCH_ENABLED ) && ( LORAMAC_REGION_SWITCH_ENABLED == 1 ))
+#ifndef LORAMAC_REGION_SWITCH_NB_SLOTS
+/*!
+ * Number of regions whose state is kept by LoRaMacRegionSwitch
+ */
+#define LORAMAC_REGION_SWITCH_NB_SLOTS              3
+#endif /* LORAMAC_REGION_SWITCH_NB_SLOTS */
+
+/*!
+ * State of a region left by LoRaMacRegionSwitch
+ */
+typedef struct sLoRaMacRegionSlot
+{
+    /*!
+     * Region of the slot
+     */
+    LoRaMacRegion_t Region;
+    /*!
+     * Set to true when the slot holds a region state
+     */
+    bool Valid;
+    /*!
+     * Value of RegionSwitchCounter when the region was left, to recycle the oldest slot
+     */
+    uint32_t LastUse;
+    /*!
+     * Region channels, masks and join state
+     */
+    RegionNvmDataGroup1_t RegionGroup1;
+    /*!
+     * Region channels and masks
+     */
+    RegionNvmDataGroup2_t RegionGroup2;
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    /*!
+     * Region bands and their duty cycle credits
+     */
+    Band_t Bands[REGION_NVM_MAX_NB_BANDS];
+#endif /* LORAMAC_VERSION */
+    /*!
+     * MAC parameters of the region
+     */
+    LoRaMacParams_t MacParams;
+    /*!
+     * Default MAC parameters of the region
+     */
+    LoRaMacParams_t MacParamsDefaults;
+    /*!
+     * Uplink datarate
+     */
+    int8_t ChannelsDatarate;
+    /*!
+     * Uplink TX power
+     */
+    int8_t ChannelsTxPower;
+    /*!
+     * Default uplink datarate
+     */
+    int8_t ChannelsDatarateDefault;
+    /*!
+     * Default uplink TX power
+     */
+    int8_t ChannelsTxPowerDefault;
+    /*!
+     * Duty cycle enforcement
+     */
+    bool DutyCycleOn;
+}LoRaMacRegionSlot_t;
+
+/*!
+ * States of the regions left by LoRaMacRegionSwitch
+ */
+static LoRaMacRegionSlot_t RegionSlots[LORAMAC_REGION_SWITCH_NB_SLOTS];
+
+/*!
+ * Number of region switches, orders the slots by last use
+ */
+static uint32_t RegionSwitchCounter;
+#endif /* LORAMAC_REGION_SWITCH_ENABLED */
+
+/*!
+ * NVM data which may be changed by LoRaMacMibSetRequestConfirmBatch,
+ * restored when a request of the batch is rejected
+ */
+typedef struct sLoRaMacMibBatchSnapshot
+{
+    /*!
+     * MAC parameters
+     */
+    LoRaMacNvmDataGroup1_t MacGroup1;
+    /*!
+     * MAC parameters
+     */
+    LoRaMacNvmDataGroup2_t MacGroup2;
+    /*!
+     * Region channels remaining, updated with the channels mask
+     */
+    RegionNvmDataGroup1_t RegionGroup1;
+    /*!
+     * Region channels mask
+     */
+    uint16_t ChannelsMask[REGION_NVM_CHANNELS_MASK_SIZE];
+    /*!
+     * Region channels default mask
+     */
+    uint16_t ChannelsDefaultMask[REGION_NVM_CHANNELS_MASK_SIZE];
+}LoRaMacMibBatchSnapshot_t;
+
+/*!
+ * State before the batch being applied by LoRaMacMibSetRequestConfirmBatch
+ */
+static LoRaMacMibBatchSnapshot_t MibBatchSnapshot;
+
+/*!
+ * MAC commands of a downlink being processed by ProcessMacCommands
+ */
+typedef struct sMacCommandsStream
+{
+    /*!
+     * Buffer holding the MAC commands
+     */
+    uint8_t* Payload;
+    /*!
+     * End of the complete MAC commands with a known CID
+     */
+    uint8_t Size;
+    /*!
+     * Index of the CID of the command being processed
+     */
+    uint8_t CmdIndex;
+    /*!
+     * Size of the command being processed, CID included. Enlarged by a
+     * handler which also processes the following commands.
+     */
+    uint8_t CmdSize;
+    /*!
+     * SNR of the downlink
+     */
+    int8_t Snr;
+    /*!
+     * Set when the block of LinkAdrReq commands has been processed
+     */
+    bool AdrBlockFound;
+    /*!
+     * Current region
+     */
+    LoRaMacRegion_t Region;
+    /*!
+     * LoRaWAN version of the session
+     */
+    Version_t Version;
+    /*!
+     * ADR enabled
+     */
+    bool AdrCtrlOn;
+}MacCommandsStream_t;
+
+/*!
+ * \brief Handler of a MAC command received from the server
+ *
+ * \param [in] stream  MAC commands being processed
+ * \param [in] payload Payload of the command, after the CID
+ */
+typedef void ( *MacCommandHandler_t )( MacCommandsStream_t* stream, const uint8_t* payload );
+
 static const KeyIdentifier_t MCKeys[LORAMAC_MAX_MC_CTX] = {
 #if ( LORAMAC_MAX_MC_CTX > 0 )
     MC_KEY_0,
@@ -715,6 +1030,28 @@ static bool IsReJoin0Required( void );
  */
 static void ResetMacParameters( bool isRejoin );
 
+/*!
+ * \brief Sets the default MAC parameters of the current region
+ */
+static void InitRegionMacParamsDefaults( void );
+
+#if (defined( LORAMAC_REGION_SWITCH_ENABLED ) && ( LORAMAC_REGION_SWITCH_ENABLED == 1 ))
+/*!
+ * \brief Stores the state of the current region in its slot, the slot of
+ *        the least recently left region is recycled when all are in use
+ */
+static void SaveRegionSlot( void );
+
+/*!
+ * \brief Restores the state of a region left before
+ *
+ * \param [in] region Region to restore
+ *
+ * \retval [true: restored, false: no slot for the region]
+ */
+static bool RestoreRegionSlot( LoRaMacRegion_t region );
+#endif /* LORAMAC_REGION_SWITCH_ENABLED */
+
 /*!
  * \brief Initializes and opens the reception window
  *
@@ -782,6 +1119,13 @@ static bool CheckRetransUnconfirmedUplink( void );
  */
 static bool CheckRetransConfirmedUplink( void );
 
+/*!
+ * \brief Records on its channel whether a confirmed uplink transmission has
+ *        been acknowledged. Called once per transmission, when its
+ *        acknowledgement has been received or can no longer be.
+ */
+static void UpdateChannelQuality( void );
+
 #if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
 /*!
  * \brief Increases the ADR ack counter. Takes the maximum
@@ -919,6 +1263,148 @@ static void LoRaMacHandleNvm( LoRaMacNvmData_t* nvmData );
 static bool LoRaMacHandleResponseTimeout( TimerTime_t timeoutInMs, TimerTime_t startTimeInMs );
 #endif /* LORAMAC_VERSION */
 
+/*!
+ * \brief Verifies if the memoised result of LoRaMacQueryTxPossible can be reused
+ *
+ * \details While the ADR backoff has not reached the step where the datarate
+ *          is lowered, the result only depends on the parameters stored in the
+ *          cache. Beyond that step it also depends on the enabled channels and
+ *          it is always recomputed.
+ *
+ * \param [in] adrNext ADR parameters of the next uplink
+ *
+ * \retval [true: cached result is valid, false: result must be recomputed]
+ */
+static bool IsTxInfoCacheValid( CalcNextAdrParams_t* adrNext );
+
+/*!
+ * \brief Stores the result of LoRaMacQueryTxPossible with its parameters
+ *
+ * \param [in] adrNext     ADR parameters of the next uplink
+ * \param [in] payloadSize Maximum application payload size without FOpts
+ */
+static void UpdateTxInfoCache( CalcNextAdrParams_t* adrNext, uint8_t payloadSize );
+
+/*!
+ * \brief Verifies if PktBuffer still holds the secured frame of the current
+ *        data message, which is the case for NbTrans repetitions and
+ *        confirmed uplink retransmissions
+ *
+ * \retval [true: the secured frame can be reused, false: the frame must be secured]
+ */
+static bool IsSecuredFrameCached( void );
+
+/*!
+ * \brief Gets the RX timing error to size a class A window with
+ *
+ * \param [in] rxSlot   RX slot, RX_SLOT_WIN_1 or RX_SLOT_WIN_2
+ * \param [in] datarate Data rate of the window
+ *
+ * \retval RX timing error in ms, SystemMaxRxError when nothing has been learned
+ */
+static uint32_t GetRxError( LoRaMacRxSlot_t rxSlot, int8_t datarate );
+
+/*!
+ * \brief Records the timing error of a downlink received in a class A window
+ *
+ * \param [in] rxSlot       RX slot the frame has been received in
+ * \param [in] size         Size of the received frame
+ * \param [in] framePending FPending bit of the received frame
+ */
+static void LearnRxError( LoRaMacRxSlot_t rxSlot, uint16_t size, bool framePending );
+
+/*!
+ * \brief Forgets all learned RX timing errors, the class A windows are
+ *        opened again with SystemMaxRxError
+ */
+static void ResetRxErrorLearning( void );
+
+/*!
+ * \brief Records whether the network is expected to answer the data uplink
+ *        being sent: confirmed uplink, ADRACKReq, MAC command waiting for its
+ *        answer or pending downlink data announced by the network
+ *
+ * \param [in] adrAckReq ADRACKReq bit of the uplink
+ */
+static void ExpectRxErrorLearning( bool adrAckReq );
+
+/*!
+ * \brief Records a data uplink without downlink in RX1 and RX2. When a
+ *        downlink was expected, the windows may have become too narrow:
+ *        the learned RX timing errors are doubled, and forgotten once they
+ *        reach SystemMaxRxError
+ */
+static void MissRxErrorLearning( void );
+
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+/*!
+ * \brief Starts a rejoin cycle timer. When LORAMAC_TIMER_COALESCING_SLACK is
+ *        set, the timeout is extended up to the deadline of another running
+ *        rejoin cycle timer expiring less than LORAMAC_TIMER_COALESCING_SLACK ms
+ *        later, so that both are handled in the same wakeup
+ *
+ * \param [in] obj   Rejoin cycle timer to start
+ * \param [in] value Minimum timeout in ms
+ */
+static void StartCoalescedTimer( TimerEvent_t* obj, TimerTime_t value );
+#endif /* LORAMAC_VERSION */
+
+/*!
+ * \brief Computes the multicast address lookup table slot of a device address
+ *
+ * \param [in] address Device address
+ *
+ * \retval First slot to probe
+ */
+static uint8_t HashMcAddr( uint32_t address );
+
+/*!
+ * \brief Rebuilds the multicast address lookup table from the multicast contexts
+ */
+static void UpdateMcAddrTable( void );
+
+/*!
+ * \brief Searches the enabled multicast context of a device address
+ *
+ * \param [in] address Device address of the received frame
+ *
+ * \retval Index of the multicast context, LORAMAC_MAX_MC_CTX when not found
+ */
+static uint8_t GetMcIndex( uint32_t address );
+
+/*!
+ * \brief Rejects the received frames which cannot be for this device from the
+ *        MAC header, the size and the device address only, before any parsing,
+ *        frame counter or cryptographic processing
+ *
+ * \param [in]  payload Received frame
+ * \param [in]  size    Size of the received frame, not 0
+ * \param [out] mcIndex Index of the matching multicast context of a data
+ *                      frame, LORAMAC_MAX_MC_CTX otherwise
+ *
+ * \retval LORAMAC_EVENT_INFO_STATUS_OK when the frame has to be processed
+ */
+static LoRaMacEventInfoStatus_t FilterRxFrame( uint8_t* payload, uint16_t size, uint8_t* mcIndex );
+
+/*!
+ * \brief Applies a MIB attribute without notifying the NVM changes
+ *
+ * \param [in] mibSet MIB-Set request
+ *
+ * \retval LoRaMacStatus_t Status of the operation
+ */
+static LoRaMacStatus_t MibSetRequestConfirm( MibRequestConfirm_t* mibSet );
+
+/*!
+ * \brief Checks if a MIB attribute may be part of a batch: its effects are
+ *        limited to the NVM data restored when the batch is rejected
+ *
+ * \param [in] type MIB attribute
+ *
+ * \retval Returns true if the attribute may be part of a batch
+ */
+static bool MibIsBatchable( Mib_t type );
+
 /*!
  * Structure used to store the radio Tx event data
  */
@@ -946,6 +1432,7 @@ static RxDoneParams_t RxDoneParams;
 static void OnRadioTxDone( void )
 {
     TxDoneParams.CurTime = TimerGetCurrentTime( );
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     MacCtx.LastTxSysTime = SysTimeGet( );
 
     LoRaMacRadioEvents.Events.TxDone = 1;
@@ -957,6 +1444,7 @@ static void OnRadioTxDone( void )
 static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr )
 {
     RxDoneParams.LastRxDone = TimerGetCurrentTime( );
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     RxDoneParams.Payload = payload;
     RxDoneParams.Size = size;
     RxDoneParams.Rssi = rssi;
@@ -973,6 +1461,7 @@ static void OnRadioRxDone( uint8_t *payload, uint16_t size, int16_t rssi, int8_t
 
 static void OnRadioTxTimeout( void )
 {
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     LoRaMacRadioEvents.Events.TxTimeout = 1;
 
     OnMacProcessNotify( );
@@ -981,6 +1470,7 @@ static void OnRadioTxTimeout( void )
 
 static void OnRadioRxError( void )
 {
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     LoRaMacRadioEvents.Events.RxError = 1;
 
     OnMacProcessNotify( );
@@ -988,6 +1478,7 @@ static void OnRadioRxError( void )
 
 static void OnRadioRxTimeout( void )
 {
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     LoRaMacRadioEvents.Events.RxTimeout = 1;
 
     OnMacProcessNotify( );
@@ -1015,6 +1506,7 @@ static void ProcessRadioTxDone( void )
     if( Nvm.MacGroup2.DeviceClass != CLASS_C )
     {
         Radio.Sleep( );
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     }
 #if ( !defined(DISABLE_LORAWAN_RX_WINDOW) || (DISABLE_LORAWAN_RX_WINDOW == 0) )
     // Setup timers
@@ -1130,6 +1622,8 @@ static void ProcessRadioRxDone( void )
     uint32_t downLinkCounter = 0;
     uint32_t address = Nvm.MacGroup2.DevAddr;
     uint8_t multicast = 0;
+    uint8_t mcIndex = LORAMAC_MAX_MC_CTX;
+    LoRaMacEventInfoStatus_t filterStatus;
     AddressIdentifier_t addrID = UNICAST_DEV_ADDR;
     FCntIdentifier_t fCntID;
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
@@ -1161,6 +1655,7 @@ static void ProcessRadioRxDone( void )
 #endif /* LORAMAC_VERSION */
 
     Radio.Sleep( );
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
 
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
     TimerStop( &MacCtx.RxWindowTimer2 );
@@ -1215,6 +1710,15 @@ static void ProcessRadioRxDone( void )
     }
 #endif /* LORAMAC_VERSION */
 
+    // Fast reject of the frames for other devices
+    filterStatus = FilterRxFrame( payload, size, &mcIndex );
+    if( filterStatus != LORAMAC_EVENT_INFO_STATUS_OK )
+    {
+        MacCtx.McpsIndication.Status = filterStatus;
+        PrepareRxDoneAbort( );
+        return;
+    }
+
     switch( macHdr.Bits.MType )
     {
         case FRAME_TYPE_JOIN_ACCEPT:
@@ -1430,12 +1934,14 @@ static void ProcessRadioRxDone( void )
             macMsgData.FRMPayload = MacCtx.RxPayload;
             macMsgData.FRMPayloadSize = LORAMAC_PHY_MAXPAYLOAD;
 
+            LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_HEADER_PARSE );
             if( LORAMAC_PARSER_SUCCESS != LoRaMacParserData( &macMsgData ) )
             {
                 MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
                 PrepareRxDoneAbort( );
                 return;
             }
+            LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_HEADER_PARSE );
 
 #if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
             // Handle Class B
@@ -1463,6 +1969,7 @@ static void ProcessRadioRxDone( void )
             MacCtx.McpsIndication.DevAddress = macMsgData.FHDR.DevAddr;
 
             FType_t fType;
+            LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_ADDRESS_MATCH );
             if( LORAMAC_STATUS_OK != DetermineFrameType( &macMsgData, &fType ) )
             {
                 MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_ERROR;
@@ -1470,25 +1977,21 @@ static void ProcessRadioRxDone( void )
                 return;
             }
 
-            //Check if it is a multicast message
+            //Check if it is a multicast message, the context has been looked up by FilterRxFrame
             multicast = 0;
             downLinkCounter = 0;
-            for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
+            if( mcIndex < LORAMAC_MAX_MC_CTX )
             {
-                if( ( Nvm.MacGroup2.MulticastChannelList[i].ChannelParams.Address == macMsgData.FHDR.DevAddr ) &&
-                    ( Nvm.MacGroup2.MulticastChannelList[i].ChannelParams.IsEnabled == true ) )
+                multicast = 1;
+                addrID = Nvm.MacGroup2.MulticastChannelList[mcIndex].ChannelParams.GroupID;
+                downLinkCounter = *( Nvm.MacGroup2.MulticastChannelList[mcIndex].DownLinkCounter );
+                address = Nvm.MacGroup2.MulticastChannelList[mcIndex].ChannelParams.Address;
+                if( Nvm.MacGroup2.DeviceClass == CLASS_C )
                 {
-                    multicast = 1;
-                    addrID = Nvm.MacGroup2.MulticastChannelList[i].ChannelParams.GroupID;
-                    downLinkCounter = *( Nvm.MacGroup2.MulticastChannelList[i].DownLinkCounter );
-                    address = Nvm.MacGroup2.MulticastChannelList[i].ChannelParams.Address;
-                    if( Nvm.MacGroup2.DeviceClass == CLASS_C )
-                    {
-                        MacCtx.RxStatus.RxSlot = RX_SLOT_WIN_CLASS_C_MULTICAST;
-                    }
-                    break;
+                    MacCtx.RxStatus.RxSlot = RX_SLOT_WIN_CLASS_C_MULTICAST;
                 }
             }
+            LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_ADDRESS_MATCH );
 
             // Filter messages according to multicast downlink exceptions
             if( ( multicast == 1 ) && ( ( fType != FRAME_TYPE_D ) ||
@@ -1506,7 +2009,9 @@ static void ProcessRadioRxDone( void )
             phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
 
             // Get downlink frame counter value
+            LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_FCNT );
             macCryptoStatus = GetFCntDown( addrID, fType, &macMsgData, Nvm.MacGroup2.Version, phyParam.Value, &fCntID, &downLinkCounter );
+            LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_FCNT );
             if( macCryptoStatus != LORAMAC_CRYPTO_SUCCESS )
             {
                 if( macCryptoStatus == LORAMAC_CRYPTO_FAIL_FCNT_DUPLICATED )
@@ -1552,7 +2057,9 @@ static void ProcessRadioRxDone( void )
             }
 #elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
             // Get downlink frame counter value
+            LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_FCNT );
             macCryptoStatus = GetFCntDown( addrID, fType, &macMsgData, Nvm.MacGroup2.Version, &fCntID, &downLinkCounter );
+            LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_FCNT );
             if( macCryptoStatus != LORAMAC_CRYPTO_SUCCESS )
             {
                 if( macCryptoStatus == LORAMAC_CRYPTO_FAIL_FCNT_DUPLICATED )
@@ -1589,6 +2096,11 @@ static void ProcessRadioRxDone( void )
             }
 #endif /* LORAMAC_VERSION */
 
+            if( multicast == 0 )
+            {
+                LearnRxError( MacCtx.RxSlot, size, macMsgData.FHDR.FCtrl.Bits.FPending == 1 );
+            }
+
             MacCtx.McpsIndication.Status = LORAMAC_EVENT_INFO_STATUS_OK;
             MacCtx.McpsIndication.Multicast = multicast;
             MacCtx.McpsIndication.Buffer = NULL;
@@ -1646,8 +2158,13 @@ static void ProcessRadioRxDone( void )
 
             // Set the pending status
 			// Fix for Class C Certification test. Re-enabled part of if condition previously removed.
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
             if( ( ( ( Nvm.MacGroup1.SrvAckRequested == true ) || ( macMsgData.FHDR.FCtrl.Bits.FPending > 0 ) ) && ( Nvm.MacGroup2.DeviceClass == CLASS_A ) ) ||
                 ( MacCtx.McpsIndication.ResponseTimeout > 0 ) ) 
+#elif (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+            // No response timeout before LoRaWAN 1.0.4
+            if( ( ( Nvm.MacGroup1.SrvAckRequested == true ) || ( macMsgData.FHDR.FCtrl.Bits.FPending > 0 ) ) && ( Nvm.MacGroup2.DeviceClass == CLASS_A ) )
+#endif /* LORAMAC_VERSION */
             //if( ( ( Nvm.MacGroup1.SrvAckRequested == true ) || ( macMsgData.FHDR.FCtrl.Bits.FPending > 0 ) ) && ( Nvm.MacGroup2.DeviceClass == CLASS_A ) )
             {
                 MacCtx.McpsIndication.IsUplinkTxPending = 1;
@@ -1655,6 +2172,7 @@ static void ProcessRadioRxDone( void )
 
             RemoveMacCommands( MacCtx.RxStatus.RxSlot, macMsgData.FHDR.FCtrl, MacCtx.McpsConfirm.McpsRequest );
 
+            LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_MAC_COMMANDS );
             switch( fType )
             {
                 case FRAME_TYPE_A:
@@ -1719,6 +2237,7 @@ static void ProcessRadioRxDone( void )
                     PrepareRxDoneAbort( );
                     break;
             }
+            LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_MAC_COMMANDS );
 
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
             // Rejoin handling
@@ -1815,6 +2334,7 @@ static void ProcessRadioTxTimeout( void )
     if( Nvm.MacGroup2.DeviceClass != CLASS_C )
     {
         Radio.Sleep( );
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     }
     UpdateRxSlotIdleState( );
 
@@ -1838,6 +2358,7 @@ static void HandleRadioRxErrorTimeout( LoRaMacEventInfoStatus_t rx1EventInfoStat
     if( Nvm.MacGroup2.DeviceClass != CLASS_C )
     {
         Radio.Sleep( );
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
     }
 
     if( LoRaMacClassBIsBeaconExpected( ) == true )
@@ -1884,6 +2405,10 @@ static void HandleRadioRxErrorTimeout( LoRaMacEventInfoStatus_t rx1EventInfoStat
             {
                 MacCtx.McpsConfirm.Status = rx2EventInfoStatus;
             }
+            if( MacCtx.RxSlot == RX_SLOT_WIN_2 )
+            {
+                MissRxErrorLearning( );
+            }
             LoRaMacConfirmQueueSetStatusCmn( rx2EventInfoStatus );
 
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
@@ -1927,7 +2452,9 @@ static void LoRaMacHandleIrqEvents( void )
         }
         if( events.Events.RxDone == 1 )
         {
+            LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_TOTAL );
             ProcessRadioRxDone( );
+            LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_TOTAL );
         }
         if( events.Events.TxTimeout == 1 )
         {
@@ -1975,12 +2502,49 @@ bool LoRaMacIsStopped( void )
     return false;
 }
 
-static void LoRaMacEnableRequests( LoRaMacRequestHandling_t requestState )
+LoRaMacStatus_t LoRaMacGetNextWakeup( TimerTime_t* nextWakeup )
 {
-    MacCtx.AllowRequests = requestState;
-}
+    TimerTime_t remainingTime;
 
-static void LoRaMacHandleRequestEvents( void )
+    if( nextWakeup == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    if( ( LoRaMacRadioEvents.Value != 0 ) ||
+        ( MacCtx.MacFlags.Bits.MacDone == 1 ) ||
+        ( MacCtx.MacFlags.Bits.McpsInd == 1 ) ||
+        ( MacCtx.MacFlags.Bits.MlmeInd == 1 ) ||
+        ( MacCtx.MacFlags.Bits.NvmHandle == 1 ) )
+    {
+        // Events are waiting for LoRaMacProcess
+        *nextWakeup = 0;
+        return LORAMAC_STATUS_OK;
+    }
+
+    *nextWakeup = LoRaMacClassBGetNextWakeup( );
+
+    for( uint8_t i = 0; i < ( sizeof( MacTimers ) / sizeof( MacTimers[0] ) ); i++ )
+    {
+        if( TimerIsStarted( MacTimers[i] ) != 0U )
+        {
+            remainingTime = TIMERTIME_T_MAX;
+            TimerGetRemainingTime( MacTimers[i], &remainingTime );
+            if( remainingTime < *nextWakeup )
+            {
+                *nextWakeup = remainingTime;
+            }
+        }
+    }
+    return LORAMAC_STATUS_OK;
+}
+
+static void LoRaMacEnableRequests( LoRaMacRequestHandling_t requestState )
+{
+    MacCtx.AllowRequests = requestState;
+}
+
+static void LoRaMacHandleRequestEvents( void )
 {
     // Handle events
     LoRaMacFlags_t reqEvents = MacCtx.MacFlags;
@@ -2004,6 +2568,7 @@ static void LoRaMacHandleRequestEvents( void )
         // Handle callbacks
         if( reqEvents.Bits.McpsReq == 1 )
         {
+            MacCtx.McpsConfirm.RadioActiveTime = LoRaMacEnergyGetActiveTime( ) - MacCtx.McpsRadioActiveTimeStart;
             MacCtx.MacPrimitives->MacMcpsConfirm( &MacCtx.McpsConfirm );
         }
 
@@ -2037,7 +2602,9 @@ static void LoRaMacHandleIndicationEvents( void )
     if( MacCtx.MacFlags.Bits.McpsInd == 1 )
     {
         MacCtx.MacFlags.Bits.McpsInd = 0;
+        LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_INDICATION );
         MacCtx.MacPrimitives->MacMcpsIndication( &MacCtx.McpsIndication, &MacCtx.RxStatus );
+        LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_INDICATION );
     }
 }
 
@@ -2098,6 +2665,7 @@ static void LoRaMacHandleMcpsRequest( void )
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
             if( MacCtx.AckTimeoutRetry == true )
             {
+                UpdateChannelQuality( );
                 stopRetransmission = CheckRetransConfirmedUplink( );
 
                 if( Nvm.MacGroup2.Version.Fields.Minor == 0 )
@@ -2119,6 +2687,7 @@ static void LoRaMacHandleMcpsRequest( void )
 #elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
             if( MacCtx.RetransmitTimeoutRetry == true )
             {
+                UpdateChannelQuality( );
                 stopRetransmission = CheckRetransConfirmedUplink( );
             }
             else
@@ -2624,6 +3193,7 @@ static LoRaMacStatus_t SwitchClass( DeviceClass_t deviceClass )
                 MacCtx.NodeAckRequested = false;
                 // Set the radio into sleep mode in case we are still in RX mode
                 Radio.Sleep( );
+                LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
 
                 OpenContinuousRxCWindow( );
 
@@ -2659,6 +3229,7 @@ static LoRaMacStatus_t SwitchClass( DeviceClass_t deviceClass )
 
                 // Set the radio into sleep to setup a defined state
                 Radio.Sleep( );
+                LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
 
                 status = LORAMAC_STATUS_OK;
 
@@ -2715,615 +3286,650 @@ static bool ValidatePayloadLength( uint8_t lenN, int8_t datarate, uint8_t fOptsL
     return false;
 }
 
-static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t commandsSize, int8_t snr, LoRaMacRxSlot_t rxSlot )
-{
-    uint8_t status = 0;
-    bool adrBlockFound = false;
-    uint8_t macCmdPayload[2] = { 0x00, 0x00 };
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+/*!
+ * \brief Removes a sticky end-device command once the server confirmed it
+ *        with a version at most equal to the one of the end-device
+ */
+static void ConfirmStickyCmd( uint8_t cid, uint8_t serverMinorVersion )
+{
     MacCommand_t* macCmd;
-#endif /* LORAMAC_VERSION */
 
-#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-    if( ( rxSlot != RX_SLOT_WIN_1 ) && ( rxSlot != RX_SLOT_WIN_2 ) )
-    {
-        // Do only parse MAC commands for Class A RX windows
-        return;
-    }
-#endif /* LORAMAC_VERSION */
-
-    while( macIndex < commandsSize )
+    // Compare own LoRaWAN Version with server's
+    if( Nvm.MacGroup2.Version.Fields.Minor >= serverMinorVersion )
     {
-        // Make sure to parse only complete MAC commands
-        if( ( LoRaMacCommandsGetCmdSize( payload[macIndex] ) + macIndex ) > commandsSize )
+        // If they equal remove the sticky MAC-Command.
+        if( LoRaMacCommandsGetCmd( cid, &macCmd ) == LORAMAC_COMMANDS_SUCCESS )
         {
-            return;
+            LoRaMacCommandsRemoveCmd( macCmd );
         }
+    }
+}
 
-        // Decode Frame MAC commands
-        switch( payload[macIndex++] )
-        {
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-            case SRV_MAC_RESET_CONF:
-            {
-                uint8_t serverMinorVersion = payload[macIndex++];
-
-                // Compare own LoRaWAN Version with server's
-                if( Nvm.MacGroup2.Version.Fields.Minor >= serverMinorVersion )
-                {
-                    // If they equal remove the sticky ResetInd MAC-Command.
-                    if( LoRaMacCommandsGetCmd( MOTE_MAC_RESET_IND, &macCmd) == LORAMAC_COMMANDS_SUCCESS )
-                    {
-                        LoRaMacCommandsRemoveCmd( macCmd );
-                    }
-                }
-                break;
-            }
+static void ProcessResetConf( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    ConfirmStickyCmd( MOTE_MAC_RESET_IND, payload[0] );
+}
 #endif /* LORAMAC_VERSION */
-            case SRV_MAC_LINK_CHECK_ANS:
-            {
-                if( LoRaMacConfirmQueueIsCmdActive( MLME_LINK_CHECK ) == true )
-                {
-                    LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_LINK_CHECK );
-                    MacCtx.MlmeConfirm.DemodMargin = payload[macIndex++];
-                    MacCtx.MlmeConfirm.NbGateways = payload[macIndex++];
-                }
-                break;
-            }
-            case SRV_MAC_LINK_ADR_REQ:
-            {
-                LinkAdrReqParams_t linkAdrReq;
-                int8_t linkAdrDatarate = DR_0;
-                int8_t linkAdrTxPower = TX_POWER_0;
-                uint8_t linkAdrNbRep = 0;
-                uint8_t linkAdrNbBytesParsed = 0;
-
-                // The end node is allowed to process one block of LinkAdrRequests.
-                // It must ignore subsequent blocks
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
-                if( adrBlockFound == false )
-                {
-                    adrBlockFound = true;
-
-                    // Fill parameter structure
-                    linkAdrReq.Payload = &payload[macIndex - 1];
-                    linkAdrReq.PayloadSize = commandsSize - ( macIndex - 1 );
-                    linkAdrReq.AdrEnabled = Nvm.MacGroup2.AdrCtrlOn;
-                    linkAdrReq.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
-                    linkAdrReq.CurrentDatarate = Nvm.MacGroup1.ChannelsDatarate;
-                    linkAdrReq.CurrentTxPower = Nvm.MacGroup1.ChannelsTxPower;
-                    linkAdrReq.CurrentNbRep = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
-                    linkAdrReq.Version = Nvm.MacGroup2.Version;
-
-                    // Process the ADR requests
-                    status = RegionLinkAdrReq( Nvm.MacGroup2.Region, &linkAdrReq, &linkAdrDatarate,
-                                               &linkAdrTxPower, &linkAdrNbRep, &linkAdrNbBytesParsed );
-
-                    if( ( status & 0x07 ) == 0x07 )
-                    {
-                        Nvm.MacGroup1.ChannelsDatarate = linkAdrDatarate;
-                        Nvm.MacGroup1.ChannelsTxPower = linkAdrTxPower;
-                        Nvm.MacGroup2.MacParams.ChannelsNbTrans = linkAdrNbRep;
-                    }
 
-                    // Add the answers to the buffer
-                    for( uint8_t i = 0; i < ( linkAdrNbBytesParsed / 5 ); i++ )
-                    {
-                        LoRaMacCommandsAddCmd( MOTE_MAC_LINK_ADR_ANS, &status, 1 );
-                    }
-                    // Update MAC index
-                    macIndex += linkAdrNbBytesParsed - 1;
-                }
-#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-                if( adrBlockFound == false )
-                {
-                    adrBlockFound = true;
-
-                    do
-                    {
-                        // Fill parameter structure
-                        linkAdrReq.Payload = &payload[macIndex - 1];
-                        linkAdrReq.AdrEnabled = Nvm.MacGroup2.AdrCtrlOn;
-                        linkAdrReq.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
-                        linkAdrReq.CurrentDatarate = Nvm.MacGroup1.ChannelsDatarate;
-                        linkAdrReq.CurrentTxPower = Nvm.MacGroup1.ChannelsTxPower;
-                        linkAdrReq.CurrentNbRep = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
-                        linkAdrReq.Version = Nvm.MacGroup2.Version;
-
-                        // There is a fundamental difference in reporting the status
-                        // of the LinkAdrRequests when ADR is on or off. When ADR is on, every
-                        // LinkAdrAns contains the same value. This does not hold when ADR is off,
-                        // where every LinkAdrAns requires an individual status.
-                        if( Nvm.MacGroup2.AdrCtrlOn == true )
-                        {
-                            // When ADR is on, the function RegionLinkAdrReq will take care
-                            // about the parsing and interpretation of the LinkAdrRequest block and
-                            // it provides one status which shall be applied to every LinkAdrAns
-                            linkAdrReq.PayloadSize = commandsSize - ( macIndex - 1 );
-                        }
-                        else
-                        {
-                            // When ADR is off, this function will loop over the individual LinkAdrRequests
-                            // and will call RegionLinkAdrReq for each individually, as every request
-                            // requires an individual answer.
-                            // When ADR is off, the function RegionLinkAdrReq ignores the new values for
-                            // ChannelsDatarate, ChannelsTxPower and ChannelsNbTrans.
-                            linkAdrReq.PayloadSize = 5;
-                        }
-
-                        // Process the ADR requests
-                        status = RegionLinkAdrReq( Nvm.MacGroup2.Region, &linkAdrReq, &linkAdrDatarate,
-                                                &linkAdrTxPower, &linkAdrNbRep, &linkAdrNbBytesParsed );
+static void ProcessLinkCheckAns( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    if( LoRaMacConfirmQueueIsCmdActive( MLME_LINK_CHECK ) == true )
+    {
+        LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_LINK_CHECK );
+        MacCtx.MlmeConfirm.DemodMargin = payload[0];
+        MacCtx.MlmeConfirm.NbGateways = payload[1];
+    }
+}
 
-                        if( ( status & 0x07 ) == 0x07 )
-                        {
-                            // Set the status that the datarate has been increased
-                            if( linkAdrDatarate > Nvm.MacGroup1.ChannelsDatarate )
-                            {
-                                Nvm.MacGroup2.ChannelsDatarateChangedLinkAdrReq = true;
-                            }
-                            Nvm.MacGroup1.ChannelsDatarate = linkAdrDatarate;
-                            Nvm.MacGroup1.ChannelsTxPower = linkAdrTxPower;
-                            Nvm.MacGroup2.MacParams.ChannelsNbTrans = linkAdrNbRep;
-                        }
+static void ProcessLinkAdrReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    LinkAdrReqParams_t linkAdrReq;
+    int8_t linkAdrDatarate = DR_0;
+    int8_t linkAdrTxPower = TX_POWER_0;
+    uint8_t linkAdrNbRep = 0;
+    uint8_t linkAdrNbBytesParsed = 0;
+    uint8_t status = 0;
 
-                        // Add the answers to the buffer
-                        for( uint8_t i = 0; i < ( linkAdrNbBytesParsed / 5 ); i++ )
-                        {
-                            LoRaMacCommandsAddCmd( MOTE_MAC_LINK_ADR_ANS, &status, 1 );
-                        }
-                        // Update MAC index
-                        macIndex += linkAdrNbBytesParsed - 1;
+    // The end node is allowed to process one block of LinkAdrRequests.
+    // It must ignore subsequent blocks
+    if( stream->AdrBlockFound == true )
+    {
+        return;
+    }
+    stream->AdrBlockFound = true;
 
-                        // Check to prevent invalid access
-                        if( macIndex >= commandsSize )
-                            break;
+    linkAdrReq.AdrEnabled = stream->AdrCtrlOn;
+    linkAdrReq.Version = stream->Version;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    // Fill parameter structure
+    linkAdrReq.Payload = &stream->Payload[stream->CmdIndex];
+    linkAdrReq.PayloadSize = stream->Size - stream->CmdIndex;
+    linkAdrReq.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+    linkAdrReq.CurrentDatarate = Nvm.MacGroup1.ChannelsDatarate;
+    linkAdrReq.CurrentTxPower = Nvm.MacGroup1.ChannelsTxPower;
+    linkAdrReq.CurrentNbRep = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
 
-                    } while( payload[macIndex++] == SRV_MAC_LINK_ADR_REQ );
+    // Process the ADR requests
+    status = RegionLinkAdrReq( stream->Region, &linkAdrReq, &linkAdrDatarate,
+                               &linkAdrTxPower, &linkAdrNbRep, &linkAdrNbBytesParsed );
 
-                    if( macIndex < commandsSize )
-                    {
-                        // Decrease the index such that it points to the next MAC command
-                        macIndex--;
-                    }
-                }
-                else
-                {
-                    // Increase the index by the MAC command size (without command)
-                    macIndex += 4;
-                }
-#endif /* LORAMAC_VERSION */
-                break;
-            }
-            case SRV_MAC_DUTY_CYCLE_REQ:
-            {
-                Nvm.MacGroup2.MaxDCycle = payload[macIndex++] & 0x0F;
-                Nvm.MacGroup2.AggregatedDCycle = 1 << Nvm.MacGroup2.MaxDCycle;
-                LoRaMacCommandsAddCmd( MOTE_MAC_DUTY_CYCLE_ANS, macCmdPayload, 0 );
-                break;
-            }
-            case SRV_MAC_RX_PARAM_SETUP_REQ:
-            {
-                RxParamSetupReqParams_t rxParamSetupReq;
-                status = 0x07;
+    if( ( status & 0x07 ) == 0x07 )
+    {
+        Nvm.MacGroup1.ChannelsDatarate = linkAdrDatarate;
+        Nvm.MacGroup1.ChannelsTxPower = linkAdrTxPower;
+        Nvm.MacGroup2.MacParams.ChannelsNbTrans = linkAdrNbRep;
+    }
 
-                rxParamSetupReq.DrOffset = ( payload[macIndex] >> 4 ) & 0x07;
-                rxParamSetupReq.Datarate = payload[macIndex] & 0x0F;
-                macIndex++;
+    // Add the answers to the buffer
+    for( uint8_t i = 0; i < ( linkAdrNbBytesParsed / 5 ); i++ )
+    {
+        LoRaMacCommandsAddCmd( MOTE_MAC_LINK_ADR_ANS, &status, 1 );
+    }
+    // The whole block has been processed
+    stream->CmdSize = MAX( stream->CmdSize, linkAdrNbBytesParsed );
+#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    // Index following the CID of the LinkAdrReq being processed
+    uint8_t macIndex = stream->CmdIndex + 1;
 
-#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-                if( rxParamSetupReq.Datarate == 0x0F )
-                {
-                    // Keep the current datarate
-                    rxParamSetupReq.Datarate = Nvm.MacGroup2.MacParams.Rx2Channel.Datarate;
-                }
-#endif
+    do
+    {
+        // Fill parameter structure
+        linkAdrReq.Payload = &stream->Payload[macIndex - 1];
+        linkAdrReq.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+        linkAdrReq.CurrentDatarate = Nvm.MacGroup1.ChannelsDatarate;
+        linkAdrReq.CurrentTxPower = Nvm.MacGroup1.ChannelsTxPower;
+        linkAdrReq.CurrentNbRep = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
 
-                rxParamSetupReq.Frequency = ( uint32_t ) payload[macIndex++];
-                rxParamSetupReq.Frequency |= ( uint32_t ) payload[macIndex++] << 8;
-                rxParamSetupReq.Frequency |= ( uint32_t ) payload[macIndex++] << 16;
-                rxParamSetupReq.Frequency *= 100;
+        // There is a fundamental difference in reporting the status
+        // of the LinkAdrRequests when ADR is on or off. When ADR is on, every
+        // LinkAdrAns contains the same value. This does not hold when ADR is off,
+        // where every LinkAdrAns requires an individual status.
+        if( stream->AdrCtrlOn == true )
+        {
+            // When ADR is on, the function RegionLinkAdrReq will take care
+            // about the parsing and interpretation of the LinkAdrRequest block and
+            // it provides one status which shall be applied to every LinkAdrAns
+            linkAdrReq.PayloadSize = stream->Size - ( macIndex - 1 );
+        }
+        else
+        {
+            // When ADR is off, this function will loop over the individual LinkAdrRequests
+            // and will call RegionLinkAdrReq for each individually, as every request
+            // requires an individual answer.
+            // When ADR is off, the function RegionLinkAdrReq ignores the new values for
+            // ChannelsDatarate, ChannelsTxPower and ChannelsNbTrans.
+            linkAdrReq.PayloadSize = 5;
+        }
 
-                // Perform request on region
-                status = RegionRxParamSetupReq( Nvm.MacGroup2.Region, &rxParamSetupReq );
+        // Process the ADR requests
+        status = RegionLinkAdrReq( stream->Region, &linkAdrReq, &linkAdrDatarate,
+                                   &linkAdrTxPower, &linkAdrNbRep, &linkAdrNbBytesParsed );
 
-                if( ( status & 0x07 ) == 0x07 )
-                {
-                    Nvm.MacGroup2.MacParams.Rx2Channel.Datarate = rxParamSetupReq.Datarate;
-                    Nvm.MacGroup2.MacParams.RxCChannel.Datarate = rxParamSetupReq.Datarate;
-                    Nvm.MacGroup2.MacParams.Rx2Channel.Frequency = rxParamSetupReq.Frequency;
-                    Nvm.MacGroup2.MacParams.RxCChannel.Frequency = rxParamSetupReq.Frequency;
-                    Nvm.MacGroup2.MacParams.Rx1DrOffset = rxParamSetupReq.DrOffset;
-                }
-                macCmdPayload[0] = status;
-                LoRaMacCommandsAddCmd( MOTE_MAC_RX_PARAM_SETUP_ANS, macCmdPayload, 1 );
-                break;
-            }
-            case SRV_MAC_DEV_STATUS_REQ:
+        if( ( status & 0x07 ) == 0x07 )
+        {
+            // Set the status that the datarate has been increased
+            if( linkAdrDatarate > Nvm.MacGroup1.ChannelsDatarate )
             {
-                uint8_t batteryLevel = BAT_LEVEL_NO_MEASURE;
-                if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->GetBatteryLevel != NULL ) )
-                {
-                    batteryLevel = MacCtx.MacCallbacks->GetBatteryLevel( );
-                }
-                macCmdPayload[0] = batteryLevel;
-                macCmdPayload[1] = ( uint8_t )( snr & 0x3F );
-                LoRaMacCommandsAddCmd( MOTE_MAC_DEV_STATUS_ANS, macCmdPayload, 2 );
-                break;
+                Nvm.MacGroup2.ChannelsDatarateChangedLinkAdrReq = true;
             }
-            case SRV_MAC_NEW_CHANNEL_REQ:
-            {
-                NewChannelReqParams_t newChannelReq;
-                ChannelParams_t chParam;
-                status = 0x03;
+            Nvm.MacGroup1.ChannelsDatarate = linkAdrDatarate;
+            Nvm.MacGroup1.ChannelsTxPower = linkAdrTxPower;
+            Nvm.MacGroup2.MacParams.ChannelsNbTrans = linkAdrNbRep;
+        }
 
-                newChannelReq.ChannelId = payload[macIndex++];
-                newChannelReq.NewChannel = &chParam;
+        // Add the answers to the buffer
+        for( uint8_t i = 0; i < ( linkAdrNbBytesParsed / 5 ); i++ )
+        {
+            LoRaMacCommandsAddCmd( MOTE_MAC_LINK_ADR_ANS, &status, 1 );
+        }
+        // Update MAC index
+        macIndex += linkAdrNbBytesParsed - 1;
 
-                chParam.Frequency = ( uint32_t ) payload[macIndex++];
-                chParam.Frequency |= ( uint32_t ) payload[macIndex++] << 8;
-                chParam.Frequency |= ( uint32_t ) payload[macIndex++] << 16;
-                chParam.Frequency *= 100;
-                chParam.Rx1Frequency = 0;
-                chParam.DrRange.Value = payload[macIndex++];
+        // Check to prevent invalid access
+        if( macIndex >= stream->Size )
+            break;
 
-                status = ( uint8_t )RegionNewChannelReq( Nvm.MacGroup2.Region, &newChannelReq );
+    } while( stream->Payload[macIndex++] == SRV_MAC_LINK_ADR_REQ );
 
-                if( ( int8_t )status >= 0 )
-                {
-                    macCmdPayload[0] = status;
-                    LoRaMacCommandsAddCmd( MOTE_MAC_NEW_CHANNEL_ANS, macCmdPayload, 1 );
-                }
-                break;
-            }
-            case SRV_MAC_RX_TIMING_SETUP_REQ:
-            {
-                uint8_t delay = payload[macIndex++] & 0x0F;
+    if( macIndex < stream->Size )
+    {
+        // Decrease the index such that it points to the next MAC command
+        macIndex--;
+    }
+    // The whole block has been processed
+    stream->CmdSize = MAX( stream->CmdSize, macIndex - stream->CmdIndex );
+#endif /* LORAMAC_VERSION */
+}
 
-                if( delay == 0 )
-                {
-                    delay++;
-                }
-                Nvm.MacGroup2.MacParams.ReceiveDelay1 = delay * 1000;
-                Nvm.MacGroup2.MacParams.ReceiveDelay2 = Nvm.MacGroup2.MacParams.ReceiveDelay1 + 1000;
-                LoRaMacCommandsAddCmd( MOTE_MAC_RX_TIMING_SETUP_ANS, macCmdPayload, 0 );
-                break;
-            }
-            case SRV_MAC_TX_PARAM_SETUP_REQ:
-            {
-                TxParamSetupReqParams_t txParamSetupReq;
-                GetPhyParams_t getPhy;
-                PhyParam_t phyParam;
-                uint8_t eirpDwellTime = payload[macIndex++];
+static void ProcessDutyCycleReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    uint8_t macCmdPayload[1] = { 0x00 };
+    Nvm.MacGroup2.MaxDCycle = payload[0] & 0x0F;
+    Nvm.MacGroup2.AggregatedDCycle = 1 << Nvm.MacGroup2.MaxDCycle;
+    LoRaMacCommandsAddCmd( MOTE_MAC_DUTY_CYCLE_ANS, macCmdPayload, 0 );
+}
 
-                txParamSetupReq.UplinkDwellTime = 0;
-                txParamSetupReq.DownlinkDwellTime = 0;
+static void ProcessRxParamSetupReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    RxParamSetupReqParams_t rxParamSetupReq;
+    uint8_t status = 0x07;
 
-                if( ( eirpDwellTime & 0x20 ) == 0x20 )
-                {
-                    txParamSetupReq.DownlinkDwellTime = 1;
-                }
-                if( ( eirpDwellTime & 0x10 ) == 0x10 )
-                {
-                    txParamSetupReq.UplinkDwellTime = 1;
-                }
-                txParamSetupReq.MaxEirp = eirpDwellTime & 0x0F;
+    rxParamSetupReq.DrOffset = ( payload[0] >> 4 ) & 0x07;
+    rxParamSetupReq.Datarate = payload[0] & 0x0F;
 
-                // Check the status for correctness
-                if( RegionTxParamSetupReq( Nvm.MacGroup2.Region, &txParamSetupReq ) != -1 )
-                {
-                    // Accept command
-                    Nvm.MacGroup2.MacParams.UplinkDwellTime = txParamSetupReq.UplinkDwellTime;
-                    Nvm.MacGroup2.MacParams.DownlinkDwellTime = txParamSetupReq.DownlinkDwellTime;
-                    Nvm.MacGroup2.MacParams.MaxEirp = LoRaMacMaxEirpTable[txParamSetupReq.MaxEirp];
-                    // Update the datarate in case of the new configuration limits it
-                    getPhy.Attribute = PHY_MIN_TX_DR;
-                    getPhy.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
-                    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
-                    Nvm.MacGroup1.ChannelsDatarate = MAX( Nvm.MacGroup1.ChannelsDatarate, ( int8_t )phyParam.Value );
-
-                    // Add command response
-                    LoRaMacCommandsAddCmd( MOTE_MAC_TX_PARAM_SETUP_ANS, macCmdPayload, 0 );
-                }
-                break;
-            }
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-            case SRV_MAC_REKEY_CONF:
-            {
-                uint8_t serverMinorVersion = payload[macIndex++];
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    if( rxParamSetupReq.Datarate == 0x0F )
+    {
+        // Keep the current datarate
+        rxParamSetupReq.Datarate = Nvm.MacGroup2.MacParams.Rx2Channel.Datarate;
+    }
+#endif
 
-                // Compare own LoRaWAN Version with server's
-                if( Nvm.MacGroup2.Version.Fields.Minor >= serverMinorVersion )
-                {
-                    // If they equal remove the sticky RekeyInd MAC-Command.
-                    if( LoRaMacCommandsGetCmd( MOTE_MAC_REKEY_IND, &macCmd) == LORAMAC_COMMANDS_SUCCESS )
-                    {
-                        LoRaMacCommandsRemoveCmd( macCmd );
-                    }
-                }
-                break;
-            }
-#endif /* LORAMAC_VERSION */
-            case SRV_MAC_DL_CHANNEL_REQ:
-            {
-                DlChannelReqParams_t dlChannelReq;
-                status = 0x03;
+    rxParamSetupReq.Frequency = ( uint32_t ) payload[1];
+    rxParamSetupReq.Frequency |= ( uint32_t ) payload[2] << 8;
+    rxParamSetupReq.Frequency |= ( uint32_t ) payload[3] << 16;
+    rxParamSetupReq.Frequency *= 100;
 
-                dlChannelReq.ChannelId = payload[macIndex++];
-                dlChannelReq.Rx1Frequency = ( uint32_t ) payload[macIndex++];
-                dlChannelReq.Rx1Frequency |= ( uint32_t ) payload[macIndex++] << 8;
-                dlChannelReq.Rx1Frequency |= ( uint32_t ) payload[macIndex++] << 16;
-                dlChannelReq.Rx1Frequency *= 100;
+    // Perform request on region
+    status = RegionRxParamSetupReq( stream->Region, &rxParamSetupReq );
 
-                status = ( uint8_t )RegionDlChannelReq( Nvm.MacGroup2.Region, &dlChannelReq );
+    if( ( status & 0x07 ) == 0x07 )
+    {
+        Nvm.MacGroup2.MacParams.Rx2Channel.Datarate = rxParamSetupReq.Datarate;
+        Nvm.MacGroup2.MacParams.RxCChannel.Datarate = rxParamSetupReq.Datarate;
+        Nvm.MacGroup2.MacParams.Rx2Channel.Frequency = rxParamSetupReq.Frequency;
+        Nvm.MacGroup2.MacParams.RxCChannel.Frequency = rxParamSetupReq.Frequency;
+        Nvm.MacGroup2.MacParams.Rx1DrOffset = rxParamSetupReq.DrOffset;
+    }
+    LoRaMacCommandsAddCmd( MOTE_MAC_RX_PARAM_SETUP_ANS, &status, 1 );
+}
 
-                if( ( int8_t )status >= 0 )
-                {
-                    macCmdPayload[0] = status;
-                    LoRaMacCommandsAddCmd( MOTE_MAC_DL_CHANNEL_ANS, macCmdPayload, 1 );
-                }
-                break;
-            }
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-            case SRV_MAC_ADR_PARAM_SETUP_REQ:
-            {
-                /* ADRParamSetupReq Payload:  ADRparam
-                 * +----------------+---------------+
-                 * | 7:4 Limit_exp  | 3:0 Delay_exp |
-                 * +----------------+---------------+
-                 */
-
-                uint8_t delayExp = 0x0F & payload[macIndex];
-                uint8_t limitExp = 0x0F & ( payload[macIndex] >> 4 );
-                macIndex++;
-
-                // ADR_ACK_ DELAY = 2^Delay_exp
-                Nvm.MacGroup2.MacParams.AdrAckDelay = 0x01 << delayExp;
-
-                // ADR_ACK_LIMIT = 2^Limit_exp
-                Nvm.MacGroup2.MacParams.AdrAckLimit = 0x01 << limitExp;
-
-                LoRaMacCommandsAddCmd( MOTE_MAC_ADR_PARAM_SETUP_ANS, macCmdPayload, 0 );
-                break;
-            }
-            case SRV_MAC_FORCE_REJOIN_REQ:
-            {
-                /* ForceRejoinReq Payload:
-                 * +--------------+------------------+-------+----------------+--------+
-                 * | 13:11 Period | 10:8 Max_Retries | 7 RFU | 6:4 RejoinType | 3:0 DR |
-                 * +--------------+------------------+-------+----------------+--------+
-                 */
-
-                // Parse payload
-                uint8_t period = ( 0x38 & payload[macIndex] ) >> 3;
-                Nvm.MacGroup2.ForceRejoinMaxRetries = 0x07 & payload[macIndex];
-                macIndex++;
-                Nvm.MacGroup2.ForceRejoinType = ( 0x70 & payload[macIndex] ) >> 4;
-                Nvm.MacGroup1.ChannelsDatarate = 0x0F & payload[macIndex];
-                macIndex ++;
-
-                // Calc delay between retransmissions: 32 seconds x 2^Period + Rand32
-                uint32_t rejoinCycleInSec = 32 * ( 0x01 << period ) + randr( 0, 32 );
-
-                MacCtx.ForceRejoinCycleTime = 0;
-                Nvm.MacGroup1.ForceRejoinRetriesCounter = 0;
-                ConvertRejoinCycleTime( rejoinCycleInSec, &MacCtx.ForceRejoinCycleTime );
-                OnForceRejoinReqCycleTimerEvent( NULL );
-                break;
-            }
-            case SRV_MAC_REJOIN_PARAM_REQ:
-            {
-                /* RejoinParamSetupReq Payload:
-                 * +----------------+---------------+
-                 * | 7:4 MaxTimeN   | 3:0 MaxCountN |
-                 * +----------------+---------------+
-                 */
-                uint8_t maxCountN = 0x0F & payload[macIndex];
-                uint8_t maxTimeN = 0x0F & ( payload[macIndex] >> 4 );
-                uint32_t cycleInSec = 0x01 << ( maxTimeN + 10 );
-                uint32_t timeInMs = 0;
-                uint16_t uplinkLimit = 0x01 << ( maxCountN + 4 );
-                macIndex++;
-                macCmdPayload[0] = 0;
-
-                if( ConvertRejoinCycleTime( cycleInSec, &timeInMs ) == true )
-                {
-                    // Calc delay between retransmissions: 2^(maxTimeN+10)
-                    Nvm.MacGroup2.Rejoin0CycleInSec = cycleInSec;
-                    // Calc number if uplinks without rejoin request: 2^(maxCountN+4)
-                    Nvm.MacGroup2.Rejoin0UplinksLimit = uplinkLimit;
-                    MacCtx.Rejoin0CycleTime = timeInMs;
-
-                    macCmdPayload[0] = 0x01;
-                    TimerStop( &MacCtx.Rejoin0CycleTimer );
-                    TimerSetValue( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
-                    TimerStart( &MacCtx.Rejoin0CycleTimer );
-                }
-                LoRaMacCommandsAddCmd( MOTE_MAC_REJOIN_PARAM_ANS, macCmdPayload, 1 );
-                break;
-             }
-            case SRV_MAC_DEVICE_MODE_CONF:
-            {
-                // 1 byte payload which we do not handle.
-                macIndex++;
-                if( LoRaMacCommandsGetCmd( MOTE_MAC_DEVICE_MODE_IND, &macCmd) == LORAMAC_COMMANDS_SUCCESS )
-                {
-                    LoRaMacCommandsRemoveCmd( macCmd );
-                }
-                break;
-            }
-#endif /* LORAMAC_VERSION */
-            case SRV_MAC_DEVICE_TIME_ANS:
-            {
-                // The mote time can be updated only when the time is received in classA
-                // receive windows only.
-                if( LoRaMacConfirmQueueIsCmdActive( MLME_DEVICE_TIME ) == true )
-                {
-                    LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_DEVICE_TIME );
-
-                    SysTime_t gpsEpochTime = { 0 };
-                    SysTime_t sysTime = { 0 };
-                    SysTime_t sysTimeCurrent = { 0 };
-
-                    gpsEpochTime.Seconds = ( uint32_t )payload[macIndex++];
-                    gpsEpochTime.Seconds |= ( uint32_t )payload[macIndex++] << 8;
-                    gpsEpochTime.Seconds |= ( uint32_t )payload[macIndex++] << 16;
-                    gpsEpochTime.Seconds |= ( uint32_t )payload[macIndex++] << 24;
-                    gpsEpochTime.SubSeconds = payload[macIndex++];
-
-                    // Convert the fractional second received in ms
-                    // round( pow( 0.5, 8.0 ) * 1000 ) = 3.90625
-                    gpsEpochTime.SubSeconds = ( int16_t )( ( ( int32_t )gpsEpochTime.SubSeconds * 1000 ) >> 8 );
-
-                    // Copy received GPS Epoch time into system time
-                    sysTime = gpsEpochTime;
-                    // Add Unix to Gps epoch offset. The system time is based on Unix time.
-                    sysTime.Seconds += UNIX_GPS_EPOCH_OFFSET;
-
-                    // Compensate time difference between Tx Done time and now
-                    sysTimeCurrent = SysTimeGet( );
-                    sysTime = SysTimeAdd( sysTimeCurrent, SysTimeSub( sysTime, MacCtx.LastTxSysTime ) );
-
-                    // Apply the new system time.
-                    SysTimeSet( sysTime );
-                    LoRaMacClassBDeviceTimeAns( );
-                    MacCtx.McpsIndication.DeviceTimeAnsReceived = true;
-                }
-                else
-                {
-#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-                    // In case of other receive windows the Device Time Answer is not received.
-                    MacCtx.McpsIndication.DeviceTimeAnsReceived = false;
-#endif /* LORAMAC_VERSION */
-                }
-                break;
-            }
-            case SRV_MAC_PING_SLOT_INFO_ANS:
-            {
-                if( LoRaMacConfirmQueueIsCmdActive( MLME_PING_SLOT_INFO ) == true )
-                {
-                    LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_PING_SLOT_INFO );
-                    // According to the specification, it is not allowed to process this answer in
-                    // a ping or multicast slot
-                    if( ( MacCtx.RxSlot != RX_SLOT_WIN_CLASS_B_PING_SLOT ) && ( MacCtx.RxSlot != RX_SLOT_WIN_CLASS_B_MULTICAST_SLOT ) )
-                    {
-                        LoRaMacClassBPingSlotInfoAns( );
-                    }
-                }
-                break;
-            }
-            case SRV_MAC_PING_SLOT_CHANNEL_REQ:
-            {
-                uint8_t status = 0x03;
-                uint32_t frequency = 0;
-                uint8_t datarate;
+static void ProcessDevStatusReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    uint8_t macCmdPayload[2] = { BAT_LEVEL_NO_MEASURE, 0x00 };
 
-                frequency = ( uint32_t )payload[macIndex++];
-                frequency |= ( uint32_t )payload[macIndex++] << 8;
-                frequency |= ( uint32_t )payload[macIndex++] << 16;
-                frequency *= 100;
-                datarate = payload[macIndex++] & 0x0F;
+    if( ( MacCtx.MacCallbacks != NULL ) && ( MacCtx.MacCallbacks->GetBatteryLevel != NULL ) )
+    {
+        macCmdPayload[0] = MacCtx.MacCallbacks->GetBatteryLevel( );
+    }
+    macCmdPayload[1] = ( uint8_t )( stream->Snr & 0x3F );
+    LoRaMacCommandsAddCmd( MOTE_MAC_DEV_STATUS_ANS, macCmdPayload, 2 );
+}
 
-                status = LoRaMacClassBPingSlotChannelReq( datarate, frequency );
-                macCmdPayload[0] = status;
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
-                LoRaMacCommandsAddCmd( MOTE_MAC_PING_SLOT_FREQ_ANS, macCmdPayload, 1 );
-#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-                LoRaMacCommandsAddCmd( MOTE_MAC_PING_SLOT_CHANNEL_ANS, macCmdPayload, 1 );
-#endif /* LORAMAC_VERSION */
-                break;
-            }
-            case SRV_MAC_BEACON_TIMING_ANS:
-            {
-                if( LoRaMacConfirmQueueIsCmdActive( MLME_BEACON_TIMING ) == true )
-                {
-                    LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_BEACON_TIMING );
-                    uint16_t beaconTimingDelay = 0;
-                    uint8_t beaconTimingChannel = 0;
+static void ProcessNewChannelReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    NewChannelReqParams_t newChannelReq;
+    ChannelParams_t chParam;
+    uint8_t status = 0x03;
 
-                    beaconTimingDelay = ( uint16_t )payload[macIndex++];
-                    beaconTimingDelay |= ( uint16_t )payload[macIndex++] << 8;
-                    beaconTimingChannel = payload[macIndex++];
+    newChannelReq.ChannelId = payload[0];
+    newChannelReq.NewChannel = &chParam;
 
-                    LoRaMacClassBBeaconTimingAns( beaconTimingDelay, beaconTimingChannel, RxDoneParams.LastRxDone );
-                }
-                break;
-            }
-            case SRV_MAC_BEACON_FREQ_REQ:
-                {
-                    uint32_t frequency = 0;
+    chParam.Frequency = ( uint32_t ) payload[1];
+    chParam.Frequency |= ( uint32_t ) payload[2] << 8;
+    chParam.Frequency |= ( uint32_t ) payload[3] << 16;
+    chParam.Frequency *= 100;
+    chParam.Rx1Frequency = 0;
+    chParam.DrRange.Value = payload[4];
 
-                    frequency = ( uint32_t )payload[macIndex++];
-                    frequency |= ( uint32_t )payload[macIndex++] << 8;
-                    frequency |= ( uint32_t )payload[macIndex++] << 16;
-                    frequency *= 100;
+    status = ( uint8_t )RegionNewChannelReq( stream->Region, &newChannelReq );
 
-                    if( LoRaMacClassBBeaconFreqReq( frequency ) == true )
-                    {
-                        macCmdPayload[0] = 1;
-                    }
-                    else
-                    {
-                        macCmdPayload[0] = 0;
-                    }
-                    LoRaMacCommandsAddCmd( MOTE_MAC_BEACON_FREQ_ANS, macCmdPayload, 1 );
-                }
-                break;
-            default:
-                // Unknown command. ABORT MAC commands processing
-                return;
-        }
+    if( ( int8_t )status >= 0 )
+    {
+        LoRaMacCommandsAddCmd( MOTE_MAC_NEW_CHANNEL_ANS, &status, 1 );
     }
 }
 
-static LoRaMacStatus_t Send( LoRaMacHeader_t* macHdr, uint8_t fPort, void* fBuffer, uint16_t fBufferSize, bool allowDelayedTx )
+static void ProcessRxTimingSetupReq( MacCommandsStream_t* stream, const uint8_t* payload )
 {
-    LoRaMacFrameCtrl_t fCtrl;
-    LoRaMacStatus_t status = LORAMAC_STATUS_PARAMETER_INVALID;
-    int8_t datarate = Nvm.MacGroup1.ChannelsDatarate;
-    int8_t txPower = Nvm.MacGroup1.ChannelsTxPower;
-    uint32_t adrAckCounter = Nvm.MacGroup1.AdrAckCounter;
-    CalcNextAdrParams_t adrNext;
+    uint8_t macCmdPayload[1] = { 0x00 };
+    uint8_t delay = payload[0] & 0x0F;
 
-    // Check if we are joined
-    if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
+    if( delay == 0 )
     {
-        return LORAMAC_STATUS_NO_NETWORK_JOINED;
-    }
-    if( Nvm.MacGroup2.MaxDCycle == 0 )
-    {
-        Nvm.MacGroup1.AggregatedTimeOff = 0;
+        delay++;
     }
+    Nvm.MacGroup2.MacParams.ReceiveDelay1 = delay * 1000;
+    Nvm.MacGroup2.MacParams.ReceiveDelay2 = Nvm.MacGroup2.MacParams.ReceiveDelay1 + 1000;
+    LoRaMacCommandsAddCmd( MOTE_MAC_RX_TIMING_SETUP_ANS, macCmdPayload, 0 );
+}
 
-    fCtrl.Value = 0;
-    fCtrl.Bits.FOptsLen      = 0;
-    fCtrl.Bits.Adr           = Nvm.MacGroup2.AdrCtrlOn;
+static void ProcessTxParamSetupReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    uint8_t macCmdPayload[1] = { 0x00 };
+    TxParamSetupReqParams_t txParamSetupReq;
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    uint8_t eirpDwellTime = payload[0];
 
-    // Check class b
-    if( Nvm.MacGroup2.DeviceClass == CLASS_B )
+    txParamSetupReq.UplinkDwellTime = 0;
+    txParamSetupReq.DownlinkDwellTime = 0;
+
+    if( ( eirpDwellTime & 0x20 ) == 0x20 )
     {
-        fCtrl.Bits.FPending      = 1;
+        txParamSetupReq.DownlinkDwellTime = 1;
     }
-    else
+    if( ( eirpDwellTime & 0x10 ) == 0x10 )
     {
-        fCtrl.Bits.FPending      = 0;
+        txParamSetupReq.UplinkDwellTime = 1;
     }
+    txParamSetupReq.MaxEirp = eirpDwellTime & 0x0F;
 
-    // Check server ack
-    if( Nvm.MacGroup1.SrvAckRequested == true )
+    // Check the status for correctness
+    if( RegionTxParamSetupReq( stream->Region, &txParamSetupReq ) != -1 )
     {
-        fCtrl.Bits.Ack = 1;
+        // Accept command
+        Nvm.MacGroup2.MacParams.UplinkDwellTime = txParamSetupReq.UplinkDwellTime;
+        Nvm.MacGroup2.MacParams.DownlinkDwellTime = txParamSetupReq.DownlinkDwellTime;
+        Nvm.MacGroup2.MacParams.MaxEirp = LoRaMacMaxEirpTable[txParamSetupReq.MaxEirp];
+        // Update the datarate in case of the new configuration limits it
+        getPhy.Attribute = PHY_MIN_TX_DR;
+        getPhy.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+        phyParam = RegionGetPhyParam( stream->Region, &getPhy );
+        Nvm.MacGroup1.ChannelsDatarate = MAX( Nvm.MacGroup1.ChannelsDatarate, ( int8_t )phyParam.Value );
+
+        // Add command response
+        LoRaMacCommandsAddCmd( MOTE_MAC_TX_PARAM_SETUP_ANS, macCmdPayload, 0 );
     }
+}
 
-    // ADR next request
-    adrNext.UpdateChanMask = true;
-    adrNext.AdrEnabled = fCtrl.Bits.Adr;
-    adrNext.AdrAckCounter = Nvm.MacGroup1.AdrAckCounter;
-    adrNext.AdrAckLimit = Nvm.MacGroup2.MacParams.AdrAckLimit;
-    adrNext.AdrAckDelay = Nvm.MacGroup2.MacParams.AdrAckDelay;
-    adrNext.Datarate = Nvm.MacGroup1.ChannelsDatarate;
-    adrNext.TxPower = Nvm.MacGroup1.ChannelsTxPower;
-    adrNext.UplinkDwellTime =  Nvm.MacGroup2.MacParams.UplinkDwellTime;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+static void ProcessRekeyConf( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    ConfirmStickyCmd( MOTE_MAC_REKEY_IND, payload[0] );
+}
+#endif /* LORAMAC_VERSION */
+
+static void ProcessDlChannelReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    DlChannelReqParams_t dlChannelReq;
+    uint8_t status = 0x03;
+
+    dlChannelReq.ChannelId = payload[0];
+    dlChannelReq.Rx1Frequency = ( uint32_t ) payload[1];
+    dlChannelReq.Rx1Frequency |= ( uint32_t ) payload[2] << 8;
+    dlChannelReq.Rx1Frequency |= ( uint32_t ) payload[3] << 16;
+    dlChannelReq.Rx1Frequency *= 100;
+
+    status = ( uint8_t )RegionDlChannelReq( stream->Region, &dlChannelReq );
+
+    if( ( int8_t )status >= 0 )
+    {
+        LoRaMacCommandsAddCmd( MOTE_MAC_DL_CHANNEL_ANS, &status, 1 );
+    }
+}
+
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+static void ProcessAdrParamSetupReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    uint8_t macCmdPayload[1] = { 0x00 };
+    /* ADRParamSetupReq Payload:  ADRparam
+     * +----------------+---------------+
+     * | 7:4 Limit_exp  | 3:0 Delay_exp |
+     * +----------------+---------------+
+     */
+
+    uint8_t delayExp = 0x0F & payload[0];
+    uint8_t limitExp = 0x0F & ( payload[0] >> 4 );
+
+    // ADR_ACK_ DELAY = 2^Delay_exp
+    Nvm.MacGroup2.MacParams.AdrAckDelay = 0x01 << delayExp;
+
+    // ADR_ACK_LIMIT = 2^Limit_exp
+    Nvm.MacGroup2.MacParams.AdrAckLimit = 0x01 << limitExp;
+
+    LoRaMacCommandsAddCmd( MOTE_MAC_ADR_PARAM_SETUP_ANS, macCmdPayload, 0 );
+}
+
+static void ProcessForceRejoinReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    /* ForceRejoinReq Payload:
+     * +--------------+------------------+-------+----------------+--------+
+     * | 13:11 Period | 10:8 Max_Retries | 7 RFU | 6:4 RejoinType | 3:0 DR |
+     * +--------------+------------------+-------+----------------+--------+
+     */
+
+    // Parse payload
+    uint8_t period = ( 0x38 & payload[0] ) >> 3;
+    Nvm.MacGroup2.ForceRejoinMaxRetries = 0x07 & payload[0];
+    Nvm.MacGroup2.ForceRejoinType = ( 0x70 & payload[1] ) >> 4;
+    Nvm.MacGroup1.ChannelsDatarate = 0x0F & payload[1];
+
+    // Calc delay between retransmissions: 32 seconds x 2^Period + Rand32
+    uint32_t rejoinCycleInSec = 32 * ( 0x01 << period ) + randr( 0, 32 );
+
+    MacCtx.ForceRejoinCycleTime = 0;
+    Nvm.MacGroup1.ForceRejoinRetriesCounter = 0;
+    ConvertRejoinCycleTime( rejoinCycleInSec, &MacCtx.ForceRejoinCycleTime );
+    OnForceRejoinReqCycleTimerEvent( NULL );
+}
+
+static void ProcessRejoinParamReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    /* RejoinParamSetupReq Payload:
+     * +----------------+---------------+
+     * | 7:4 MaxTimeN   | 3:0 MaxCountN |
+     * +----------------+---------------+
+     */
+    uint8_t maxCountN = 0x0F & payload[0];
+    uint8_t maxTimeN = 0x0F & ( payload[0] >> 4 );
+    uint32_t cycleInSec = 0x01 << ( maxTimeN + 10 );
+    uint32_t timeInMs = 0;
+    uint16_t uplinkLimit = 0x01 << ( maxCountN + 4 );
+    uint8_t status = 0;
+
+    if( ConvertRejoinCycleTime( cycleInSec, &timeInMs ) == true )
+    {
+        // Calc delay between retransmissions: 2^(maxTimeN+10)
+        Nvm.MacGroup2.Rejoin0CycleInSec = cycleInSec;
+        // Calc number if uplinks without rejoin request: 2^(maxCountN+4)
+        Nvm.MacGroup2.Rejoin0UplinksLimit = uplinkLimit;
+        MacCtx.Rejoin0CycleTime = timeInMs;
+
+        status = 0x01;
+        TimerStop( &MacCtx.Rejoin0CycleTimer );
+        StartCoalescedTimer( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
+    }
+    LoRaMacCommandsAddCmd( MOTE_MAC_REJOIN_PARAM_ANS, &status, 1 );
+}
+
+static void ProcessDeviceModeConf( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    MacCommand_t* macCmd;
+
+    // 1 byte payload which we do not handle.
+    if( LoRaMacCommandsGetCmd( MOTE_MAC_DEVICE_MODE_IND, &macCmd ) == LORAMAC_COMMANDS_SUCCESS )
+    {
+        LoRaMacCommandsRemoveCmd( macCmd );
+    }
+}
+#endif /* LORAMAC_VERSION */
+
+static void ProcessDeviceTimeAns( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    // The mote time can be updated only when the time is received in classA
+    // receive windows only.
+    if( LoRaMacConfirmQueueIsCmdActive( MLME_DEVICE_TIME ) == true )
+    {
+        LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_DEVICE_TIME );
+
+        SysTime_t gpsEpochTime = { 0 };
+        SysTime_t sysTime = { 0 };
+        SysTime_t sysTimeCurrent = { 0 };
+
+        gpsEpochTime.Seconds = ( uint32_t )payload[0];
+        gpsEpochTime.Seconds |= ( uint32_t )payload[1] << 8;
+        gpsEpochTime.Seconds |= ( uint32_t )payload[2] << 16;
+        gpsEpochTime.Seconds |= ( uint32_t )payload[3] << 24;
+        gpsEpochTime.SubSeconds = payload[4];
+
+        // Convert the fractional second received in ms
+        // round( pow( 0.5, 8.0 ) * 1000 ) = 3.90625
+        gpsEpochTime.SubSeconds = ( int16_t )( ( ( int32_t )gpsEpochTime.SubSeconds * 1000 ) >> 8 );
+
+        // Copy received GPS Epoch time into system time
+        sysTime = gpsEpochTime;
+        // Add Unix to Gps epoch offset. The system time is based on Unix time.
+        sysTime.Seconds += UNIX_GPS_EPOCH_OFFSET;
+
+        // Compensate time difference between Tx Done time and now
+        sysTimeCurrent = SysTimeGet( );
+        sysTime = SysTimeAdd( sysTimeCurrent, SysTimeSub( sysTime, MacCtx.LastTxSysTime ) );
+
+        // Apply the new system time.
+        SysTimeSet( sysTime );
+        LoRaMacClassBDeviceTimeAns( );
+        MacCtx.McpsIndication.DeviceTimeAnsReceived = true;
+    }
+    else
+    {
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+        // In case of other receive windows the Device Time Answer is not received.
+        MacCtx.McpsIndication.DeviceTimeAnsReceived = false;
+#endif /* LORAMAC_VERSION */
+    }
+}
+
+static void ProcessPingSlotInfoAns( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    if( LoRaMacConfirmQueueIsCmdActive( MLME_PING_SLOT_INFO ) == true )
+    {
+        LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_PING_SLOT_INFO );
+        // According to the specification, it is not allowed to process this answer in
+        // a ping or multicast slot
+        if( ( MacCtx.RxSlot != RX_SLOT_WIN_CLASS_B_PING_SLOT ) && ( MacCtx.RxSlot != RX_SLOT_WIN_CLASS_B_MULTICAST_SLOT ) )
+        {
+            LoRaMacClassBPingSlotInfoAns( );
+        }
+    }
+}
+
+static void ProcessPingSlotChannelReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    uint8_t status = 0x03;
+    uint32_t frequency = 0;
+    uint8_t datarate;
+
+    frequency = ( uint32_t )payload[0];
+    frequency |= ( uint32_t )payload[1] << 8;
+    frequency |= ( uint32_t )payload[2] << 16;
+    frequency *= 100;
+    datarate = payload[3] & 0x0F;
+
+    status = LoRaMacClassBPingSlotChannelReq( datarate, frequency );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    LoRaMacCommandsAddCmd( MOTE_MAC_PING_SLOT_FREQ_ANS, &status, 1 );
+#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    LoRaMacCommandsAddCmd( MOTE_MAC_PING_SLOT_CHANNEL_ANS, &status, 1 );
+#endif /* LORAMAC_VERSION */
+}
+
+static void ProcessBeaconTimingAns( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    if( LoRaMacConfirmQueueIsCmdActive( MLME_BEACON_TIMING ) == true )
+    {
+        LoRaMacConfirmQueueSetStatus( LORAMAC_EVENT_INFO_STATUS_OK, MLME_BEACON_TIMING );
+        uint16_t beaconTimingDelay = 0;
+        uint8_t beaconTimingChannel = 0;
+
+        beaconTimingDelay = ( uint16_t )payload[0];
+        beaconTimingDelay |= ( uint16_t )payload[1] << 8;
+        beaconTimingChannel = payload[2];
+
+        LoRaMacClassBBeaconTimingAns( beaconTimingDelay, beaconTimingChannel, RxDoneParams.LastRxDone );
+    }
+}
+
+static void ProcessBeaconFreqReq( MacCommandsStream_t* stream, const uint8_t* payload )
+{
+    uint32_t frequency = 0;
+    uint8_t status = 0;
+
+    frequency = ( uint32_t )payload[0];
+    frequency |= ( uint32_t )payload[1] << 8;
+    frequency |= ( uint32_t )payload[2] << 16;
+    frequency *= 100;
+
+    if( LoRaMacClassBBeaconFreqReq( frequency ) == true )
+    {
+        status = 1;
+    }
+    LoRaMacCommandsAddCmd( MOTE_MAC_BEACON_FREQ_ANS, &status, 1 );
+}
+
+/*!
+ * Handlers of the MAC commands received from the server, indexed by CID.
+ * The commands without handler end the processing.
+ */
+static const MacCommandHandler_t MacCommandHandlers[] =
+{
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    [SRV_MAC_RESET_CONF]             = ProcessResetConf,
+#endif /* LORAMAC_VERSION */
+    [SRV_MAC_LINK_CHECK_ANS]         = ProcessLinkCheckAns,
+    [SRV_MAC_LINK_ADR_REQ]           = ProcessLinkAdrReq,
+    [SRV_MAC_DUTY_CYCLE_REQ]         = ProcessDutyCycleReq,
+    [SRV_MAC_RX_PARAM_SETUP_REQ]     = ProcessRxParamSetupReq,
+    [SRV_MAC_DEV_STATUS_REQ]         = ProcessDevStatusReq,
+    [SRV_MAC_NEW_CHANNEL_REQ]        = ProcessNewChannelReq,
+    [SRV_MAC_RX_TIMING_SETUP_REQ]    = ProcessRxTimingSetupReq,
+    [SRV_MAC_TX_PARAM_SETUP_REQ]     = ProcessTxParamSetupReq,
+    [SRV_MAC_DL_CHANNEL_REQ]         = ProcessDlChannelReq,
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    [SRV_MAC_REKEY_CONF]             = ProcessRekeyConf,
+    [SRV_MAC_ADR_PARAM_SETUP_REQ]    = ProcessAdrParamSetupReq,
+#endif /* LORAMAC_VERSION */
+    [SRV_MAC_DEVICE_TIME_ANS]        = ProcessDeviceTimeAns,
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    [SRV_MAC_FORCE_REJOIN_REQ]       = ProcessForceRejoinReq,
+    [SRV_MAC_REJOIN_PARAM_REQ]       = ProcessRejoinParamReq,
+#endif /* LORAMAC_VERSION */
+    [SRV_MAC_PING_SLOT_INFO_ANS]     = ProcessPingSlotInfoAns,
+    [SRV_MAC_PING_SLOT_CHANNEL_REQ]  = ProcessPingSlotChannelReq,
+    [SRV_MAC_BEACON_TIMING_ANS]      = ProcessBeaconTimingAns,
+    [SRV_MAC_BEACON_FREQ_REQ]        = ProcessBeaconFreqReq,
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    [SRV_MAC_DEVICE_MODE_CONF]       = ProcessDeviceModeConf,
+#endif /* LORAMAC_VERSION */
+};
+
+static void ProcessMacCommands( uint8_t *payload, uint8_t macIndex, uint8_t commandsSize, int8_t snr, LoRaMacRxSlot_t rxSlot )
+{
+    MacCommandsStream_t stream;
+    MacCommandHandler_t handler;
+    uint8_t cid;
+
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    if( ( rxSlot != RX_SLOT_WIN_1 ) && ( rxSlot != RX_SLOT_WIN_2 ) )
+    {
+        // Do only parse MAC commands for Class A RX windows
+        return;
+    }
+#endif /* LORAMAC_VERSION */
+
+    if( macIndex >= commandsSize )
+    {
+        return;
+    }
+
+    // Validate the whole stream once: only the complete MAC commands preceding
+    // the first unknown or truncated command are processed
+    stream.Payload = payload;
+    stream.Size = macIndex + LoRaMacCommandsGetValidSize( &payload[macIndex], commandsSize - macIndex );
+    stream.Snr = snr;
+    stream.AdrBlockFound = false;
+    // The MAC state the commands do not change is read once for the stream
+    stream.Region = Nvm.MacGroup2.Region;
+    stream.Version = Nvm.MacGroup2.Version;
+    stream.AdrCtrlOn = Nvm.MacGroup2.AdrCtrlOn;
+
+    while( macIndex < stream.Size )
+    {
+        cid = payload[macIndex];
+        handler = ( cid < ( sizeof( MacCommandHandlers ) / sizeof( MacCommandHandlers[0] ) ) ) ? MacCommandHandlers[cid] : NULL;
+        if( handler == NULL )
+        {
+            // Unknown command. ABORT MAC commands processing
+            return;
+        }
+
+        // The next command starts after the descriptor size, whatever the handler consumed
+        stream.CmdIndex = macIndex;
+        stream.CmdSize = LoRaMacCommandsGetCmdSize( cid );
+        handler( &stream, &payload[macIndex + 1] );
+        macIndex = stream.CmdIndex + stream.CmdSize;
+    }
+}
+
+static LoRaMacStatus_t Send( LoRaMacHeader_t* macHdr, uint8_t fPort, void* fBuffer, uint16_t fBufferSize, bool allowDelayedTx )
+{
+    LoRaMacFrameCtrl_t fCtrl;
+    LoRaMacStatus_t status = LORAMAC_STATUS_PARAMETER_INVALID;
+    int8_t datarate = Nvm.MacGroup1.ChannelsDatarate;
+    int8_t txPower = Nvm.MacGroup1.ChannelsTxPower;
+    uint32_t adrAckCounter = Nvm.MacGroup1.AdrAckCounter;
+    CalcNextAdrParams_t adrNext;
+
+    // Check if we are joined
+    if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
+    {
+        return LORAMAC_STATUS_NO_NETWORK_JOINED;
+    }
+    if( Nvm.MacGroup2.MaxDCycle == 0 )
+    {
+        Nvm.MacGroup1.AggregatedTimeOff = 0;
+    }
+
+    fCtrl.Value = 0;
+    fCtrl.Bits.FOptsLen      = 0;
+    fCtrl.Bits.Adr           = Nvm.MacGroup2.AdrCtrlOn;
+
+    // Check class b
+    if( Nvm.MacGroup2.DeviceClass == CLASS_B )
+    {
+        fCtrl.Bits.FPending      = 1;
+    }
+    else
+    {
+        fCtrl.Bits.FPending      = 0;
+    }
+
+    // Check server ack
+    if( Nvm.MacGroup1.SrvAckRequested == true )
+    {
+        fCtrl.Bits.Ack = 1;
+    }
+
+    // ADR next request
+    adrNext.UpdateChanMask = true;
+    adrNext.AdrEnabled = fCtrl.Bits.Adr;
+    adrNext.AdrAckCounter = Nvm.MacGroup1.AdrAckCounter;
+    adrNext.AdrAckLimit = Nvm.MacGroup2.MacParams.AdrAckLimit;
+    adrNext.AdrAckDelay = Nvm.MacGroup2.MacParams.AdrAckDelay;
+    adrNext.Datarate = Nvm.MacGroup1.ChannelsDatarate;
+    adrNext.TxPower = Nvm.MacGroup1.ChannelsTxPower;
+    adrNext.UplinkDwellTime =  Nvm.MacGroup2.MacParams.UplinkDwellTime;
     adrNext.Region = Nvm.MacGroup2.Region;
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
     adrNext.Version = Nvm.MacGroup2.Version;
@@ -3338,6 +3944,7 @@ static LoRaMacStatus_t Send( LoRaMacHeader_t* macHdr, uint8_t fPort, void* fBuff
 
     // Prepare the frame
     status = PrepareFrame( macHdr, &fCtrl, fPort, fBuffer, fBufferSize );
+    ExpectRxErrorLearning( fCtrl.Bits.AdrAckReq == 1 );
 
     // Validate status
     if( ( status == LORAMAC_STATUS_OK ) || ( status == LORAMAC_STATUS_SKIPPED_APP_DATA ) )
@@ -3375,6 +3982,8 @@ static LoRaMacStatus_t SendReJoinReq( JoinReqIdentifier_t joinReqType )
     macHdr.Value = 0;
     bool allowDelayedTx = true;
 
+    MacCtx.SecuredFrameCache.IsValid = false;
+
     // Setup join/rejoin message
     switch( joinReqType )
     {
@@ -3488,20 +4097,22 @@ static LoRaMacStatus_t CheckForClassBCollision( void )
 
 static void ComputeRxWindowParameters( void )
 {
+    int8_t rx1Datarate = RegionApplyDrOffset( Nvm.MacGroup2.Region,
+                                              Nvm.MacGroup2.MacParams.DownlinkDwellTime,
+                                              Nvm.MacGroup1.ChannelsDatarate,
+                                              Nvm.MacGroup2.MacParams.Rx1DrOffset );
+
     // Compute Rx1 windows parameters
     RegionComputeRxWindowParameters( Nvm.MacGroup2.Region,
-                                     RegionApplyDrOffset( Nvm.MacGroup2.Region,
-                                                          Nvm.MacGroup2.MacParams.DownlinkDwellTime,
-                                                          Nvm.MacGroup1.ChannelsDatarate,
-                                                          Nvm.MacGroup2.MacParams.Rx1DrOffset ),
+                                     rx1Datarate,
                                      Nvm.MacGroup2.MacParams.MinRxSymbols,
-                                     Nvm.MacGroup2.MacParams.SystemMaxRxError,
+                                     GetRxError( RX_SLOT_WIN_1, rx1Datarate ),
                                      &MacCtx.RxWindow1Config );
     // Compute Rx2 windows parameters
     RegionComputeRxWindowParameters( Nvm.MacGroup2.Region,
                                      Nvm.MacGroup2.MacParams.Rx2Channel.Datarate,
                                      Nvm.MacGroup2.MacParams.MinRxSymbols,
-                                     Nvm.MacGroup2.MacParams.SystemMaxRxError,
+                                     GetRxError( RX_SLOT_WIN_2, Nvm.MacGroup2.MacParams.Rx2Channel.Datarate ),
                                      &MacCtx.RxWindow2Config );
 
     // Default setup, in case the device joined
@@ -3587,6 +4198,8 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     LoRaMacStatus_t status = LORAMAC_STATUS_PARAMETER_INVALID;
     NextChanParams_t nextChan;
 
+    LORAMAC_PROFILING_START( LORAMAC_PROFILING_TX_SCHEDULE );
+
     // Check class b collisions
     status = CheckForClassBCollision( );
     if( status != LORAMAC_STATUS_OK )
@@ -3597,11 +4210,18 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     // Update back-off
     CalculateBackOff( );
 
-    // Serialize frame
-    status = SerializeTxFrame( );
-    if( status != LORAMAC_STATUS_OK )
+    // Serialize frame, repetitions keep the frame secured for the previous transmission
+    if( IsSecuredFrameCached( ) == true )
     {
-        return status;
+        MacCtx.PktBufferLen = MacCtx.SecuredFrameCache.BufSize;
+    }
+    else
+    {
+        status = SerializeTxFrame( );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            return status;
+        }
     }
 
     nextChan.AggrTimeOff = Nvm.MacGroup1.AggregatedTimeOff;
@@ -3612,6 +4232,7 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
     nextChan.LastTxIsJoinRequest = false;
     nextChan.Joined = true;
     nextChan.PktLen = MacCtx.PktBufferLen;
+    nextChan.QueryOnly = false;
 
     // Setup the parameters based on the join status
     if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
@@ -3658,6 +4279,8 @@ static LoRaMacStatus_t ScheduleTx( bool allowDelayedTx )
         return status;
     }
 
+    LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_TX_SCHEDULE );
+
     // Try to send now
     return SendFrameOnChannel( MacCtx.Channel );
 }
@@ -3671,6 +4294,10 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh )
     {
         case LORAMAC_MSG_TYPE_JOIN_REQUEST:
             macCryptoStatus = LoRaMacCryptoPrepareJoinRequest( &MacCtx.TxMsg.Message.JoinReq );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+            // The DevNonce is drawn from the radio random generator
+            RegionCommonRadioShadowInvalidate( );
+#endif /* LORAMAC_VERSION */
             if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
             {
                 return LORAMAC_STATUS_CRYPTO_ERROR;
@@ -3711,11 +4338,33 @@ static LoRaMacStatus_t SecureFrame( uint8_t txDr, uint8_t txCh )
                 fCntUp -= 1;
             }
 
-            macCryptoStatus = LoRaMacCryptoSecureMessage( fCntUp, txDr, txCh, &MacCtx.TxMsg.Message.Data );
-            if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
+            if( ( IsSecuredFrameCached( ) == true ) && ( MacCtx.SecuredFrameCache.FCntUp == fCntUp ) )
             {
-                return LORAMAC_STATUS_CRYPTO_ERROR;
+                // The payload is already encrypted, only the MIC may depend on the data rate and channel
+                if( ( MacCtx.SecuredFrameCache.Datarate != txDr ) || ( MacCtx.SecuredFrameCache.Channel != txCh ) )
+                {
+                    macCryptoStatus = LoRaMacCryptoUpdateMessageMic( fCntUp, txDr, txCh, &MacCtx.TxMsg.Message.Data );
+                    if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
+                    {
+                        MacCtx.SecuredFrameCache.IsValid = false;
+                        return LORAMAC_STATUS_CRYPTO_ERROR;
+                    }
+                }
+            }
+            else
+            {
+                macCryptoStatus = LoRaMacCryptoSecureMessage( fCntUp, txDr, txCh, &MacCtx.TxMsg.Message.Data );
+                if( LORAMAC_CRYPTO_SUCCESS != macCryptoStatus )
+                {
+                    MacCtx.SecuredFrameCache.IsValid = false;
+                    return LORAMAC_STATUS_CRYPTO_ERROR;
+                }
+                MacCtx.SecuredFrameCache.IsValid = true;
+                MacCtx.SecuredFrameCache.FCntUp = fCntUp;
+                MacCtx.SecuredFrameCache.BufSize = MacCtx.TxMsg.Message.Data.BufSize;
             }
+            MacCtx.SecuredFrameCache.Datarate = txDr;
+            MacCtx.SecuredFrameCache.Channel = txCh;
             MacCtx.PktBufferLen = MacCtx.TxMsg.Message.Data.BufSize;
             break;
         case LORAMAC_MSG_TYPE_JOIN_ACCEPT:
@@ -3900,6 +4549,8 @@ static void RxWindowSetup( TimerEvent_t* rxTimer, RxConfigParams_t* rxConfig )
     {
         MacCtx.MlmeIndication.RxDatarate = MacCtx.McpsIndication.RxDatarate;
         Radio.Rx( Nvm.MacGroup2.MacParams.MaxRxWindow );
+        LORAMAC_ENERGY_SET_STATE( ( rxConfig->RxContinuous == true ) ? LORAMAC_ENERGY_STATE_RX_CONTINUOUS : LORAMAC_ENERGY_STATE_RX_WINDOW,
+                                  MacCtx.McpsIndication.RxDatarate, 0 );
         MacCtx.RxSlot = rxConfig->RxSlot;
     }
 }
@@ -3926,6 +4577,7 @@ static void OpenContinuousRxCWindow( void )
     {
         MacCtx.MlmeIndication.RxDatarate = MacCtx.McpsIndication.RxDatarate;
         Radio.Rx( 0 ); // Continuous mode
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CONTINUOUS, MacCtx.McpsIndication.RxDatarate, 0 );
         MacCtx.RxSlot = MacCtx.RxWindowCConfig.RxSlot;
     }
 }
@@ -3934,6 +4586,7 @@ static LoRaMacStatus_t PrepareFrame( LoRaMacHeader_t* macHdr, LoRaMacFrameCtrl_t
 {
     MacCtx.PktBufferLen = 0;
     MacCtx.NodeAckRequested = false;
+    MacCtx.SecuredFrameCache.IsValid = false;
     uint32_t fCntUp = 0;
     size_t macCmdsSize = 0;
     uint8_t availableSize = 0;
@@ -4045,6 +4698,8 @@ static LoRaMacStatus_t SendFrameOnChannel( uint8_t channel )
     TxConfigParams_t txConfig;
     int8_t txPower = 0;
 
+    LORAMAC_PROFILING_START( LORAMAC_PROFILING_TX_SEND_FRAME );
+
     txConfig.Channel = channel;
     txConfig.Datarate = Nvm.MacGroup1.ChannelsDatarate;
     txConfig.TxPower = Nvm.MacGroup1.ChannelsTxPower;
@@ -4105,7 +4760,10 @@ static LoRaMacStatus_t SendFrameOnChannel( uint8_t channel )
     MacCtx.ResponseTimeoutStartTime = 0;
 #endif /* LORAMAC_VERSION */
 
+    LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_TX_SEND_FRAME );
+
     // Send now
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_TX, Nvm.MacGroup1.ChannelsDatarate, txPower );
     Radio.Send( MacCtx.PktBuffer, MacCtx.PktBufferLen );
 
     return LORAMAC_STATUS_OK;
@@ -4132,7 +4790,9 @@ static LoRaMacStatus_t SetTxContinuousWave( uint16_t timeout )
 
 static LoRaMacStatus_t SetTxContinuousWave1( uint16_t timeout, uint32_t frequency, uint8_t power )
 {
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_TX, -1, -1 );
     Radio.SetTxContinuousWave( frequency, power, timeout );
+    RegionCommonRadioShadowInvalidate( );
 
     MacCtx.MacState |= LORAMAC_TX_RUNNING;
 
@@ -4141,7 +4801,9 @@ static LoRaMacStatus_t SetTxContinuousWave1( uint16_t timeout, uint32_t frequenc
 #elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
 static LoRaMacStatus_t SetTxContinuousWave( uint16_t timeout, uint32_t frequency, uint8_t power )
 {
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_TX, -1, -1 );
     Radio.SetTxContinuousWave( frequency, power, timeout );
+    RegionCommonRadioShadowInvalidate( );
 
     MacCtx.MacState |= LORAMAC_TX_RUNNING;
 
@@ -4192,6 +4854,16 @@ static LoRaMacStatus_t RestoreNvmData( void )
         return LORAMAC_STATUS_NVM_DATA_INCONSISTENT;
     }
 
+#if (defined( REGION_NVM_SIZED_BY_REGIONS ) && ( REGION_NVM_SIZED_BY_REGIONS == 1 ))
+    // The region groups are sized by the enabled regions, a context stored
+    // with another set of regions can not be interpreted. The tag is read
+    // before the CRC, which covers a region group of the other layout.
+    if( NvmBackup.RegionGroup1.LayoutTag != REGION_NVM_LAYOUT_TAG )
+    {
+        return LORAMAC_STATUS_NVM_DATA_INCONSISTENT;
+    }
+#endif /* REGION_NVM_SIZED_BY_REGIONS */
+
     // RegionGroup1
     crc = Crc32( ( uint8_t* ) &(NvmBackup.RegionGroup1), sizeof( NvmBackup.RegionGroup1 ) -
                                             sizeof( NvmBackup.RegionGroup1.Crc32 ) );
@@ -4229,6 +4901,9 @@ static LoRaMacStatus_t RestoreNvmData( void )
     // from NVM and we thus need to synchronize the radio. The same function
     // is invoked in LoRaMacInitialization.
     Radio.SetPublicNetwork( Nvm.MacGroup2.PublicNetwork );
+    RegionCommonRadioShadowInvalidate( );
+
+    UpdateMcAddrTable( );
 #endif /* CONTEXT_MANAGEMENT_ENABLED == 1 */
 
     return LORAMAC_STATUS_OK;
@@ -4391,6 +5066,15 @@ static uint32_t IncreaseAdrAckCounter( uint32_t counter )
 }
 #endif /* LORAMAC_VERSION */
 
+static void UpdateChannelQuality( void )
+{
+    // A frame which has not been sent tells nothing about the channel
+    if( MacCtx.McpsConfirm.Status != LORAMAC_EVENT_INFO_STATUS_TX_TIMEOUT )
+    {
+        RegionCommonChannelQualityUpdate( MacCtx.Channel, MacCtx.McpsConfirm.AckReceived );
+    }
+}
+
 static bool StopRetransmission( void )
 {
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
@@ -4512,73 +5196,26 @@ static uint8_t IsRequestPending( void )
     return 0;
 }
 
-LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacCallback_t* callbacks, LoRaMacRegion_t region )
+static void InitRegionMacParamsDefaults( void )
 {
     GetPhyParams_t getPhy;
     PhyParam_t phyParam;
 
-    if( ( primitives == NULL ) ||
-        ( callbacks == NULL ) )
-    {
-        return LORAMAC_STATUS_PARAMETER_INVALID;
-    }
+    getPhy.Attribute = PHY_DUTY_CYCLE;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    Nvm.MacGroup2.DutyCycleOn = ( bool ) phyParam.Value;
 
-    if( ( primitives->MacMcpsConfirm == NULL ) ||
-        ( primitives->MacMcpsIndication == NULL ) ||
-        ( primitives->MacMlmeConfirm == NULL ) ||
-        ( primitives->MacMlmeIndication == NULL ) )
-    {
-        return LORAMAC_STATUS_PARAMETER_INVALID;
-    }
-    // Verify if the region is supported
-    if( RegionIsActive( region ) == false )
-    {
-        return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
-    }
+    getPhy.Attribute = PHY_DEF_TX_POWER;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    Nvm.MacGroup2.ChannelsTxPowerDefault = phyParam.Value;
 
-    // Confirm queue reset
-    LoRaMacConfirmQueueInit( primitives );
+    getPhy.Attribute = PHY_DEF_TX_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    Nvm.MacGroup2.ChannelsDatarateDefault = phyParam.Value;
 
-    // Initialize the module context with zeros
-    memset1( ( uint8_t* ) &Nvm, 0x00, sizeof( LoRaMacNvmData_t ) );
-    memset1( ( uint8_t* ) &MacCtx, 0x00, sizeof( LoRaMacCtx_t ) );
-
-    // Set non zero variables to its default value
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
-    MacCtx.AckTimeoutRetriesCounter = 1;
-    MacCtx.AckTimeoutRetries = 1;
-#endif /* LORAMAC_VERSION */
-    Nvm.MacGroup2.Region = region;
-    Nvm.MacGroup2.DeviceClass = CLASS_A;
-    Nvm.MacGroup2.MacParams.RepeaterSupport = false;
-
-    // Setup version
-    Nvm.MacGroup2.Version.Value = LORAMAC_VERSION;
-#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-    InitDefaultsParams_t params;
-    params.Type = INIT_TYPE_DEFAULTS;
-    params.NvmGroup1 = &Nvm.RegionGroup1;
-    params.NvmGroup2 = &Nvm.RegionGroup2;
-    params.Bands = &RegionBands;
-    RegionInitDefaults( Nvm.MacGroup2.Region, &params );
-#endif /* LORAMAC_VERSION */
-
-    // Reset to defaults
-    getPhy.Attribute = PHY_DUTY_CYCLE;
-    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
-    Nvm.MacGroup2.DutyCycleOn = ( bool ) phyParam.Value;
-
-    getPhy.Attribute = PHY_DEF_TX_POWER;
-    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
-    Nvm.MacGroup2.ChannelsTxPowerDefault = phyParam.Value;
-
-    getPhy.Attribute = PHY_DEF_TX_DR;
-    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
-    Nvm.MacGroup2.ChannelsDatarateDefault = phyParam.Value;
-
-    getPhy.Attribute = PHY_MAX_RX_WINDOW;
-    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
-    Nvm.MacGroup2.MacParamsDefaults.MaxRxWindow = phyParam.Value;
+    getPhy.Attribute = PHY_MAX_RX_WINDOW;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    Nvm.MacGroup2.MacParamsDefaults.MaxRxWindow = phyParam.Value;
 
     getPhy.Attribute = PHY_RECEIVE_DELAY1;
     phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
@@ -4633,6 +5270,68 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     getPhy.Attribute = PHY_DEF_ADR_ACK_DELAY;
     phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
     Nvm.MacGroup2.MacParamsDefaults.AdrAckDelay = phyParam.Value;
+}
+
+LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacCallback_t* callbacks, LoRaMacRegion_t region )
+{
+    if( ( primitives == NULL ) ||
+        ( callbacks == NULL ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    if( ( primitives->MacMcpsConfirm == NULL ) ||
+        ( primitives->MacMcpsIndication == NULL ) ||
+        ( primitives->MacMlmeConfirm == NULL ) ||
+        ( primitives->MacMlmeIndication == NULL ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    // Verify if the region is supported
+    if( RegionIsActive( region ) == false )
+    {
+        return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+    }
+
+    // Confirm queue reset
+    LoRaMacConfirmQueueInit( primitives );
+
+    // Initialize the module context with zeros
+    memset1( ( uint8_t* ) &Nvm, 0x00, sizeof( LoRaMacNvmData_t ) );
+    memset1( ( uint8_t* ) &MacCtx, 0x00, sizeof( LoRaMacCtx_t ) );
+
+    // Set non zero variables to its default value
+    ResetRxErrorLearning( );
+    RegionCommonChannelQualityReset( );
+    RegionCommonLbtReset( );
+#if (defined( LORAMAC_REGION_SWITCH_ENABLED ) && ( LORAMAC_REGION_SWITCH_ENABLED == 1 ))
+    memset1( ( uint8_t* ) RegionSlots, 0x00, sizeof( RegionSlots ) );
+#endif /* LORAMAC_REGION_SWITCH_ENABLED */
+    UpdateMcAddrTable( );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    MacCtx.AckTimeoutRetriesCounter = 1;
+    MacCtx.AckTimeoutRetries = 1;
+#endif /* LORAMAC_VERSION */
+    Nvm.MacGroup2.Region = region;
+    Nvm.MacGroup2.DeviceClass = CLASS_A;
+    Nvm.MacGroup2.MacParams.RepeaterSupport = false;
+
+    // Setup version
+    Nvm.MacGroup2.Version.Value = LORAMAC_VERSION;
+#if (defined( REGION_NVM_SIZED_BY_REGIONS ) && ( REGION_NVM_SIZED_BY_REGIONS == 1 ))
+    Nvm.RegionGroup1.LayoutTag = REGION_NVM_LAYOUT_TAG;
+#endif /* REGION_NVM_SIZED_BY_REGIONS */
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    InitDefaultsParams_t params;
+    params.Type = INIT_TYPE_DEFAULTS;
+    params.NvmGroup1 = &Nvm.RegionGroup1;
+    params.NvmGroup2 = &Nvm.RegionGroup2;
+    params.Bands = &RegionBands;
+    RegionInitDefaults( Nvm.MacGroup2.Region, &params );
+#endif /* LORAMAC_VERSION */
+
+    // Reset to defaults
+    InitRegionMacParamsDefaults( );
 
     // Init parameters which are not set in function ResetMacParameters
     Nvm.MacGroup2.MacParamsDefaults.ChannelsNbTrans = 1;
@@ -4731,68 +5430,553 @@ LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacC
     srand1( Radio.Random( ) );
 
     Radio.SetPublicNetwork( Nvm.MacGroup2.PublicNetwork );
+    // The radio configuration is unknown after its initialization
+    RegionCommonRadioShadowInvalidate( );
     Radio.Sleep( );
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
+
+    LoRaMacEnableRequests( LORAMAC_REQUEST_HANDLING_ON );
+
+    return LORAMAC_STATUS_OK;
+}
+
+#if (defined( LORAMAC_REGION_SWITCH_ENABLED ) && ( LORAMAC_REGION_SWITCH_ENABLED == 1 ))
+static void SaveRegionSlot( void )
+{
+    LoRaMacRegionSlot_t* slot = &RegionSlots[0];
+
+    for( uint8_t i = 0; i < LORAMAC_REGION_SWITCH_NB_SLOTS; i++ )
+    {
+        if( ( RegionSlots[i].Valid == true ) && ( RegionSlots[i].Region == Nvm.MacGroup2.Region ) )
+        {
+            slot = &RegionSlots[i];
+            break;
+        }
+        if( ( slot->Valid == true ) &&
+            ( ( RegionSlots[i].Valid == false ) || ( RegionSlots[i].LastUse < slot->LastUse ) ) )
+        {
+            slot = &RegionSlots[i];
+        }
+    }
+
+    slot->Region = Nvm.MacGroup2.Region;
+    slot->Valid = true;
+    slot->LastUse = ++RegionSwitchCounter;
+    slot->RegionGroup1 = Nvm.RegionGroup1;
+    slot->RegionGroup2 = Nvm.RegionGroup2;
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    memcpy1( ( uint8_t* )slot->Bands, ( uint8_t* )RegionBands, sizeof( RegionBands ) );
+#endif /* LORAMAC_VERSION */
+    slot->MacParams = Nvm.MacGroup2.MacParams;
+    slot->MacParamsDefaults = Nvm.MacGroup2.MacParamsDefaults;
+    slot->ChannelsDatarate = Nvm.MacGroup1.ChannelsDatarate;
+    slot->ChannelsTxPower = Nvm.MacGroup1.ChannelsTxPower;
+    slot->ChannelsDatarateDefault = Nvm.MacGroup2.ChannelsDatarateDefault;
+    slot->ChannelsTxPowerDefault = Nvm.MacGroup2.ChannelsTxPowerDefault;
+    slot->DutyCycleOn = Nvm.MacGroup2.DutyCycleOn;
+}
+
+static bool RestoreRegionSlot( LoRaMacRegion_t region )
+{
+    for( uint8_t i = 0; i < LORAMAC_REGION_SWITCH_NB_SLOTS; i++ )
+    {
+        LoRaMacRegionSlot_t* slot = &RegionSlots[i];
+
+        if( ( slot->Valid == true ) && ( slot->Region == region ) )
+        {
+            Nvm.RegionGroup1 = slot->RegionGroup1;
+            Nvm.RegionGroup2 = slot->RegionGroup2;
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+            memcpy1( ( uint8_t* )RegionBands, ( uint8_t* )slot->Bands, sizeof( RegionBands ) );
+#endif /* LORAMAC_VERSION */
+            Nvm.MacGroup2.MacParams = slot->MacParams;
+            Nvm.MacGroup2.MacParamsDefaults = slot->MacParamsDefaults;
+            Nvm.MacGroup1.ChannelsDatarate = slot->ChannelsDatarate;
+            Nvm.MacGroup1.ChannelsTxPower = slot->ChannelsTxPower;
+            Nvm.MacGroup2.ChannelsDatarateDefault = slot->ChannelsDatarateDefault;
+            Nvm.MacGroup2.ChannelsTxPowerDefault = slot->ChannelsTxPowerDefault;
+            Nvm.MacGroup2.DutyCycleOn = slot->DutyCycleOn;
+            return true;
+        }
+    }
+    return false;
+}
+#endif /* LORAMAC_REGION_SWITCH_ENABLED */
+
+LoRaMacStatus_t LoRaMacRegionSwitch( LoRaMacRegion_t region )
+{
+#if (defined( LORAMAC_REGION_SWITCH_ENABLED ) && ( LORAMAC_REGION_SWITCH_ENABLED == 1 ))
+    LoRaMacParams_t macParams;
+
+    // Verify if the region is supported
+    if( RegionIsActive( region ) == false )
+    {
+        return LORAMAC_STATUS_REGION_NOT_SUPPORTED;
+    }
+    if( LoRaMacIsBusy( ) == true )
+    {
+        return LORAMAC_STATUS_BUSY;
+    }
+    // The class B beacon and class C window frequencies belong to the region
+    if( Nvm.MacGroup2.DeviceClass != CLASS_A )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    if( region == Nvm.MacGroup2.Region )
+    {
+        return LORAMAC_STATUS_OK;
+    }
+
+    LORAMAC_PROFILING_START( LORAMAC_PROFILING_REGION_SWITCH );
+
+    // Parameters which do not depend on the region
+    macParams = Nvm.MacGroup2.MacParams;
+
+    SaveRegionSlot( );
+    Nvm.MacGroup2.Region = region;
+
+    if( RestoreRegionSlot( region ) == false )
+    {
+        // First use of the region
+        InitDefaultsParams_t params;
+        params.Type = INIT_TYPE_DEFAULTS;
+        params.NvmGroup1 = &Nvm.RegionGroup1;
+        params.NvmGroup2 = &Nvm.RegionGroup2;
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+        params.Bands = &RegionBands;
+#endif /* LORAMAC_VERSION */
+        RegionInitDefaults( Nvm.MacGroup2.Region, &params );
+
+        InitRegionMacParamsDefaults( );
+        Nvm.MacGroup2.MacParams = Nvm.MacGroup2.MacParamsDefaults;
+        Nvm.MacGroup1.ChannelsTxPower = Nvm.MacGroup2.ChannelsTxPowerDefault;
+        Nvm.MacGroup1.ChannelsDatarate = Nvm.MacGroup2.ChannelsDatarateDefault;
+    }
+
+    Nvm.MacGroup2.MacParams.SystemMaxRxError = macParams.SystemMaxRxError;
+    Nvm.MacGroup2.MacParams.MinRxSymbols = macParams.MinRxSymbols;
+    Nvm.MacGroup2.MacParams.RepeaterSupport = macParams.RepeaterSupport;
+    Nvm.MacGroup2.MacParams.ReceiveDelay1 = macParams.ReceiveDelay1;
+    Nvm.MacGroup2.MacParams.ReceiveDelay2 = macParams.ReceiveDelay2;
+    Nvm.MacGroup2.MacParams.ChannelsNbTrans = macParams.ChannelsNbTrans;
+
+    // The learned channel and timing data are indexed by the channels and datarates of the region
+    ResetRxErrorLearning( );
+    RegionCommonChannelQualityReset( );
+    RegionCommonLbtReset( );
+    MacCtx.Channel = 0;
+
+    // Handle NVM potential changes
+    MacCtx.MacFlags.Bits.NvmHandle = 1;
+
+    LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_REGION_SWITCH );
+    return LORAMAC_STATUS_OK;
+#else
+    return LORAMAC_STATUS_SERVICE_UNKNOWN;
+#endif /* LORAMAC_REGION_SWITCH_ENABLED */
+}
+
+LoRaMacStatus_t LoRaMacStart( void )
+{
+    MacCtx.MacState = LORAMAC_IDLE;
+    UpdateRxSlotIdleState();
+    return LORAMAC_STATUS_OK;
+}
+
+LoRaMacStatus_t LoRaMacStop( void )
+{
+    if( LoRaMacIsBusy( ) == false )
+    {
+        if( Nvm.MacGroup2.DeviceClass == CLASS_C )
+        {
+            Radio.Sleep( );
+            LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
+        }
+        MacCtx.MacState = LORAMAC_STOPPED;
+        return LORAMAC_STATUS_OK;
+    }
+    else if(  MacCtx.MacState == LORAMAC_STOPPED )
+    {
+        return LORAMAC_STATUS_OK;
+    }
+    return LORAMAC_STATUS_BUSY;
+}
+
+LoRaMacStatus_t LoRaMacHalt( void )
+{
+    // Stop Timers
+    TimerStop( &MacCtx.TxDelayedTimer );
+    TimerStop( &MacCtx.RxWindowTimer1 );
+    TimerStop( &MacCtx.RxWindowTimer2 );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    TimerStop( &MacCtx.AckTimeoutTimer );
+#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    TimerStop( &MacCtx.RetransmitTimeoutTimer );
+#endif /* LORAMAC_VERSION */
+
+    // Take care about class B
+    LoRaMacClassBHaltBeaconing( );
+
+    // Switch off Radio
+    Radio.Sleep( );
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
+
+    MacCtx.MacState = LORAMAC_IDLE;
+
+#if (defined( CONTEXT_MANAGEMENT_ENABLED ) && ( CONTEXT_MANAGEMENT_ENABLED == 1 ))
+    LoRaMacHandleNvm( &Nvm );
+
+    // Preserve the Nvm context if data retention
+    memcpy1( ( uint8_t* ) &NvmBackup, ( uint8_t* ) &Nvm, sizeof( LoRaMacNvmData_t ) );
+#endif /* CONTEXT_MANAGEMENT_ENABLED */
+
+    MacCtx.MacState = LORAMAC_STOPPED;
+
+    return LORAMAC_STATUS_OK;
+}
+
+static bool IsTxInfoCacheValid( CalcNextAdrParams_t* adrNext )
+{
+    LoRaMacTxInfoCache_t* cache = &MacCtx.TxInfoCache;
+
+    if( ( adrNext->AdrEnabled == true ) &&
+        ( adrNext->AdrAckCounter >= ( ( uint32_t )adrNext->AdrAckLimit + adrNext->AdrAckDelay ) ) )
+    {
+        return false;
+    }
+
+    if( ( cache->IsValid == false ) ||
+        ( cache->Region != adrNext->Region ) ||
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+        ( cache->Version != adrNext->Version.Value ) ||
+        ( cache->ChannelsDatarateDefault != Nvm.MacGroup2.ChannelsDatarateDefault ) ||
+#endif /* LORAMAC_VERSION */
+        ( cache->AdrCtrlOn != adrNext->AdrEnabled ) ||
+        ( cache->ChannelsDatarate != adrNext->Datarate ) ||
+        ( cache->UplinkDwellTime != adrNext->UplinkDwellTime ) ||
+        ( cache->RepeaterSupport != Nvm.MacGroup2.MacParams.RepeaterSupport ) )
+    {
+        return false;
+    }
+    return true;
+}
+
+static void UpdateTxInfoCache( CalcNextAdrParams_t* adrNext, uint8_t payloadSize )
+{
+    LoRaMacTxInfoCache_t* cache = &MacCtx.TxInfoCache;
+
+    cache->Region = adrNext->Region;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    cache->Version = adrNext->Version.Value;
+    cache->ChannelsDatarateDefault = Nvm.MacGroup2.ChannelsDatarateDefault;
+#endif /* LORAMAC_VERSION */
+    cache->AdrCtrlOn = adrNext->AdrEnabled;
+    cache->ChannelsDatarate = adrNext->Datarate;
+    cache->UplinkDwellTime = adrNext->UplinkDwellTime;
+    cache->RepeaterSupport = Nvm.MacGroup2.MacParams.RepeaterSupport;
+    cache->CurrentPossiblePayloadSize = payloadSize;
+    cache->IsValid = true;
+}
+
+static bool IsSecuredFrameCached( void )
+{
+    if( ( MacCtx.TxMsg.Type == LORAMAC_MSG_TYPE_DATA ) && ( MacCtx.SecuredFrameCache.IsValid == true ) )
+    {
+        return true;
+    }
+    return false;
+}
+
+static uint32_t GetRxError( LoRaMacRxSlot_t rxSlot, int8_t datarate )
+{
+    uint32_t rxError = Nvm.MacGroup2.MacParams.SystemMaxRxError;
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+    uint8_t learned = LORAMAC_RX_ERROR_UNKNOWN;
+
+    // Join-accept windows are always opened with the configured error
+    if( ( MacCtx.TxMsg.Type != LORAMAC_MSG_TYPE_DATA ) || ( datarate < 0 ) ||
+        ( datarate >= LORAMAC_RX_ERROR_LEARNING_NB_DR ) )
+    {
+        return rxError;
+    }
+    if( rxSlot == RX_SLOT_WIN_1 )
+    {
+        learned = MacCtx.RxErrorLearned[0][datarate];
+    }
+    else if( rxSlot == RX_SLOT_WIN_2 )
+    {
+        learned = MacCtx.RxErrorLearned[1][datarate];
+    }
+    if( learned != LORAMAC_RX_ERROR_UNKNOWN )
+    {
+        rxError = MIN( rxError, ( uint32_t )learned + LORAMAC_RX_ERROR_LEARNING_MARGIN );
+    }
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+    return rxError;
+}
+
+static void LearnRxError( LoRaMacRxSlot_t rxSlot, uint16_t size, bool framePending )
+{
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    RxConfigParams_t* rxConfig = NULL;
+    uint8_t* learned = NULL;
+    uint32_t receiveDelay = 0;
+    uint32_t bandwidth = 0;
+    uint32_t spreadingFactor = 0;
+    TimerTime_t timeOnAir = 0;
+    int32_t rxError = 0;
+
+    if( MacCtx.TxMsg.Type != LORAMAC_MSG_TYPE_DATA )
+    {
+        return;
+    }
+    if( rxSlot == RX_SLOT_WIN_1 )
+    {
+        rxConfig = &MacCtx.RxWindow1Config;
+        learned = MacCtx.RxErrorLearned[0];
+        receiveDelay = Nvm.MacGroup2.MacParams.ReceiveDelay1;
+    }
+    else if( rxSlot == RX_SLOT_WIN_2 )
+    {
+        rxConfig = &MacCtx.RxWindow2Config;
+        learned = MacCtx.RxErrorLearned[1];
+        receiveDelay = Nvm.MacGroup2.MacParams.ReceiveDelay2;
+    }
+    else
+    {
+        return;
+    }
+
+    // The expected downlink has been received, the next one is expected
+    // after the next uplink when the network has more data
+    MacCtx.RxErrorDownlinkExpected = false;
+    MacCtx.RxErrorFramePending = framePending;
+
+    if( ( rxConfig->Datarate < 0 ) || ( rxConfig->Datarate >= LORAMAC_RX_ERROR_LEARNING_NB_DR ) )
+    {
+        return;
+    }
+
+    getPhy.Attribute = PHY_SF_FROM_DR;
+    getPhy.Datarate = rxConfig->Datarate;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    spreadingFactor = phyParam.Value;
+
+    getPhy.Attribute = PHY_BW_FROM_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    bandwidth = phyParam.Value;
+
+    // The downlink preamble started one time on air before the RX done event,
+    // it was expected receiveDelay after the end of the uplink.
+    if( ( spreadingFactor >= 5 ) && ( spreadingFactor <= 12 ) )
+    {
+        timeOnAir = RegionCommonComputeTimeOnAirLoRa( bandwidth, spreadingFactor, 1, 8, false, size, false );
+    }
+    else
+    {
+        // FSK datarate, given in kbps
+        timeOnAir = RegionCommonComputeTimeOnAirFsk( spreadingFactor * 1000, 5, false, size, true );
+    }
+    rxError = ( int32_t )( RxDoneParams.LastRxDone - TxDoneParams.CurTime ) -
+              ( int32_t )timeOnAir - ( int32_t )receiveDelay;
+    if( rxError < 0 )
+    {
+        rxError = -rxError;
+    }
+    rxError = MIN( rxError, LORAMAC_RX_ERROR_UNKNOWN - 1 );
+
+    if( ( learned[rxConfig->Datarate] == LORAMAC_RX_ERROR_UNKNOWN ) || ( rxError >= learned[rxConfig->Datarate] ) )
+    {
+        // Widen immediately
+        learned[rxConfig->Datarate] = ( uint8_t )rxError;
+    }
+    else
+    {
+        // Shrink slowly towards the observed error
+        learned[rxConfig->Datarate] -= ( uint8_t )( ( learned[rxConfig->Datarate] - rxError ) / 4 );
+    }
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+}
+
+static void ResetRxErrorLearning( void )
+{
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+    memset1( ( uint8_t* )MacCtx.RxErrorLearned, LORAMAC_RX_ERROR_UNKNOWN, sizeof( MacCtx.RxErrorLearned ) );
+    MacCtx.RxErrorDownlinkExpected = false;
+    MacCtx.RxErrorFramePending = false;
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+}
+
+static void ExpectRxErrorLearning( bool adrAckReq )
+{
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+    MacCtx.RxErrorDownlinkExpected = ( MacCtx.NodeAckRequested == true ) || ( adrAckReq == true ) ||
+                                     ( LoRaMacConfirmQueueGetCnt( ) > 0 ) || ( MacCtx.RxErrorFramePending == true );
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+}
+
+static void MissRxErrorLearning( void )
+{
+#if (defined( LORAMAC_RX_ERROR_LEARNING_ENABLED ) && ( LORAMAC_RX_ERROR_LEARNING_ENABLED == 1 ))
+    uint8_t* learned = &MacCtx.RxErrorLearned[0][0];
+    uint32_t widened = 0;
+
+    // Most uplinks of a periodic telemetry get no answer, their silence
+    // tells nothing about the window sizes
+    if( ( MacCtx.TxMsg.Type != LORAMAC_MSG_TYPE_DATA ) || ( MacCtx.RxErrorDownlinkExpected == false ) )
+    {
+        return;
+    }
+    MacCtx.RxErrorDownlinkExpected = false;
+
+    // Widen stepwise, back to SystemMaxRxError after a few misses
+    for( uint8_t i = 0; i < sizeof( MacCtx.RxErrorLearned ); i++ )
+    {
+        if( learned[i] == LORAMAC_RX_ERROR_UNKNOWN )
+        {
+            continue;
+        }
+        widened = 2 * ( uint32_t )learned[i] + LORAMAC_RX_ERROR_LEARNING_MARGIN;
+        if( widened >= MIN( Nvm.MacGroup2.MacParams.SystemMaxRxError, LORAMAC_RX_ERROR_UNKNOWN ) )
+        {
+            learned[i] = LORAMAC_RX_ERROR_UNKNOWN;
+        }
+        else
+        {
+            learned[i] = ( uint8_t )widened;
+        }
+    }
+#endif /* LORAMAC_RX_ERROR_LEARNING_ENABLED */
+}
+
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+static void StartCoalescedTimer( TimerEvent_t* obj, TimerTime_t value )
+{
+#if (defined( LORAMAC_TIMER_COALESCING_SLACK ) && ( LORAMAC_TIMER_COALESCING_SLACK > 0 ))
+    TimerTime_t deadline = TIMERTIME_T_MAX;
+    TimerTime_t remainingTime;
 
-    LoRaMacEnableRequests( LORAMAC_REQUEST_HANDLING_ON );
+    // The delayed transmission, RX windows, acknowledgement and Class B timers are
+    // not considered: an uplink moved on their deadline could not be sent
+    for( uint8_t i = 0; i < ( sizeof( RejoinTimers ) / sizeof( RejoinTimers[0] ) ); i++ )
+    {
+        if( ( RejoinTimers[i] != obj ) && ( TimerIsStarted( RejoinTimers[i] ) != 0U ) )
+        {
+            remainingTime = TIMERTIME_T_MAX;
+            TimerGetRemainingTime( RejoinTimers[i], &remainingTime );
+            if( ( remainingTime >= value ) && ( ( remainingTime - value ) <= LORAMAC_TIMER_COALESCING_SLACK ) &&
+                ( remainingTime < deadline ) )
+            {
+                deadline = remainingTime;
+            }
+        }
+    }
 
-    return LORAMAC_STATUS_OK;
+    if( deadline != TIMERTIME_T_MAX )
+    {
+        // Expire together with the already programmed deadline
+        value = deadline;
+    }
+#endif /* LORAMAC_TIMER_COALESCING_SLACK */
+    TimerSetValue( obj, value );
+    TimerStart( obj );
 }
+#endif /* LORAMAC_VERSION */
 
-LoRaMacStatus_t LoRaMacStart( void )
+static uint8_t HashMcAddr( uint32_t address )
 {
-    MacCtx.MacState = LORAMAC_IDLE;
-    UpdateRxSlotIdleState();
-    return LORAMAC_STATUS_OK;
+    address ^= address >> 16;
+    address ^= address >> 8;
+    return ( uint8_t )( address & ( LORAMAC_MC_ADDR_TABLE_SIZE - 1 ) );
 }
 
-LoRaMacStatus_t LoRaMacStop( void )
+static void UpdateMcAddrTable( void )
 {
-    if( LoRaMacIsBusy( ) == false )
+    uint8_t slot;
+
+    memset1( MacCtx.McAddrTable, 0, sizeof( MacCtx.McAddrTable ) );
+
+    for( uint8_t i = 0; i < LORAMAC_MAX_MC_CTX; i++ )
     {
-        if( Nvm.MacGroup2.DeviceClass == CLASS_C )
+        if( Nvm.MacGroup2.MulticastChannelList[i].ChannelParams.IsEnabled == false )
         {
-            Radio.Sleep( );
+            continue;
         }
-        MacCtx.MacState = LORAMAC_STOPPED;
-        return LORAMAC_STATUS_OK;
-    }
-    else if(  MacCtx.MacState == LORAMAC_STOPPED )
-    {
-        return LORAMAC_STATUS_OK;
+        // Linear probing
+        slot = HashMcAddr( Nvm.MacGroup2.MulticastChannelList[i].ChannelParams.Address );
+        while( MacCtx.McAddrTable[slot] != 0 )
+        {
+            slot = ( slot + 1 ) & ( LORAMAC_MC_ADDR_TABLE_SIZE - 1 );
+        }
+        MacCtx.McAddrTable[slot] = i + 1;
     }
-    return LORAMAC_STATUS_BUSY;
 }
 
-LoRaMacStatus_t LoRaMacHalt( void )
+static uint8_t GetMcIndex( uint32_t address )
 {
-    // Stop Timers
-    TimerStop( &MacCtx.TxDelayedTimer );
-    TimerStop( &MacCtx.RxWindowTimer1 );
-    TimerStop( &MacCtx.RxWindowTimer2 );
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
-    TimerStop( &MacCtx.AckTimeoutTimer );
-#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-    TimerStop( &MacCtx.RetransmitTimeoutTimer );
-#endif /* LORAMAC_VERSION */
+    uint8_t slot = HashMcAddr( address );
+    uint8_t index;
 
-    // Take care about class B
-    LoRaMacClassBHaltBeaconing( );
+    for( uint8_t i = 0; i < LORAMAC_MC_ADDR_TABLE_SIZE; i++ )
+    {
+        if( MacCtx.McAddrTable[slot] == 0 )
+        {
+            break;
+        }
+        index = MacCtx.McAddrTable[slot] - 1;
+        if( Nvm.MacGroup2.MulticastChannelList[index].ChannelParams.Address == address )
+        {
+            // The lowest index wins when several contexts share the same address
+            return index;
+        }
+        slot = ( slot + 1 ) & ( LORAMAC_MC_ADDR_TABLE_SIZE - 1 );
+    }
+    return LORAMAC_MAX_MC_CTX;
+}
 
-    // Switch off Radio
-    Radio.Sleep( );
+static LoRaMacEventInfoStatus_t FilterRxFrame( uint8_t* payload, uint16_t size, uint8_t* mcIndex )
+{
+    LoRaMacHeader_t macHdr;
+    uint32_t address;
 
-    MacCtx.MacState = LORAMAC_IDLE;
+    *mcIndex = LORAMAC_MAX_MC_CTX;
+    macHdr.Value = payload[0];
 
-#if (defined( CONTEXT_MANAGEMENT_ENABLED ) && ( CONTEXT_MANAGEMENT_ENABLED == 1 ))
-    LoRaMacHandleNvm( &Nvm );
+    switch( macHdr.Bits.MType )
+    {
+        case FRAME_TYPE_JOIN_ACCEPT:
+        case FRAME_TYPE_PROPRIETARY:
+            // Checked by their own processing
+            return LORAMAC_EVENT_INFO_STATUS_OK;
+        case FRAME_TYPE_DATA_CONFIRMED_DOWN:
+        case FRAME_TYPE_DATA_UNCONFIRMED_DOWN:
+            break;
+        default:
+            MacCtx.RxFilterStats.NbRejectedMType++;
+            return LORAMAC_EVENT_INFO_STATUS_ERROR;
+    }
 
-    // Preserve the Nvm context if data retention
-    memcpy1( ( uint8_t* ) &NvmBackup, ( uint8_t* ) &Nvm, sizeof( LoRaMacNvmData_t ) );
-#endif /* CONTEXT_MANAGEMENT_ENABLED */
+    if( size < LORAMAC_FRAME_PAYLOAD_MIN_SIZE )
+    {
+        MacCtx.RxFilterStats.NbRejectedSize++;
+        return LORAMAC_EVENT_INFO_STATUS_ERROR;
+    }
 
-    MacCtx.MacState = LORAMAC_STOPPED;
+    address = ( uint32_t )payload[LORAMAC_MHDR_FIELD_SIZE];
+    address |= ( ( uint32_t )payload[LORAMAC_MHDR_FIELD_SIZE + 1] << 8 );
+    address |= ( ( uint32_t )payload[LORAMAC_MHDR_FIELD_SIZE + 2] << 16 );
+    address |= ( ( uint32_t )payload[LORAMAC_MHDR_FIELD_SIZE + 3] << 24 );
 
-    return LORAMAC_STATUS_OK;
+    // Multicast contexts have the precedence over the unicast address
+    *mcIndex = GetMcIndex( address );
+    if( ( *mcIndex == LORAMAC_MAX_MC_CTX ) && ( address != Nvm.MacGroup2.DevAddr ) )
+    {
+        MacCtx.RxFilterStats.NbRejectedAddress++;
+        return LORAMAC_EVENT_INFO_STATUS_ADDRESS_FAIL;
+    }
+    return LORAMAC_EVENT_INFO_STATUS_OK;
 }
 
 LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
@@ -4828,15 +6012,24 @@ LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
     adrNext.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
     adrNext.Region = Nvm.MacGroup2.Region;
 
-    // We call the function for information purposes only. We don't want to
-    // apply the datarate, the tx power and the ADR ack counter.
+    if( IsTxInfoCacheValid( &adrNext ) == true )
+    {
+        txInfo->CurrentPossiblePayloadSize = MacCtx.TxInfoCache.CurrentPossiblePayloadSize;
+    }
+    else
+    {
+        // We call the function for information purposes only. We don't want to
+        // apply the datarate, the tx power and the ADR ack counter.
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
-    LoRaMacAdrCalcNext( &adrNext, &datarate, &txPower, &adrAckCounter );
+        LoRaMacAdrCalcNext( &adrNext, &datarate, &txPower, &adrAckCounter );
 #elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-    LoRaMacAdrCalcNext( &adrNext, &datarate, &txPower, &nbTrans, &adrAckCounter );
+        LoRaMacAdrCalcNext( &adrNext, &datarate, &txPower, &nbTrans, &adrAckCounter );
 #endif /* LORAMAC_VERSION */
 
-    txInfo->CurrentPossiblePayloadSize = GetMaxAppPayloadWithoutFOptsLength( datarate );
+        txInfo->CurrentPossiblePayloadSize = GetMaxAppPayloadWithoutFOptsLength( datarate );
+
+        UpdateTxInfoCache( &adrNext, txInfo->CurrentPossiblePayloadSize );
+    }
 
     if( LoRaMacCommandsGetSizeSerializedCmds( &macCmdsSize ) != LORAMAC_COMMANDS_SUCCESS )
     {
@@ -4865,6 +6058,109 @@ LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo )
     }
 }
 
+LoRaMacStatus_t LoRaMacQueryTxPlan( uint8_t size, LoRaMacTxPlan_t* txPlan )
+{
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    VerifyParams_t verify;
+    NextChanParams_t nextChan;
+    LoRaMacTxPlanEntry_t* entry;
+    TimerTime_t aggregatedTimeOff = 0;
+    TimerTime_t txDelay = 0;
+    uint8_t channel = 0;
+    int8_t minDatarate;
+    int8_t maxDatarate;
+    size_t macCmdsSize = 0;
+
+    if( txPlan == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    if( LoRaMacCommandsGetSizeSerializedCmds( &macCmdsSize ) != LORAMAC_COMMANDS_SUCCESS )
+    {
+        return LORAMAC_STATUS_MAC_COMMAD_ERROR;
+    }
+    if( macCmdsSize > LORA_MAC_COMMAND_MAX_FOPTS_LENGTH )
+    {
+        // The MAC commands will be sent without application data
+        macCmdsSize = 0;
+    }
+
+    getPhy.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+    getPhy.Attribute = PHY_MIN_TX_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    minDatarate = phyParam.Value;
+    getPhy.Attribute = PHY_MAX_TX_DR;
+    phyParam = RegionGetPhyParam( Nvm.MacGroup2.Region, &getPhy );
+    maxDatarate = phyParam.Value;
+
+    // Same parameters as ScheduleTx, evaluated without side effects
+    nextChan.AggrTimeOff = Nvm.MacGroup1.AggregatedTimeOff;
+    nextChan.DutyCycleEnabled = Nvm.MacGroup2.DutyCycleOn;
+    nextChan.ElapsedTimeSinceStartUp = SysTimeSub( SysTimeGetMcuTime( ), Nvm.MacGroup2.InitializationTime );
+    nextChan.LastAggrTx = Nvm.MacGroup1.LastTxDoneTime;
+    nextChan.LastTxIsJoinRequest = false;
+    nextChan.Joined = true;
+    nextChan.PktLen = LORAMAC_FRAME_PAYLOAD_MIN_SIZE + macCmdsSize;
+    if( size > 0 )
+    {
+        nextChan.PktLen += LORAMAC_F_PORT_FIELD_SIZE + size;
+    }
+    nextChan.QueryOnly = true;
+
+    if( Nvm.MacGroup2.NetworkActivation == ACTIVATION_TYPE_NONE )
+    {
+        nextChan.LastTxIsJoinRequest = true;
+        nextChan.Joined = false;
+    }
+
+    txPlan->NbEntries = 0;
+    for( int8_t datarate = minDatarate; ( datarate <= maxDatarate ) && ( txPlan->NbEntries < LORAMAC_TX_PLAN_MAX_NB_DR ); datarate++ )
+    {
+        verify.DatarateParams.Datarate = datarate;
+        verify.DatarateParams.UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+        if( RegionVerify( Nvm.MacGroup2.Region, &verify, PHY_TX_DR ) == false )
+        {
+            continue;
+        }
+
+        entry = &txPlan->Entries[txPlan->NbEntries++];
+        entry->Datarate = datarate;
+        entry->TimeOnAir = 0;
+        entry->TxDelay = 0;
+        entry->TimeCredits = 0;
+
+        if( ValidatePayloadLength( size, datarate, macCmdsSize ) == false )
+        {
+            entry->Status = LORAMAC_STATUS_LENGTH_ERROR;
+            continue;
+        }
+
+        nextChan.Datarate = datarate;
+        nextChan.TimeOnAir = 0;
+        nextChan.TimeCredits = 0;
+        entry->Status = RegionNextChannel( Nvm.MacGroup2.Region, &nextChan, &channel, &txDelay, &aggregatedTimeOff );
+        entry->TimeOnAir = nextChan.TimeOnAir;
+        entry->TimeCredits = nextChan.TimeCredits;
+        if( entry->Status == LORAMAC_STATUS_DUTYCYCLE_RESTRICTED )
+        {
+            entry->TxDelay = txDelay;
+        }
+    }
+    return LORAMAC_STATUS_OK;
+}
+
+LoRaMacStatus_t LoRaMacGetRxFilterStats( LoRaMacRxFilterStats_t* stats )
+{
+    if( stats == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    *stats = MacCtx.RxFilterStats;
+    return LORAMAC_STATUS_OK;
+}
+
 LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
 {
     LoRaMacStatus_t status = LORAMAC_STATUS_OK;
@@ -5153,21 +6449,12 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet )
     return status;
 }
 
-LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
+static LoRaMacStatus_t MibSetRequestConfirm( MibRequestConfirm_t* mibSet )
 {
     LoRaMacStatus_t status = LORAMAC_STATUS_OK;
     ChanMaskSetParams_t chanMaskSet;
     VerifyParams_t verify;
 
-    if( mibSet == NULL )
-    {
-        return LORAMAC_STATUS_PARAMETER_INVALID;
-    }
-    if( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) == LORAMAC_TX_RUNNING )
-    {
-        return LORAMAC_STATUS_BUSY;
-    }
-
     switch( mibSet->Type )
     {
         case MIB_DEVICE_CLASS:
@@ -5571,7 +6858,9 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
         {
             Nvm.MacGroup2.PublicNetwork = mibSet->Param.EnablePublicNetwork;
             Radio.SetPublicNetwork( Nvm.MacGroup2.PublicNetwork );
+            RegionCommonRadioShadowInvalidate( );
             Radio.Sleep( );
+            LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
             break;
         }
         case MIB_REPEATER_SUPPORT:
@@ -5632,6 +6921,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
                     // class type.
                     // Set the radio into sleep mode in case we are still in RX mode
                     Radio.Sleep( );
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
 
                     OpenContinuousRxCWindow( );
                 }
@@ -5849,8 +7139,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
                 Nvm.MacGroup2.Rejoin0CycleInSec = mibSet->Param.Rejoin0CycleInSec;
                 MacCtx.Rejoin0CycleTime = cycleTime;
                 TimerStop( &MacCtx.Rejoin0CycleTimer );
-                TimerSetValue( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
-                TimerStart( &MacCtx.Rejoin0CycleTimer );
+                StartCoalescedTimer( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
             }
             else
             {
@@ -5867,8 +7156,7 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
                 Nvm.MacGroup2.Rejoin1CycleInSec = mibSet->Param.Rejoin1CycleInSec;
                 MacCtx.Rejoin0CycleTime = cycleTime;
                 TimerStop( &MacCtx.Rejoin1CycleTimer );
-                TimerSetValue( &MacCtx.Rejoin1CycleTimer, MacCtx.Rejoin1CycleTime );
-                TimerStart( &MacCtx.Rejoin1CycleTimer );
+                StartCoalescedTimer( &MacCtx.Rejoin1CycleTimer, MacCtx.Rejoin1CycleTime );
             }
             else
             {
@@ -5935,6 +7223,23 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
             break;
         }
     }
+    return status;
+}
+
+LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
+{
+    LoRaMacStatus_t status;
+
+    if( mibSet == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    if( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) == LORAMAC_TX_RUNNING )
+    {
+        return LORAMAC_STATUS_BUSY;
+    }
+
+    status = MibSetRequestConfirm( mibSet );
 
 #if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
     if( status == LORAMAC_STATUS_OK )
@@ -5946,6 +7251,145 @@ LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet )
     return status;
 }
 
+static bool MibIsBatchable( Mib_t type )
+{
+    switch( type )
+    {
+        case MIB_NETWORK_ACTIVATION:
+        case MIB_ADR:
+        case MIB_NET_ID:
+        case MIB_REPEATER_SUPPORT:
+        case MIB_RX2_CHANNEL:
+        case MIB_RX2_DEFAULT_CHANNEL:
+        case MIB_RXC_DEFAULT_CHANNEL:
+        case MIB_CHANNELS_MASK:
+        case MIB_CHANNELS_DEFAULT_MASK:
+        case MIB_CHANNELS_NB_TRANS:
+        case MIB_MAX_RX_WINDOW_DURATION:
+        case MIB_RECEIVE_DELAY_1:
+        case MIB_RECEIVE_DELAY_2:
+        case MIB_JOIN_ACCEPT_DELAY_1:
+        case MIB_JOIN_ACCEPT_DELAY_2:
+        case MIB_CHANNELS_DEFAULT_DATARATE:
+        case MIB_CHANNELS_DATARATE:
+        case MIB_CHANNELS_DEFAULT_TX_POWER:
+        case MIB_CHANNELS_TX_POWER:
+        case MIB_SYSTEM_MAX_RX_ERROR:
+        case MIB_MIN_RX_SYMBOLS:
+        case MIB_ANTENNA_GAIN:
+        case MIB_DEFAULT_ANTENNA_GAIN:
+        case MIB_RXB_C_TIMEOUT:
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+        case MIB_IS_CERT_FPORT_ON:
+#endif /* LORAMAC_VERSION */
+        case MIB_ADR_ACK_LIMIT:
+        case MIB_ADR_ACK_DELAY:
+        case MIB_ADR_ACK_DEFAULT_LIMIT:
+        case MIB_ADR_ACK_DEFAULT_DELAY:
+        {
+            return true;
+        }
+        default:
+        {
+            // Keys, identifiers, class, radio settings, timers and NVM contexts
+            return false;
+        }
+    }
+}
+
+LoRaMacStatus_t LoRaMacMibSetRequestConfirmBatch( MibRequestConfirm_t* mibSet, uint8_t nbRequests )
+{
+    LoRaMacStatus_t status = LORAMAC_STATUS_OK;
+    uint8_t i = 0;
+
+    if( ( mibSet == NULL ) || ( nbRequests == 0 ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    if( ( MacCtx.MacState & LORAMAC_TX_RUNNING ) == LORAMAC_TX_RUNNING )
+    {
+        return LORAMAC_STATUS_BUSY;
+    }
+
+    // Refuse the whole batch before applying anything
+    for( i = 0; i < nbRequests; i++ )
+    {
+        if( MibIsBatchable( mibSet[i].Type ) == false )
+        {
+            return LORAMAC_STATUS_PARAMETER_INVALID;
+        }
+    }
+
+    MibBatchSnapshot.MacGroup1 = Nvm.MacGroup1;
+    MibBatchSnapshot.MacGroup2 = Nvm.MacGroup2;
+    MibBatchSnapshot.RegionGroup1 = Nvm.RegionGroup1;
+    memcpy1( ( uint8_t* )MibBatchSnapshot.ChannelsMask, ( uint8_t* )Nvm.RegionGroup2.ChannelsMask, sizeof( MibBatchSnapshot.ChannelsMask ) );
+    memcpy1( ( uint8_t* )MibBatchSnapshot.ChannelsDefaultMask, ( uint8_t* )Nvm.RegionGroup2.ChannelsDefaultMask, sizeof( MibBatchSnapshot.ChannelsDefaultMask ) );
+
+    // Apply all attributes before giving back the control to LoRaMacProcess
+    for( i = 0; i < nbRequests; i++ )
+    {
+        status = MibSetRequestConfirm( &mibSet[i] );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            break;
+        }
+    }
+
+    if( status != LORAMAC_STATUS_OK )
+    {
+        // All or nothing, restore the attributes applied before the rejected one
+        Nvm.MacGroup1 = MibBatchSnapshot.MacGroup1;
+        Nvm.MacGroup2 = MibBatchSnapshot.MacGroup2;
+        Nvm.RegionGroup1 = MibBatchSnapshot.RegionGroup1;
+        memcpy1( ( uint8_t* )Nvm.RegionGroup2.ChannelsMask, ( uint8_t* )MibBatchSnapshot.ChannelsMask, sizeof( MibBatchSnapshot.ChannelsMask ) );
+        memcpy1( ( uint8_t* )Nvm.RegionGroup2.ChannelsDefaultMask, ( uint8_t* )MibBatchSnapshot.ChannelsDefaultMask, sizeof( MibBatchSnapshot.ChannelsDefaultMask ) );
+        return status;
+    }
+
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    // Handle NVM potential changes once for the whole batch
+    MacCtx.MacFlags.Bits.NvmHandle = 1;
+#endif /* LORAMAC_VERSION */
+    return status;
+}
+
+LoRaMacStatus_t LoRaMacGetStatusSnapshot( LoRaMacStatusSnapshot_t* snapshot )
+{
+    if( snapshot == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    SecureElementGetDevAddr( Nvm.MacGroup2.NetworkActivation, &snapshot->DevAddr );
+    snapshot->FCntUp = Nvm.Crypto.FCntList.FCntUp;
+    snapshot->LastDownFCnt = Nvm.Crypto.LastDownFCnt;
+    snapshot->AdrAckCounter = Nvm.MacGroup1.AdrAckCounter;
+    snapshot->ReceiveDelay1 = Nvm.MacGroup2.MacParams.ReceiveDelay1;
+    snapshot->ReceiveDelay2 = Nvm.MacGroup2.MacParams.ReceiveDelay2;
+    snapshot->SystemMaxRxError = Nvm.MacGroup2.MacParams.SystemMaxRxError;
+    snapshot->DutyCycleWaitTime = MacCtx.DutyCycleWaitTime;
+    snapshot->MaxEirp = Nvm.MacGroup2.MacParams.MaxEirp;
+    snapshot->AntennaGain = Nvm.MacGroup2.MacParams.AntennaGain;
+    snapshot->Class = Nvm.MacGroup2.DeviceClass;
+    snapshot->NetworkActivation = Nvm.MacGroup2.NetworkActivation;
+    snapshot->Region = Nvm.MacGroup2.Region;
+    snapshot->Rx2Channel = Nvm.MacGroup2.MacParams.Rx2Channel;
+    snapshot->ChannelsDatarate = Nvm.MacGroup1.ChannelsDatarate;
+    snapshot->ChannelsTxPower = Nvm.MacGroup1.ChannelsTxPower;
+    snapshot->ChannelsNbTrans = Nvm.MacGroup2.MacParams.ChannelsNbTrans;
+    snapshot->Rx1DrOffset = Nvm.MacGroup2.MacParams.Rx1DrOffset;
+    snapshot->MinRxSymbols = Nvm.MacGroup2.MacParams.MinRxSymbols;
+    snapshot->UplinkDwellTime = Nvm.MacGroup2.MacParams.UplinkDwellTime;
+    snapshot->DownlinkDwellTime = Nvm.MacGroup2.MacParams.DownlinkDwellTime;
+    snapshot->AdrEnable = Nvm.MacGroup2.AdrCtrlOn;
+    snapshot->DutyCycleOn = Nvm.MacGroup2.DutyCycleOn;
+    snapshot->PublicNetwork = Nvm.MacGroup2.PublicNetwork;
+
+    return LORAMAC_STATUS_OK;
+}
+
 LoRaMacStatus_t LoRaMacChannelAdd( uint8_t id, ChannelParams_t params )
 {
     ChannelAddParams_t channelAdd;
@@ -5999,6 +7443,7 @@ LoRaMacStatus_t LoRaMacMcChannelSetup( McChannelParams_t *channel )
 
     Nvm.MacGroup2.MulticastChannelList[channel->GroupID].ChannelParams = *channel;
     MacCtx.MacFlags.Bits.NvmHandle = 1;
+    UpdateMcAddrTable( );
 
     if( channel->IsRemotelySetup == true )
     {
@@ -6049,6 +7494,7 @@ LoRaMacStatus_t LoRaMacMcChannelDelete( AddressIdentifier_t groupID )
 
     Nvm.MacGroup2.MulticastChannelList[groupID].ChannelParams = channel;
     MacCtx.MacFlags.Bits.NvmHandle = 1;
+    UpdateMcAddrTable( );
     return LORAMAC_STATUS_OK;
 }
 
@@ -6532,6 +7978,7 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest, bool allowDelayedTx
             }
         }
 
+        MacCtx.McpsRadioActiveTimeStart = LoRaMacEnergyGetActiveTime( );
         status = Send( &macHdr, fPort, fBuffer, fBufferSize, allowDelayedTx );
         if( status == LORAMAC_STATUS_OK )
         {
@@ -6646,6 +8093,7 @@ LoRaMacStatus_t LoRaMacMcpsRequest( McpsReq_t* mcpsRequest, bool allowDelayedTx
         LoRaMacHandleResponseTimeout( Nvm.MacGroup2.MacParams.RxBCTimeout,
                                       MacCtx.ResponseTimeoutStartTime );
 
+        MacCtx.McpsRadioActiveTimeStart = LoRaMacEnergyGetActiveTime( );
         status = Send( &macHdr, fPort, fBuffer, fBufferSize, allowDelayedTx );
         if( status == LORAMAC_STATUS_OK )
         {
@@ -6689,8 +8137,7 @@ static void OnRejoin0CycleTimerEvent( void* context )
 
     Nvm.MacGroup2.IsRejoin0RequestQueued = true;
 
-    TimerSetValue( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
-    TimerStart( &MacCtx.Rejoin0CycleTimer );
+    StartCoalescedTimer( &MacCtx.Rejoin0CycleTimer, MacCtx.Rejoin0CycleTime );
 }
 
 static void OnRejoin1CycleTimerEvent( void* context )
@@ -6702,8 +8149,7 @@ static void OnRejoin1CycleTimerEvent( void* context )
 
     Nvm.MacGroup2.IsRejoin1RequestQueued = true;
 
-    TimerSetValue( &MacCtx.Rejoin1CycleTimer, MacCtx.Rejoin1CycleTime );
-    TimerStart( &MacCtx.Rejoin1CycleTimer );
+    StartCoalescedTimer( &MacCtx.Rejoin1CycleTimer, MacCtx.Rejoin1CycleTime );
 }
 
 static void OnForceRejoinReqCycleTimerEvent( void* context )
@@ -6725,8 +8171,7 @@ static void OnForceRejoinReqCycleTimerEvent( void* context )
     }
     else
     {
-        TimerSetValue( &MacCtx.ForceRejoinReqCycleTimer, MacCtx.ForceRejoinCycleTime );
-        TimerStart( &MacCtx.ForceRejoinReqCycleTimer );
+        StartCoalescedTimer( &MacCtx.ForceRejoinReqCycleTimer, MacCtx.ForceRejoinCycleTime );
     }
 
     OnMacProcessNotify( );
@@ -6747,6 +8192,11 @@ void LoRaMacTestSetDutyCycleOn( bool enable )
     }
 }
 
+void LoRaMacTestRxFrame( uint8_t* payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    OnRadioRxDone( payload, size, rssi, snr );
+}
+
 LoRaMacStatus_t LoRaMacDeInitialization( void )
 {
     // Check the current state of the LoRaMac
@@ -6768,6 +8218,7 @@ LoRaMacStatus_t LoRaMacDeInitialization( void )
 
         // Switch off Radio
         Radio.Sleep( );
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
 
         // Return success
         return LORAMAC_STATUS_OK;
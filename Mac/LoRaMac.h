@@ -179,6 +179,27 @@ extern "C"
  */
 LoRaMacStatus_t LoRaMacInitialization( LoRaMacPrimitives_t* primitives, LoRaMacCallback_t* callbacks, LoRaMacRegion_t region );
 
+/*!
+ * \brief   Switches the active region without initializing the LoRaMAC again
+ *
+ * \details The session ( keys, address, frame counters ) is kept. The channels,
+ *          bands and MAC parameters of the region left are stored in one of the
+ *          LORAMAC_REGION_SWITCH_NB_SLOTS slots and restored when switching back.
+ *          A region used for the first time starts from its defaults.
+ *          Requires LORAMAC_REGION_SWITCH_ENABLED, the device in class A and
+ *          no pending request.
+ *
+ * \param   [in] region - The region to switch to.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_BUSY,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_REGION_NOT_SUPPORTED,
+ *          \ref LORAMAC_STATUS_SERVICE_UNKNOWN.
+ */
+LoRaMacStatus_t LoRaMacRegionSwitch( LoRaMacRegion_t region );
+
 /*!
  * \brief   Starts LoRaMAC layer
  *
@@ -213,6 +234,24 @@ bool LoRaMacIsBusy( void );
  */
 bool LoRaMacIsStopped( void );
 
+/*!
+ * \brief   Returns the time until the MAC layer has to run again
+ *
+ * \details Computes the earliest deadline among the running MAC timers
+ *          (RX windows, delayed transmission, acknowledge or retransmission
+ *          timeout, rejoin cycles and Class B slots). The application may
+ *          sleep for that amount of time unless a radio interrupt occurs.
+ *
+ * \param   [out] nextWakeup - Time in ms before the next MAC deadline.
+ *                             0 when events are waiting for \ref LoRaMacProcess,
+ *                             TIMERTIME_T_MAX when no deadline is scheduled.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacGetNextWakeup( TimerTime_t* nextWakeup );
+
 /*!
  * Processes the LoRaMac events.
  *
@@ -247,6 +286,39 @@ void LoRaMacProcess( void );
  */
 LoRaMacStatus_t LoRaMacQueryTxPossible( uint8_t size, LoRaMacTxInfo_t* txInfo );
 
+/*!
+ * \brief   Queries for each valid uplink data rate when a frame with the given
+ *          application data payload size could be sent, without changing the
+ *          MAC state. The bands time credits, the channels masks and the
+ *          aggregated time-off are evaluated on copies, no carrier sense is
+ *          performed and no channel is selected. The scheduled MAC commands
+ *          are taken into account when they fit into the FOpts field.
+ *
+ * \param   [in] size - Size of application data payload to be send
+ *
+ * \param   [out] txPlan - Earliest transmission delay, time-on-air and band
+ *                         time credits per data rate
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_MAC_COMMAD_ERROR.
+ */
+LoRaMacStatus_t LoRaMacQueryTxPlan( uint8_t size, LoRaMacTxPlan_t* txPlan );
+
+/*!
+ * \brief   Gets the counters of the received frames rejected from their
+ *          header before any parsing or cryptographic processing.
+ *          The counters are cleared by LoRaMacInitialization.
+ *
+ * \param   [out] stats - Rejection counters
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacGetRxFilterStats( LoRaMacRxFilterStats_t* stats );
+
 /*!
  * \brief   LoRaMAC channel add service
  *
@@ -394,6 +466,56 @@ LoRaMacStatus_t LoRaMacMibGetRequestConfirm( MibRequestConfirm_t* mibGet );
  */
 LoRaMacStatus_t LoRaMacMibSetRequestConfirm( MibRequestConfirm_t* mibSet );
 
+/*!
+ * \brief   LoRaMAC MIB-Set of several attributes
+ *
+ * \details Applies the requests in order within a single call, so no MAC
+ *          processing takes place between two attributes, and raises a
+ *          single NVM change notification for the whole batch.
+ *          The batch is applied as a whole or not at all: when a request
+ *          is rejected, the requests applied before it are undone.
+ *          Only the MAC parameters, the channels masks, the datarates and
+ *          the TX powers may be batched. The other attributes (keys,
+ *          identifiers, device class, radio settings, rejoin cycles, NVM
+ *          contexts) refuse the whole batch and are set with
+ *          \ref LoRaMacMibSetRequestConfirm.
+ *
+ * \code
+ * MibRequestConfirm_t mibReq[2];
+ * mibReq[0].Type = MIB_ADR;
+ * mibReq[0].Param.AdrEnable = false;
+ * mibReq[1].Type = MIB_CHANNELS_DATARATE;
+ * mibReq[1].Param.ChannelsDatarate = DR_3;
+ *
+ * if( LoRaMacMibSetRequestConfirmBatch( mibReq, 2 ) == LORAMAC_STATUS_OK )
+ * {
+ *   // LoRaMAC updated both parameters
+ * }
+ * \endcode
+ *
+ * \param   [in] mibSet - Array of MIB-SET-Requests to perform. Refer to \ref MibRequestConfirm_t.
+ *
+ * \param   [in] nbRequests - Number of requests in the array.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_BUSY,
+ *          \ref LORAMAC_STATUS_SERVICE_UNKNOWN,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacMibSetRequestConfirmBatch( MibRequestConfirm_t* mibSet, uint8_t nbRequests );
+
+/*!
+ * \brief   Gets the commonly read LoRaMAC parameters in a single call
+ *
+ * \param   [out] snapshot - Parameters snapshot. Refer to \ref LoRaMacStatusSnapshot_t.
+ *
+ * \retval  LoRaMacStatus_t Status of the operation. Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID.
+ */
+LoRaMacStatus_t LoRaMacGetStatusSnapshot( LoRaMacStatusSnapshot_t* snapshot );
+
 /*!
  * \brief   LoRaMAC MLME-Request
  *
@@ -47,6 +47,8 @@
 #include "LoRaMacClassBNvm.h"
 #include "LoRaMacClassBConfig.h"
 #include "LoRaMacConfirmQueue.h"
+#include "LoRaMacProfiling.h"
+#include "LoRaMacEnergy.h"
 #include "radio.h"
 #include "Region.h"
 #include "mw_log_conf.h"
@@ -405,6 +407,7 @@ static void RxBeaconSetup( TimerTime_t rxTime, bool activateDefaultChannel, uint
     rxBeaconSetup.Frequency = frequency;
 
     RegionRxBeaconSetup( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &rxBeaconSetup, &Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate );
+    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
 
     Ctx.LoRaMacClassBParams.MlmeIndication->BeaconInfo.Frequency = frequency;
     Ctx.LoRaMacClassBParams.MlmeIndication->BeaconInfo.Datarate = Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate;
@@ -819,6 +822,7 @@ static void LoRaMacClassBProcessBeacon( void )
             if( Ctx.BeaconCtx.Ctrl.AcquisitionPending == 1 )
             {
                 Radio.Sleep();
+                LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
                 Ctx.BeaconState = BEACON_STATE_LOST;
             }
             else
@@ -886,6 +890,7 @@ static void LoRaMacClassBProcessBeacon( void )
             if( Ctx.BeaconCtx.Ctrl.AcquisitionPending == 1 )
             {
                 Radio.Sleep();
+                LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
                 Ctx.BeaconState = BEACON_STATE_LOST;
             }
             else
@@ -1157,10 +1162,12 @@ static void LoRaMacClassBProcessPingSlot( void )
                 if( pingSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
                 }
                 else
                 {
                     Radio.Rx( 0 ); // Continuous mode
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
                 }
             }
             else
@@ -1206,10 +1213,12 @@ static void LoRaMacClassBProcessPingSlot( void )
                 if( pingSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
                 }
                 else
                 {
                     Radio.Rx( 0 ); // Continuous mode
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
                 }
             }
             else
@@ -1385,10 +1394,12 @@ static void LoRaMacClassBProcessMulticastSlot( void )
             if( multicastSlotRxConfig.RxContinuous == false )
             {
                 Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
+                LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
             }
             else
             {
                 Radio.Rx( 0 ); // Continuous mode
+                LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
             }
 #elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
             // Verify, if the unicast has priority.
@@ -1422,10 +1433,12 @@ static void LoRaMacClassBProcessMulticastSlot( void )
                 if( multicastSlotRxConfig.RxContinuous == false )
                 {
                     Radio.Rx( Ctx.LoRaMacClassBParams.LoRaMacParams->MaxRxWindow );
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
                 }
                 else
                 {
                     Radio.Rx( 0 ); // Continuous mode
+                    LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_RX_CLASS_B, Ctx.LoRaMacClassBParams.McpsIndication->RxDatarate, 0 );
                 }
             }
             else
@@ -1464,6 +1477,7 @@ bool LoRaMacClassBRxBeacon( uint8_t *payload, uint16_t size )
     // Verify if we are in the state where we expect a beacon
     if( ( Ctx.BeaconState == BEACON_STATE_RX ) || ( Ctx.BeaconCtx.Ctrl.AcquisitionPending == 1 ) )
     {
+        LORAMAC_PROFILING_START( LORAMAC_PROFILING_CLASSB_RX_BEACON );
         if( size == phyParam.BeaconFormat.BeaconSize )
         {
 #if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
@@ -1569,7 +1583,7 @@ bool LoRaMacClassBRxBeacon( uint8_t *payload, uint16_t size )
                 phyParam = RegionGetPhyParam( *Ctx.LoRaMacClassBParams.LoRaMacRegion, &getPhy );
                 bandwidth = phyParam.Value;
 
-                TimerTime_t time = Radio.TimeOnAir( MODEM_LORA, bandwidth, spreadingFactor, 1, 10, true, size, false );
+                TimerTime_t time = RegionCommonComputeTimeOnAirLoRa( bandwidth, spreadingFactor, 1, 10, true, size, false );
                 SysTime_t timeOnAir;
                 timeOnAir.Seconds = time / 1000;
                 timeOnAir.SubSeconds = time - timeOnAir.Seconds * 1000;
@@ -1602,6 +1616,7 @@ bool LoRaMacClassBRxBeacon( uint8_t *payload, uint16_t size )
         // the MAC shall ignore the frame completely. Thus, the function must always return true, even if no
         // valid beacon has been received.
         beaconProcessed = true;
+        LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_CLASSB_RX_BEACON );
     }
     return beaconProcessed;
 #else
@@ -2081,3 +2096,34 @@ void LoRaMacClassBProcess( void )
     }
 #endif /* LORAMAC_CLASSB_ENABLED */
 }
+
+TimerTime_t LoRaMacClassBGetNextWakeup( void )
+{
+#if ( LORAMAC_CLASSB_ENABLED == 1 )
+    TimerEvent_t* timers[] = { &Ctx.BeaconTimer, &Ctx.PingSlotTimer, &Ctx.MulticastSlotTimer };
+    TimerTime_t nextWakeup = TIMERTIME_T_MAX;
+    TimerTime_t remainingTime;
+
+    if( LoRaMacClassBEvents.Value != 0 )
+    {
+        // Events are waiting for LoRaMacClassBProcess
+        return 0;
+    }
+
+    for( uint8_t i = 0; i < ( sizeof( timers ) / sizeof( timers[0] ) ); i++ )
+    {
+        if( TimerIsStarted( timers[i] ) != 0U )
+        {
+            remainingTime = TIMERTIME_T_MAX;
+            TimerGetRemainingTime( timers[i], &remainingTime );
+            if( remainingTime < nextWakeup )
+            {
+                nextWakeup = remainingTime;
+            }
+        }
+    }
+    return nextWakeup;
+#else
+    return TIMERTIME_T_MAX;
+#endif /* LORAMAC_CLASSB_ENABLED */
+}
@@ -497,6 +497,15 @@ void LoRaMacClassBSetFPendingBit( uint32_t address, uint8_t fPendingSet );
  */
 void LoRaMacClassBProcess( void );
 
+/*!
+ * \brief Returns the time until the next Class B timer expires. This
+ *        includes the beacon, ping slot and multicast slot timers.
+ *
+ * \retval Time in ms before the next Class B event, 0 if an event is
+ *         already pending and TIMERTIME_T_MAX if no timer is running
+ */
+TimerTime_t LoRaMacClassBGetNextWakeup( void );
+
 /*! \} defgroup LORAMACCLASSB */
 
 #ifdef __cplusplus
@@ -44,11 +44,100 @@
 #endif /* LORAMAC_VERSION */
 #endif
 
+#if ( NUM_OF_MAC_COMMANDS > 32 )
+#error "NUM_OF_MAC_COMMANDS exceeds the size of the slot occupancy bitmap"
+#endif
+
 /*!
  * Size of the CID field of MAC commands
  */
 #define CID_FIELD_SIZE 1
 
+/*!
+ * Highest MAC command identifier
+ */
+#define MAC_COMMAND_CID_MAX 0x20
+
+/*!
+ * Descriptor of a MAC command identifier
+ */
+typedef struct sMacCommandDesc
+{
+    /*
+     * Size of the command received from the server, CID included.
+     * 0 for an unknown command
+     */
+    uint8_t SrvCmdSize;
+    /*
+     * The end-device command is sticky
+     */
+    bool IsSticky;
+    /*
+     * The end-device command requires an explicit confirmation
+     */
+    bool IsConfirmationRequired;
+} MacCommandDesc_t;
+
+/*!
+ * MAC command descriptors, indexed by CID
+ */
+static const MacCommandDesc_t MacCommandDescs[MAC_COMMAND_CID_MAX + 1] =
+{
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    // cid + Serv_LoRaWAN_version
+    [SRV_MAC_RESET_CONF]             = { 2, true,  true  },
+#endif /* LORAMAC_VERSION */
+    // cid + Margin + GwCnt
+    [SRV_MAC_LINK_CHECK_ANS]         = { 3, false, false },
+    // cid + DataRate_TXPower + ChMask (2) + Redundancy
+    [SRV_MAC_LINK_ADR_REQ]           = { 5, false, false },
+    // cid + DutyCyclePL
+    [SRV_MAC_DUTY_CYCLE_REQ]         = { 2, false, false },
+    // cid + DLsettings + Frequency (3)
+    [SRV_MAC_RX_PARAM_SETUP_REQ]     = { 5, true,  false },
+    // cid
+    [SRV_MAC_DEV_STATUS_REQ]         = { 1, false, false },
+    // cid + ChIndex + Frequency (3) + DrRange
+    [SRV_MAC_NEW_CHANNEL_REQ]        = { 6, false, false },
+    // cid + Settings
+    [SRV_MAC_RX_TIMING_SETUP_REQ]    = { 2, true,  false },
+    // cid + EIRP_DwellTime
+    [SRV_MAC_TX_PARAM_SETUP_REQ]     = { 2, true,  false },
+    // cid + ChIndex + Frequency (3)
+    [SRV_MAC_DL_CHANNEL_REQ]         = { 5, true,  false },
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    // cid + Serv_LoRaWAN_version
+    [SRV_MAC_REKEY_CONF]             = { 2, true,  true  },
+    // cid + ADRparam
+    [SRV_MAC_ADR_PARAM_SETUP_REQ]    = { 2, false, false },
+#endif /* LORAMAC_VERSION */
+    // cid + Seconds (4) + Fractional seconds (1)
+    [SRV_MAC_DEVICE_TIME_ANS]        = { 6, false, false },
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    // cid + Payload (2)
+    [SRV_MAC_FORCE_REJOIN_REQ]       = { 3, false, false },
+    // cid + Payload (1)
+    [SRV_MAC_REJOIN_PARAM_REQ]       = { 2, false, false },
+#endif /* LORAMAC_VERSION */
+    // cid
+    [SRV_MAC_PING_SLOT_INFO_ANS]     = { 1, false, false },
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    // cid + Frequency (3) + DR
+    [SRV_MAC_PING_SLOT_CHANNEL_REQ]  = { 5, false, false },
+#elif (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    // cid + Frequency (3) + DR
+    [SRV_MAC_PING_SLOT_CHANNEL_REQ]  = { 5, true,  false },
+#endif /* LORAMAC_VERSION */
+    // cid + TimingDelay (2) + Channel
+    [SRV_MAC_BEACON_TIMING_ANS]      = { 4, false, false },
+    // cid + Frequency (3)
+    [SRV_MAC_BEACON_FREQ_REQ]        = { 4, false, false },
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    // cid + Class
+    [SRV_MAC_DEVICE_MODE_CONF]       = { 2, true,  true  },
+#endif /* LORAMAC_VERSION */
+};
+
 /*!
  *  Mac Commands list structure
  */
@@ -77,6 +166,10 @@ typedef struct sLoRaMacCommandsCtx
      * Buffer to store MAC command elements
      */
     MacCommand_t MacCommandSlots[NUM_OF_MAC_COMMANDS];
+    /*
+     * Occupancy of the MAC command slots, bit n set when slot n is allocated
+     */
+    uint32_t SlotsBitmap;
     /*
      * Size of all MAC commands serialized as buffer
      */
@@ -91,44 +184,51 @@ static LoRaMacCommandsCtx_t CommandsCtx;
 /* Memory management functions */
 
 /*!
- * \brief Determines if a MAC command slot is free
+ * \brief Allocates a new MAC command memory slot
  *
- * \param [in]    slot           - Slot to check
- * \retval                       - Status of the operation
+ * \retval                       - Pointer to slot
  */
-static bool IsSlotFree( const MacCommand_t* slot )
+static MacCommand_t* MallocNewMacCommandSlot( void )
 {
-    uint8_t* mem = ( uint8_t* )slot;
+    // Lowest cleared bit of the occupancy bitmap
+    uint32_t freeBit = ~CommandsCtx.SlotsBitmap & ( CommandsCtx.SlotsBitmap + 1 );
+    uint8_t itr;
 
-    for( uint16_t size = 0; size < sizeof( MacCommand_t ); size++ )
+    if( freeBit == 0 )
     {
-        if( mem[size] != 0x00 )
-        {
-            return false;
-        }
+        return NULL;
     }
-    return true;
+    itr = LowestBitPosition( freeBit );
+    if( itr >= NUM_OF_MAC_COMMANDS )
+    {
+        return NULL;
+    }
+
+    CommandsCtx.SlotsBitmap |= freeBit;
+    return &CommandsCtx.MacCommandSlots[itr];
 }
 
 /*!
- * \brief Allocates a new MAC command memory slot
+ * \brief Gets the slot index of an allocated MAC command
  *
- * \retval                       - Pointer to slot
+ * \param [in]    slot           - Slot to check
+ *
+ * \retval                       - Slot index, NUM_OF_MAC_COMMANDS if not allocated
  */
-static MacCommand_t* MallocNewMacCommandSlot( void )
+static uint8_t GetMacCommandSlotIndex( const MacCommand_t* slot )
 {
-    uint8_t itr = 0;
+    uint8_t itr;
 
-    while( IsSlotFree( ( const MacCommand_t* )&CommandsCtx.MacCommandSlots[itr] ) == false )
+    if( ( slot < &CommandsCtx.MacCommandSlots[0] ) || ( slot >= &CommandsCtx.MacCommandSlots[NUM_OF_MAC_COMMANDS] ) )
     {
-        itr++;
-        if( itr == NUM_OF_MAC_COMMANDS )
-        {
-            return NULL;
-        }
+        return NUM_OF_MAC_COMMANDS;
     }
-
-    return &CommandsCtx.MacCommandSlots[itr];
+    itr = ( uint8_t )( slot - &CommandsCtx.MacCommandSlots[0] );
+    if( ( CommandsCtx.SlotsBitmap & ( 1UL << itr ) ) == 0 )
+    {
+        return NUM_OF_MAC_COMMANDS;
+    }
+    return itr;
 }
 
 /*!
@@ -140,12 +240,14 @@ static MacCommand_t* MallocNewMacCommandSlot( void )
  */
 static bool FreeMacCommandSlot( MacCommand_t* slot )
 {
-    if( slot == NULL )
+    uint8_t itr = GetMacCommandSlotIndex( slot );
+
+    if( itr == NUM_OF_MAC_COMMANDS )
     {
         return false;
     }
 
-    memset1( ( uint8_t* )slot, 0x00, sizeof( MacCommand_t ) );
+    CommandsCtx.SlotsBitmap &= ~( 1UL << itr );
 
     return true;
 }
@@ -197,8 +299,9 @@ static bool LinkedListAdd( MacCommandsList_t* list, MacCommand_t* element )
         list->Last->Next = element;
     }
 
-    // Update the next point of this entry.
+    // Update the next and previous points of this entry.
     element->Next = NULL;
+    element->Prev = list->Last;
 
     // Update the last entry of the list.
     list->Last = element;
@@ -206,42 +309,6 @@ static bool LinkedListAdd( MacCommandsList_t* list, MacCommand_t* element )
     return true;
 }
 
-/*!
- * \brief Return the previous element in the list.
- *
- * \param [in]    list           - List
- * \param [in]    element        - Element where the previous element shall be searched
- * \retval                       - Status of the operation
- */
-static MacCommand_t* LinkedListGetPrevious( MacCommandsList_t* list, MacCommand_t* element )
-{
-    if( ( list == NULL ) || ( element == NULL ) )
-    {
-        return NULL;
-    }
-
-    MacCommand_t* curElement;
-
-    // Start at the head of the list
-    curElement = list->First;
-
-    // When current element is the first of the list, there's no previous element so we can return NULL immediately.
-    if( element != curElement )
-    {
-        // Loop through all elements until the end is reached or the next of current is the current element.
-        while( ( curElement != NULL ) && ( curElement->Next != element ) )
-        {
-            curElement = curElement->Next;
-        }
-    }
-    else
-    {
-        curElement = NULL;
-    }
-
-    return curElement;
-}
-
 /*!
  * \brief Remove an element from the list
  *
@@ -256,8 +323,6 @@ static bool LinkedListRemove( MacCommandsList_t* list, MacCommand_t* element )
         return false;
     }
 
-    MacCommand_t* PrevElement = LinkedListGetPrevious( list, element );
-
     if( list->First == element )
     {
         list->First = element->Next;
@@ -265,15 +330,21 @@ static bool LinkedListRemove( MacCommandsList_t* list, MacCommand_t* element )
 
     if( list->Last == element )
     {
-        list->Last = PrevElement;
+        list->Last = element->Prev;
     }
 
-    if( PrevElement != NULL )
+    if( element->Prev != NULL )
     {
-        PrevElement->Next = element->Next;
+        element->Prev->Next = element->Next;
+    }
+
+    if( element->Next != NULL )
+    {
+        element->Next->Prev = element->Prev;
     }
 
     element->Next = NULL;
+    element->Prev = NULL;
 
     return true;
 }
@@ -287,24 +358,11 @@ static bool LinkedListRemove( MacCommandsList_t* list, MacCommand_t* element )
  */
 static bool IsSticky( uint8_t cid )
 {
-    switch( cid )
+    if( cid > MAC_COMMAND_CID_MAX )
     {
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-        case MOTE_MAC_RESET_IND:
-        case MOTE_MAC_REKEY_IND:
-        case MOTE_MAC_DEVICE_MODE_IND:
-#endif /* LORAMAC_VERSION */
-        case MOTE_MAC_DL_CHANNEL_ANS:
-        case MOTE_MAC_RX_PARAM_SETUP_ANS:
-        case MOTE_MAC_RX_TIMING_SETUP_ANS:
-        case MOTE_MAC_TX_PARAM_SETUP_ANS:
-#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
-        case MOTE_MAC_PING_SLOT_CHANNEL_ANS:
-#endif /* LORAMAC_VERSION */
-            return true;
-        default:
-            return false;
+        return false;
     }
+    return MacCommandDescs[cid].IsSticky;
 }
 
 /*
@@ -316,17 +374,11 @@ static bool IsSticky( uint8_t cid )
  */
 static bool IsConfirmationRequired( uint8_t cid )
 {
-    switch( cid )
+    if( cid > MAC_COMMAND_CID_MAX )
     {
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-        case MOTE_MAC_RESET_IND:
-        case MOTE_MAC_REKEY_IND:
-        case MOTE_MAC_DEVICE_MODE_IND:
-            return true;
-#endif /* LORAMAC_VERSION */
-        default:
-            return false;
+        return false;
     }
+    return MacCommandDescs[cid].IsConfirmationRequired;
 }
 
 LoRaMacCommandStatus_t LoRaMacCommandsInit( void )
@@ -380,6 +432,12 @@ LoRaMacCommandStatus_t LoRaMacCommandsRemoveCmd( MacCommand_t* macCmd )
         return LORAMAC_COMMANDS_ERROR_NPE;
     }
 
+    // Only allocated slots are linked in MacCommandList
+    if( GetMacCommandSlotIndex( macCmd ) == NUM_OF_MAC_COMMANDS )
+    {
+        return LORAMAC_COMMANDS_ERROR_CMD_NOT_FOUND;
+    }
+
     // Remove the Mac command element from MacCommandList
     if( LinkedListRemove( &CommandsCtx.MacCommandList, macCmd ) == false )
     {
@@ -525,140 +583,32 @@ LoRaMacCommandStatus_t LoRaMacCommandsSerializeCmds( size_t availableSize, size_
 
 uint8_t LoRaMacCommandsGetCmdSize( uint8_t cid )
 {
-    uint8_t cidSize = 0;
+    if( cid > MAC_COMMAND_CID_MAX )
+    {
+        // Unknown command. ABORT MAC commands processing
+        return 0;
+    }
+    return MacCommandDescs[cid].SrvCmdSize;
+}
+
+uint8_t LoRaMacCommandsGetValidSize( const uint8_t* payload, uint8_t size )
+{
+    uint8_t validSize = 0;
+    uint8_t cmdSize = 0;
 
-    // Decode Frame MAC commands
-    switch( cid )
+    if( payload == NULL )
     {
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-        case SRV_MAC_RESET_CONF:
-        {
-            // cid + Serv_LoRaWAN_version
-            cidSize = 2;
-            break;
-        }
-#endif /* LORAMAC_VERSION */
-        case SRV_MAC_LINK_CHECK_ANS:
-        {
-            // cid + Margin + GwCnt
-            cidSize = 3;
-            break;
-        }
-        case SRV_MAC_LINK_ADR_REQ:
-        {
-            // cid + DataRate_TXPower + ChMask (2) + Redundancy
-            cidSize = 5;
-            break;
-        }
-        case SRV_MAC_DUTY_CYCLE_REQ:
-        {
-            // cid + DutyCyclePL
-            cidSize = 2;
-            break;
-        }
-        case SRV_MAC_RX_PARAM_SETUP_REQ:
-        {
-            // cid + DLsettings + Frequency (3)
-            cidSize = 5;
-            break;
-        }
-        case SRV_MAC_DEV_STATUS_REQ:
-        {
-            // cid
-            cidSize = 1;
-            break;
-        }
-        case SRV_MAC_NEW_CHANNEL_REQ:
-        {
-            // cid + ChIndex + Frequency (3) + DrRange
-            cidSize = 6;
-            break;
-        }
-        case SRV_MAC_RX_TIMING_SETUP_REQ:
-        {
-            // cid + Settings
-            cidSize = 2;
-            break;
-        }
-        case SRV_MAC_TX_PARAM_SETUP_REQ:
-        {
-            // cid + EIRP_DwellTime
-            cidSize = 2;
-            break;
-        }
-        case SRV_MAC_DL_CHANNEL_REQ:
-        {
-            // cid + ChIndex + Frequency (3)
-            cidSize = 5;
-            break;
-        }
-#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
-        case SRV_MAC_REKEY_CONF:
-        {
-            // cid + Serv_LoRaWAN_version
-            cidSize = 2;
-            break;
-        }
-        case SRV_MAC_ADR_PARAM_SETUP_REQ:
-        {
-            // cid + ADRparam
-            cidSize = 2;
-            break;
-        }
-        case SRV_MAC_FORCE_REJOIN_REQ:
-        {
-            // cid + Payload (2)
-            cidSize = 3;
-            break;
-        }
-        case SRV_MAC_REJOIN_PARAM_REQ:
-        {
-            // cid + Payload (1)
-            cidSize = 2;
-            break;
-        }
-        case SRV_MAC_DEVICE_MODE_CONF:
-        {
-            // cid + Class
-            cidSize = 2;
-            break;
-        }
-#endif /* LORAMAC_VERSION */
-        case SRV_MAC_DEVICE_TIME_ANS:
-        {
-            // cid + Seconds (4) + Fractional seconds (1)
-            cidSize = 6;
-            break;
-        }
-        case SRV_MAC_PING_SLOT_INFO_ANS:
-        {
-            // cid
-            cidSize = 1;
-            break;
-        }
-        case SRV_MAC_PING_SLOT_CHANNEL_REQ:
-        {
-            // cid + Frequency (3) + DR
-            cidSize = 5;
-            break;
-        }
-        case SRV_MAC_BEACON_TIMING_ANS:
-        {
-            // cid + TimingDelay (2) + Channel
-            cidSize = 4;
-            break;
-        }
-        case SRV_MAC_BEACON_FREQ_REQ:
-        {
-            // cid + Frequency (3)
-            cidSize = 4;
-            break;
-        }
-        default:
+        return 0;
+    }
+
+    while( validSize < size )
+    {
+        cmdSize = LoRaMacCommandsGetCmdSize( payload[validSize] );
+        if( ( cmdSize == 0 ) || ( ( validSize + cmdSize ) > size ) )
         {
-            // Unknown command. ABORT MAC commands processing
             break;
         }
+        validSize += cmdSize;
     }
-    return cidSize;
+    return validSize;
 }
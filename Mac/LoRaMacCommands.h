@@ -58,6 +58,10 @@ struct sMacCommand
      *  The pointer to the next MAC Command element in the list
      */
     MacCommand_t* Next;
+    /*!
+     *  The pointer to the previous MAC Command element in the list
+     */
+    MacCommand_t* Prev;
     /*!
      * MAC command identifier
      */
@@ -197,6 +201,18 @@ LoRaMacCommandStatus_t LoRaMacCommandsSerializeCmds( size_t availableSize, size_
  */
 uint8_t LoRaMacCommandsGetCmdSize( uint8_t cid );
 
+/*!
+ * \brief Get the size of the leading part of a received MAC commands stream
+ *        made of complete commands with a known CID. The processing of a
+ *        stream stops at the first unknown or truncated command.
+ *
+ * \param [in]  payload        - Received MAC commands
+ * \param [in]  size           - Size of the received MAC commands
+ *
+ * \retval Size of the MAC commands to process.
+ */
+uint8_t LoRaMacCommandsGetValidSize( const uint8_t* payload, uint8_t size );
+
 /*! \} addtogroup LORAMAC */
 
 #ifdef __cplusplus
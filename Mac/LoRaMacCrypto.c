@@ -46,6 +46,7 @@
 #include "LoRaMacParser.h"
 #include "LoRaMacSerializer.h"
 #include "LoRaMacVersion.h"
+#include "LoRaMacProfiling.h"
 
 /*
  * Frame direction definition for uplink communications
@@ -1548,6 +1549,46 @@ LoRaMacCryptoStatus_t LoRaMacCryptoSecureMessage( uint32_t fCntUp, uint8_t txDr,
     return LORAMAC_CRYPTO_SUCCESS;
 }
 
+LoRaMacCryptoStatus_t LoRaMacCryptoUpdateMessageMic( uint32_t fCntUp, uint8_t txDr, uint8_t txCh, LoRaMacMessageData_t* macMsg )
+{
+    if( macMsg == NULL )
+    {
+        return LORAMAC_CRYPTO_ERROR_NPE;
+    }
+
+    // Only the last secured uplink can be updated
+    if( fCntUp != CryptoNvm->FCntList.FCntUp )
+    {
+        return LORAMAC_CRYPTO_FAIL_FCNT_SMALLER;
+    }
+
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    if( CryptoNvm->LrWanVersion.Fields.Minor == 1 )
+    {
+        LoRaMacCryptoStatus_t retval = LORAMAC_CRYPTO_ERROR;
+        uint32_t cmacS = 0;
+        uint16_t micPos = macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE;
+
+        // Only cmacS depends on the data rate and channel, cmacF[0..1] is kept
+        // cmacS  = aes128_cmac(SNwkSIntKey, B1 | msg)
+        retval = ComputeCmacB1( macMsg->Buffer, micPos, S_NWK_S_INT_KEY, macMsg->FHDR.FCtrl.Bits.Ack, txDr, txCh, macMsg->FHDR.DevAddr, fCntUp, &cmacS );
+        if( retval != LORAMAC_CRYPTO_SUCCESS )
+        {
+            return retval;
+        }
+        macMsg->MIC = ( macMsg->MIC & 0xFFFF0000 ) | ( cmacS & 0x0000FFFF );
+
+        // The message is already serialized, only the MIC field is rewritten
+        macMsg->Buffer[micPos++] = macMsg->MIC & 0xFF;
+        macMsg->Buffer[micPos++] = ( macMsg->MIC >> 8 ) & 0xFF;
+        macMsg->Buffer[micPos++] = ( macMsg->MIC >> 16 ) & 0xFF;
+        macMsg->Buffer[micPos++] = ( macMsg->MIC >> 24 ) & 0xFF;
+    }
+#endif /* LORAMAC_VERSION */
+
+    return LORAMAC_CRYPTO_SUCCESS;
+}
+
 LoRaMacCryptoStatus_t LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID, uint32_t address, FCntIdentifier_t fCntID, uint32_t fCntDown, LoRaMacMessageData_t* macMsg )
 {
     if( macMsg == 0 )
@@ -1600,13 +1641,16 @@ LoRaMacCryptoStatus_t LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID,
     }
 
     // Verify mic
+    LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_MIC_VERIFY );
     retval = VerifyCmacB0( macMsg->Buffer, ( macMsg->BufSize - LORAMAC_MIC_FIELD_SIZE ), micComputationKeyID, isAck, DOWNLINK, address, fCntDown, macMsg->MIC );
+    LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_MIC_VERIFY );
     if( retval != LORAMAC_CRYPTO_SUCCESS )
     {
         return retval;
     }
 
     // Decrypt payload
+    LORAMAC_PROFILING_START( LORAMAC_PROFILING_RX_DECRYPT );
     if( macMsg->FPort == 0 )
     {
         // Use network session encryption key
@@ -1636,6 +1680,7 @@ LoRaMacCryptoStatus_t LoRaMacCryptoUnsecureMessage( AddressIdentifier_t addrID,
         }
     }
 #endif /* LORAMAC_VERSION */
+    LORAMAC_PROFILING_STOP( LORAMAC_PROFILING_RX_DECRYPT );
 
     UpdateFCntDown( fCntID, fCntDown );
 
@@ -301,6 +301,19 @@ LoRaMacCryptoStatus_t LoRaMacCryptoHandleJoinAccept( JoinReqIdentifier_t joinReq
  */
 LoRaMacCryptoStatus_t LoRaMacCryptoSecureMessage( uint32_t fCntUp, uint8_t txDr, uint8_t txCh, LoRaMacMessageData_t* macMsg );
 
+/*!
+ * Updates the MIC of the last secured message for a retransmission on another
+ * data rate or channel. The message must still hold the serialized and secured frame.
+ * Only LoRaWAN 1.1 requires a new MIC, the message is left untouched otherwise.
+ *
+ * \param [in]    fCntUp          - Uplink sequence counter of the secured message
+ * \param [in]    txDr            - Data rate used for the transmission
+ * \param [in]    txCh            - Index of the channel used for the transmission
+ * \param [in,out] macMsg         - Data message object
+ * \retval                        - Status of the operation
+ */
+LoRaMacCryptoStatus_t LoRaMacCryptoUpdateMessageMic( uint32_t fCntUp, uint8_t txDr, uint8_t txCh, LoRaMacMessageData_t* macMsg );
+
 /*!
  * Unsecures a message (decryption + integrity verification).
  *
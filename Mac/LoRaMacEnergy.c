@@ -0,0 +1,162 @@
+/**
+  ******************************************************************************
+  * @file    LoRaMacEnergy.c
+  * @author  MCD Application Team
+  * @brief   LoRa MAC radio activity accounting
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#include "utilities.h"
+#include "timer.h"
+#include "LoRaMacEnergy.h"
+
+#if (defined( LORAMAC_ENERGY_STATS_ENABLED ) && ( LORAMAC_ENERGY_STATS_ENABLED == 1 ))
+/*
+ * Accounting context
+ */
+typedef struct sLoRaMacEnergyCtx
+{
+    /*!
+     * Current radio state
+     */
+    LoRaMacEnergyState_t State;
+    /*!
+     * Data rate of the current state
+     */
+    int8_t Datarate;
+    /*!
+     * TX power index of the current state
+     */
+    int8_t TxPower;
+    /*!
+     * Time the current state has been entered
+     */
+    TimerTime_t StateStartTime;
+    /*!
+     * Accumulated statistics, the current state excluded
+     */
+    LoRaMacEnergyStats_t Stats;
+}LoRaMacEnergyCtx_t;
+
+/*
+ * Accounting context. Zero initialized, thus starting in the idle state
+ */
+static LoRaMacEnergyCtx_t EnergyCtx;
+
+/*!
+ * \brief   Adds the elapsed time of the current state to the statistics
+ *
+ * \param   [IN] now   - Current time
+ *
+ * \param   [OUT] stats - Statistics to update
+ */
+static void AccountCurrentState( TimerTime_t now, LoRaMacEnergyStats_t* stats )
+{
+    // Unsigned difference handles a single timestamp wrap around
+    TimerTime_t elapsed = now - EnergyCtx.StateStartTime;
+
+    stats->StateTime[EnergyCtx.State] += elapsed;
+
+    if( ( EnergyCtx.Datarate < 0 ) || ( EnergyCtx.Datarate >= LORAMAC_ENERGY_NB_INDEX ) )
+    {
+        return;
+    }
+    if( EnergyCtx.State == LORAMAC_ENERGY_STATE_TX )
+    {
+        stats->TxTimePerDatarate[EnergyCtx.Datarate] += elapsed;
+        if( ( EnergyCtx.TxPower >= 0 ) && ( EnergyCtx.TxPower < LORAMAC_ENERGY_NB_INDEX ) )
+        {
+            stats->TxTimePerTxPower[EnergyCtx.TxPower] += elapsed;
+        }
+    }
+    else if( ( EnergyCtx.State == LORAMAC_ENERGY_STATE_RX_WINDOW ) ||
+             ( EnergyCtx.State == LORAMAC_ENERGY_STATE_RX_CONTINUOUS ) ||
+             ( EnergyCtx.State == LORAMAC_ENERGY_STATE_RX_CLASS_B ) )
+    {
+        stats->RxTimePerDatarate[EnergyCtx.Datarate] += elapsed;
+    }
+}
+#endif /* LORAMAC_ENERGY_STATS_ENABLED */
+
+void LoRaMacEnergySetState( LoRaMacEnergyState_t state, int8_t datarate, int8_t txPower )
+{
+#if (defined( LORAMAC_ENERGY_STATS_ENABLED ) && ( LORAMAC_ENERGY_STATS_ENABLED == 1 ))
+    TimerTime_t now;
+
+    if( state >= LORAMAC_ENERGY_STATE_MAX )
+    {
+        return;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    now = TimerGetCurrentTime( );
+    AccountCurrentState( now, &EnergyCtx.Stats );
+
+    if( ( state != EnergyCtx.State ) || ( state != LORAMAC_ENERGY_STATE_IDLE ) )
+    {
+        EnergyCtx.Stats.StateCount[state]++;
+    }
+    EnergyCtx.State = state;
+    EnergyCtx.Datarate = datarate;
+    EnergyCtx.TxPower = txPower;
+    EnergyCtx.StateStartTime = now;
+    CRITICAL_SECTION_END( );
+#endif /* LORAMAC_ENERGY_STATS_ENABLED */
+}
+
+LoRaMacStatus_t LoRaMacEnergyGetStats( LoRaMacEnergyStats_t* stats )
+{
+#if (defined( LORAMAC_ENERGY_STATS_ENABLED ) && ( LORAMAC_ENERGY_STATS_ENABLED == 1 ))
+    if( stats == NULL )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+
+    CRITICAL_SECTION_BEGIN( );
+    *stats = EnergyCtx.Stats;
+    AccountCurrentState( TimerGetCurrentTime( ), stats );
+    CRITICAL_SECTION_END( );
+    return LORAMAC_STATUS_OK;
+#else
+    return LORAMAC_STATUS_SERVICE_UNKNOWN;
+#endif /* LORAMAC_ENERGY_STATS_ENABLED */
+}
+
+TimerTime_t LoRaMacEnergyGetActiveTime( void )
+{
+#if (defined( LORAMAC_ENERGY_STATS_ENABLED ) && ( LORAMAC_ENERGY_STATS_ENABLED == 1 ))
+    LoRaMacEnergyStats_t stats;
+    TimerTime_t activeTime = 0;
+
+    LoRaMacEnergyGetStats( &stats );
+    for( uint8_t i = 0; i < LORAMAC_ENERGY_STATE_MAX; i++ )
+    {
+        if( i != LORAMAC_ENERGY_STATE_IDLE )
+        {
+            activeTime += stats.StateTime[i];
+        }
+    }
+    return activeTime;
+#else
+    return 0;
+#endif /* LORAMAC_ENERGY_STATS_ENABLED */
+}
+
+void LoRaMacEnergyReset( void )
+{
+#if (defined( LORAMAC_ENERGY_STATS_ENABLED ) && ( LORAMAC_ENERGY_STATS_ENABLED == 1 ))
+    CRITICAL_SECTION_BEGIN( );
+    memset1( ( uint8_t* )&EnergyCtx.Stats, 0, sizeof( EnergyCtx.Stats ) );
+    EnergyCtx.StateStartTime = TimerGetCurrentTime( );
+    CRITICAL_SECTION_END( );
+#endif /* LORAMAC_ENERGY_STATS_ENABLED */
+}
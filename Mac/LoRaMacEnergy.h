@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file    LoRaMacEnergy.h
+  * @author  MCD Application Team
+  * @brief   LoRa MAC radio activity accounting
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*!
+ * \defgroup  LORAMACENERGY LoRa MAC radio activity accounting
+ *            This module accumulates the time the radio spends in each state
+ *            driven by the LoRaMAC (transmission, class A windows, continuous
+ *            reception, class B slots, channel activity detection). The
+ *            accounting is only compiled in when \ref LORAMAC_ENERGY_STATS_ENABLED
+ *            is set to 1.
+ *            The consumed energy is obtained by weighting the reported times
+ *            with the board current of each state.
+ * \{
+ */
+#ifndef __LORAMAC_ENERGY_H__
+#define __LORAMAC_ENERGY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "LoRaMacInterfaces.h"
+
+/*!
+ * Number of data rates and TX power indexes accounted separately
+ */
+#define LORAMAC_ENERGY_NB_INDEX                     16
+
+/*!
+ * Radio states accounted by the LoRaMAC
+ */
+typedef enum eLoRaMacEnergyState
+{
+    /*!
+     * Radio in sleep or standby mode
+     */
+    LORAMAC_ENERGY_STATE_IDLE,
+    /*!
+     * Transmission of an uplink or a continuous wave
+     */
+    LORAMAC_ENERGY_STATE_TX,
+    /*!
+     * Class A RX1 or RX2 window
+     */
+    LORAMAC_ENERGY_STATE_RX_WINDOW,
+    /*!
+     * Class C continuous reception
+     */
+    LORAMAC_ENERGY_STATE_RX_CONTINUOUS,
+    /*!
+     * Class B beacon or ping slot reception
+     */
+    LORAMAC_ENERGY_STATE_RX_CLASS_B,
+    /*!
+     * Channel activity detection ( listen before talk )
+     */
+    LORAMAC_ENERGY_STATE_CAD,
+    /*!
+     * Number of accounted states
+     */
+    LORAMAC_ENERGY_STATE_MAX
+}LoRaMacEnergyState_t;
+
+/*!
+ * Radio activity statistics
+ */
+typedef struct sLoRaMacEnergyStats
+{
+    /*!
+     * Time in ms spent in each state
+     */
+    TimerTime_t StateTime[LORAMAC_ENERGY_STATE_MAX];
+    /*!
+     * Number of times each state has been entered
+     */
+    uint32_t StateCount[LORAMAC_ENERGY_STATE_MAX];
+    /*!
+     * Transmission time in ms per data rate
+     */
+    TimerTime_t TxTimePerDatarate[LORAMAC_ENERGY_NB_INDEX];
+    /*!
+     * Transmission time in ms per TX power index
+     */
+    TimerTime_t TxTimePerTxPower[LORAMAC_ENERGY_NB_INDEX];
+    /*!
+     * Reception time in ms per data rate, all RX states included
+     */
+    TimerTime_t RxTimePerDatarate[LORAMAC_ENERGY_NB_INDEX];
+}LoRaMacEnergyStats_t;
+
+#if (defined( LORAMAC_ENERGY_STATS_ENABLED ) && ( LORAMAC_ENERGY_STATS_ENABLED == 1 ))
+#define LORAMAC_ENERGY_SET_STATE( state, datarate, txPower )    LoRaMacEnergySetState( state, datarate, txPower )
+#else
+#define LORAMAC_ENERGY_SET_STATE( state, datarate, txPower )
+#endif /* LORAMAC_ENERGY_STATS_ENABLED */
+
+/*!
+ * \brief   Closes the accounting of the current radio state and starts the
+ *          accounting of the new one. May be called from interrupt context
+ *
+ * \param   [IN] state    - New radio state
+ * \param   [IN] datarate - Data rate of a TX or RX state
+ * \param   [IN] txPower  - TX power index of a TX state
+ */
+void LoRaMacEnergySetState( LoRaMacEnergyState_t state, int8_t datarate, int8_t txPower );
+
+/*!
+ * \brief   Gets the radio activity statistics, the ongoing state included
+ *
+ * \param   [OUT] stats - Radio activity statistics
+ *
+ * \retval  Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_SERVICE_UNKNOWN ( accounting not compiled in ).
+ */
+LoRaMacStatus_t LoRaMacEnergyGetStats( LoRaMacEnergyStats_t* stats );
+
+/*!
+ * \brief   Gets the total time the radio spent out of the idle state
+ *
+ * \retval  Active time in ms, 0 when the accounting is not compiled in
+ */
+TimerTime_t LoRaMacEnergyGetActiveTime( void );
+
+/*!
+ * \brief   Resets the radio activity statistics. The current state is kept
+ */
+void LoRaMacEnergyReset( void );
+
+/*! \} defgroup LORAMACENERGY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LORAMAC_ENERGY_H__
@@ -1457,6 +1457,12 @@ typedef struct sMcpsConfirm
      * The uplink channel related to the frame
      */
     uint32_t Channel;
+    /*!
+     * Time in ms the radio was transmitting or receiving for the request,
+     * retransmissions and receive windows included.
+     * Always 0 when LORAMAC_ENERGY_STATS_ENABLED is not set to 1
+     */
+    TimerTime_t RadioActiveTime;
 }McpsConfirm_t;
 
 /*!
@@ -2958,6 +2964,113 @@ typedef struct sLoRaMacTxInfo
     uint8_t CurrentPossiblePayloadSize;
 }LoRaMacTxInfo_t;
 
+/*!
+ * LoRaMAC status snapshot
+ *
+ * \remark Commonly read MAC parameters gathered in a single call, see
+ *         \ref LoRaMacGetStatusSnapshot. Fields are ordered by size to avoid
+ *         padding.
+ */
+typedef struct sLoRaMacStatusSnapshot
+{
+    /*!
+     * LoRaMAC device address
+     */
+    uint32_t DevAddr;
+    /*!
+     * Last uplink frame counter used
+     */
+    uint32_t FCntUp;
+    /*!
+     * Last downlink frame counter received
+     */
+    uint32_t LastDownFCnt;
+    /*!
+     * ADR acknowledgement counter
+     */
+    uint32_t AdrAckCounter;
+    /*!
+     * Receive delay 1 in ms
+     */
+    uint32_t ReceiveDelay1;
+    /*!
+     * Receive delay 2 in ms
+     */
+    uint32_t ReceiveDelay2;
+    /*!
+     * System overall timing error in milliseconds
+     */
+    uint32_t SystemMaxRxError;
+    /*!
+     * Current duty cycle wait time in ms
+     */
+    TimerTime_t DutyCycleWaitTime;
+    /*!
+     * Maximum EIRP in dBm
+     */
+    float MaxEirp;
+    /*!
+     * Antenna gain in dBi
+     */
+    float AntennaGain;
+    /*!
+     * LoRaWAN device class
+     */
+    DeviceClass_t Class;
+    /*!
+     * Network activation type
+     */
+    ActivationType_t NetworkActivation;
+    /*!
+     * LoRaWAN region
+     */
+    LoRaMacRegion_t Region;
+    /*!
+     * Set of parameters for RX2 window
+     */
+    RxChannelParams_t Rx2Channel;
+    /*!
+     * Current datarate
+     */
+    int8_t ChannelsDatarate;
+    /*!
+     * Current TX power
+     */
+    int8_t ChannelsTxPower;
+    /*!
+     * Number of uplink messages repetitions
+     */
+    uint8_t ChannelsNbTrans;
+    /*!
+     * Datarate offset between uplink and downlink on first window
+     */
+    uint8_t Rx1DrOffset;
+    /*!
+     * Minimum required number of symbols to detect an Rx frame
+     */
+    uint8_t MinRxSymbols;
+    /*!
+     * Uplink dwell time configuration
+     */
+    uint8_t UplinkDwellTime;
+    /*!
+     * Downlink dwell time configuration
+     */
+    uint8_t DownlinkDwellTime;
+    /*!
+     * Adaptive data rate state
+     */
+    bool AdrEnable;
+    /*!
+     * Duty cycle state
+     */
+    bool DutyCycleOn;
+    /*!
+     * Public network state
+     */
+    bool PublicNetwork;
+}LoRaMacStatusSnapshot_t;
+
 /*!
  * LoRaMAC Status
  */
@@ -3078,6 +3191,76 @@ typedef enum eLoRaMacStatus
     LORAMAC_STATUS_ERROR
 }LoRaMacStatus_t;
 
+/*!
+ * Maximum number of data rates reported by \ref LoRaMacQueryTxPlan
+ */
+#define LORAMAC_TX_PLAN_MAX_NB_DR                   16
+
+/*!
+ * LoRaMAC transmission plan of a data rate
+ */
+typedef struct sLoRaMacTxPlanEntry
+{
+    /*!
+     * Time-on-air of the frame
+     */
+    TimerTime_t TimeOnAir;
+    /*!
+     * Time in ms to wait before the frame can be sent. 0 when it can be sent now
+     */
+    TimerTime_t TxDelay;
+    /*!
+     * Highest time credits of the bands available for the frame
+     */
+    TimerTime_t TimeCredits;
+    /*!
+     * Availability of the data rate. Possible values are
+     * \ref LORAMAC_STATUS_OK, \ref LORAMAC_STATUS_DUTYCYCLE_RESTRICTED,
+     * \ref LORAMAC_STATUS_NO_CHANNEL_FOUND and \ref LORAMAC_STATUS_LENGTH_ERROR
+     */
+    LoRaMacStatus_t Status;
+    /*!
+     * Uplink data rate
+     */
+    int8_t Datarate;
+}LoRaMacTxPlanEntry_t;
+
+/*!
+ * LoRaMAC transmission plan
+ */
+typedef struct sLoRaMacTxPlan
+{
+    /*!
+     * Transmission plan of each valid uplink data rate
+     */
+    LoRaMacTxPlanEntry_t Entries[LORAMAC_TX_PLAN_MAX_NB_DR];
+    /*!
+     * Number of valid entries
+     */
+    uint8_t NbEntries;
+}LoRaMacTxPlan_t;
+
+/*!
+ * Counters of the received frames rejected before their parsing,
+ * frame counter and MIC processing
+ */
+typedef struct sLoRaMacRxFilterStats
+{
+    /*!
+     * Frames with an uplink or reserved message type
+     */
+    uint32_t NbRejectedMType;
+    /*!
+     * Data frames shorter than the minimum frame size
+     */
+    uint32_t NbRejectedSize;
+    /*!
+     * Data frames addressed neither to the device address
+     * nor to an enabled multicast address
+     */
+    uint32_t NbRejectedAddress;
+}LoRaMacRxFilterStats_t;
+
 /*!
  * LoRaMAC events structure
  * Used to notify upper layers of MAC events
@@ -0,0 +1,220 @@
+/**
+  ******************************************************************************
+  * @file    LoRaMacProfiling.c
+  * @author  MCD Application Team
+  * @brief   LoRa MAC processing time probes
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#include "utilities.h"
+#include "timer.h"
+#include "LoRaMacProfiling.h"
+
+#if (defined( LORAMAC_PROFILING_ENABLED ) && ( LORAMAC_PROFILING_ENABLED == 1 ))
+#ifndef LORAMAC_PROFILING_STACK_PAINT_SIZE
+/*
+ * Size of the painted stack area, 0 disables the stack measurement
+ */
+#define LORAMAC_PROFILING_STACK_PAINT_SIZE          0
+#endif /* LORAMAC_PROFILING_STACK_PAINT_SIZE */
+
+/*
+ * Accumulated data of a profiled stage
+ */
+typedef struct sLoRaMacProfilingEntry
+{
+    /*!
+     * Timestamp of the pending measurement
+     */
+    uint32_t StartTime;
+    /*!
+     * Set to true while a measurement is pending
+     */
+    bool Started;
+    /*!
+     * Number of completed measurements
+     */
+    uint32_t Count;
+    /*!
+     * Shortest measured duration
+     */
+    uint32_t Min;
+    /*!
+     * Longest measured duration
+     */
+    uint32_t Max;
+    /*!
+     * Sum of the measured durations
+     */
+    uint64_t Total;
+    /*!
+     * Stack position of the pending measurement
+     */
+    uintptr_t StartStack;
+    /*!
+     * Deepest stack usage observed, from the painted stack high-water mark
+     */
+    uint32_t MaxStackDepth;
+}LoRaMacProfilingEntry_t;
+
+/*
+ * Profiling data of all stages
+ */
+static LoRaMacProfilingEntry_t ProfilingEntries[LORAMAC_PROFILING_STAGE_MAX];
+
+#if ( LORAMAC_PROFILING_STACK_PAINT_SIZE > 0 )
+#ifndef LORAMAC_PROFILING_STACK_GUARD_SIZE
+/*
+ * Bytes left untouched below the probe, they hold the probe locals (and the red zone of some ABIs)
+ */
+#define LORAMAC_PROFILING_STACK_GUARD_SIZE          64
+#endif /* LORAMAC_PROFILING_STACK_GUARD_SIZE */
+
+/*
+ * Pattern of the painted stack area
+ */
+#define LORAMAC_PROFILING_STACK_PATTERN             0xA5
+
+/*
+ * Lowest address of the painted stack area
+ */
+static volatile uint8_t* StackPaintBottom = NULL;
+
+/*
+ * Address following the painted stack area
+ */
+static volatile uint8_t* StackPaintTop = NULL;
+
+/*
+ * Reports the high-water mark of the painted stack area to the pending measurements,
+ * then paints the free stack below the probe again. The stack is assumed descending.
+ */
+static void UpdateStackDepth( void )
+{
+    uint8_t marker = 0;
+    volatile uint8_t* low = StackPaintBottom;
+
+    if( StackPaintBottom != NULL )
+    {
+        // The deepest stack position used since the last probe is the lowest overwritten byte
+        while( ( low < StackPaintTop ) && ( *low == LORAMAC_PROFILING_STACK_PATTERN ) )
+        {
+            low++;
+        }
+        for( uint8_t i = 0; i < LORAMAC_PROFILING_STAGE_MAX; i++ )
+        {
+            if( ( ProfilingEntries[i].Started == true ) && ( ProfilingEntries[i].StartStack > ( uintptr_t )low ) &&
+                ( ( ProfilingEntries[i].StartStack - ( uintptr_t )low ) > ProfilingEntries[i].MaxStackDepth ) )
+            {
+                ProfilingEntries[i].MaxStackDepth = ( uint32_t )( ProfilingEntries[i].StartStack - ( uintptr_t )low );
+            }
+        }
+    }
+
+    StackPaintTop = ( volatile uint8_t* )( ( uintptr_t )&marker - LORAMAC_PROFILING_STACK_GUARD_SIZE );
+    StackPaintBottom = StackPaintTop - LORAMAC_PROFILING_STACK_PAINT_SIZE;
+    for( low = StackPaintBottom; low < StackPaintTop; low++ )
+    {
+        *low = LORAMAC_PROFILING_STACK_PATTERN;
+    }
+}
+#endif /* LORAMAC_PROFILING_STACK_PAINT_SIZE */
+#endif /* LORAMAC_PROFILING_ENABLED */
+
+void LoRaMacProfilingStart( LoRaMacProfilingStage_t stage )
+{
+#if (defined( LORAMAC_PROFILING_ENABLED ) && ( LORAMAC_PROFILING_ENABLED == 1 ))
+    uint8_t marker = 0;
+
+    if( stage >= LORAMAC_PROFILING_STAGE_MAX )
+    {
+        return;
+    }
+#if ( LORAMAC_PROFILING_STACK_PAINT_SIZE > 0 )
+    UpdateStackDepth( );
+#endif /* LORAMAC_PROFILING_STACK_PAINT_SIZE */
+    // The probes are called at the same depth, the local variable gives the stack position of the stage
+    ProfilingEntries[stage].StartStack = ( uintptr_t )&marker;
+    ProfilingEntries[stage].Started = true;
+    ProfilingEntries[stage].StartTime = LORAMAC_PROFILING_GET_TIMESTAMP( );
+#endif /* LORAMAC_PROFILING_ENABLED */
+}
+
+void LoRaMacProfilingStop( LoRaMacProfilingStage_t stage )
+{
+#if (defined( LORAMAC_PROFILING_ENABLED ) && ( LORAMAC_PROFILING_ENABLED == 1 ))
+    uint32_t now = LORAMAC_PROFILING_GET_TIMESTAMP( );
+    uint32_t elapsed = 0;
+    LoRaMacProfilingEntry_t* entry;
+
+    if( stage >= LORAMAC_PROFILING_STAGE_MAX )
+    {
+        return;
+    }
+#if ( LORAMAC_PROFILING_STACK_PAINT_SIZE > 0 )
+    UpdateStackDepth( );
+#endif /* LORAMAC_PROFILING_STACK_PAINT_SIZE */
+    entry = &ProfilingEntries[stage];
+    if( entry->Started == false )
+    {
+        return;
+    }
+    entry->Started = false;
+
+    // Unsigned difference handles a single timestamp wrap around
+    elapsed = now - entry->StartTime;
+
+    if( ( entry->Count == 0 ) || ( elapsed < entry->Min ) )
+    {
+        entry->Min = elapsed;
+    }
+    if( elapsed > entry->Max )
+    {
+        entry->Max = elapsed;
+    }
+    entry->Total += elapsed;
+    entry->Count++;
+#endif /* LORAMAC_PROFILING_ENABLED */
+}
+
+LoRaMacStatus_t LoRaMacProfilingGetStats( LoRaMacProfilingStage_t stage, LoRaMacProfilingStats_t* stats )
+{
+#if (defined( LORAMAC_PROFILING_ENABLED ) && ( LORAMAC_PROFILING_ENABLED == 1 ))
+    LoRaMacProfilingEntry_t* entry;
+
+    if( ( stage >= LORAMAC_PROFILING_STAGE_MAX ) || ( stats == NULL ) )
+    {
+        return LORAMAC_STATUS_PARAMETER_INVALID;
+    }
+    entry = &ProfilingEntries[stage];
+
+    stats->Count = entry->Count;
+    stats->Min = entry->Min;
+    stats->Max = entry->Max;
+    stats->MaxStackDepth = entry->MaxStackDepth;
+    stats->Mean = 0;
+    if( entry->Count != 0 )
+    {
+        stats->Mean = ( uint32_t )( entry->Total / entry->Count );
+    }
+    return LORAMAC_STATUS_OK;
+#else
+    return LORAMAC_STATUS_SERVICE_UNKNOWN;
+#endif /* LORAMAC_PROFILING_ENABLED */
+}
+
+void LoRaMacProfilingReset( void )
+{
+#if (defined( LORAMAC_PROFILING_ENABLED ) && ( LORAMAC_PROFILING_ENABLED == 1 ))
+    memset1( ( uint8_t* )ProfilingEntries, 0, sizeof( ProfilingEntries ) );
+#endif /* LORAMAC_PROFILING_ENABLED */
+}
@@ -0,0 +1,185 @@
+/**
+  ******************************************************************************
+  * @file    LoRaMacProfiling.h
+  * @author  MCD Application Team
+  * @brief   LoRa MAC processing time probes
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*!
+ * \defgroup  LORAMACPROFILING LoRa MAC processing time probes
+ *            This module accumulates the time spent in the main stages of the
+ *            LoRaMAC receive and transmit paths. The probes are only compiled in
+ *            when \ref LORAMAC_PROFILING_ENABLED is set to 1.
+ *            The unit of the reported values is the unit of
+ *            \ref LORAMAC_PROFILING_GET_TIMESTAMP.
+ *            When \ref LORAMAC_PROFILING_STACK_PAINT_SIZE is set, each probe paints
+ *            the free stack below it and reads back the high-water mark left since
+ *            the previous probe. The stack depth of a stage is the deepest stack
+ *            position reached while it is measured, relative to its start probe,
+ *            including the probes nested in the stage and the interrupts served on
+ *            the same stack. It assumes a descending stack.
+ * \{
+ */
+#ifndef __LORAMAC_PROFILING_H__
+#define __LORAMAC_PROFILING_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "LoRaMacInterfaces.h"
+
+/*!
+ * Profiled stages of the LoRaMAC
+ */
+typedef enum eLoRaMacProfilingStage
+{
+    /*!
+     * Complete processing of a received frame
+     */
+    LORAMAC_PROFILING_RX_TOTAL,
+    /*!
+     * Parsing of the data frame header
+     */
+    LORAMAC_PROFILING_RX_HEADER_PARSE,
+    /*!
+     * Frame type determination and device / multicast address matching
+     */
+    LORAMAC_PROFILING_RX_ADDRESS_MATCH,
+    /*!
+     * Downlink frame counter retrieval and check
+     */
+    LORAMAC_PROFILING_RX_FCNT,
+    /*!
+     * MIC verification of a data frame
+     */
+    LORAMAC_PROFILING_RX_MIC_VERIFY,
+    /*!
+     * Decryption of the FRMPayload and FOpts
+     */
+    LORAMAC_PROFILING_RX_DECRYPT,
+    /*!
+     * Processing of the received MAC commands
+     */
+    LORAMAC_PROFILING_RX_MAC_COMMANDS,
+    /*!
+     * MCPS-Indication callback
+     */
+    LORAMAC_PROFILING_RX_INDICATION,
+    /*!
+     * Transmission scheduling ( channel selection, duty cycle, frame securing )
+     */
+    LORAMAC_PROFILING_TX_SCHEDULE,
+    /*!
+     * Radio configuration of the uplink up to Radio.Send
+     */
+    LORAMAC_PROFILING_TX_SEND_FRAME,
+    /*!
+     * Class B beacon reception processing
+     */
+    LORAMAC_PROFILING_CLASSB_RX_BEACON,
+    /*!
+     * Region switch with LoRaMacRegionSwitch
+     */
+    LORAMAC_PROFILING_REGION_SWITCH,
+    /*!
+     * Number of profiled stages
+     */
+    LORAMAC_PROFILING_STAGE_MAX
+}LoRaMacProfilingStage_t;
+
+/*!
+ * Statistics of a profiled stage
+ */
+typedef struct sLoRaMacProfilingStats
+{
+    /*!
+     * Number of completed measurements
+     */
+    uint32_t Count;
+    /*!
+     * Shortest measured duration
+     */
+    uint32_t Min;
+    /*!
+     * Longest measured duration
+     */
+    uint32_t Max;
+    /*!
+     * Mean measured duration
+     */
+    uint32_t Mean;
+    /*!
+     * Deepest stack usage in bytes observed during the stage, 0 when
+     * LORAMAC_PROFILING_STACK_PAINT_SIZE is 0
+     */
+    uint32_t MaxStackDepth;
+}LoRaMacProfilingStats_t;
+
+#if (defined( LORAMAC_PROFILING_ENABLED ) && ( LORAMAC_PROFILING_ENABLED == 1 ))
+#ifndef LORAMAC_PROFILING_GET_TIMESTAMP
+/*!
+ * Timestamp source of the probes. May be redefined in lorawan_conf.h
+ */
+#define LORAMAC_PROFILING_GET_TIMESTAMP( )          ( ( uint32_t )TimerGetCurrentTime( ) )
+#endif /* LORAMAC_PROFILING_GET_TIMESTAMP */
+
+#define LORAMAC_PROFILING_START( stage )            LoRaMacProfilingStart( stage )
+#define LORAMAC_PROFILING_STOP( stage )             LoRaMacProfilingStop( stage )
+#else
+#define LORAMAC_PROFILING_START( stage )
+#define LORAMAC_PROFILING_STOP( stage )
+#endif /* LORAMAC_PROFILING_ENABLED */
+
+/*!
+ * \brief   Starts a measurement of the given stage
+ *
+ * \param   [IN] stage - Profiled stage
+ */
+void LoRaMacProfilingStart( LoRaMacProfilingStage_t stage );
+
+/*!
+ * \brief   Stops the measurement of the given stage and updates its statistics.
+ *          A stop without a matching start is ignored.
+ *
+ * \param   [IN] stage - Profiled stage
+ */
+void LoRaMacProfilingStop( LoRaMacProfilingStage_t stage );
+
+/*!
+ * \brief   Gets the statistics of a profiled stage
+ *
+ * \param   [IN] stage - Profiled stage
+ *
+ * \param   [OUT] stats - Statistics of the stage
+ *
+ * \retval  Possible returns are:
+ *          \ref LORAMAC_STATUS_OK,
+ *          \ref LORAMAC_STATUS_PARAMETER_INVALID,
+ *          \ref LORAMAC_STATUS_SERVICE_UNKNOWN ( probes not compiled in ).
+ */
+LoRaMacStatus_t LoRaMacProfilingGetStats( LoRaMacProfilingStage_t stage, LoRaMacProfilingStats_t* stats );
+
+/*!
+ * \brief   Resets the statistics of all stages
+ */
+void LoRaMacProfilingReset( void );
+
+/*! \} defgroup LORAMACPROFILING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LORAMAC_PROFILING_H__
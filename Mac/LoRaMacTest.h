@@ -51,6 +51,22 @@ extern "C"
  */
 void LoRaMacTestSetDutyCycleOn( bool enable );
 
+/*!
+ * \brief   Injects a frame in the reception path as if it had been received by the radio
+ *
+ * \details This is a test function. It shall be used for testing purposes only.
+ *          It allows to replay recorded or synthetic downlinks and to measure their
+ *          processing with the LoRaMacProfiling probes. The frame is processed by the
+ *          next LoRaMacProcess call, in the context of the currently open reception slot.
+ *          The buffer must remain valid until then.
+ *
+ * \param   [in] payload - Received frame, starting with the MAC header
+ * \param   [in] size    - Size of the received frame
+ * \param   [in] rssi    - RSSI reported for the frame
+ * \param   [in] snr     - SNR reported for the frame
+ */
+void LoRaMacTestRxFrame( uint8_t* payload, uint16_t size, int16_t rssi, int8_t snr );
+
 /*! \} defgroup LORAMACTEST */
 
 #ifdef __cplusplus
@@ -823,6 +823,21 @@ typedef struct sNextChanParams
      * Payload length of the next frame
      */
     uint16_t PktLen;
+    /*!
+     * Set to true to only evaluate the channel availability. The bands, the
+     * channels masks and the aggregated time-off are not updated, no carrier
+     * sense is performed and no channel is selected.
+     */
+    bool QueryOnly;
+    /*!
+     * Time-on-air of the frame. Output, only set when QueryOnly is true.
+     */
+    TimerTime_t TimeOnAir;
+    /*!
+     * Highest time credits of the bands available for the frame. Output,
+     * only set when QueryOnly is true.
+     */
+    TimerTime_t TimeCredits;
 }NextChanParams_t;
 
 /*!
@@ -903,6 +918,46 @@ typedef struct sRxBeaconSetupParams
     uint32_t Frequency;
 }RxBeaconSetup_t;
 
+/*!
+ * Operations implemented by a region, see the Region<Operation> functions
+ */
+typedef struct sRegionOps
+{
+    PhyParam_t ( *GetPhyParam )( GetPhyParams_t* getPhy );
+    void ( *SetBandTxDone )( SetBandTxDoneParams_t* txDone );
+    void ( *InitDefaults )( InitDefaultsParams_t* params );
+    bool ( *Verify )( VerifyParams_t* verify, PhyAttribute_t phyAttribute );
+    void ( *ApplyCFList )( ApplyCFListParams_t* applyCFList );
+    bool ( *ChanMaskSet )( ChanMaskSetParams_t* chanMaskSet );
+    void ( *ComputeRxWindowParameters )( int8_t datarate, uint8_t minRxSymbols, uint32_t rxError, RxConfigParams_t *rxConfigParams );
+    bool ( *RxConfig )( RxConfigParams_t* rxConfig, int8_t* datarate );
+    bool ( *TxConfig )( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime_t* txTimeOnAir );
+    uint8_t ( *LinkAdrReq )( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, int8_t* txPowOut, uint8_t* nbRepOut, uint8_t* nbBytesParsed );
+    uint8_t ( *RxParamSetupReq )( RxParamSetupReqParams_t* rxParamSetupReq );
+    int8_t ( *NewChannelReq )( NewChannelReqParams_t* newChannelReq );
+    int8_t ( *TxParamSetupReq )( TxParamSetupReqParams_t* txParamSetupReq );
+    int8_t ( *DlChannelReq )( DlChannelReqParams_t* dlChannelReq );
+    int8_t ( *AlternateDr )( int8_t currentDr, AlternateDrType_t type );
+    LoRaMacStatus_t ( *NextChannel )( NextChanParams_t* nextChanParams, uint8_t* channel, TimerTime_t* time, TimerTime_t* aggregatedTimeOff );
+    LoRaMacStatus_t ( *ChannelAdd )( ChannelAddParams_t* channelAdd );
+    bool ( *ChannelsRemove )( ChannelRemoveParams_t* channelRemove );
+#if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
+    void ( *SetContinuousWave )( ContinuousWaveParams_t* continuousWave );
+#endif /* REGION_VERSION */
+    uint8_t ( *ApplyDrOffset )( uint8_t downlinkDwellTime, int8_t dr, int8_t drOffset );
+    void ( *RxBeaconSetup )( RxBeaconSetup_t* rxBeaconSetup, uint8_t* outDr );
+}RegionOps_t;
+
+/*!
+ * \brief Gets the operations of a region. The Region<Operation> functions
+ *        dispatch through this table with a single indirect call.
+ *
+ * \param [in] region LoRaWAN region.
+ *
+ * \retval Operations of the region, NULL if the region is not linked in.
+ */
+const RegionOps_t* RegionGetOps( LoRaMacRegion_t region );
+
 /*!
  * \brief The function verifies if a region is active or not. If a region
  *        is not active, it cannot be used.
@@ -106,7 +106,22 @@ static TimerTime_t GetTimeOnAir( int8_t datarate, uint16_t pktLen )
     int8_t phyDr = DataratesAU915[datarate];
     uint32_t bandwidth = RegionCommonGetBandwidth( datarate, BandwidthsAU915 );
 
-    return Radio.TimeOnAir( MODEM_LORA, bandwidth, phyDr, 1, 8, false, pktLen, true );
+    return RegionCommonGetUplinkTimeOnAir( datarate, MODEM_LORA, phyDr, bandwidth, pktLen );
+}
+
+static uint32_t GetJoinSubBandOrder( void )
+{
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+    // Planned at the first join request of the sweep, once the MAC has
+    // seeded the random generator
+    if( RegionNvmGroup1->JoinSubBandOrder == REGION_BASE_US_JOIN_ORDER_UNPLANNED )
+    {
+        RegionNvmGroup1->JoinSubBandOrder = RegionBaseUSComputeJoinSweepOrder( );
+    }
+    return RegionNvmGroup1->JoinSubBandOrder;
+#else
+    return REGION_BASE_US_JOIN_ORDER_SEQUENTIAL;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
 }
 #endif /* REGION_AU915 */
 
@@ -406,6 +421,9 @@ void RegionAU915InitDefaults( InitDefaultsParams_t* params )
 
             // Initialize 8 bit channel groups index
             RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+            RegionNvmGroup1->JoinSubBandOrder = REGION_BASE_US_JOIN_ORDER_UNPLANNED;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
 
             // Initialize the join trials counter
             RegionNvmGroup1->JoinTrialsCounter = 0;
@@ -629,10 +647,10 @@ bool RegionAU915RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     // Read the physical datarate from the datarates table
     phyDr = DataratesAU915[dr];
 
-    Radio.SetChannel( frequency );
+    RegionCommonRadioSetChannel( frequency );
 
     // Radio configuration
-    Radio.SetRxConfig( MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
+    RegionCommonRadioSetRxConfig( MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
 
     if( rxConfig->RepeaterSupport == true )
     {
@@ -642,7 +660,7 @@ bool RegionAU915RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     {
         maxPayload = MaxPayloadOfDatarateDwell0AU915[dr];
     }
-    Radio.SetMaxPayloadLength( MODEM_LORA, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
 
     RegionCommonRxConfigPrint(rxConfig->RxSlot, frequency, dr);
 
@@ -669,13 +687,13 @@ bool RegionAU915TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    RegionCommonRadioSetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
 
-    Radio.SetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
+    RegionCommonRadioSetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
     RegionCommonTxConfigPrint(RegionNvmGroup2->Channels[txConfig->Channel].Frequency, txConfig->Datarate);
 
     // Setup maximum payload length of the radio driver
-    Radio.SetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
 
     // Update time-on-air
     *txTimeOnAir = GetTimeOnAir( txConfig->Datarate, txConfig->PktLen );
@@ -939,26 +957,42 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
 
+    uint16_t channelsMaskRemaining[CHANNELS_MASK_SIZE];
+    uint16_t* channelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
+
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Work on a copy, the remaining channels are only consumed by a transmission
+        RegionCommonChanMaskCopy( channelsMaskRemaining, RegionNvmGroup1->ChannelsMaskRemaining, CHANNELS_MASK_SIZE );
+        channelsMask = channelsMaskRemaining;
+    }
+
     // Count 125kHz channels
-    if( RegionCommonCountChannels( RegionNvmGroup1->ChannelsMaskRemaining, 0, 4 ) == 0 )
+    if( RegionCommonCountChannels( channelsMask, 0, 4 ) == 0 )
     { // Reactivate default channels
-        RegionCommonChanMaskCopy( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, 4  );
+        RegionCommonChanMaskCopy( channelsMask, RegionNvmGroup2->ChannelsMask, 4  );
 
-        RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+        if( nextChanParams->QueryOnly == false )
+        {
+            RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+            RegionNvmGroup1->JoinSubBandOrder = REGION_BASE_US_JOIN_ORDER_UNPLANNED;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
+        }
     }
     // Check other channels
     if( nextChanParams->Datarate >= DR_6 )
     {
-        if( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) == 0 )
+        if( ( channelsMask[4] & CHANNELS_MASK_500KHZ_MASK ) == 0 )
         {
-            RegionNvmGroup1->ChannelsMaskRemaining[4] = RegionNvmGroup2->ChannelsMask[4];
+            channelsMask[4] = RegionNvmGroup2->ChannelsMask[4];
         }
     }
 
     // Search how many channels are enabled
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
-    countChannelsParams.ChannelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
+    countChannelsParams.ChannelsMask = channelsMask;
     countChannelsParams.Channels = RegionNvmGroup2->Channels;
 #if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
     countChannelsParams.Bands = RegionNvmGroup1->Bands;
@@ -978,16 +1012,25 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
     identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
 
     identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+    identifyChannelsParam.QueryOnly = nextChanParams->QueryOnly;
 
     status = RegionCommonIdentifyChannels( &identifyChannelsParam, aggregatedTimeOff, enabledChannels,
                                            &nbEnabledChannels, &nbRestrictedChannels, time );
 
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Report the availability only, no channel is selected
+        nextChanParams->TimeOnAir = identifyChannelsParam.ExpectedTimeOnAir;
+        nextChanParams->TimeCredits = identifyChannelsParam.TimeCredits;
+        return status;
+    }
+
     if( status == LORAMAC_STATUS_OK )
     {
         if( nextChanParams->Joined == true )
         {
             // Choose randomly on of the remaining channels
-            *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+            *channel = enabledChannels[RegionCommonSelectChannel( enabledChannels, nbEnabledChannels )];
         }
         else
         {
@@ -999,7 +1042,7 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
             // 125kHz Channels (0 - 63) DR2
             if( nextChanParams->Datarate == DR_2 )
             {
-                if( RegionBaseUSComputeNext125kHzJoinChannel( ( uint16_t* ) RegionNvmGroup1->ChannelsMaskRemaining,
+                if( RegionBaseUSComputeNextJoinChannel( ( uint16_t* ) RegionNvmGroup1->ChannelsMaskRemaining, GetJoinSubBandOrder( ),
                     &RegionNvmGroup1->JoinChannelGroupsCurrentIndex, channel ) == LORAMAC_STATUS_PARAMETER_INVALID )
                 {
                     return LORAMAC_STATUS_PARAMETER_INVALID;
@@ -1009,12 +1052,8 @@ LoRaMacStatus_t RegionAU915NextChannel( NextChanParams_t* nextChanParams, uint8_
             else
             {
                 // Choose the next available channel
-                uint8_t i = 0;
-                while( ( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) & ( 1 << i ) ) == 0 )
-                {
-                    i++;
-                }
-                *channel = 64 + i;
+                *channel = 64 + RegionBaseUSComputeNext500kHzJoinChannel( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK,
+                                                                          GetJoinSubBandOrder( ) );
             }
         }
 
@@ -1049,6 +1088,7 @@ void RegionAU915SetContinuousWave( ContinuousWaveParams_t* continuousWave )
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, continuousWave->MaxEirp, continuousWave->AntennaGain );
 
     Radio.SetTxContinuousWave( frequency, phyTxPower, continuousWave->Timeout );
+    RegionCommonRadioShadowInvalidate( );
 #endif /* REGION_AU915 */
 }
 #endif /* REGION_VERSION */
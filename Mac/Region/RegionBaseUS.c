@@ -71,14 +71,48 @@ static LoRaMacStatus_t FindAvailable125kHzChannels( uint16_t currentChannelMaskL
     return LORAMAC_STATUS_OK;
 }
 
+#ifndef REGION_JOIN_SWEEP_PREFERRED_SUB_BAND
+/*!
+ * Sub-band probed first by the join sweeps (1 to 8), 0 for none
+ */
+#define REGION_JOIN_SWEEP_PREFERRED_SUB_BAND        0
+#endif /* REGION_JOIN_SWEEP_PREFERRED_SUB_BAND */
+
+/*!
+ * Sub-band probed first by the join sweeps planned with RegionBaseUSComputeJoinSweepOrder
+ */
+static uint8_t JoinPreferredSubBand = REGION_JOIN_SWEEP_PREFERRED_SUB_BAND;
+
+/*!
+ * \brief Gets the sub-band at the given position of a join sweep order.
+ *
+ * \param [in] subBandOrder Sub-band order, one sub-band per nibble.
+ *
+ * \param [in] position Position in the order.
+ *
+ * \retval Sub-band, 0 to 7.
+ */
+static uint8_t GetJoinSweepSubBand( uint32_t subBandOrder, uint8_t position )
+{
+    return ( uint8_t )( ( subBandOrder >> ( position * 4 ) ) & 0x07 );
+}
+
 LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMaskRemaining,
                                                           uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex )
+{
+    return RegionBaseUSComputeNextJoinChannel( channelsMaskRemaining, REGION_BASE_US_JOIN_ORDER_SEQUENTIAL,
+                                               groupsCurrentIndex, newChannelIndex );
+}
+
+LoRaMacStatus_t RegionBaseUSComputeNextJoinChannel( uint16_t* channelsMaskRemaining, uint32_t subBandOrder,
+                                                    uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex )
 {
     uint8_t currentChannelMaskLeftIndex;
     uint16_t currentChannelMaskLeft;
     uint8_t findAvailableChannelsIndex[8] = { 0 };
     uint8_t availableChannels = 0;
     uint8_t startIndex;
+    uint8_t subBand;
 
     // Null pointer check
     if( channelsMaskRemaining == NULL || groupsCurrentIndex == NULL || newChannelIndex == NULL )
@@ -86,16 +120,18 @@ LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMask
         return LORAMAC_STATUS_PARAMETER_INVALID;
     }
 
-    // copy the current index.
-    startIndex = *groupsCurrentIndex;
+    // copy the current position in the order.
+    startIndex = *groupsCurrentIndex & 0x07;
 
     do
     {
+        subBand = GetJoinSweepSubBand( subBandOrder, startIndex );
+
         // Current ChannelMaskRemaining, two groups per channel mask. For example Group 0 and 1 (8 bit) are ChannelMaskRemaining 0 (16 bit), etc.
-        currentChannelMaskLeftIndex = (uint8_t) startIndex / 2;
+        currentChannelMaskLeftIndex = (uint8_t) subBand / 2;
 
         // For even numbers we need the 8 LSBs and for uneven the 8 MSBs
-        if( ( startIndex % 2 ) == 0 )
+        if( ( subBand % 2 ) == 0 )
         {
             currentChannelMaskLeft = ( channelsMaskRemaining[currentChannelMaskLeftIndex] & 0x00FF );
         }
@@ -112,7 +148,7 @@ LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMask
         if ( availableChannels > 0 )
         {
             // Choose randomly a free channel 125kHz
-            *newChannelIndex = ( startIndex * 8 ) + findAvailableChannelsIndex[randr( 0, ( availableChannels - 1 ) )];
+            *newChannelIndex = ( subBand * 8 ) + findAvailableChannelsIndex[randr( 0, ( availableChannels - 1 ) )];
         }
 
         // Increment start index
@@ -121,7 +157,7 @@ LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMask
         {
             startIndex = 0;
         }
-    } while( ( availableChannels == 0 ) && ( startIndex != *groupsCurrentIndex ) );
+    } while( ( availableChannels == 0 ) && ( startIndex != ( *groupsCurrentIndex & 0x07 ) ) );
 
     if ( availableChannels > 0 )
     {
@@ -132,6 +168,63 @@ LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMask
     return LORAMAC_STATUS_PARAMETER_INVALID;
 }
 
+uint8_t RegionBaseUSComputeNext500kHzJoinChannel( uint16_t channelsMask500kHz, uint32_t subBandOrder )
+{
+    uint8_t subBand = GetJoinSweepSubBand( subBandOrder, 0 );
+
+    for( uint8_t i = 0; i < 8; i++ )
+    {
+        // The 500 kHz channel i is centered in the sub-band i
+        if( ( channelsMask500kHz & ( 1 << GetJoinSweepSubBand( subBandOrder, i ) ) ) != 0 )
+        {
+            subBand = GetJoinSweepSubBand( subBandOrder, i );
+            break;
+        }
+    }
+    return subBand;
+}
+
+uint32_t RegionBaseUSComputeJoinSweepOrder( void )
+{
+    uint8_t subBands[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    uint8_t first = 0;
+    uint8_t tmp;
+    uint8_t j;
+    uint32_t subBandOrder = 0;
+
+    if( ( JoinPreferredSubBand >= 1 ) && ( JoinPreferredSubBand <= 8 ) )
+    {
+        // The preferred sub-band is always probed first
+        subBands[0] = JoinPreferredSubBand - 1;
+        subBands[JoinPreferredSubBand - 1] = 0;
+        first = 1;
+    }
+
+    // Fisher-Yates shuffle of the other sub-bands
+    for( uint8_t i = 7; i > first; i-- )
+    {
+        j = ( uint8_t )randr( first, i );
+        tmp = subBands[i];
+        subBands[i] = subBands[j];
+        subBands[j] = tmp;
+    }
+
+    for( uint8_t i = 0; i < 8; i++ )
+    {
+        subBandOrder |= ( uint32_t )subBands[i] << ( i * 4 );
+    }
+    return subBandOrder;
+}
+
+void RegionBaseUSSetJoinPreferredSubBand( uint8_t subBand )
+{
+    if( subBand > 8 )
+    {
+        subBand = 0;
+    }
+    JoinPreferredSubBand = subBand;
+}
+
 bool RegionBaseUSVerifyFrequencyGroup( uint32_t freq, uint32_t minFreq, uint32_t maxFreq, uint32_t stepwidth )
 {
     if( ( freq < minFreq ) ||
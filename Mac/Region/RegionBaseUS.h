@@ -43,6 +43,16 @@ extern "C"
 
 #include "LoRaMac.h"
 
+/*!
+ * Sub-band order of a sequential join sweep, one sub-band per nibble
+ */
+#define REGION_BASE_US_JOIN_ORDER_SEQUENTIAL        0x76543210
+
+/*!
+ * Sub-band order of a join sweep not planned yet, never a valid order
+ */
+#define REGION_BASE_US_JOIN_ORDER_UNPLANNED         0x00000000
+
 /*!
  * \brief Computes the next 125kHz channel used for join requests.
  *        And it returns all the parameters updated.
@@ -58,6 +68,51 @@ extern "C"
 LoRaMacStatus_t RegionBaseUSComputeNext125kHzJoinChannel( uint16_t* channelsMaskRemaining,
                                                           uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex );
 
+/*!
+ * \brief Computes the next 125kHz channel used for join requests, probing
+ *        the sub-bands in the given order.
+ *
+ * \param [in]  channelsMaskRemaining pointer to remaining channels.
+ *
+ * \param [in]  subBandOrder Sub-band order, one sub-band (0 to 7) per nibble,
+ *              the first one in the least significant nibble.
+ *
+ * \param [in]  groupsCurrentIndex Current position in the sub-band order.
+ *
+ * \param [out] newChannelIndex Index of next available channel.
+ *
+ * \retval Status
+ */
+LoRaMacStatus_t RegionBaseUSComputeNextJoinChannel( uint16_t* channelsMaskRemaining, uint32_t subBandOrder,
+                                                    uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex );
+
+/*!
+ * \brief Computes the next 500kHz channel used for join requests: the
+ *        first remaining one in the sub-band order.
+ *
+ * \param [in]  channelsMask500kHz Remaining 500kHz channels (bits 0 to 7).
+ *
+ * \param [in]  subBandOrder Sub-band order, one sub-band per nibble.
+ *
+ * \retval Index of the 500kHz channel, 0 to 7.
+ */
+uint8_t RegionBaseUSComputeNext500kHzJoinChannel( uint16_t channelsMask500kHz, uint32_t subBandOrder );
+
+/*!
+ * \brief Computes a random sub-band order for a join sweep. The preferred
+ *        sub-band, if any, is always the first one.
+ *
+ * \retval Sub-band order, one sub-band per nibble.
+ */
+uint32_t RegionBaseUSComputeJoinSweepOrder( void );
+
+/*!
+ * \brief Sets the sub-band probed first by the next join sweeps.
+ *
+ * \param [in]  subBand Sub-band, 1 to 8 (channels 0-7 and 64 for 1). 0 for none.
+ */
+void RegionBaseUSSetJoinPreferredSubBand( uint8_t subBand );
+
 /*!
  * \brief Verifies if the frequency is in the correct range with a
  *        specific stepwidth.
@@ -191,121 +191,142 @@ static RegionNvmDataGroup2_t* RegionNvmGroup2;
 #if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
 static Band_t* RegionBands;
 
+/*
+ * Configurations of the channel plans, indexed by RegionCN470ChannelPlan_t.
+ */
+static const RegionCN470ChannelPlanCtx_t ChannelPlanCtxs[] =
+{
+    // CHANNEL_PLAN_UNKNOWN: apply CHANNEL_PLAN_20MHZ_TYPE_A
+    {
+        .ChannelsMaskSize = CN470_A20_CHANNELS_MASK_SIZE,
+        .JoinAcceptListSize = CN470_A20_JOIN_ACCEPT_LIST_SIZE,
+        .NbBeaconChannels = CN470_A20_BEACON_NB_CHANNELS,
+        .NbPingSlotChannels = CN470_A20_PING_SLOT_NB_CHANNELS,
+        .GetDownlinkFrequency = RegionCN470A20GetDownlinkFrequency,
+        .GetBeaconChannelOffset = RegionCN470A20GetBeaconChannelOffset,
+        .LinkAdrChMaskUpdate = RegionCN470A20LinkAdrChMaskUpdate,
+        .VerifyRfFreq = RegionCN470A20VerifyRfFreq,
+        .InitializeChannels = RegionCN470A20InitializeChannels,
+        .InitializeChannelsMask = RegionCN470A20InitializeChannelsMask,
+        .GetRx1Frequency = RegionCN470A20GetRx1Frequency,
+        .GetRx2Frequency = RegionCN470A20GetRx2Frequency,
+    },
+    // CHANNEL_PLAN_20MHZ_TYPE_A
+    {
+        .ChannelsMaskSize = CN470_A20_CHANNELS_MASK_SIZE,
+        .JoinAcceptListSize = CN470_A20_JOIN_ACCEPT_LIST_SIZE,
+        .NbBeaconChannels = CN470_A20_BEACON_NB_CHANNELS,
+        .NbPingSlotChannels = CN470_A20_PING_SLOT_NB_CHANNELS,
+        .GetDownlinkFrequency = RegionCN470A20GetDownlinkFrequency,
+        .GetBeaconChannelOffset = RegionCN470A20GetBeaconChannelOffset,
+        .LinkAdrChMaskUpdate = RegionCN470A20LinkAdrChMaskUpdate,
+        .VerifyRfFreq = RegionCN470A20VerifyRfFreq,
+        .InitializeChannels = RegionCN470A20InitializeChannels,
+        .InitializeChannelsMask = RegionCN470A20InitializeChannelsMask,
+        .GetRx1Frequency = RegionCN470A20GetRx1Frequency,
+        .GetRx2Frequency = RegionCN470A20GetRx2Frequency,
+    },
+    // CHANNEL_PLAN_20MHZ_TYPE_B
+    {
+        .ChannelsMaskSize = CN470_B20_CHANNELS_MASK_SIZE,
+        .JoinAcceptListSize = CN470_B20_JOIN_ACCEPT_LIST_SIZE,
+        .NbBeaconChannels = CN470_B20_BEACON_NB_CHANNELS,
+        .NbPingSlotChannels = CN470_B20_PING_SLOT_NB_CHANNELS,
+        .GetDownlinkFrequency = RegionCN470B20GetDownlinkFrequency,
+        .GetBeaconChannelOffset = RegionCN470B20GetBeaconChannelOffset,
+        .LinkAdrChMaskUpdate = RegionCN470B20LinkAdrChMaskUpdate,
+        .VerifyRfFreq = RegionCN470B20VerifyRfFreq,
+        .InitializeChannels = RegionCN470B20InitializeChannels,
+        .InitializeChannelsMask = RegionCN470B20InitializeChannelsMask,
+        .GetRx1Frequency = RegionCN470B20GetRx1Frequency,
+        .GetRx2Frequency = RegionCN470B20GetRx2Frequency,
+    },
+    // CHANNEL_PLAN_26MHZ_TYPE_A
+    {
+        .ChannelsMaskSize = CN470_A26_CHANNELS_MASK_SIZE,
+        .JoinAcceptListSize = CN470_A26_JOIN_ACCEPT_LIST_SIZE,
+        .NbBeaconChannels = CN470_A26_BEACON_NB_CHANNELS,
+        .NbPingSlotChannels = CN470_A26_PING_SLOT_NB_CHANNELS,
+        .GetDownlinkFrequency = RegionCN470A26GetDownlinkFrequency,
+        .GetBeaconChannelOffset = RegionCN470A26GetBeaconChannelOffset,
+        .LinkAdrChMaskUpdate = RegionCN470A26LinkAdrChMaskUpdate,
+        .VerifyRfFreq = RegionCN470A26VerifyRfFreq,
+        .InitializeChannels = RegionCN470A26InitializeChannels,
+        .InitializeChannelsMask = RegionCN470A26InitializeChannelsMask,
+        .GetRx1Frequency = RegionCN470A26GetRx1Frequency,
+        .GetRx2Frequency = RegionCN470A26GetRx2Frequency,
+    },
+    // CHANNEL_PLAN_26MHZ_TYPE_B
+    {
+        .ChannelsMaskSize = CN470_B26_CHANNELS_MASK_SIZE,
+        .JoinAcceptListSize = CN470_B26_JOIN_ACCEPT_LIST_SIZE,
+        .NbBeaconChannels = CN470_B26_BEACON_NB_CHANNELS,
+        .NbPingSlotChannels = CN470_B26_PING_SLOT_NB_CHANNELS,
+        .GetDownlinkFrequency = RegionCN470B26GetDownlinkFrequency,
+        .GetBeaconChannelOffset = RegionCN470B26GetBeaconChannelOffset,
+        .LinkAdrChMaskUpdate = RegionCN470B26LinkAdrChMaskUpdate,
+        .VerifyRfFreq = RegionCN470B26VerifyRfFreq,
+        .InitializeChannels = RegionCN470B26InitializeChannels,
+        .InitializeChannelsMask = RegionCN470B26InitializeChannelsMask,
+        .GetRx1Frequency = RegionCN470B26GetRx1Frequency,
+        .GetRx2Frequency = RegionCN470B26GetRx2Frequency,
+    },
+};
+
+/*
+ * Channel plan of each common join channel.
+ */
+static const RegionCN470ChannelPlan_t JoinChannelPlans[CN470_COMMON_JOIN_CHANNELS_SIZE] =
+{
+    CHANNEL_PLAN_20MHZ_TYPE_A, CHANNEL_PLAN_20MHZ_TYPE_A, CHANNEL_PLAN_20MHZ_TYPE_A, CHANNEL_PLAN_20MHZ_TYPE_A,
+    CHANNEL_PLAN_20MHZ_TYPE_A, CHANNEL_PLAN_20MHZ_TYPE_A, CHANNEL_PLAN_20MHZ_TYPE_A, CHANNEL_PLAN_20MHZ_TYPE_A,
+    CHANNEL_PLAN_20MHZ_TYPE_B, CHANNEL_PLAN_20MHZ_TYPE_B,
+    CHANNEL_PLAN_26MHZ_TYPE_A, CHANNEL_PLAN_26MHZ_TYPE_A, CHANNEL_PLAN_26MHZ_TYPE_A, CHANNEL_PLAN_26MHZ_TYPE_A,
+    CHANNEL_PLAN_26MHZ_TYPE_A,
+    CHANNEL_PLAN_26MHZ_TYPE_B, CHANNEL_PLAN_26MHZ_TYPE_B, CHANNEL_PLAN_26MHZ_TYPE_B, CHANNEL_PLAN_26MHZ_TYPE_B,
+    CHANNEL_PLAN_26MHZ_TYPE_B,
+};
+
 /*
  * Context for the current channel plan.
  */
-static RegionCN470ChannelPlanCtx_t ChannelPlanCtx;
+static const RegionCN470ChannelPlanCtx_t* ChannelPlanCtx = &ChannelPlanCtxs[CHANNEL_PLAN_20MHZ_TYPE_A];
+
+/*
+ * Channel plan ChannelPlanCtx has been resolved for.
+ */
+static RegionCN470ChannelPlan_t ChannelPlanCtxPlan = CHANNEL_PLAN_20MHZ_TYPE_A;
 
 // Static functions
-static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan, RegionCN470ChannelPlanCtx_t* ctx )
+static void ApplyChannelPlanConfig( RegionCN470ChannelPlan_t channelPlan )
 {
-    switch( channelPlan )
+    ChannelPlanCtxPlan = channelPlan;
+
+    if( channelPlan > CHANNEL_PLAN_26MHZ_TYPE_B )
     {
-        case CHANNEL_PLAN_20MHZ_TYPE_A:
-        {
-            ctx->ChannelsMaskSize = CN470_A20_CHANNELS_MASK_SIZE;
-            ctx->JoinAcceptListSize = CN470_A20_JOIN_ACCEPT_LIST_SIZE;
-            ctx->NbBeaconChannels = CN470_A20_BEACON_NB_CHANNELS;
-            ctx->NbPingSlotChannels = CN470_A20_PING_SLOT_NB_CHANNELS;
-            ctx->GetDownlinkFrequency = RegionCN470A20GetDownlinkFrequency;
-            ctx->GetBeaconChannelOffset = RegionCN470A20GetBeaconChannelOffset;
-            ctx->LinkAdrChMaskUpdate = RegionCN470A20LinkAdrChMaskUpdate;
-            ctx->VerifyRfFreq = RegionCN470A20VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470A20InitializeChannels;
-            ctx->InitializeChannelsMask = RegionCN470A20InitializeChannelsMask;
-            ctx->GetRx1Frequency = RegionCN470A20GetRx1Frequency;
-            ctx->GetRx2Frequency = RegionCN470A20GetRx2Frequency;
-            break;
-        }
-        case CHANNEL_PLAN_20MHZ_TYPE_B:
-        {
-            ctx->ChannelsMaskSize = CN470_B20_CHANNELS_MASK_SIZE;
-            ctx->JoinAcceptListSize = CN470_B20_JOIN_ACCEPT_LIST_SIZE;
-            ctx->NbBeaconChannels = CN470_B20_BEACON_NB_CHANNELS;
-            ctx->NbPingSlotChannels = CN470_B20_PING_SLOT_NB_CHANNELS;
-            ctx->GetDownlinkFrequency = RegionCN470B20GetDownlinkFrequency;
-            ctx->GetBeaconChannelOffset = RegionCN470B20GetBeaconChannelOffset;
-            ctx->LinkAdrChMaskUpdate = RegionCN470B20LinkAdrChMaskUpdate;
-            ctx->VerifyRfFreq = RegionCN470B20VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470B20InitializeChannels;
-            ctx->InitializeChannelsMask = RegionCN470B20InitializeChannelsMask;
-            ctx->GetRx1Frequency = RegionCN470B20GetRx1Frequency;
-            ctx->GetRx2Frequency = RegionCN470B20GetRx2Frequency;
-            break;
-        }
-        case CHANNEL_PLAN_26MHZ_TYPE_A:
-        {
-            ctx->ChannelsMaskSize = CN470_A26_CHANNELS_MASK_SIZE;
-            ctx->JoinAcceptListSize = CN470_A26_JOIN_ACCEPT_LIST_SIZE;
-            ctx->NbBeaconChannels = CN470_A26_BEACON_NB_CHANNELS;
-            ctx->NbPingSlotChannels = CN470_A26_PING_SLOT_NB_CHANNELS;
-            ctx->GetDownlinkFrequency = RegionCN470A26GetDownlinkFrequency;
-            ctx->GetBeaconChannelOffset = RegionCN470A26GetBeaconChannelOffset;
-            ctx->LinkAdrChMaskUpdate = RegionCN470A26LinkAdrChMaskUpdate;
-            ctx->VerifyRfFreq = RegionCN470A26VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470A26InitializeChannels;
-            ctx->InitializeChannelsMask = RegionCN470A26InitializeChannelsMask;
-            ctx->GetRx1Frequency = RegionCN470A26GetRx1Frequency;
-            ctx->GetRx2Frequency = RegionCN470A26GetRx2Frequency;
-            break;
-        }
-        case CHANNEL_PLAN_26MHZ_TYPE_B:
-        {
-            ctx->ChannelsMaskSize = CN470_B26_CHANNELS_MASK_SIZE;
-            ctx->JoinAcceptListSize = CN470_B26_JOIN_ACCEPT_LIST_SIZE;
-            ctx->NbBeaconChannels = CN470_B26_BEACON_NB_CHANNELS;
-            ctx->NbPingSlotChannels = CN470_B26_PING_SLOT_NB_CHANNELS;
-            ctx->GetDownlinkFrequency = RegionCN470B26GetDownlinkFrequency;
-            ctx->GetBeaconChannelOffset = RegionCN470B26GetBeaconChannelOffset;
-            ctx->LinkAdrChMaskUpdate = RegionCN470B26LinkAdrChMaskUpdate;
-            ctx->VerifyRfFreq = RegionCN470B26VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470B26InitializeChannels;
-            ctx->InitializeChannelsMask = RegionCN470B26InitializeChannelsMask;
-            ctx->GetRx1Frequency = RegionCN470B26GetRx1Frequency;
-            ctx->GetRx2Frequency = RegionCN470B26GetRx2Frequency;
-            break;
-        }
-        default:
-        {
-            // Apply CHANNEL_PLAN_20MHZ_TYPE_A
-            ctx->ChannelsMaskSize = CN470_A20_CHANNELS_MASK_SIZE;
-            ctx->JoinAcceptListSize = CN470_A20_JOIN_ACCEPT_LIST_SIZE;
-            ctx->NbBeaconChannels = CN470_A20_BEACON_NB_CHANNELS;
-            ctx->NbPingSlotChannels = CN470_A20_PING_SLOT_NB_CHANNELS;
-            ctx->GetDownlinkFrequency = RegionCN470A20GetDownlinkFrequency;
-            ctx->GetBeaconChannelOffset = RegionCN470A20GetBeaconChannelOffset;
-            ctx->LinkAdrChMaskUpdate = RegionCN470A20LinkAdrChMaskUpdate;
-            ctx->VerifyRfFreq = RegionCN470A20VerifyRfFreq;
-            ctx->InitializeChannels = RegionCN470A20InitializeChannels;
-            ctx->InitializeChannelsMask = RegionCN470A20InitializeChannelsMask;
-            ctx->GetRx1Frequency = RegionCN470A20GetRx1Frequency;
-            ctx->GetRx2Frequency = RegionCN470A20GetRx2Frequency;
-            break;
-        }
+        // Apply CHANNEL_PLAN_20MHZ_TYPE_A
+        channelPlan = CHANNEL_PLAN_UNKNOWN;
     }
+    ChannelPlanCtx = &ChannelPlanCtxs[channelPlan];
 }
 
-static RegionCN470ChannelPlan_t IdentifyChannelPlan( uint8_t joinChannel )
+static const RegionCN470ChannelPlanCtx_t* GetChannelPlanCtx( void )
 {
-    RegionCN470ChannelPlan_t channelPlan = CHANNEL_PLAN_UNKNOWN;
-
-    if( joinChannel <= 7 )
-    {
-        channelPlan = CHANNEL_PLAN_20MHZ_TYPE_A;
-    }
-    else if ( ( joinChannel <= 9 ) && ( joinChannel >= 8 ) )
+    // The plan of the NVM context changes without ApplyChannelPlanConfig when the context is restored
+    if( RegionNvmGroup2->ChannelPlan != ChannelPlanCtxPlan )
     {
-        channelPlan = CHANNEL_PLAN_20MHZ_TYPE_B;
+        ApplyChannelPlanConfig( RegionNvmGroup2->ChannelPlan );
     }
-    else if ( ( joinChannel <= 14 ) && ( joinChannel >= 10 ) )
-    {
-        channelPlan = CHANNEL_PLAN_26MHZ_TYPE_A;
-    }
-    else if( ( joinChannel <= 19 ) && ( joinChannel >= 15 ) )
+    return ChannelPlanCtx;
+}
+
+static RegionCN470ChannelPlan_t IdentifyChannelPlan( uint8_t joinChannel )
+{
+    if( joinChannel < CN470_COMMON_JOIN_CHANNELS_SIZE )
     {
-        channelPlan = CHANNEL_PLAN_26MHZ_TYPE_B;
+        return JoinChannelPlans[joinChannel];
     }
-    return channelPlan;
+    return CHANNEL_PLAN_UNKNOWN;
 }
 #endif /* REGION_VERSION */
 
@@ -342,7 +363,7 @@ static bool VerifyRfFreq( uint32_t frequency )
         return false;
     }
 
-    return ChannelPlanCtx.VerifyRfFreq( frequency );
+    return GetChannelPlanCtx( )->VerifyRfFreq( frequency );
 }
 #endif /* REGION_VERSION */
 
@@ -351,7 +372,7 @@ static TimerTime_t GetTimeOnAir( int8_t datarate, uint16_t pktLen )
     int8_t phyDr = DataratesCN470[datarate];
     uint32_t bandwidth = RegionCommonGetBandwidth( datarate, BandwidthsCN470 );
 
-    return Radio.TimeOnAir( MODEM_LORA, bandwidth, phyDr, 1, 8, false, pktLen, true );
+    return RegionCommonGetUplinkTimeOnAir( datarate, MODEM_LORA, phyDr, bandwidth, pktLen );
 }
 #endif /* REGION_CN470 */
 
@@ -483,7 +504,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
 
             if( RegionNvmGroup2->ChannelPlan != CHANNEL_PLAN_UNKNOWN )
             {
-                phyParam.Value = ChannelPlanCtx.GetRx2Frequency( RegionNvmGroup2->CommonJoinChannelIndex, RegionNvmGroup2->IsOtaaDevice );
+                phyParam.Value = GetChannelPlanCtx( )->GetRx2Frequency( RegionNvmGroup2->CommonJoinChannelIndex, RegionNvmGroup2->IsOtaaDevice );
             }
 #endif /* REGION_VERSION */
             break;
@@ -545,7 +566,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
             // Implementation depending on the join channel
             if( RegionNvmGroup2->ChannelPlan != CHANNEL_PLAN_UNKNOWN )
             {
-                phyParam.Value = ChannelPlanCtx.GetDownlinkFrequency( getPhy->Channel,
+                phyParam.Value = GetChannelPlanCtx( )->GetDownlinkFrequency( getPhy->Channel,
                                                                       RegionNvmGroup2->CommonJoinChannelIndex,
                                                                       false );
             }
@@ -593,7 +614,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
             // Implementation depending on the join channel
             if( RegionNvmGroup2->ChannelPlan != CHANNEL_PLAN_UNKNOWN )
             {
-                phyParam.Value = ChannelPlanCtx.NbBeaconChannels;
+                phyParam.Value = GetChannelPlanCtx( )->NbBeaconChannels;
             }
             break;
         }
@@ -603,7 +624,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
             // Implementation depending on the join channel
             if( RegionNvmGroup2->ChannelPlan != CHANNEL_PLAN_UNKNOWN )
             {
-                phyParam.Value = ChannelPlanCtx.GetBeaconChannelOffset( RegionNvmGroup2->CommonJoinChannelIndex );
+                phyParam.Value = GetChannelPlanCtx( )->GetBeaconChannelOffset( RegionNvmGroup2->CommonJoinChannelIndex );
             }
             break;
         }
@@ -614,7 +635,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
             // Implementation depending on the join channel
             if( RegionNvmGroup2->ChannelPlan != CHANNEL_PLAN_UNKNOWN )
             {
-                phyParam.Value = ChannelPlanCtx.GetDownlinkFrequency( getPhy->Channel,
+                phyParam.Value = GetChannelPlanCtx( )->GetDownlinkFrequency( getPhy->Channel,
                                                                       RegionNvmGroup2->CommonJoinChannelIndex,
                                                                       true );
             }
@@ -630,7 +651,7 @@ PhyParam_t RegionCN470GetPhyParam( GetPhyParams_t* getPhy )
             // Implementation depending on the join channel
             if( RegionNvmGroup2->ChannelPlan != CHANNEL_PLAN_UNKNOWN )
             {
-                phyParam.Value = ChannelPlanCtx.NbPingSlotChannels;
+                phyParam.Value = GetChannelPlanCtx( )->NbPingSlotChannels;
             }
             break;
         }
@@ -732,13 +753,13 @@ void RegionCN470InitDefaults( InitDefaultsParams_t* params )
             RegionNvmGroup2->IsOtaaDevice = false;
 
             // Apply the channel plan configuration
-            ApplyChannelPlanConfig( RegionNvmGroup2->ChannelPlan, &ChannelPlanCtx );
+            ApplyChannelPlanConfig( RegionNvmGroup2->ChannelPlan );
 
             // Default channels
-            ChannelPlanCtx.InitializeChannels( RegionNvmGroup2->Channels );
+            GetChannelPlanCtx( )->InitializeChannels( RegionNvmGroup2->Channels );
 
             // Default ChannelsMask
-            ChannelPlanCtx.InitializeChannelsMask( RegionNvmGroup2->ChannelsDefaultMask );
+            GetChannelPlanCtx( )->InitializeChannelsMask( RegionNvmGroup2->ChannelsDefaultMask );
 
             // Copy channels default mask
             RegionCommonChanMaskCopy( RegionNvmGroup2->ChannelsMask, RegionNvmGroup2->ChannelsDefaultMask, CHANNELS_MASK_SIZE );
@@ -827,7 +848,7 @@ void RegionCN470ApplyCFList( ApplyCFListParams_t* applyCFList )
         RegionNvmGroup2->ChannelPlan = REGION_CN470_DEFAULT_CHANNEL_PLAN;
     }
     // Apply the configuration for the channel plan
-    ApplyChannelPlanConfig( RegionNvmGroup2->ChannelPlan, &ChannelPlanCtx );
+    ApplyChannelPlanConfig( RegionNvmGroup2->ChannelPlan );
 #endif /* REGION_VERSION */
 
     // Size of the optional CF list must be 16 byte
@@ -850,7 +871,7 @@ void RegionCN470ApplyCFList( ApplyCFListParams_t* applyCFList )
         RegionNvmGroup2->ChannelsMask[chMaskItr] |= (uint16_t) (applyCFList->Payload[cntPayload+1] << 8);
     }
 #elif (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
-    for( uint8_t chMaskItr = 0, cntPayload = 0; chMaskItr < ChannelPlanCtx.JoinAcceptListSize; chMaskItr++, cntPayload+=2 )
+    for( uint8_t chMaskItr = 0, cntPayload = 0; chMaskItr < GetChannelPlanCtx( )->JoinAcceptListSize; chMaskItr++, cntPayload+=2 )
     {
         RegionNvmGroup2->ChannelsMask[chMaskItr] = (uint16_t) (0x00FF & applyCFList->Payload[cntPayload]);
         RegionNvmGroup2->ChannelsMask[chMaskItr] |= (uint16_t) (applyCFList->Payload[cntPayload+1] << 8);
@@ -936,12 +957,12 @@ bool RegionCN470RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
         if( rxConfig->RxSlot == RX_SLOT_WIN_1 )
         {
             // Apply window 1 frequency
-            frequency = ChannelPlanCtx.GetRx1Frequency( rxConfig->Channel );
+            frequency = GetChannelPlanCtx( )->GetRx1Frequency( rxConfig->Channel );
         }
         else if( rxConfig->RxSlot == RX_SLOT_WIN_2 )
         {
             // Apply window 2 frequency
-            frequency = ChannelPlanCtx.GetRx2Frequency( RegionNvmGroup2->CommonJoinChannelIndex, RegionNvmGroup2->IsOtaaDevice );
+            frequency = GetChannelPlanCtx( )->GetRx2Frequency( RegionNvmGroup2->CommonJoinChannelIndex, RegionNvmGroup2->IsOtaaDevice );
         }
     }
     else
@@ -955,10 +976,10 @@ bool RegionCN470RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     // Read the physical datarate from the datarates table
     phyDr = DataratesCN470[dr];
 
-    Radio.SetChannel( frequency );
+    RegionCommonRadioSetChannel( frequency );
 
     // Radio configuration
-    Radio.SetRxConfig( MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
+    RegionCommonRadioSetRxConfig( MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
     if( rxConfig->RepeaterSupport == true )
     {
         maxPayload = MaxPayloadOfDatarateRepeaterCN470[dr];
@@ -967,7 +988,7 @@ bool RegionCN470RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     {
         maxPayload = MaxPayloadOfDatarateCN470[dr];
     }
-    Radio.SetMaxPayloadLength( MODEM_LORA, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
 
     RegionCommonRxConfigPrint(rxConfig->RxSlot, frequency, dr);
 
@@ -991,13 +1012,13 @@ bool RegionCN470TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    RegionCommonRadioSetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
 
-    Radio.SetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
+    RegionCommonRadioSetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
     RegionCommonTxConfigPrint(RegionNvmGroup2->Channels[txConfig->Channel].Frequency, txConfig->Datarate);
 
     // Setup maximum payload length of the radio driver
-    Radio.SetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
 #elif (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
     RadioModems_t modem;
     uint32_t frequency;
@@ -1025,22 +1046,22 @@ bool RegionCN470TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain );
 
     // Setup the radio frequency
-    Radio.SetChannel( frequency );
+    RegionCommonRadioSetChannel( frequency );
 
     if( txConfig->Datarate == DR_7 )
     { // High Speed FSK channel
         modem = MODEM_FSK;
-        Radio.SetTxConfig( modem, phyTxPower, 25000, bandwidth, phyDr * 1000, 0, 5, false, true, 0, 0, false, 4000 );
+        RegionCommonRadioSetTxConfig( modem, phyTxPower, 25000, bandwidth, phyDr * 1000, 0, 5, false, true, 0, 0, false, 4000 );
     }
     else
     {
         modem = MODEM_LORA;
-        Radio.SetTxConfig( modem, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
+        RegionCommonRadioSetTxConfig( modem, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
     }
     RegionCommonTxConfigPrint(frequency, txConfig->Datarate);
 
     // Setup maximum payload length of the radio driver
-    Radio.SetMaxPayloadLength( modem, txConfig->PktLen );
+    RegionCommonRadioSetMaxPayloadLength( modem, txConfig->PktLen );
 #endif /* REGION_VERSION */
     // Update time-on-air
     *txTimeOnAir = GetTimeOnAir( txConfig->Datarate, txConfig->PktLen );
@@ -1122,12 +1143,12 @@ uint8_t RegionCN470LinkAdrReq( LinkAdrReqParams_t* linkAdrReq, int8_t* drOut, in
         bytesProcessed += nextIndex;
 
         // Update the channel plan
-        status = ChannelPlanCtx.LinkAdrChMaskUpdate( channelsMask, linkAdrParams.ChMaskCtrl,
+        status = GetChannelPlanCtx( )->LinkAdrChMaskUpdate( channelsMask, linkAdrParams.ChMaskCtrl,
                                                      linkAdrParams.ChMask, RegionNvmGroup2->Channels );
     }
 
     // Make sure at least one channel is active
-    if( RegionCommonCountChannels( channelsMask, 0, ChannelPlanCtx.ChannelsMaskSize ) == 0 )
+    if( RegionCommonCountChannels( channelsMask, 0, GetChannelPlanCtx( )->ChannelsMaskSize ) == 0 )
     {
         status &= 0xFE; // Channel mask KO
     }
@@ -1251,22 +1272,29 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
     RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
+    uint16_t channelsMaskQuery[CHANNELS_MASK_SIZE];
+    uint16_t* channelsMask = RegionNvmGroup2->ChannelsMask;
 
     // Count 125kHz channels
     if( RegionCommonCountChannels( RegionNvmGroup2->ChannelsMask, 0, CHANNELS_MASK_SIZE ) == 0 )
     { // Reactivate default channels
-        RegionNvmGroup2->ChannelsMask[0] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[1] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[2] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[3] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[4] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[5] = 0xFFFF;
+        if( nextChanParams->QueryOnly == true )
+        {
+            // Evaluate a copy, the default channels are only reactivated by a transmission
+            channelsMask = channelsMaskQuery;
+        }
+        channelsMask[0] = 0xFFFF;
+        channelsMask[1] = 0xFFFF;
+        channelsMask[2] = 0xFFFF;
+        channelsMask[3] = 0xFFFF;
+        channelsMask[4] = 0xFFFF;
+        channelsMask[5] = 0xFFFF;
     }
 
     // Search how many channels are enabled
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
-    countChannelsParams.ChannelsMask = RegionNvmGroup2->ChannelsMask;
+    countChannelsParams.ChannelsMask = channelsMask;
     countChannelsParams.Channels = RegionNvmGroup2->Channels;
     countChannelsParams.Bands = RegionNvmGroup1->Bands;
     countChannelsParams.MaxNbChannels = CN470_MAX_NB_CHANNELS;
@@ -1279,23 +1307,39 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
     RegionCommonIdentifyChannelsParam_t identifyChannelsParam;
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
+    uint16_t channelsMaskRemaining[CHANNELS_MASK_SIZE];
+    uint16_t* channelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
+
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Work on a copy, the remaining channels are only consumed by a transmission
+        RegionCommonChanMaskCopy( channelsMaskRemaining, RegionNvmGroup1->ChannelsMaskRemaining, CHANNELS_MASK_SIZE );
+        channelsMask = channelsMaskRemaining;
+    }
 
     // Count 125kHz channels
-    if( RegionCommonCountChannels( RegionNvmGroup1->ChannelsMaskRemaining, 0, ChannelPlanCtx.ChannelsMaskSize ) == 0 )
+    if( RegionCommonCountChannels( channelsMask, 0, GetChannelPlanCtx( )->ChannelsMaskSize ) == 0 )
     { // Reactivate default channels
-        RegionNvmGroup2->ChannelsMask[0] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[1] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[2] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[3] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[4] = 0xFFFF;
-        RegionNvmGroup2->ChannelsMask[5] = 0xFFFF;
-        RegionCommonChanMaskCopy( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, ChannelPlanCtx.ChannelsMaskSize  );
+        if( nextChanParams->QueryOnly == false )
+        {
+            RegionNvmGroup2->ChannelsMask[0] = 0xFFFF;
+            RegionNvmGroup2->ChannelsMask[1] = 0xFFFF;
+            RegionNvmGroup2->ChannelsMask[2] = 0xFFFF;
+            RegionNvmGroup2->ChannelsMask[3] = 0xFFFF;
+            RegionNvmGroup2->ChannelsMask[4] = 0xFFFF;
+            RegionNvmGroup2->ChannelsMask[5] = 0xFFFF;
+            RegionCommonChanMaskCopy( channelsMask, RegionNvmGroup2->ChannelsMask, GetChannelPlanCtx( )->ChannelsMaskSize  );
+        }
+        else
+        {
+            memset1( ( uint8_t* )channelsMask, 0xFF, GetChannelPlanCtx( )->ChannelsMaskSize * sizeof( uint16_t ) );
+        }
     }
 
     // Search how many channels are enabled
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
-    countChannelsParams.ChannelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
+    countChannelsParams.ChannelsMask = channelsMask;
     countChannelsParams.Channels = RegionNvmGroup2->Channels;
     countChannelsParams.Bands = RegionBands;
     countChannelsParams.MaxNbChannels = CN470_MAX_NB_CHANNELS;
@@ -1323,18 +1367,27 @@ LoRaMacStatus_t RegionCN470NextChannel( NextChanParams_t* nextChanParams, uint8_
     identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
 
     identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+    identifyChannelsParam.QueryOnly = nextChanParams->QueryOnly;
 
     status = RegionCommonIdentifyChannels( &identifyChannelsParam, aggregatedTimeOff, enabledChannels,
                                            &nbEnabledChannels, &nbRestrictedChannels, time );
 
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Report the availability only, no channel is selected
+        nextChanParams->TimeOnAir = identifyChannelsParam.ExpectedTimeOnAir;
+        nextChanParams->TimeCredits = identifyChannelsParam.TimeCredits;
+        return status;
+    }
+
     if( status == LORAMAC_STATUS_OK )
     {
         // We found a valid channel. Selection is random.
-        *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+        *channel = enabledChannels[RegionCommonSelectChannel( enabledChannels, nbEnabledChannels )];
 
 #if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
         // Disable the channel in the mask
-        RegionCommonChanDisable( RegionNvmGroup1->ChannelsMaskRemaining, *channel, ChannelPlanCtx.ChannelsMaskSize );
+        RegionCommonChanDisable( RegionNvmGroup1->ChannelsMaskRemaining, *channel, GetChannelPlanCtx( )->ChannelsMaskSize );
 #endif /* REGION_VERSION */
     }
     return status;
@@ -1365,6 +1418,7 @@ void RegionCN470SetContinuousWave( ContinuousWaveParams_t* continuousWave )
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, continuousWave->MaxEirp, continuousWave->AntennaGain );
 
     Radio.SetTxContinuousWave( frequency, phyTxPower, continuousWave->Timeout );
+    RegionCommonRadioShadowInvalidate( );
 #endif /* REGION_CN470 */
 }
 #endif /* REGION_VERSION */
@@ -55,6 +55,26 @@
 #define HYBRID_DEFAULT_MASK5 0x0000
 #endif
 
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+/*!
+ * RX1 frequencies of the 64 channels
+ */
+static const uint32_t Rx1Frequencies[64] =
+{
+    483900000, 484100000, 484300000, 484500000, 484700000, 484900000,
+    485100000, 485300000, 485500000, 485700000, 485900000, 486100000,
+    486300000, 486500000, 486700000, 486900000, 487100000, 487300000,
+    487500000, 487700000, 487900000, 488100000, 488300000, 488500000,
+    488700000, 488900000, 489100000, 489300000, 489500000, 489700000,
+    489900000, 490100000, 490300000, 490500000, 490700000, 490900000,
+    491100000, 491300000, 491500000, 491700000, 491900000, 492100000,
+    492300000, 492500000, 492700000, 492900000, 493100000, 493300000,
+    493500000, 493700000, 493900000, 494100000, 494300000, 494500000,
+    494700000, 494900000, 495100000, 495300000, 495500000, 495700000,
+    495900000, 496100000, 496300000, 496500000,
+};
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
+
 uint32_t RegionCN470A20GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     return RegionCN470A20GetRx1Frequency( channel );
@@ -162,6 +182,12 @@ void RegionCN470A20InitializeChannelsMask(  uint16_t* channelsDefaultMask )
 
 uint32_t RegionCN470A20GetRx1Frequency( uint8_t channel )
 {
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+    if( channel < 64 )
+    {
+        return Rx1Frequencies[channel];
+    }
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
     // Base frequency for downstream group 1
     uint32_t baseFrequency = CN470_A20_FIRST_RX_CHANNEL;
     uint8_t offset = 0;
@@ -177,7 +203,7 @@ uint32_t RegionCN470A20GetRx1Frequency( uint8_t channel )
 
 uint32_t RegionCN470A20GetRx2Frequency( uint8_t joinChannelIndex, bool isOtaaDevice )
 {
-    uint32_t otaaFrequencies[] = CN470_A20_RX_WND_2_FREQ_OTAA;
+    static const uint32_t otaaFrequencies[] = CN470_A20_RX_WND_2_FREQ_OTAA;
 
     if( isOtaaDevice == true )
     {
@@ -55,6 +55,19 @@
 #define HYBRID_DEFAULT_MASK5 0x0000
 #endif
 
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+/*!
+ * RX1 frequencies, indexed by the channel modulo 24
+ */
+static const uint32_t Rx1Frequencies[24] =
+{
+    490100000, 490300000, 490500000, 490700000, 490900000, 491100000,
+    491300000, 491500000, 491700000, 491900000, 492100000, 492300000,
+    492500000, 492700000, 492900000, 493100000, 493300000, 493500000,
+    493700000, 493900000, 494100000, 494300000, 494500000, 494700000,
+};
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
+
 uint32_t RegionCN470A26GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     return CN470_A26_BEACON_FREQ;
@@ -156,7 +169,11 @@ void RegionCN470A26InitializeChannelsMask( uint16_t* channelsDefaultMask )
 
 uint32_t RegionCN470A26GetRx1Frequency( uint8_t channel )
 {
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+    return Rx1Frequencies[channel % 24];
+#else
     return ( CN470_A26_FIRST_RX_CHANNEL + ( ( channel % 24 ) * CN470_A26_STEPWIDTH_RX_CHANNEL ) );
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
 }
 
 uint32_t RegionCN470A26GetRx2Frequency( uint8_t joinChannelIndex, bool isOtaaDevice )
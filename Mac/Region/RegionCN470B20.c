@@ -35,6 +35,26 @@
 #include "RegionCN470B20.h"
 #include "RegionCN470A20.h"
 
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+/*!
+ * RX1 frequencies of the 64 channels
+ */
+static const uint32_t Rx1Frequencies[64] =
+{
+    476900000, 477100000, 477300000, 477500000, 477700000, 477900000,
+    478100000, 478300000, 478500000, 478700000, 478900000, 479100000,
+    479300000, 479500000, 479700000, 479900000, 480100000, 480300000,
+    480500000, 480700000, 480900000, 481100000, 481300000, 481500000,
+    481700000, 481900000, 482100000, 482300000, 482500000, 482700000,
+    482900000, 483100000, 496900000, 497100000, 497300000, 497500000,
+    497700000, 497900000, 498100000, 498300000, 498500000, 498700000,
+    498900000, 499100000, 499300000, 499500000, 499700000, 499900000,
+    500100000, 500300000, 500500000, 500700000, 500900000, 501100000,
+    501300000, 501500000, 501700000, 501900000, 502100000, 502300000,
+    502500000, 502700000, 502900000, 503100000,
+};
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
+
 uint32_t RegionCN470B20GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     if( isPingSlot == true)
@@ -114,6 +134,12 @@ void RegionCN470B20InitializeChannelsMask( uint16_t* channelsDefaultMask )
 
 uint32_t RegionCN470B20GetRx1Frequency( uint8_t channel )
 {
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+    if( channel < 64 )
+    {
+        return Rx1Frequencies[channel];
+    }
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
     // Base frequency for downstream group 1
     uint32_t baseFrequency = CN470_B20_FIRST_RX1_CHANNEL;
     uint8_t offset = 0;
@@ -129,7 +155,7 @@ uint32_t RegionCN470B20GetRx1Frequency( uint8_t channel )
 
 uint32_t RegionCN470B20GetRx2Frequency( uint8_t joinChannelIndex, bool isOtaaDevice )
 {
-    uint32_t otaaFrequencies[] = CN470_B20_RX_WND_2_FREQ_OTAA;
+    static const uint32_t otaaFrequencies[] = CN470_B20_RX_WND_2_FREQ_OTAA;
 
     if( isOtaaDevice == true )
     {
@@ -35,6 +35,19 @@
 #include "RegionCN470A26.h"
 #include "RegionCN470B26.h"
 
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+/*!
+ * RX1 frequencies, indexed by the channel modulo 24
+ */
+static const uint32_t Rx1Frequencies[24] =
+{
+    500100000, 500300000, 500500000, 500700000, 500900000, 501100000,
+    501300000, 501500000, 501700000, 501900000, 502100000, 502300000,
+    502500000, 502700000, 502900000, 503100000, 503300000, 503500000,
+    503700000, 503900000, 504100000, 504300000, 504500000, 504700000,
+};
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
+
 uint32_t RegionCN470B26GetDownlinkFrequency( uint8_t channel, uint8_t joinChannelIndex, bool isPingSlot )
 {
     return CN470_B26_BEACON_FREQ;
@@ -82,7 +95,11 @@ void RegionCN470B26InitializeChannelsMask( uint16_t* channelsDefaultMask )
 
 uint32_t RegionCN470B26GetRx1Frequency( uint8_t channel )
 {
+#if (defined( REGION_CN470_FREQUENCY_TABLES_ENABLED ) && ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ))
+    return Rx1Frequencies[channel % 24];
+#else
     return ( CN470_B26_FIRST_RX_CHANNEL + ( ( channel % 24 ) * CN470_B26_STEPWIDTH_RX_CHANNEL ) );
+#endif /* REGION_CN470_FREQUENCY_TABLES_ENABLED */
 }
 
 uint32_t RegionCN470B26GetRx2Frequency( uint8_t joinChannelIndex, bool isOtaaDevice )
@@ -77,17 +77,13 @@ static TimerTime_t GetTimeOnAir( int8_t datarate, uint16_t pktLen )
 {
     int8_t phyDr = DataratesCN779[datarate];
     uint32_t bandwidth = RegionCommonGetBandwidth( datarate, BandwidthsCN779 );
-    TimerTime_t timeOnAir = 0;
+    RadioModems_t modem = MODEM_LORA;
 
     if( datarate == DR_7 )
     { // High Speed FSK channel
-        timeOnAir = Radio.TimeOnAir( MODEM_FSK, bandwidth, phyDr * 1000, 0, 5, false, pktLen, true );
-    }
-    else
-    {
-        timeOnAir = Radio.TimeOnAir( MODEM_LORA, bandwidth, phyDr, 1, 8, false, pktLen, true );
+        modem = MODEM_FSK;
     }
-    return timeOnAir;
+    return RegionCommonGetUplinkTimeOnAir( datarate, modem, phyDr, bandwidth, pktLen );
 }
 #endif /* REGION_CN779 */
 
@@ -561,18 +557,18 @@ bool RegionCN779RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     // Read the physical datarate from the datarates table
     phyDr = DataratesCN779[dr];
 
-    Radio.SetChannel( frequency );
+    RegionCommonRadioSetChannel( frequency );
 
     // Radio configuration
     if( dr == DR_7 )
     {
         modem = MODEM_FSK;
-        Radio.SetRxConfig( modem, 50000, phyDr * 1000, 0, 83333, 5, rxConfig->WindowTimeout, false, 0, true, 0, 0, false, rxConfig->RxContinuous );
+        RegionCommonRadioSetRxConfig( modem, 50000, phyDr * 1000, 0, 83333, 5, rxConfig->WindowTimeout, false, 0, true, 0, 0, false, rxConfig->RxContinuous );
     }
     else
     {
         modem = MODEM_LORA;
-        Radio.SetRxConfig( modem, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
+        RegionCommonRadioSetRxConfig( modem, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
     }
 
     if( rxConfig->RepeaterSupport == true )
@@ -583,7 +579,7 @@ bool RegionCN779RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     {
         maxPayload = MaxPayloadOfDatarateCN779[dr];
     }
-    Radio.SetMaxPayloadLength( modem, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
+    RegionCommonRadioSetMaxPayloadLength( modem, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
 
     RegionCommonRxConfigPrint(rxConfig->RxSlot, frequency, dr);
 
@@ -611,17 +607,17 @@ bool RegionCN779TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, txConfig->MaxEirp, txConfig->AntennaGain );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    RegionCommonRadioSetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
 
     if( txConfig->Datarate == DR_7 )
     { // High Speed FSK channel
         modem = MODEM_FSK;
-        Radio.SetTxConfig( modem, phyTxPower, 25000, bandwidth, phyDr * 1000, 0, 5, false, true, 0, 0, false, 4000 );
+        RegionCommonRadioSetTxConfig( modem, phyTxPower, 25000, bandwidth, phyDr * 1000, 0, 5, false, true, 0, 0, false, 4000 );
     }
     else
     {
         modem = MODEM_LORA;
-        Radio.SetTxConfig( modem, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
+        RegionCommonRadioSetTxConfig( modem, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
     }
     RegionCommonTxConfigPrint(RegionNvmGroup2->Channels[txConfig->Channel].Frequency, txConfig->Datarate);
 
@@ -629,7 +625,7 @@ bool RegionCN779TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     *txTimeOnAir = GetTimeOnAir( txConfig->Datarate, txConfig->PktLen );
 
     // Setup maximum payload length of the radio driver
-    Radio.SetMaxPayloadLength( modem, txConfig->PktLen );
+    RegionCommonRadioSetMaxPayloadLength( modem, txConfig->PktLen );
 
     *txPower = txPowerLimited;
     return true;
@@ -878,16 +874,28 @@ LoRaMacStatus_t RegionCN779NextChannel( NextChanParams_t* nextChanParams, uint8_
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
     uint16_t joinChannels = CN779_JOIN_CHANNELS;
+    uint16_t channelsMaskQuery[CHANNELS_MASK_SIZE];
+    uint16_t* channelsMask = RegionNvmGroup2->ChannelsMask;
 
     if( RegionCommonCountChannels( RegionNvmGroup2->ChannelsMask, 0, 1 ) == 0 )
     { // Reactivate default channels
-        RegionNvmGroup2->ChannelsMask[0] |= LC( 1 ) + LC( 2 ) + LC( 3 );
+        if( nextChanParams->QueryOnly == false )
+        {
+            RegionNvmGroup2->ChannelsMask[0] |= LC( 1 ) + LC( 2 ) + LC( 3 );
+        }
+        else
+        {
+            // Evaluate a copy, the default channels are only reactivated by a transmission
+            RegionCommonChanMaskCopy( channelsMaskQuery, RegionNvmGroup2->ChannelsMask, CHANNELS_MASK_SIZE );
+            channelsMaskQuery[0] |= LC( 1 ) + LC( 2 ) + LC( 3 );
+            channelsMask = channelsMaskQuery;
+        }
     }
 
     // Search how many channels are enabled
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
-    countChannelsParams.ChannelsMask = RegionNvmGroup2->ChannelsMask;
+    countChannelsParams.ChannelsMask = channelsMask;
     countChannelsParams.Channels = RegionNvmGroup2->Channels;
 #if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
     countChannelsParams.Bands = RegionNvmGroup1->Bands;
@@ -907,14 +915,23 @@ LoRaMacStatus_t RegionCN779NextChannel( NextChanParams_t* nextChanParams, uint8_
     identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
 
     identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+    identifyChannelsParam.QueryOnly = nextChanParams->QueryOnly;
 
     status = RegionCommonIdentifyChannels( &identifyChannelsParam, aggregatedTimeOff, enabledChannels,
                                            &nbEnabledChannels, &nbRestrictedChannels, time );
 
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Report the availability only, no channel is selected
+        nextChanParams->TimeOnAir = identifyChannelsParam.ExpectedTimeOnAir;
+        nextChanParams->TimeCredits = identifyChannelsParam.TimeCredits;
+        return status;
+    }
+
     if( status == LORAMAC_STATUS_OK )
     {
         // We found a valid channel
-        *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+        *channel = enabledChannels[RegionCommonSelectChannel( enabledChannels, nbEnabledChannels )];
     }
     else if( status == LORAMAC_STATUS_NO_CHANNEL_FOUND )
     {
@@ -1021,6 +1038,7 @@ void RegionCN779SetContinuousWave( ContinuousWaveParams_t* continuousWave )
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, continuousWave->MaxEirp, continuousWave->AntennaGain );
 
     Radio.SetTxContinuousWave( frequency, phyTxPower, continuousWave->Timeout );
+    RegionCommonRadioShadowInvalidate( );
 #endif /* REGION_CN779 */
 }
 #endif /* REGION_VERSION */
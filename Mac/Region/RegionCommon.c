@@ -39,9 +39,11 @@
   ******************************************************************************
   */
 #include <math.h>
+#include <string.h>
 #include "radio.h"
 #include "utilities.h"
 #include "RegionCommon.h"
+#include "LoRaMacEnergy.h"
 #include "systime.h"
 #include "mw_log_conf.h"
 
@@ -98,6 +100,253 @@
 static const char *EventRXSlotStrings[] = { "1", "2", "C", "Multi_C", "P", "Multi_P" };
 #endif
 
+#if (defined( LORAMAC_RADIO_SHADOW_ENABLED ) && ( LORAMAC_RADIO_SHADOW_ENABLED == 1 ))
+/*!
+ * Modem configuration last applied to the radio
+ */
+typedef enum eRadioShadowConfig
+{
+    RADIO_SHADOW_CONFIG_NONE,
+    RADIO_SHADOW_CONFIG_RX,
+    RADIO_SHADOW_CONFIG_TX,
+}RadioShadowConfig_t;
+
+/*!
+ * Radio.SetRxConfig parameters
+ */
+typedef struct sRadioShadowRxConfig
+{
+    RadioModems_t Modem;
+    uint32_t Bandwidth;
+    uint32_t Datarate;
+    uint32_t BandwidthAfc;
+    uint16_t PreambleLen;
+    uint16_t SymbTimeout;
+    uint8_t Coderate;
+    uint8_t PayloadLen;
+    uint8_t HopPeriod;
+    bool FixLen;
+    bool CrcOn;
+    bool FreqHopOn;
+    bool IqInverted;
+    bool RxContinuous;
+}RadioShadowRxConfig_t;
+
+/*!
+ * Radio.SetTxConfig parameters
+ */
+typedef struct sRadioShadowTxConfig
+{
+    RadioModems_t Modem;
+    uint32_t Fdev;
+    uint32_t Bandwidth;
+    uint32_t Datarate;
+    uint32_t Timeout;
+    uint16_t PreambleLen;
+    int8_t Power;
+    uint8_t Coderate;
+    uint8_t HopPeriod;
+    bool FixLen;
+    bool CrcOn;
+    bool FreqHopOn;
+    bool IqInverted;
+}RadioShadowTxConfig_t;
+
+/*!
+ * Last radio configuration applied through the RegionCommonRadioSet functions
+ */
+typedef struct sRadioShadow
+{
+    bool ChannelValid;
+    uint32_t Frequency;
+    RadioShadowConfig_t Config;
+    RadioShadowRxConfig_t RxConfig;
+    RadioShadowTxConfig_t TxConfig;
+    bool MaxPayloadValid;
+    RadioModems_t MaxPayloadModem;
+    uint8_t MaxPayload;
+}RadioShadow_t;
+
+static RadioShadow_t RadioShadow;
+#endif /* LORAMAC_RADIO_SHADOW_ENABLED */
+
+static RegionCommonRadioShadowStats_t RadioShadowStats;
+
+/*!
+ * Channel selection strategy, NULL for the uniform random selection
+ */
+static RegionCommonChannelSelector_t ChannelSelector = NULL;
+
+#if (defined( LORAMAC_CHANNEL_QUALITY_ENABLED ) && ( LORAMAC_CHANNEL_QUALITY_ENABLED == 1 ))
+/*!
+ * Score of a channel without recorded uplinks
+ */
+#define CHANNEL_QUALITY_SCORE_INIT                  255
+
+/*!
+ * Lowest selection weight of a channel, keeps the selection random among all
+ * the enabled channels
+ */
+#define CHANNEL_QUALITY_MIN_WEIGHT                  32
+
+/*!
+ * Quality records, indexed by channel id
+ */
+static RegionCommonChannelQuality_t ChannelQuality[REGION_NVM_MAX_NB_CHANNELS];
+#endif /* LORAMAC_CHANNEL_QUALITY_ENABLED */
+
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+/*!
+ * Number of channels with a busy history, covers the LBT regions
+ */
+#define LBT_MAX_NB_CHANNELS                         16
+
+/*!
+ * The busy score of a channel is halved each period without carrier sense
+ */
+#define LBT_BUSY_SCORE_DECAY_PERIOD                 30000
+
+/*!
+ * Busy history of a channel
+ */
+typedef struct sLbtChannel
+{
+    /*!
+     * Time of the last carrier sense
+     */
+    TimerTime_t LastSenseTime;
+    /*!
+     * From 0 ( found free ) to 255 ( found busy )
+     */
+    uint8_t BusyScore;
+}LbtChannel_t;
+
+/*!
+ * Busy history, indexed by channel id
+ */
+static LbtChannel_t LbtChannels[LBT_MAX_NB_CHANNELS];
+
+/*!
+ * Listen before talk statistics
+ */
+static RegionCommonLbtStats_t LbtStats;
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+
+#if (defined( REGION_TIME_ON_AIR_TABLE_ENABLED ) && ( REGION_TIME_ON_AIR_TABLE_ENABLED == 1 ))
+#ifndef REGION_TIME_ON_AIR_TABLE_MAX_LEN
+/*!
+ * Longest frame served by the time on air table, longer frames are computed
+ */
+#define REGION_TIME_ON_AIR_TABLE_MAX_LEN            64
+#endif /* REGION_TIME_ON_AIR_TABLE_MAX_LEN */
+
+/*!
+ * Number of datarates of the time on air table
+ */
+#define REGION_TIME_ON_AIR_TABLE_NB_DR              16
+
+/*!
+ * Time on air table row, filled on demand
+ */
+typedef struct sTimeOnAirRow
+{
+    /*!
+     * Modulation the entries were computed for, 0 when the row is empty
+     */
+    uint16_t Modulation;
+    /*!
+     * Time on air in ms indexed by frame length, 0 when not yet computed
+     */
+    uint16_t TimeOnAir[REGION_TIME_ON_AIR_TABLE_MAX_LEN + 1];
+}TimeOnAirRow_t;
+
+/*!
+ * Time on air table, indexed by datarate
+ */
+static TimeOnAirRow_t TimeOnAirTable[REGION_TIME_ON_AIR_TABLE_NB_DR];
+#endif /* REGION_TIME_ON_AIR_TABLE_ENABLED */
+
+/*!
+ * Copy of the bands on which RegionCommonIdentifyChannels synchronizes the
+ * credits of a QueryOnly evaluation. Kept out of the stack of the regular
+ * channel selection.
+ */
+static Band_t QueryBands[REGION_NVM_MAX_NB_BANDS];
+
+#if (defined( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED ) && ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ))
+/*!
+ * Event of a band in the incremental duty cycle model
+ */
+typedef struct sBandEvent
+{
+    /*!
+     * RP002-1.0.3: time at which the observation period of the band ends and
+     * its credits are restored.
+     * Otherwise: time from which the band is ready for the credit costs of
+     * the model.
+     */
+    TimerTime_t Time;
+    /*!
+     * Index of the band
+     */
+    uint8_t Band;
+    /*!
+     * Set when the maximum credits of the band cover the credit costs
+     */
+    bool Valid;
+}BandEvent_t;
+
+/*!
+ * Incremental duty cycle model of the bands of a joined end-device with the
+ * duty cycle enabled. In this state the credits of a band only change with
+ * the time, on a line known since the last transmission on the band, and the
+ * band events sorted by time answer RegionCommonUpdateBandTimeOff.
+ */
+typedef struct sBandModel
+{
+    /*!
+     * Bands of the model, NULL when there is no model
+     */
+    Band_t* Bands;
+    /*!
+     * Number of bands
+     */
+    uint8_t NbBands;
+    /*!
+     * Time on air the ready times are computed for
+     */
+    TimerTime_t ExpectedTimeOnAir;
+    /*!
+     * Time of the last RegionCommonUpdateBandTimeOff. Before RP002-1.0.3, the
+     * credits of the bands are only written back when the band events are
+     * computed, the credits of this time follow from the update time.
+     */
+    TimerTime_t SyncTime;
+    /*!
+     * Band fields as left by the model, a band changed by someone else ends the model
+     */
+    Band_t Snapshot[REGION_NVM_MAX_NB_BANDS];
+    /*!
+     * Band events, sorted by time
+     */
+    BandEvent_t Events[REGION_NVM_MAX_NB_BANDS];
+    /*!
+     * Number of bands whose maximum credits cover the credit costs
+     */
+    uint8_t NbValidBands;
+    /*!
+     * Before RP002-1.0.3, number of leading events already ready
+     */
+    uint8_t NbReadyEvents;
+    /*!
+     * Set when the ready state of every band must be evaluated again
+     */
+    bool Rescan;
+}BandModel_t;
+
+static BandModel_t BandModel;
+#endif /* REGION_DUTY_CYCLE_INCREMENTAL_ENABLED */
+
 static uint16_t GetDutyCycle( Band_t* band, bool joined, SysTime_t elapsedTimeSinceStartup )
 {
     uint16_t dutyCycle = band->DCycle;
@@ -289,17 +538,275 @@ static uint16_t UpdateTimeCredits( Band_t* band, bool joined, bool dutyCycleEnab
 }
 #endif
 
-static uint8_t CountChannels( uint16_t mask, uint8_t nbBits )
+#if (defined( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED ) && ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ))
+/*!
+ * \brief Compares two times less than 2^31 ms apart, wrap around safe.
+ *
+ * \retval Returns true when the time a is before the time b.
+ */
+static bool IsTimeBefore( TimerTime_t a, TimerTime_t b )
 {
-    uint8_t nbActiveBits = 0;
+    return ( int32_t )( a - b ) < 0;
+}
+
+static void SaveBandSnapshot( uint8_t band )
+{
+    BandModel.Snapshot[band] = BandModel.Bands[band];
+}
+
+static bool IsBandSnapshot( uint8_t band )
+{
+    Band_t* current = &BandModel.Bands[band];
+    Band_t* snapshot = &BandModel.Snapshot[band];
+
+    return ( current->DCycle == snapshot->DCycle ) &&
+           ( current->LastBandUpdateTime == snapshot->LastBandUpdateTime ) &&
+           ( current->LastMaxCreditAssignTime == snapshot->LastMaxCreditAssignTime ) &&
+           ( current->TimeCredits == snapshot->TimeCredits ) &&
+           ( current->MaxTimeCredits == snapshot->MaxTimeCredits );
+}
+
+/*!
+ * \brief Checks that the model describes the given bands, left untouched since.
+ */
+static bool IsBandModelOf( Band_t* bands, uint8_t nbBands )
+{
+    if( ( BandModel.Bands != bands ) || ( BandModel.NbBands != nbBands ) )
+    {
+        return false;
+    }
+    for( uint8_t i = 0; i < nbBands; i++ )
+    {
+        if( IsBandSnapshot( i ) == false )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static TimerTime_t GetBandCreditCosts( uint8_t band )
+{
+    return BandModel.ExpectedTimeOnAir * MAX( BandModel.Bands[band].DCycle, 1 );
+}
+
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x01010003 ) || ( REGION_VERSION == 0x02010001 )))
+/*!
+ * \brief Writes the credits of the band at the time of the last synchronization.
+ */
+static void SyncBandCredits( uint8_t band )
+{
+    Band_t* modelled = &BandModel.Bands[band];
+
+    modelled->TimeCredits += BandModel.SyncTime - modelled->LastBandUpdateTime;
+    if( modelled->TimeCredits > modelled->MaxTimeCredits )
+    {
+        modelled->TimeCredits = modelled->MaxTimeCredits;
+    }
+    modelled->LastBandUpdateTime = BandModel.SyncTime;
+    SaveBandSnapshot( band );
+}
+
+/*!
+ * \brief Gets the time from which the credits of the band exceed the credit costs.
+ *
+ * \remark The credits grow by 1 per ms since the last transmission, until
+ *         the maximum credits which are above the credit costs.
+ */
+static TimerTime_t GetBandReadyTime( uint8_t band )
+{
+    Band_t* modelled = &BandModel.Bands[band];
+
+    return modelled->LastBandUpdateTime + GetBandCreditCosts( band ) - modelled->TimeCredits + 1;
+}
+#endif /* REGION_VERSION */
+
+/*!
+ * \brief Sorts the band events by time, the bands which can never be ready last.
+ */
+static void SortBandEvents( void )
+{
+    for( uint8_t i = 1; i < BandModel.NbBands; i++ )
+    {
+        BandEvent_t event = BandModel.Events[i];
+        uint8_t j = i;
+
+        while( j > 0 )
+        {
+            BandEvent_t* previous = &BandModel.Events[j - 1];
+
+            if( ( event.Valid == previous->Valid ) ? ( IsTimeBefore( event.Time, previous->Time ) == false ) :
+                                                     ( previous->Valid == true ) )
+            {
+                break;
+            }
+            BandModel.Events[j] = *previous;
+            j--;
+        }
+        BandModel.Events[j] = event;
+    }
+}
+
+/*!
+ * \brief Computes the band events for the expected time on air.
+ */
+static void SetBandEvents( TimerTime_t expectedTimeOnAir )
+{
+    BandModel.ExpectedTimeOnAir = expectedTimeOnAir;
+    BandModel.NbValidBands = 0;
+    for( uint8_t i = 0; i < BandModel.NbBands; i++ )
+    {
+        BandModel.Events[i].Band = i;
+#if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x02010003 ))
+        BandModel.Events[i].Time = BandModel.Bands[i].LastBandUpdateTime + DUTY_CYCLE_TIME_PERIOD;
+#else
+        SyncBandCredits( i );
+        BandModel.Events[i].Time = GetBandReadyTime( i );
+#endif /* REGION_VERSION */
+        BandModel.Events[i].Valid = BandModel.Bands[i].MaxTimeCredits > GetBandCreditCosts( i );
+        if( BandModel.Events[i].Valid == true )
+        {
+            BandModel.NbValidBands++;
+        }
+    }
+    SortBandEvents( );
+    BandModel.NbReadyEvents = 0;
+    BandModel.Rescan = true;
+}
 
-    for( uint8_t j = 0; j < nbBits; j++ )
+/*!
+ * \brief Starts the model on bands just synchronized by RegionCommonUpdateBandTimeOff.
+ */
+static void StartBandModel( Band_t* bands, uint8_t nbBands, TimerTime_t currentTime, TimerTime_t expectedTimeOnAir )
+{
+    if( ( nbBands > REGION_NVM_MAX_NB_BANDS ) || ( currentTime == 0 ) )
+    {
+        // A null update time restores the credits at the next synchronization
+        BandModel.Bands = NULL;
+        return;
+    }
+    BandModel.Bands = bands;
+    BandModel.NbBands = nbBands;
+    BandModel.SyncTime = currentTime;
+    for( uint8_t i = 0; i < nbBands; i++ )
     {
-        if( ( mask & ( 1 << j ) ) == ( 1 << j ) )
+        SaveBandSnapshot( i );
+    }
+    SetBandEvents( expectedTimeOnAir );
+}
+
+/*!
+ * \brief Ends the model, leaving the bands as the full synchronization would have.
+ */
+static void StopBandModel( void )
+{
+    if( BandModel.Bands == NULL )
+    {
+        return;
+    }
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x01010003 ) || ( REGION_VERSION == 0x02010001 )))
+    if( IsBandModelOf( BandModel.Bands, BandModel.NbBands ) == true )
+    {
+        for( uint8_t i = 0; i < BandModel.NbBands; i++ )
         {
-            nbActiveBits++;
+            SyncBandCredits( i );
         }
     }
+#endif /* REGION_VERSION */
+    BandModel.Bands = NULL;
+}
+
+/*!
+ * \brief RegionCommonUpdateBandTimeOff of a joined end-device with the duty
+ *        cycle enabled, answered from the band events.
+ */
+static TimerTime_t UpdateBandModel( TimerTime_t currentTime, TimerTime_t expectedTimeOnAir )
+{
+    TimerTime_t minTimeToWait = TIMERTIME_T_MAX;
+
+    BandModel.SyncTime = currentTime;
+    if( expectedTimeOnAir != BandModel.ExpectedTimeOnAir )
+    {
+        SetBandEvents( expectedTimeOnAir );
+    }
+
+#if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x02010003 ))
+    // Restore the credits of the bands whose observation period has ended
+    while( IsTimeBefore( currentTime, BandModel.Events[0].Time ) == false )
+    {
+        Band_t* band = &BandModel.Bands[BandModel.Events[0].Band];
+
+        band->TimeCredits = band->MaxTimeCredits;
+        band->LastBandUpdateTime = currentTime;
+        SaveBandSnapshot( BandModel.Events[0].Band );
+        BandModel.Events[0].Time = currentTime + DUTY_CYCLE_TIME_PERIOD;
+        SortBandEvents( );
+        BandModel.Rescan = true;
+    }
+    if( BandModel.Rescan == true )
+    {
+        for( uint8_t i = 0; i < BandModel.NbBands; i++ )
+        {
+            BandModel.Bands[i].ReadyForTransmission = BandModel.Bands[i].TimeCredits > GetBandCreditCosts( i );
+        }
+        BandModel.Rescan = false;
+    }
+    // The next transmission waits for the first valid band not ready to end its observation period
+    for( uint8_t i = 0; i < BandModel.NbValidBands; i++ )
+    {
+        if( BandModel.Bands[BandModel.Events[i].Band].ReadyForTransmission == false )
+        {
+            minTimeToWait = BandModel.Events[i].Time - currentTime;
+            break;
+        }
+    }
+#else
+    if( BandModel.Rescan == true )
+    {
+        for( uint8_t i = 0; i < BandModel.NbBands; i++ )
+        {
+            BandModel.Bands[i].ReadyForTransmission = false;
+        }
+        BandModel.NbReadyEvents = 0;
+        BandModel.Rescan = false;
+    }
+    // The bands become ready in the order of the events
+    while( ( BandModel.NbReadyEvents < BandModel.NbValidBands ) &&
+           ( IsTimeBefore( currentTime, BandModel.Events[BandModel.NbReadyEvents].Time ) == false ) )
+    {
+        BandModel.Bands[BandModel.Events[BandModel.NbReadyEvents].Band].ReadyForTransmission = true;
+        BandModel.NbReadyEvents++;
+    }
+    if( BandModel.NbReadyEvents < BandModel.NbValidBands )
+    {
+        minTimeToWait = BandModel.Events[BandModel.NbReadyEvents].Time - 1 - currentTime;
+    }
+#endif /* REGION_VERSION */
+
+    if( BandModel.NbValidBands == 0 )
+    {
+        // There is no valid band available to handle a transmission
+        // in the given DUTY_CYCLE_TIME_PERIOD.
+        return TIMERTIME_T_MAX;
+    }
+    return minTimeToWait;
+}
+#endif /* REGION_DUTY_CYCLE_INCREMENTAL_ENABLED */
+
+static uint8_t CountChannels( uint16_t mask, uint8_t nbBits )
+{
+    uint8_t nbActiveBits = 0;
+
+    if( nbBits < 16 )
+    {
+        mask &= ( uint16_t )( ( 1U << nbBits ) - 1 );
+    }
+    // Each iteration clears the lowest bit set
+    while( mask != 0 )
+    {
+        mask &= ( uint16_t )( mask - 1 );
+        nbActiveBits++;
+    }
     return nbActiveBits;
 }
 
@@ -385,6 +892,26 @@ void RegionCommonSetBandTxDone( Band_t* band, TimerTime_t lastTxAirTime, bool jo
     // Get the band duty cycle. If not joined, the function either returns the join duty cycle
     // or the band duty cycle, whichever is more restrictive.
     uint16_t dutyCycle = GetDutyCycle( band, joined, elapsedTimeSinceStartup );
+#if (defined( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED ) && ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ))
+    bool modelled = ( BandModel.Bands != NULL ) && ( band >= BandModel.Bands ) &&
+                    ( band < ( BandModel.Bands + BandModel.NbBands ) );
+
+    if( modelled == true )
+    {
+        if( IsBandModelOf( BandModel.Bands, BandModel.NbBands ) == false )
+        {
+            StopBandModel( );
+            modelled = false;
+        }
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x01010003 ) || ( REGION_VERSION == 0x02010001 )))
+        else
+        {
+            // Spend the credits the band has at the last synchronization
+            SyncBandCredits( band - BandModel.Bands );
+        }
+#endif /* REGION_VERSION */
+    }
+#endif /* REGION_DUTY_CYCLE_INCREMENTAL_ENABLED */
 
     // Reduce with transmission time
     if( band->TimeCredits > ( lastTxAirTime * dutyCycle ) )
@@ -396,6 +923,15 @@ void RegionCommonSetBandTxDone( Band_t* band, TimerTime_t lastTxAirTime, bool jo
     {
         band->TimeCredits = 0;
     }
+
+#if (defined( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED ) && ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ))
+    if( modelled == true )
+    {
+        // Only the events of this band change, the model stays valid
+        SaveBandSnapshot( band - BandModel.Bands );
+        SetBandEvents( BandModel.ExpectedTimeOnAir );
+    }
+#endif /* REGION_DUTY_CYCLE_INCREMENTAL_ENABLED */
 }
 
 TimerTime_t RegionCommonUpdateBandTimeOff( bool joined, Band_t* bands,
@@ -409,6 +945,20 @@ TimerTime_t RegionCommonUpdateBandTimeOff( bool joined, Band_t* bands,
     uint16_t dutyCycle = 1;
     uint8_t validBands = 0;
 
+#if (defined( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED ) && ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ))
+    // The queries work on a copy of the bands and leave the model alone
+    if( bands != QueryBands )
+    {
+        if( ( joined == true ) && ( dutyCycleEnabled == true ) && ( currentTime != 0 ) &&
+            ( ( currentTime - BandModel.SyncTime ) < DUTY_CYCLE_TIME_PERIOD ) &&
+            ( IsBandModelOf( bands, nbBands ) == true ) )
+        {
+            return UpdateBandModel( currentTime, expectedTimeOnAir );
+        }
+        StopBandModel( );
+    }
+#endif /* REGION_DUTY_CYCLE_INCREMENTAL_ENABLED */
+
     for( uint8_t i = 0; i < nbBands; i++ )
     {
 #if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x02010003 ))
@@ -505,6 +1055,13 @@ TimerTime_t RegionCommonUpdateBandTimeOff( bool joined, Band_t* bands,
         }
     }
 
+#if (defined( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED ) && ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ))
+    if( ( bands != QueryBands ) && ( joined == true ) && ( dutyCycleEnabled == true ) )
+    {
+        StartBandModel( bands, nbBands, currentTime, expectedTimeOnAir );
+    }
+#endif /* REGION_DUTY_CYCLE_INCREMENTAL_ENABLED */
+
     if( validBands == 0 )
     {
         // There is no valid band available to handle a transmission
@@ -613,6 +1170,99 @@ uint32_t RegionCommonComputeSymbolTimeFsk( uint8_t phyDrInKbps )
     return 8000 / ( uint32_t )phyDrInKbps; // 1 symbol equals 1 byte
 }
 
+TimerTime_t RegionCommonComputeTimeOnAirLoRa( uint32_t bandwidth, uint32_t spreadingFactor, uint8_t coderate,
+                                              uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    const uint32_t bandwidthsInHz[] = { 125000, 250000, 500000 };
+    int32_t ceilNumerator = ( ( int32_t )payloadLen << 3 ) + ( crcOn ? 16 : 0 ) - ( 4 * ( int32_t )spreadingFactor ) + ( fixLen ? 0 : 20 );
+    int32_t ceilDenominator = 4 * ( int32_t )spreadingFactor;
+    int32_t nbSymbols = 0;
+
+    if( bandwidth > 2 )
+    {
+        bandwidth = 0;
+    }
+
+    if( spreadingFactor <= 6 )
+    {
+        // SF5 and SF6 require at least 12 preamble symbols
+        preambleLen = MAX( preambleLen, 12 );
+    }
+    else
+    {
+        ceilNumerator += 8;
+        // Low datarate optimization
+        if( ( ( bandwidth == 0 ) && ( spreadingFactor >= 11 ) ) ||
+            ( ( bandwidth == 1 ) && ( spreadingFactor == 12 ) ) )
+        {
+            ceilDenominator = 4 * ( ( int32_t )spreadingFactor - 2 );
+        }
+    }
+    ceilNumerator = MAX( ceilNumerator, 0 );
+
+    // Number of quarter symbols: 4 * ( preamble + 4.25 + 8 + payload symbols )
+    nbSymbols = DIV_CEIL( ceilNumerator, ceilDenominator ) * ( coderate + 4 ) + preambleLen + 12;
+    if( spreadingFactor <= 6 )
+    {
+        nbSymbols += 2;
+    }
+
+    return DIV_CEIL( ( uint64_t )1000 * ( uint32_t )( 4 * nbSymbols + 1 ) * ( 1UL << ( spreadingFactor - 2 ) ),
+                     bandwidthsInHz[bandwidth] );
+}
+
+TimerTime_t RegionCommonComputeTimeOnAirFsk( uint32_t datarate, uint16_t preambleLen, bool fixLen,
+                                             uint8_t payloadLen, bool crcOn )
+{
+    // Preamble, length byte, 3 bytes sync word, payload and CRC
+    uint32_t nbBits = ( ( uint32_t )preambleLen << 3 ) + ( fixLen ? 0 : 8 ) + ( 3 << 3 ) +
+                      ( ( ( uint32_t )payloadLen + ( crcOn ? 2 : 0 ) ) << 3 );
+
+    return DIV_CEIL( 1000 * nbBits, datarate );
+}
+
+TimerTime_t RegionCommonGetUplinkTimeOnAir( int8_t datarate, RadioModems_t modem, uint8_t phyDr,
+                                            uint32_t bandwidth, uint16_t pktLen )
+{
+    TimerTime_t timeOnAir = 0;
+#if (defined( REGION_TIME_ON_AIR_TABLE_ENABLED ) && ( REGION_TIME_ON_AIR_TABLE_ENABLED == 1 ))
+    uint16_t modulation = ( uint16_t )( ( ( uint16_t )modem << 12 ) | ( ( bandwidth & 0x0F ) << 8 ) | phyDr ) + 1;
+    TimeOnAirRow_t* row = NULL;
+
+    if( ( datarate >= 0 ) && ( datarate < REGION_TIME_ON_AIR_TABLE_NB_DR ) && ( pktLen <= REGION_TIME_ON_AIR_TABLE_MAX_LEN ) )
+    {
+        row = &TimeOnAirTable[datarate];
+        if( row->Modulation != modulation )
+        {
+            // Datarate of another region or first use of the row
+            memset1( ( uint8_t* )row->TimeOnAir, 0, sizeof( row->TimeOnAir ) );
+            row->Modulation = modulation;
+        }
+        if( row->TimeOnAir[pktLen] != 0 )
+        {
+            return row->TimeOnAir[pktLen];
+        }
+    }
+#endif /* REGION_TIME_ON_AIR_TABLE_ENABLED */
+
+    if( modem == MODEM_FSK )
+    {
+        timeOnAir = RegionCommonComputeTimeOnAirFsk( ( uint32_t )phyDr * 1000, 5, false, pktLen, true );
+    }
+    else
+    {
+        timeOnAir = RegionCommonComputeTimeOnAirLoRa( bandwidth, phyDr, 1, 8, false, pktLen, true );
+    }
+
+#if (defined( REGION_TIME_ON_AIR_TABLE_ENABLED ) && ( REGION_TIME_ON_AIR_TABLE_ENABLED == 1 ))
+    if( ( row != NULL ) && ( timeOnAir <= UINT16_MAX ) )
+    {
+        row->TimeOnAir[pktLen] = ( uint16_t )timeOnAir;
+    }
+#endif /* REGION_TIME_ON_AIR_TABLE_ENABLED */
+    return timeOnAir;
+}
+
 void RegionCommonComputeRxWindowParameters( uint32_t tSymbolInUs, uint8_t minRxSymbols, uint32_t rxErrorInMs, uint32_t wakeUpTimeInMs, uint32_t* windowTimeoutInSymbols, int32_t* windowOffsetInMs )
 {
     *windowTimeoutInSymbols = MAX( DIV_CEIL( ( ( 2 * minRxSymbols - 8 ) * tSymbolInUs + 2 * ( rxErrorInMs * 1000 ) ),  tSymbolInUs ), minRxSymbols ); // Computed number of symbols
@@ -639,8 +1289,8 @@ void RegionCommonRxBeaconSetup( RegionCommonRxBeaconSetupParams_t* rxBeaconSetup
     Radio.Sleep( );
 
     // Setup frequency and payload length
-    Radio.SetChannel( rxBeaconSetupParams->Frequency );
-    Radio.SetMaxPayloadLength( MODEM_LORA, rxBeaconSetupParams->BeaconSize );
+    RegionCommonRadioSetChannel( rxBeaconSetupParams->Frequency );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, rxBeaconSetupParams->BeaconSize );
 
     // Check the RX continuous mode
     if( rxBeaconSetupParams->RxTime != 0 )
@@ -652,8 +1302,8 @@ void RegionCommonRxBeaconSetup( RegionCommonRxBeaconSetupParams_t* rxBeaconSetup
     datarate = rxBeaconSetupParams->Datarates[rxBeaconSetupParams->BeaconDatarate];
 
     // Setup radio
-    Radio.SetRxConfig( MODEM_LORA, rxBeaconSetupParams->BeaconChannelBW, datarate,
-                       1, 0, 10, rxBeaconSetupParams->SymbolTimeout, true, rxBeaconSetupParams->BeaconSize, false, 0, 0, false, rxContinuous );
+    RegionCommonRadioSetRxConfig( MODEM_LORA, rxBeaconSetupParams->BeaconChannelBW, datarate,
+                                  1, 0, 10, rxBeaconSetupParams->SymbolTimeout, true, rxBeaconSetupParams->BeaconSize, false, 0, 0, false, rxContinuous );
 
     Radio.Rx( rxBeaconSetupParams->RxTime );
     MW_LOG(TS_ON, VLEVEL_M, "RX_BC on freq %d Hz at DR %d\r\n", rxBeaconSetupParams->Frequency, rxBeaconSetupParams->BeaconDatarate );
@@ -664,38 +1314,52 @@ void RegionCommonCountNbOfEnabledChannels( RegionCommonCountNbOfEnabledChannelsP
 {
     uint8_t nbChannelCount = 0;
     uint8_t nbRestrictedChannelsCount = 0;
+    uint32_t bandsChecked = 0;
+    uint32_t bandsReady = 0;
 
     for( uint8_t i = 0, k = 0; i < countNbOfEnabledChannelsParams->MaxNbChannels; i += 16, k++ )
     {
-        for( uint8_t j = 0; j < 16; j++ )
+        uint16_t eligible = countNbOfEnabledChannelsParams->ChannelsMask[k];
+
+        if( ( countNbOfEnabledChannelsParams->Joined == false ) &&
+            ( countNbOfEnabledChannelsParams->JoinChannels != NULL ) )
         {
-            if( ( countNbOfEnabledChannelsParams->ChannelsMask[k] & ( 1 << j ) ) != 0 )
-            {
-                if( countNbOfEnabledChannelsParams->Channels[i + j].Frequency == 0 )
-                { // Check if the channel is enabled
-                    continue;
-                }
-                if( ( countNbOfEnabledChannelsParams->Joined == false ) &&
-                    ( countNbOfEnabledChannelsParams->JoinChannels != NULL ) )
+            eligible &= countNbOfEnabledChannelsParams->JoinChannels[k];
+        }
+
+        // Only visit the channels set in the masks, in increasing order
+        while( eligible != 0 )
+        {
+            uint8_t id = i + LowestBitPosition( eligible );
+            ChannelParams_t* channel = &countNbOfEnabledChannelsParams->Channels[id];
+            uint32_t bandBit = 1UL << channel->Band;
+
+            eligible &= ( uint16_t )( eligible - 1 );
+
+            if( channel->Frequency == 0 )
+            { // Check if the channel is enabled
+                continue;
+            }
+            if( RegionCommonValueInRange( countNbOfEnabledChannelsParams->Datarate,
+                                          channel->DrRange.Fields.Min,
+                                          channel->DrRange.Fields.Max ) == false )
+            { // Check if the current channel selection supports the given datarate
+                continue;
+            }
+            if( ( bandsChecked & bandBit ) == 0 )
+            { // The band state is read once per band
+                bandsChecked |= bandBit;
+                if( countNbOfEnabledChannelsParams->Bands[channel->Band].ReadyForTransmission == true )
                 {
-                    if( ( countNbOfEnabledChannelsParams->JoinChannels[k] & ( 1 << j ) ) == 0 )
-                    {
-                        continue;
-                    }
-                }
-                if( RegionCommonValueInRange( countNbOfEnabledChannelsParams->Datarate,
-                                              countNbOfEnabledChannelsParams->Channels[i + j].DrRange.Fields.Min,
-                                              countNbOfEnabledChannelsParams->Channels[i + j].DrRange.Fields.Max ) == false )
-                { // Check if the current channel selection supports the given datarate
-                    continue;
-                }
-                if( countNbOfEnabledChannelsParams->Bands[countNbOfEnabledChannelsParams->Channels[i + j].Band].ReadyForTransmission == false )
-                { // Check if the band is available for transmission
-                    nbRestrictedChannelsCount++;
-                    continue;
+                    bandsReady |= bandBit;
                 }
-                enabledChannels[nbChannelCount++] = i + j;
             }
+            if( ( bandsReady & bandBit ) == 0 )
+            { // Check if the band is available for transmission
+                nbRestrictedChannelsCount++;
+                continue;
+            }
+            enabledChannels[nbChannelCount++] = id;
         }
     }
     *nbEnabledChannels = nbChannelCount;
@@ -708,15 +1372,32 @@ LoRaMacStatus_t RegionCommonIdentifyChannels( RegionCommonIdentifyChannelsParam_
                                               TimerTime_t* nextTxDelay )
 {
     TimerTime_t elapsed = TimerGetElapsedTime( identifyChannelsParam->LastAggrTx );
+    RegionCommonCountNbOfEnabledChannelsParams_t* countParams = identifyChannelsParam->CountNbOfEnabledChannelsParam;
+    Band_t* regionBands = countParams->Bands;
     *nextTxDelay = identifyChannelsParam->AggrTimeOff - elapsed;
     *nbRestrictedChannels = 1;
     *nbEnabledChannels = 0;
 
+    if( identifyChannelsParam->QueryOnly == true )
+    {
+        if( identifyChannelsParam->MaxBands > REGION_NVM_MAX_NB_BANDS )
+        {
+            return LORAMAC_STATUS_PARAMETER_INVALID;
+        }
+        // The credits are synchronized on a copy of the bands
+        memcpy1( ( uint8_t* )QueryBands, ( uint8_t* )regionBands, identifyChannelsParam->MaxBands * sizeof( Band_t ) );
+        countParams->Bands = QueryBands;
+        identifyChannelsParam->TimeCredits = 0;
+    }
+
     if( ( identifyChannelsParam->LastAggrTx == 0 ) ||
         ( identifyChannelsParam->AggrTimeOff <= elapsed ) )
     {
         // Reset Aggregated time off
-        *aggregatedTimeOff = 0;
+        if( identifyChannelsParam->QueryOnly == false )
+        {
+            *aggregatedTimeOff = 0;
+        }
 
         // Update bands Time OFF
         *nextTxDelay = RegionCommonUpdateBandTimeOff( identifyChannelsParam->CountNbOfEnabledChannelsParam->Joined,
@@ -731,6 +1412,16 @@ LoRaMacStatus_t RegionCommonIdentifyChannels( RegionCommonIdentifyChannelsParam_
                                               nbEnabledChannels, nbRestrictedChannels );
     }
 
+    if( identifyChannelsParam->QueryOnly == true )
+    {
+        for( uint8_t i = 0; i < *nbEnabledChannels; i++ )
+        {
+            identifyChannelsParam->TimeCredits = MAX( identifyChannelsParam->TimeCredits,
+                                                      QueryBands[countParams->Channels[enabledChannels[i]].Band].TimeCredits );
+        }
+        countParams->Bands = regionBands;
+    }
+
     if( *nbEnabledChannels > 0 )
     {
         *nextTxDelay = 0;
@@ -802,3 +1493,380 @@ void RegionCommonTxConfigPrint(uint32_t frequency, int8_t dr)
 {
     MW_LOG(TS_ON, VLEVEL_M,  "TX on freq %d Hz at DR %d\r\n", frequency, dr );
 }
+
+void RegionCommonRadioSetChannel( uint32_t freq )
+{
+#if (defined( LORAMAC_RADIO_SHADOW_ENABLED ) && ( LORAMAC_RADIO_SHADOW_ENABLED == 1 ))
+    if( ( RadioShadow.ChannelValid == true ) && ( RadioShadow.Frequency == freq ) )
+    {
+        RadioShadowStats.ChannelSkipped++;
+        return;
+    }
+    RadioShadow.ChannelValid = true;
+    RadioShadow.Frequency = freq;
+#endif /* LORAMAC_RADIO_SHADOW_ENABLED */
+    RadioShadowStats.ChannelApplied++;
+    Radio.SetChannel( freq );
+}
+
+void RegionCommonRadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                                   uint32_t datarate, uint8_t coderate,
+                                   uint32_t bandwidthAfc, uint16_t preambleLen,
+                                   uint16_t symbTimeout, bool fixLen,
+                                   uint8_t payloadLen,
+                                   bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                                   bool iqInverted, bool rxContinuous )
+{
+#if (defined( LORAMAC_RADIO_SHADOW_ENABLED ) && ( LORAMAC_RADIO_SHADOW_ENABLED == 1 ))
+    RadioShadowRxConfig_t rxConfig;
+
+    // Clear the padding bytes to allow a memory comparison
+    memset1( ( uint8_t* )&rxConfig, 0, sizeof( RadioShadowRxConfig_t ) );
+    rxConfig.Modem = modem;
+    rxConfig.Bandwidth = bandwidth;
+    rxConfig.Datarate = datarate;
+    rxConfig.BandwidthAfc = bandwidthAfc;
+    rxConfig.PreambleLen = preambleLen;
+    rxConfig.SymbTimeout = symbTimeout;
+    rxConfig.Coderate = coderate;
+    rxConfig.PayloadLen = payloadLen;
+    rxConfig.HopPeriod = hopPeriod;
+    rxConfig.FixLen = fixLen;
+    rxConfig.CrcOn = crcOn;
+    rxConfig.FreqHopOn = freqHopOn;
+    rxConfig.IqInverted = iqInverted;
+    rxConfig.RxContinuous = rxContinuous;
+
+    if( ( RadioShadow.Config == RADIO_SHADOW_CONFIG_RX ) &&
+        ( memcmp( &RadioShadow.RxConfig, &rxConfig, sizeof( RadioShadowRxConfig_t ) ) == 0 ) )
+    {
+        RadioShadowStats.RxConfigSkipped++;
+        return;
+    }
+    RadioShadow.Config = RADIO_SHADOW_CONFIG_RX;
+    RadioShadow.RxConfig = rxConfig;
+    // The modem configuration may have overwritten the payload length
+    RadioShadow.MaxPayloadValid = false;
+#endif /* LORAMAC_RADIO_SHADOW_ENABLED */
+    RadioShadowStats.RxConfigApplied++;
+    Radio.SetRxConfig( modem, bandwidth, datarate, coderate, bandwidthAfc, preambleLen, symbTimeout,
+                       fixLen, payloadLen, crcOn, freqHopOn, hopPeriod, iqInverted, rxContinuous );
+}
+
+void RegionCommonRadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                                   uint32_t bandwidth, uint32_t datarate,
+                                   uint8_t coderate, uint16_t preambleLen,
+                                   bool fixLen, bool crcOn, bool freqHopOn,
+                                   uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+#if (defined( LORAMAC_RADIO_SHADOW_ENABLED ) && ( LORAMAC_RADIO_SHADOW_ENABLED == 1 ))
+    RadioShadowTxConfig_t txConfig;
+
+    // Clear the padding bytes to allow a memory comparison
+    memset1( ( uint8_t* )&txConfig, 0, sizeof( RadioShadowTxConfig_t ) );
+    txConfig.Modem = modem;
+    txConfig.Fdev = fdev;
+    txConfig.Bandwidth = bandwidth;
+    txConfig.Datarate = datarate;
+    txConfig.Timeout = timeout;
+    txConfig.PreambleLen = preambleLen;
+    txConfig.Power = power;
+    txConfig.Coderate = coderate;
+    txConfig.HopPeriod = hopPeriod;
+    txConfig.FixLen = fixLen;
+    txConfig.CrcOn = crcOn;
+    txConfig.FreqHopOn = freqHopOn;
+    txConfig.IqInverted = iqInverted;
+
+    if( ( RadioShadow.Config == RADIO_SHADOW_CONFIG_TX ) &&
+        ( memcmp( &RadioShadow.TxConfig, &txConfig, sizeof( RadioShadowTxConfig_t ) ) == 0 ) )
+    {
+        RadioShadowStats.TxConfigSkipped++;
+        return;
+    }
+    RadioShadow.Config = RADIO_SHADOW_CONFIG_TX;
+    RadioShadow.TxConfig = txConfig;
+    // The modem configuration may have overwritten the payload length
+    RadioShadow.MaxPayloadValid = false;
+#endif /* LORAMAC_RADIO_SHADOW_ENABLED */
+    RadioShadowStats.TxConfigApplied++;
+    Radio.SetTxConfig( modem, power, fdev, bandwidth, datarate, coderate, preambleLen,
+                       fixLen, crcOn, freqHopOn, hopPeriod, iqInverted, timeout );
+}
+
+void RegionCommonRadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+#if (defined( LORAMAC_RADIO_SHADOW_ENABLED ) && ( LORAMAC_RADIO_SHADOW_ENABLED == 1 ))
+    if( ( RadioShadow.MaxPayloadValid == true ) && ( RadioShadow.MaxPayloadModem == modem ) &&
+        ( RadioShadow.MaxPayload == max ) )
+    {
+        RadioShadowStats.MaxPayloadSkipped++;
+        return;
+    }
+    RadioShadow.MaxPayloadValid = true;
+    RadioShadow.MaxPayloadModem = modem;
+    RadioShadow.MaxPayload = max;
+#endif /* LORAMAC_RADIO_SHADOW_ENABLED */
+    RadioShadowStats.MaxPayloadApplied++;
+    Radio.SetMaxPayloadLength( modem, max );
+}
+
+void RegionCommonRadioShadowInvalidate( void )
+{
+#if (defined( LORAMAC_RADIO_SHADOW_ENABLED ) && ( LORAMAC_RADIO_SHADOW_ENABLED == 1 ))
+    RadioShadow.ChannelValid = false;
+    RadioShadow.Config = RADIO_SHADOW_CONFIG_NONE;
+    RadioShadow.MaxPayloadValid = false;
+#endif /* LORAMAC_RADIO_SHADOW_ENABLED */
+}
+
+void RegionCommonRadioShadowGetStats( RegionCommonRadioShadowStats_t* stats )
+{
+    if( stats != NULL )
+    {
+        *stats = RadioShadowStats;
+    }
+}
+
+void RegionCommonSetChannelSelector( RegionCommonChannelSelector_t selector )
+{
+    ChannelSelector = selector;
+}
+
+uint8_t RegionCommonSelectChannel( const uint8_t* enabledChannels, uint8_t nbEnabledChannels )
+{
+    uint8_t index;
+
+    if( ChannelSelector == NULL )
+    {
+        // Default strategy, weighted by the channel quality when it is recorded
+        return RegionCommonChannelSelectorQualityAware( enabledChannels, nbEnabledChannels );
+    }
+
+    index = ChannelSelector( enabledChannels, nbEnabledChannels );
+    if( index >= nbEnabledChannels )
+    {
+        index = randr( 0, nbEnabledChannels - 1 );
+    }
+    return index;
+}
+
+uint8_t RegionCommonChannelSelectorQualityAware( const uint8_t* enabledChannels, uint8_t nbEnabledChannels )
+{
+#if (defined( LORAMAC_CHANNEL_QUALITY_ENABLED ) && ( LORAMAC_CHANNEL_QUALITY_ENABLED == 1 ))
+    int32_t totalWeight = 0;
+    int32_t draw = 0;
+    uint8_t i;
+
+    for( i = 0; i < nbEnabledChannels; i++ )
+    {
+        totalWeight += MAX( ChannelQuality[enabledChannels[i]].Score, CHANNEL_QUALITY_MIN_WEIGHT );
+    }
+
+    // Weighted random selection
+    draw = randr( 0, totalWeight - 1 );
+    for( i = 0; i < ( nbEnabledChannels - 1 ); i++ )
+    {
+        draw -= MAX( ChannelQuality[enabledChannels[i]].Score, CHANNEL_QUALITY_MIN_WEIGHT );
+        if( draw < 0 )
+        {
+            break;
+        }
+    }
+    return i;
+#else
+    return randr( 0, nbEnabledChannels - 1 );
+#endif /* LORAMAC_CHANNEL_QUALITY_ENABLED */
+}
+
+void RegionCommonChannelQualityUpdate( uint8_t channel, bool ackReceived )
+{
+#if (defined( LORAMAC_CHANNEL_QUALITY_ENABLED ) && ( LORAMAC_CHANNEL_QUALITY_ENABLED == 1 ))
+    RegionCommonChannelQuality_t* quality;
+
+    if( channel >= REGION_NVM_MAX_NB_CHANNELS )
+    {
+        return;
+    }
+    quality = &ChannelQuality[channel];
+
+    if( ackReceived == true )
+    {
+        // Recover slowly
+        quality->Score += ( uint8_t )( ( 255 - quality->Score ) / 8 );
+        if( quality->NbAckReceived < UINT16_MAX )
+        {
+            quality->NbAckReceived++;
+        }
+    }
+    else
+    {
+        // Degrade quickly
+        quality->Score -= ( uint8_t )( quality->Score / 4 );
+        if( quality->NbAckMissed < UINT16_MAX )
+        {
+            quality->NbAckMissed++;
+        }
+    }
+#endif /* LORAMAC_CHANNEL_QUALITY_ENABLED */
+}
+
+bool RegionCommonChannelQualityGet( uint8_t channel, RegionCommonChannelQuality_t* quality )
+{
+#if (defined( LORAMAC_CHANNEL_QUALITY_ENABLED ) && ( LORAMAC_CHANNEL_QUALITY_ENABLED == 1 ))
+    if( ( channel >= REGION_NVM_MAX_NB_CHANNELS ) || ( quality == NULL ) )
+    {
+        return false;
+    }
+    *quality = ChannelQuality[channel];
+    return true;
+#else
+    return false;
+#endif /* LORAMAC_CHANNEL_QUALITY_ENABLED */
+}
+
+void RegionCommonChannelQualityReset( void )
+{
+#if (defined( LORAMAC_CHANNEL_QUALITY_ENABLED ) && ( LORAMAC_CHANNEL_QUALITY_ENABLED == 1 ))
+    for( uint8_t i = 0; i < REGION_NVM_MAX_NB_CHANNELS; i++ )
+    {
+        ChannelQuality[i].NbAckReceived = 0;
+        ChannelQuality[i].NbAckMissed = 0;
+        ChannelQuality[i].Score = CHANNEL_QUALITY_SCORE_INIT;
+    }
+#endif /* LORAMAC_CHANNEL_QUALITY_ENABLED */
+}
+
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+/*!
+ * \brief Gets the busy score of a channel, decayed up to now
+ */
+static uint8_t LbtGetBusyScore( uint8_t channel, TimerTime_t now )
+{
+    uint32_t periods = 0;
+
+    if( channel >= LBT_MAX_NB_CHANNELS )
+    {
+        return 0;
+    }
+    periods = ( now - LbtChannels[channel].LastSenseTime ) / LBT_BUSY_SCORE_DECAY_PERIOD;
+    if( periods >= 8 )
+    {
+        return 0;
+    }
+    return LbtChannels[channel].BusyScore >> periods;
+}
+
+/*!
+ * \brief Records the result of a carrier sense
+ */
+static void LbtUpdateBusyScore( uint8_t channel, bool isChannelFree, TimerTime_t now )
+{
+    uint8_t score = 0;
+
+    if( channel >= LBT_MAX_NB_CHANNELS )
+    {
+        return;
+    }
+    score = LbtGetBusyScore( channel, now );
+    if( isChannelFree == true )
+    {
+        score -= ( uint8_t )( score / 2 );
+    }
+    else
+    {
+        score += ( uint8_t )( ( 255 - score ) / 2 );
+    }
+    LbtChannels[channel].BusyScore = score;
+    LbtChannels[channel].LastSenseTime = now;
+}
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+
+LoRaMacStatus_t RegionCommonLbtFindFreeChannel( RegionCommonLbtParams_t* lbtParams, const uint8_t* enabledChannels,
+                                                uint8_t nbEnabledChannels, uint8_t* channel )
+{
+    uint8_t start = RegionCommonSelectChannel( enabledChannels, nbEnabledChannels );
+    uint8_t channelNext = 0;
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+    TimerTime_t now = TimerGetCurrentTime( );
+    uint8_t order[LBT_MAX_NB_CHANNELS];
+    uint8_t scores[LBT_MAX_NB_CHANNELS];
+    uint8_t nbOrdered = MIN( nbEnabledChannels, LBT_MAX_NB_CHANNELS );
+
+    // Least busy channels first, the stable sort keeps the random start among equal scores
+    for( uint8_t i = 0; i < nbOrdered; i++ )
+    {
+        uint8_t id = enabledChannels[( start + i ) % nbEnabledChannels];
+        uint8_t score = LbtGetBusyScore( id, now );
+        uint8_t j = i;
+
+        for( ; ( j > 0 ) && ( scores[j - 1] > score ); j-- )
+        {
+            order[j] = order[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        order[j] = id;
+        scores[j] = score;
+    }
+    LbtStats.NbSearches++;
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+
+    for( uint8_t i = 0; i < lbtParams->MaxNbAttempts; i++ )
+    {
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+        channelNext = ( nbEnabledChannels <= LBT_MAX_NB_CHANNELS ) ? order[i % nbEnabledChannels] :
+                                                                     enabledChannels[( start + i ) % nbEnabledChannels];
+#else
+        channelNext = enabledChannels[( start + i ) % nbEnabledChannels];
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+
+        // Perform carrier sense for CarrierSenseTime
+        // If the channel is free, we can stop the LBT mechanism
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_CAD, -1, -1 );
+        bool isChannelFree = Radio.IsChannelFree( lbtParams->Channels[channelNext].Frequency, lbtParams->RxBandwidth,
+                                                  lbtParams->RssiFreeThreshold, lbtParams->CarrierSenseTime );
+        LORAMAC_ENERGY_SET_STATE( LORAMAC_ENERGY_STATE_IDLE, 0, 0 );
+        // The carrier sense reconfigures the radio
+        RegionCommonRadioShadowInvalidate( );
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+        LbtStats.NbCarrierSenses++;
+        LbtUpdateBusyScore( channelNext, isChannelFree, now );
+        if( isChannelFree == false )
+        {
+            LbtStats.NbBusy++;
+        }
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+        if( isChannelFree == true )
+        {
+            // Free channel found
+            *channel = channelNext;
+            return LORAMAC_STATUS_OK;
+        }
+    }
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+    LbtStats.NbNoFreeChannel++;
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+    return LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND;
+}
+
+bool RegionCommonLbtGetStats( RegionCommonLbtStats_t* stats )
+{
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+    if( stats == NULL )
+    {
+        return false;
+    }
+    *stats = LbtStats;
+    return true;
+#else
+    return false;
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+}
+
+void RegionCommonLbtReset( void )
+{
+#if (defined( LORAMAC_LBT_ADAPTIVE_ENABLED ) && ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ))
+    memset1( ( uint8_t* )LbtChannels, 0, sizeof( LbtChannels ) );
+    memset1( ( uint8_t* )&LbtStats, 0, sizeof( LbtStats ) );
+#endif /* LORAMAC_LBT_ADAPTIVE_ENABLED */
+}
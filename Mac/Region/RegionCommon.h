@@ -52,6 +52,7 @@ extern "C"
 {
 #endif
 
+#include "radio.h"
 #include "LoRaMacInterfaces.h"
 #include "LoRaMacHeaderTypes.h"
 #include "RegionNvm.h"
@@ -320,6 +321,15 @@ typedef struct sRegionCommonIdentifyChannelsParam
      * Pointer to a structure of RegionCommonCountNbOfEnabledChannelsParams_t.
      */
     RegionCommonCountNbOfEnabledChannelsParams_t* CountNbOfEnabledChannelsParam;
+    /*!
+     * Set to true to evaluate the bands on a copy. The bands are left untouched.
+     */
+    bool QueryOnly;
+    /*!
+     * Highest time credits of the bands of the enabled channels. Output, only
+     * set when QueryOnly is true.
+     */
+    TimerTime_t TimeCredits;
 }RegionCommonIdentifyChannelsParam_t;
 
 typedef struct sRegionCommonSetDutyCycleParams
@@ -348,6 +358,112 @@ typedef struct sRegionCommonGetNextLowerTxDrParams
     ChannelParams_t* Channels;
 }RegionCommonGetNextLowerTxDrParams_t;
 
+/*!
+ * Counters of the radio configuration shadow
+ */
+typedef struct sRegionCommonRadioShadowStats
+{
+    /*!
+     * Radio.SetChannel calls forwarded to the radio / skipped
+     */
+    uint32_t ChannelApplied;
+    uint32_t ChannelSkipped;
+    /*!
+     * Radio.SetRxConfig calls forwarded to the radio / skipped
+     */
+    uint32_t RxConfigApplied;
+    uint32_t RxConfigSkipped;
+    /*!
+     * Radio.SetTxConfig calls forwarded to the radio / skipped
+     */
+    uint32_t TxConfigApplied;
+    uint32_t TxConfigSkipped;
+    /*!
+     * Radio.SetMaxPayloadLength calls forwarded to the radio / skipped
+     */
+    uint32_t MaxPayloadApplied;
+    uint32_t MaxPayloadSkipped;
+}RegionCommonRadioShadowStats_t;
+
+/*!
+ * Channel selection strategy.
+ *
+ * \param [in] enabledChannels   Channels available for the transmission
+ * \param [in] nbEnabledChannels Number of available channels, at least 1
+ *
+ * \retval Index in enabledChannels of the channel to use
+ */
+typedef uint8_t ( *RegionCommonChannelSelector_t )( const uint8_t* enabledChannels, uint8_t nbEnabledChannels );
+
+/*!
+ * Quality record of a channel
+ */
+typedef struct sRegionCommonChannelQuality
+{
+    /*!
+     * Number of confirmed uplinks acknowledged
+     */
+    uint16_t NbAckReceived;
+    /*!
+     * Number of confirmed uplinks without acknowledgement
+     */
+    uint16_t NbAckMissed;
+    /*!
+     * Selection weight of the channel, from 0 ( always missed ) to 255 ( always acknowledged )
+     */
+    uint8_t Score;
+}RegionCommonChannelQuality_t;
+
+/*!
+ * Parameters of a listen before talk channel search
+ */
+typedef struct sRegionCommonLbtParams
+{
+    /*!
+     * A pointer to the channels
+     */
+    ChannelParams_t* Channels;
+    /*!
+     * Receiver bandwidth of the carrier sense [Hz]
+     */
+    uint32_t RxBandwidth;
+    /*!
+     * RSSI threshold for a free channel [dBm]
+     */
+    int16_t RssiFreeThreshold;
+    /*!
+     * Duration of a carrier sense [ms]
+     */
+    uint32_t CarrierSenseTime;
+    /*!
+     * Maximum number of carrier senses of the search
+     */
+    uint8_t MaxNbAttempts;
+}RegionCommonLbtParams_t;
+
+/*!
+ * Listen before talk statistics
+ */
+typedef struct sRegionCommonLbtStats
+{
+    /*!
+     * Number of channel searches
+     */
+    uint32_t NbSearches;
+    /*!
+     * Number of carrier senses performed
+     */
+    uint32_t NbCarrierSenses;
+    /*!
+     * Number of carrier senses which found the channel busy
+     */
+    uint32_t NbBusy;
+    /*!
+     * Number of searches without any free channel
+     */
+    uint32_t NbNoFreeChannel;
+}RegionCommonLbtStats_t;
+
 /*!
  * \brief Verifies, if a value is in a given range.
  *        This is a generic function and valid for all regions.
@@ -512,6 +628,69 @@ uint32_t RegionCommonComputeSymbolTimeLoRa( uint8_t phyDr, uint32_t bandwidthInH
  */
 uint32_t RegionCommonComputeSymbolTimeFsk( uint8_t phyDrInKbps );
 
+/*!
+ * \brief Computes the time on air of a LoRa frame, without any radio access.
+ *        Same integer formula and rounding as the radio drivers.
+ *
+ * \param [in] bandwidth Bandwidth index: [0: 125 kHz, 1: 250 kHz, 2: 500 kHz].
+ *
+ * \param [in] spreadingFactor Spreading factor [5: 12].
+ *
+ * \param [in] coderate Coding rate [1: 4/5, 2: 4/6, 3: 4/7, 4: 4/8].
+ *
+ * \param [in] preambleLen Preamble length in symbols.
+ *
+ * \param [in] fixLen Set to true for the implicit header mode.
+ *
+ * \param [in] payloadLen Payload length in bytes.
+ *
+ * \param [in] crcOn Set to true when the payload CRC is present.
+ *
+ * \retval Returns the time on air in milliseconds, rounded up.
+ */
+TimerTime_t RegionCommonComputeTimeOnAirLoRa( uint32_t bandwidth, uint32_t spreadingFactor, uint8_t coderate,
+                                              uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn );
+
+/*!
+ * \brief Computes the time on air of a FSK frame, without any radio access.
+ *        Same integer formula and rounding as the radio drivers.
+ *
+ * \param [in] datarate Datarate in bits per second.
+ *
+ * \param [in] preambleLen Preamble length in bytes.
+ *
+ * \param [in] fixLen Set to true for the fixed length packets.
+ *
+ * \param [in] payloadLen Payload length in bytes.
+ *
+ * \param [in] crcOn Set to true when the payload CRC is present.
+ *
+ * \retval Returns the time on air in milliseconds, rounded up.
+ */
+TimerTime_t RegionCommonComputeTimeOnAirFsk( uint32_t datarate, uint16_t preambleLen, bool fixLen,
+                                             uint8_t payloadLen, bool crcOn );
+
+/*!
+ * \brief Gets the time on air of an uplink frame sent with the regional settings
+ *        (LoRa: coding rate 4/5, 8 symbols preamble, FSK: 5 bytes preamble, CRC on).
+ *        Served from a table indexed by datarate and length when
+ *        REGION_TIME_ON_AIR_TABLE_ENABLED is set.
+ *
+ * \param [in] datarate Datarate index of the region.
+ *
+ * \param [in] modem Modem of the datarate.
+ *
+ * \param [in] phyDr Physical datarate: spreading factor for LoRa, kbps for FSK.
+ *
+ * \param [in] bandwidth Bandwidth index, see \ref RegionCommonGetBandwidth.
+ *
+ * \param [in] pktLen Frame length in bytes.
+ *
+ * \retval Returns the time on air in milliseconds.
+ */
+TimerTime_t RegionCommonGetUplinkTimeOnAir( int8_t datarate, RadioModems_t modem, uint8_t phyDr,
+                                            uint32_t bandwidth, uint16_t pktLen );
+
 /*!
  * \brief Computes the RX window timeout and the RX window offset.
  *
@@ -650,6 +829,155 @@ void RegionCommonRxConfigPrint(LoRaMacRxSlot_t rxSlot,
  *
  */
 void RegionCommonTxConfigPrint(uint32_t frequency, int8_t dr);
+
+/*!
+ * \brief Sets the radio channel. The radio is only accessed if the frequency
+ *        differs from the last applied one, see \ref LORAMAC_RADIO_SHADOW_ENABLED.
+ *
+ * \param [in] freq Channel RF frequency
+ */
+void RegionCommonRadioSetChannel( uint32_t freq );
+
+/*!
+ * \brief Sets the radio reception parameters. The radio is only accessed if
+ *        the parameters differ from the last applied reception configuration.
+ *        Parameters are the ones of Radio.SetRxConfig.
+ */
+void RegionCommonRadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth,
+                                   uint32_t datarate, uint8_t coderate,
+                                   uint32_t bandwidthAfc, uint16_t preambleLen,
+                                   uint16_t symbTimeout, bool fixLen,
+                                   uint8_t payloadLen,
+                                   bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                                   bool iqInverted, bool rxContinuous );
+
+/*!
+ * \brief Sets the radio transmission parameters. The radio is only accessed if
+ *        the parameters differ from the last applied transmission configuration.
+ *        Parameters are the ones of Radio.SetTxConfig.
+ */
+void RegionCommonRadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev,
+                                   uint32_t bandwidth, uint32_t datarate,
+                                   uint8_t coderate, uint16_t preambleLen,
+                                   bool fixLen, bool crcOn, bool freqHopOn,
+                                   uint8_t hopPeriod, bool iqInverted, uint32_t timeout );
+
+/*!
+ * \brief Sets the radio maximum payload length. The radio is only accessed if
+ *        the value differs or if the modem has been reconfigured meanwhile.
+ *
+ * \param [in] modem Radio modem to be used
+ *
+ * \param [in] max   Maximum payload length in bytes
+ */
+void RegionCommonRadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max );
+
+/*!
+ * \brief Forgets the radio configuration shadow. Must be called whenever the
+ *        radio is configured without the RegionCommonRadioSet functions
+ *        ( Radio.Init, Radio.IsChannelFree, Radio.SetTxContinuousWave, ... ).
+ */
+void RegionCommonRadioShadowInvalidate( void );
+
+/*!
+ * \brief Gets the counters of the radio configuration shadow
+ *
+ * \param [out] stats Applied and skipped radio configurations
+ */
+void RegionCommonRadioShadowGetStats( RegionCommonRadioShadowStats_t* stats );
+
+/*!
+ * \brief Sets the channel selection strategy used by the regions among the
+ *        enabled channels. The strategy must keep a random selection among
+ *        the enabled channels to comply with the regional parameters.
+ *
+ * \param [in] selector Selection strategy, NULL restores the default selection:
+ *                      \ref RegionCommonChannelSelectorQualityAware, which is
+ *                      the uniform random selection unless
+ *                      LORAMAC_CHANNEL_QUALITY_ENABLED is set to 1
+ */
+void RegionCommonSetChannelSelector( RegionCommonChannelSelector_t selector );
+
+/*!
+ * \brief Selects the channel of the next transmission with the configured strategy
+ *
+ * \param [in] enabledChannels   Channels available for the transmission
+ * \param [in] nbEnabledChannels Number of available channels, at least 1
+ *
+ * \retval Index in enabledChannels of the channel to use
+ */
+uint8_t RegionCommonSelectChannel( const uint8_t* enabledChannels, uint8_t nbEnabledChannels );
+
+/*!
+ * \brief Channel selection strategy weighting the random selection with the
+ *        acknowledgement success of each channel. Every enabled channel keeps
+ *        a minimum probability of selection. Falls back to the uniform random
+ *        selection when LORAMAC_CHANNEL_QUALITY_ENABLED is not set to 1.
+ *
+ * \param [in] enabledChannels   Channels available for the transmission
+ * \param [in] nbEnabledChannels Number of available channels, at least 1
+ *
+ * \retval Index in enabledChannels of the channel to use
+ */
+uint8_t RegionCommonChannelSelectorQualityAware( const uint8_t* enabledChannels, uint8_t nbEnabledChannels );
+
+/*!
+ * \brief Records the outcome of a confirmed uplink sent on a channel. The MAC
+ *        calls it once per transmission: acknowledged, or missed when no
+ *        downlink with the ACK bit is received in RX1 nor RX2.
+ *
+ * \param [in] channel     Channel id of the uplink
+ * \param [in] ackReceived Set to true when the uplink has been acknowledged
+ */
+void RegionCommonChannelQualityUpdate( uint8_t channel, bool ackReceived );
+
+/*!
+ * \brief Gets the quality record of a channel
+ *
+ * \param [in]  channel Channel id
+ * \param [out] quality Quality record of the channel
+ *
+ * \retval Returns true when the record is available
+ */
+bool RegionCommonChannelQualityGet( uint8_t channel, RegionCommonChannelQuality_t* quality );
+
+/*!
+ * \brief Forgets the quality records of all channels
+ */
+void RegionCommonChannelQualityReset( void );
+
+/*!
+ * \brief Searches a free channel with carrier senses among the enabled channels.
+ *        The search starts with the channel picked by \ref RegionCommonSelectChannel.
+ *        When LORAMAC_LBT_ADAPTIVE_ENABLED is set, the channels found busy
+ *        recently are sensed last.
+ *
+ * \param [in]  lbtParams         Carrier sense parameters
+ * \param [in]  enabledChannels   Channels available for the transmission
+ * \param [in]  nbEnabledChannels Number of available channels, at least 1
+ * \param [out] channel           Free channel found
+ *
+ * \retval Possible returns are:
+ *         \ref LORAMAC_STATUS_OK,
+ *         \ref LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND.
+ */
+LoRaMacStatus_t RegionCommonLbtFindFreeChannel( RegionCommonLbtParams_t* lbtParams, const uint8_t* enabledChannels,
+                                                uint8_t nbEnabledChannels, uint8_t* channel );
+
+/*!
+ * \brief Gets the listen before talk statistics
+ *
+ * \param [out] stats Statistics
+ *
+ * \retval Returns true when the statistics are available
+ */
+bool RegionCommonLbtGetStats( RegionCommonLbtStats_t* stats );
+
+/*!
+ * \brief Forgets the channels busy history and resets the statistics
+ */
+void RegionCommonLbtReset( void );
+
 /*! \} defgroup REGIONCOMMON */
 
 #ifdef __cplusplus
@@ -54,7 +54,34 @@ typedef enum eRegionCN470ChannelPlan
     CHANNEL_PLAN_26MHZ_TYPE_A,
     CHANNEL_PLAN_26MHZ_TYPE_B
 }RegionCN470ChannelPlan_t;
+#endif /* REGION_VERSION */
+
+#if (defined( REGION_NVM_SIZED_BY_REGIONS ) && ( REGION_NVM_SIZED_BY_REGIONS == 1 ))
+// Selection of REGION_NVM_MAX_NB_CHANNELS among the enabled regions
+#if defined( REGION_CN470 ) && (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
+#define REGION_NVM_MAX_NB_CHANNELS                 96
+#elif defined( REGION_US915 ) || defined( REGION_AU915 ) || defined( REGION_CN470 )
+#define REGION_NVM_MAX_NB_CHANNELS                 72
+#else
+#define REGION_NVM_MAX_NB_CHANNELS                 16
+#endif /* REGION_CN470 */
+
+// Selection of REGION_NVM_MAX_NB_BANDS among the enabled regions
+#if defined( REGION_EU868 )
+#define REGION_NVM_MAX_NB_BANDS                    6
+#else
+#define REGION_NVM_MAX_NB_BANDS                    1
+#endif /* REGION_EU868 */
+
+// Selection of REGION_NVM_CHANNELS_MASK_SIZE among the enabled regions
+#if defined( REGION_US915 ) || defined( REGION_AU915 ) || defined( REGION_CN470 )
+#define REGION_NVM_CHANNELS_MASK_SIZE              6
+#else
+#define REGION_NVM_CHANNELS_MASK_SIZE              1
+#endif /* REGION_US915 || REGION_AU915 || REGION_CN470 */
 
+#else
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
 // Selection of REGION_NVM_MAX_NB_CHANNELS ( MAX = REGION_US915 | REGION_AU915 )
 #define REGION_NVM_MAX_NB_CHANNELS                 72
 
@@ -69,12 +96,36 @@ typedef enum eRegionCN470ChannelPlan
 
 // Selection of REGION_NVM_CHANNELS_MASK_SIZE
 #define REGION_NVM_CHANNELS_MASK_SIZE              6
+#endif /* REGION_NVM_SIZED_BY_REGIONS */
+
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+#define REGION_NVM_LAYOUT_JOIN_SWEEP               1
+#else
+#define REGION_NVM_LAYOUT_JOIN_SWEEP               0
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
+
+/*!
+ * Identifier of the region NVM layout, stored in the region sized contexts.
+ * Covers the array sizes and the optional members of the region groups.
+ */
+#define REGION_NVM_LAYOUT_TAG                      ( ( ( uint32_t )REGION_NVM_LAYOUT_JOIN_SWEEP << 24 ) |  \
+                                                     ( ( uint32_t )REGION_NVM_MAX_NB_CHANNELS << 16 ) |    \
+                                                     ( ( uint32_t )REGION_NVM_MAX_NB_BANDS << 8 ) |        \
+                                                     ( uint32_t )REGION_NVM_CHANNELS_MASK_SIZE )
 
 /*!
  * Region specific data which must be stored in the NVM.
  */
 typedef struct sRegionNvmDataGroup1
 {
+#if (defined( REGION_NVM_SIZED_BY_REGIONS ) && ( REGION_NVM_SIZED_BY_REGIONS == 1 ))
+    /*!
+     * Layout of the stored context, REGION_NVM_LAYOUT_TAG of the build which
+     * stored it. Kept first of the first region group: its offset in the NVM
+     * data only depends on the MAC groups, not on the enabled regions.
+     */
+    uint32_t LayoutTag;
+#endif /* REGION_NVM_SIZED_BY_REGIONS */
 #if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
     /*!
      * LoRaMac bands
@@ -97,6 +148,15 @@ typedef struct sRegionNvmDataGroup1
      * Counter of join trials needed to alternate between datarates.
      */
     uint8_t JoinTrialsCounter;
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+    /*!
+     * Sub-band order of the current join sweep, one sub-band per nibble.
+     * JoinChannelGroupsCurrentIndex is the position in this order.
+     * REGION_BASE_US_JOIN_ORDER_UNPLANNED until the first join request of
+     * the sweep.
+     */
+    uint32_t JoinSubBandOrder;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
 #endif
     /*!
      * CRC32 value of the Region data structure.
@@ -126,7 +126,22 @@ static TimerTime_t GetTimeOnAir( int8_t datarate, uint16_t pktLen )
     int8_t phyDr = DataratesUS915[datarate];
     uint32_t bandwidth = RegionCommonGetBandwidth( datarate, BandwidthsUS915 );
 
-    return Radio.TimeOnAir( MODEM_LORA, bandwidth, phyDr, 1, 8, false, pktLen, true );
+    return RegionCommonGetUplinkTimeOnAir( datarate, MODEM_LORA, phyDr, bandwidth, pktLen );
+}
+
+static uint32_t GetJoinSubBandOrder( void )
+{
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+    // Planned at the first join request of the sweep, once the MAC has
+    // seeded the random generator
+    if( RegionNvmGroup1->JoinSubBandOrder == REGION_BASE_US_JOIN_ORDER_UNPLANNED )
+    {
+        RegionNvmGroup1->JoinSubBandOrder = RegionBaseUSComputeJoinSweepOrder( );
+    }
+    return RegionNvmGroup1->JoinSubBandOrder;
+#else
+    return REGION_BASE_US_JOIN_ORDER_SEQUENTIAL;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
 }
 #endif /* REGION_US915 */
 
@@ -396,6 +411,9 @@ void RegionUS915InitDefaults( InitDefaultsParams_t* params )
 #if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
             // Initialize 8 bit channel groups index
             RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+            RegionNvmGroup1->JoinSubBandOrder = REGION_BASE_US_JOIN_ORDER_UNPLANNED;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
 
             // Initialize the join trials counter
             RegionNvmGroup1->JoinTrialsCounter = 0;
@@ -407,6 +425,9 @@ void RegionUS915InitDefaults( InitDefaultsParams_t* params )
 
             // Initialize 8 bit channel groups index
             RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+            RegionNvmGroup1->JoinSubBandOrder = REGION_BASE_US_JOIN_ORDER_UNPLANNED;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
 
             // Initialize the join trials counter
             RegionNvmGroup1->JoinTrialsCounter = 0;
@@ -637,10 +658,10 @@ bool RegionUS915RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
     // Read the physical datarate from the datarates table
     phyDr = DataratesUS915[dr];
 
-    Radio.SetChannel( frequency );
+    RegionCommonRadioSetChannel( frequency );
 
     // Radio configuration
-    Radio.SetRxConfig( MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
+    RegionCommonRadioSetRxConfig( MODEM_LORA, rxConfig->Bandwidth, phyDr, 1, 0, 8, rxConfig->WindowTimeout, false, 0, false, 0, 0, true, rxConfig->RxContinuous );
 
     if( rxConfig->RepeaterSupport == true )
     {
@@ -651,7 +672,7 @@ bool RegionUS915RxConfig( RxConfigParams_t* rxConfig, int8_t* datarate )
         maxPayload = MaxPayloadOfDatarateUS915[dr];
     }
 
-    Radio.SetMaxPayloadLength( MODEM_LORA, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, maxPayload + LORAMAC_FRAME_PAYLOAD_OVERHEAD_SIZE );
 
     RegionCommonRxConfigPrint(rxConfig->RxSlot, frequency, dr);
 
@@ -679,13 +700,13 @@ bool RegionUS915TxConfig( TxConfigParams_t* txConfig, int8_t* txPower, TimerTime
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, US915_DEFAULT_MAX_ERP, 0 );
 
     // Setup the radio frequency
-    Radio.SetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
+    RegionCommonRadioSetChannel( RegionNvmGroup2->Channels[txConfig->Channel].Frequency );
 
-    Radio.SetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
+    RegionCommonRadioSetTxConfig( MODEM_LORA, phyTxPower, 0, bandwidth, phyDr, 1, 8, false, true, 0, 0, false, 4000 );
     RegionCommonTxConfigPrint(RegionNvmGroup2->Channels[txConfig->Channel].Frequency, txConfig->Datarate);
 
     // Setup maximum payload length of the radio driver
-    Radio.SetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
+    RegionCommonRadioSetMaxPayloadLength( MODEM_LORA, txConfig->PktLen );
 
     // Update time-on-air
     *txTimeOnAir = GetTimeOnAir( txConfig->Datarate, txConfig->PktLen );
@@ -953,26 +974,42 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
     RegionCommonCountNbOfEnabledChannelsParams_t countChannelsParams;
     LoRaMacStatus_t status = LORAMAC_STATUS_NO_CHANNEL_FOUND;
 
+    uint16_t channelsMaskRemaining[CHANNELS_MASK_SIZE];
+    uint16_t* channelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
+
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Work on a copy, the remaining channels are only consumed by a transmission
+        RegionCommonChanMaskCopy( channelsMaskRemaining, RegionNvmGroup1->ChannelsMaskRemaining, CHANNELS_MASK_SIZE );
+        channelsMask = channelsMaskRemaining;
+    }
+
     // Count 125kHz channels
-    if( RegionCommonCountChannels( RegionNvmGroup1->ChannelsMaskRemaining, 0, 4 ) == 0 )
+    if( RegionCommonCountChannels( channelsMask, 0, 4 ) == 0 )
     { // Reactivate default channels
-        RegionCommonChanMaskCopy( RegionNvmGroup1->ChannelsMaskRemaining, RegionNvmGroup2->ChannelsMask, 4  );
+        RegionCommonChanMaskCopy( channelsMask, RegionNvmGroup2->ChannelsMask, 4  );
 
-        RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+        if( nextChanParams->QueryOnly == false )
+        {
+            RegionNvmGroup1->JoinChannelGroupsCurrentIndex = 0;
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+            RegionNvmGroup1->JoinSubBandOrder = REGION_BASE_US_JOIN_ORDER_UNPLANNED;
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
+        }
     }
     // Check other channels
     if( nextChanParams->Datarate >= DR_4 )
     {
-        if( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) == 0 )
+        if( ( channelsMask[4] & CHANNELS_MASK_500KHZ_MASK ) == 0 )
         {
-            RegionNvmGroup1->ChannelsMaskRemaining[4] = RegionNvmGroup2->ChannelsMask[4];
+            channelsMask[4] = RegionNvmGroup2->ChannelsMask[4];
         }
     }
 
     // Search how many channels are enabled
     countChannelsParams.Joined = nextChanParams->Joined;
     countChannelsParams.Datarate = nextChanParams->Datarate;
-    countChannelsParams.ChannelsMask = RegionNvmGroup1->ChannelsMaskRemaining;
+    countChannelsParams.ChannelsMask = channelsMask;
     countChannelsParams.Channels = RegionNvmGroup2->Channels;
 #if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
     countChannelsParams.Bands = RegionNvmGroup1->Bands;
@@ -993,8 +1030,10 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
     identifyChannelsParam.ExpectedTimeOnAir = GetTimeOnAir( nextChanParams->Datarate, nextChanParams->PktLen );
 
     identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+    identifyChannelsParam.QueryOnly = nextChanParams->QueryOnly;
 #elif (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
     identifyChannelsParam.CountNbOfEnabledChannelsParam = &countChannelsParams;
+    identifyChannelsParam.QueryOnly = nextChanParams->QueryOnly;
 
     identifyChannelsParam.ElapsedTimeSinceStartUp = nextChanParams->ElapsedTimeSinceStartUp;
     identifyChannelsParam.LastTxIsJoinRequest = nextChanParams->LastTxIsJoinRequest;
@@ -1004,12 +1043,20 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
     status = RegionCommonIdentifyChannels( &identifyChannelsParam, aggregatedTimeOff, enabledChannels,
                                            &nbEnabledChannels, &nbRestrictedChannels, time );
 
+    if( nextChanParams->QueryOnly == true )
+    {
+        // Report the availability only, no channel is selected
+        nextChanParams->TimeOnAir = identifyChannelsParam.ExpectedTimeOnAir;
+        nextChanParams->TimeCredits = identifyChannelsParam.TimeCredits;
+        return status;
+    }
+
     if( status == LORAMAC_STATUS_OK )
     {
         if( nextChanParams->Joined == true )
         {
             // Choose randomly on of the remaining channels
-            *channel = enabledChannels[randr( 0, nbEnabledChannels - 1 )];
+            *channel = enabledChannels[RegionCommonSelectChannel( enabledChannels, nbEnabledChannels )];
         }
         else
         {
@@ -1021,7 +1068,7 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
             // 125kHz Channels (0 - 63) DR0
             if( nextChanParams->Datarate == DR_0 )
             {
-                if( RegionBaseUSComputeNext125kHzJoinChannel( ( uint16_t* ) RegionNvmGroup1->ChannelsMaskRemaining,
+                if( RegionBaseUSComputeNextJoinChannel( ( uint16_t* ) RegionNvmGroup1->ChannelsMaskRemaining, GetJoinSubBandOrder( ),
                     &RegionNvmGroup1->JoinChannelGroupsCurrentIndex, channel ) == LORAMAC_STATUS_PARAMETER_INVALID )
                 {
                     return LORAMAC_STATUS_PARAMETER_INVALID;
@@ -1031,12 +1078,8 @@ LoRaMacStatus_t RegionUS915NextChannel( NextChanParams_t* nextChanParams, uint8_
             else
             {
                 // Choose the next available channel
-                uint8_t i = 0;
-                while( ( ( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK ) & ( 1 << i ) ) == 0 )
-                {
-                    i++;
-                }
-                *channel = 64 + i;
+                *channel = 64 + RegionBaseUSComputeNext500kHzJoinChannel( RegionNvmGroup1->ChannelsMaskRemaining[4] & CHANNELS_MASK_500KHZ_MASK,
+                                                                          GetJoinSubBandOrder( ) );
             }
         }
 
@@ -1071,6 +1114,7 @@ void RegionUS915SetContinuousWave( ContinuousWaveParams_t* continuousWave )
     phyTxPower = RegionCommonComputeTxPower( txPowerLimited, US915_DEFAULT_MAX_ERP, 0 );
 
     Radio.SetTxContinuousWave( frequency, phyTxPower, continuousWave->Timeout );
+    RegionCommonRadioShadowInvalidate( );
 #endif /* REGION_US915 */
 }
 #endif /* REGION_VERSION */
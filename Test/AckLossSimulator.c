@@ -0,0 +1,390 @@
+/**
+  ******************************************************************************
+  * @file    AckLossSimulator.c
+  * @author  MCD Application Team
+  * @brief   Simulates the loss of the acknowledgements of the confirmed uplinks per channel
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: AckLossSimulator [uplinks] [seed]
+ *
+ * An EU868 end-device, activated by personalization, with the 3 default
+ * channels and 5 added ones, sends confirmed uplinks with up to
+ * SIM_NB_TRANS transmissions each. The acknowledgement of a transmission is
+ * answered in RX1, unless it is lost with the probability of the channel in
+ * AckLossRates. The McpsConfirm of each uplink tells whether it was
+ * acknowledged. The program reports the retransmissions per confirmed
+ * uplink and the share of the transmissions per channel. It is built with
+ * and without LORAMAC_CHANNEL_QUALITY_ENABLED to compare both selections.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "HostPlatform.h"
+#include "ReplayKeys.h"
+#include "cmac.h"
+
+/*!
+ * Longest simulated time waited for the LoRaMac, in ms
+ */
+#define SIM_MAX_WAIT                                ( 3600 * 1000 )
+
+/*!
+ * Maximum number of transmissions of a confirmed uplink
+ */
+#define SIM_NB_TRANS                                8
+
+/*!
+ * Number of channels of the end-device
+ */
+#define SIM_NB_CHANNELS                             8
+
+/*!
+ * MAC header of an unconfirmed downlink and FCtrl with the ACK bit
+ */
+#define SIM_MHDR_UNCONFIRMED_DOWN                   0x60
+#define SIM_FCTRL_ACK                               0x20
+
+/*!
+ * Channel frequencies: the 3 EU868 default channels and the added ones
+ */
+static const uint32_t Frequencies[SIM_NB_CHANNELS] =
+{
+    868100000, 868300000, 868500000, 867100000, 867300000, 867500000, 867700000, 867900000
+};
+
+/*!
+ * Probability that the acknowledgement of a transmission on the channel is lost, in percent
+ */
+static const uint8_t AckLossRates[SIM_NB_CHANNELS] = { 5, 5, 10, 90, 60, 5, 40, 10 };
+
+static uint8_t AppData[16];
+static uint8_t AckFrame[12];
+static uint32_t FCntDown;
+
+static bool ProcessPending;
+static bool McpsConfirmReceived;
+static bool AckReceived;
+
+static uint32_t Transmissions[SIM_NB_CHANNELS];
+
+static uint8_t DevEui[8] = REPLAY_DEV_EUI;
+static uint8_t JoinEui[8] = REPLAY_JOIN_EUI;
+static uint8_t NwkKey[16] = REPLAY_NWK_KEY;
+static uint8_t AppKey[16] = REPLAY_APP_KEY;
+static uint8_t NwkSKey[16] = REPLAY_NWK_S_KEY;
+static uint8_t AppSKey[16] = REPLAY_APP_S_KEY;
+
+static void OnMcpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    McpsConfirmReceived = true;
+    AckReceived = mcpsConfirm->AckReceived;
+}
+
+static void OnMcpsIndication( McpsIndication_t* mcpsIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+}
+
+static void OnMlmeIndication( MlmeIndication_t* mlmeIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives =
+{
+    .MacMcpsConfirm = OnMcpsConfirm,
+    .MacMcpsIndication = OnMcpsIndication,
+    .MacMlmeConfirm = OnMlmeConfirm,
+    .MacMlmeIndication = OnMlmeIndication,
+};
+
+static LoRaMacCallback_t Callbacks =
+{
+    .MacProcessNotify = OnMacProcessNotify,
+};
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 2 );
+}
+
+static void SetMib( Mib_t type, MibRequestConfirm_t* mib )
+{
+    LoRaMacStatus_t status;
+
+    mib->Type = type;
+    status = LoRaMacMibSetRequestConfirm( mib );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        fprintf( stderr, "MIB %d ", type );
+        Fail( "LoRaMacMibSetRequestConfirm", status );
+    }
+}
+
+static void ProcessMac( void )
+{
+    while( ProcessPending == true )
+    {
+        ProcessPending = false;
+        LoRaMacProcess( );
+    }
+}
+
+/*!
+ * Initializes the LoRaMac of the EU868 end-device, activated by personalization,
+ * with the added channels
+ */
+static void SetupMac( void )
+{
+    MibRequestConfirm_t mib;
+    ChannelParams_t channel;
+    LoRaMacStatus_t status;
+
+    HostPlatformInit( 1 );
+
+    status = LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacInitialization", status );
+    }
+    mib.Param.DevEui = DevEui;
+    SetMib( MIB_DEV_EUI, &mib );
+    mib.Param.JoinEui = JoinEui;
+    SetMib( MIB_JOIN_EUI, &mib );
+    mib.Param.NwkKey = NwkKey;
+    SetMib( MIB_NWK_KEY, &mib );
+    mib.Param.AppKey = AppKey;
+    SetMib( MIB_APP_KEY, &mib );
+
+    status = LoRaMacStart( );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacStart", status );
+    }
+    LoRaMacTestSetDutyCycleOn( false );
+
+    mib.Param.NetID = REPLAY_NET_ID;
+    SetMib( MIB_NET_ID, &mib );
+    mib.Param.DevAddr = REPLAY_DEV_ADDR;
+    SetMib( MIB_DEV_ADDR, &mib );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    mib.Param.FNwkSIntKey = NwkSKey;
+    SetMib( MIB_F_NWK_S_INT_KEY, &mib );
+    mib.Param.SNwkSIntKey = NwkSKey;
+    SetMib( MIB_S_NWK_S_INT_KEY, &mib );
+    mib.Param.NwkSEncKey = NwkSKey;
+    SetMib( MIB_NWK_S_ENC_KEY, &mib );
+    mib.Param.AbpLrWanVersion.Value = 0x01010100;
+    SetMib( MIB_ABP_LORAWAN_VERSION, &mib );
+#else
+    mib.Param.NwkSKey = NwkSKey;
+    SetMib( MIB_NWK_S_KEY, &mib );
+#endif /* LORAMAC_VERSION */
+    mib.Param.AppSKey = AppSKey;
+    SetMib( MIB_APP_S_KEY, &mib );
+    mib.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+    SetMib( MIB_NETWORK_ACTIVATION, &mib );
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    mib.Param.ChannelsNbTrans = SIM_NB_TRANS;
+    SetMib( MIB_CHANNELS_NB_TRANS, &mib );
+#endif /* LORAMAC_VERSION */
+
+    memset( &channel, 0, sizeof( channel ) );
+    channel.DrRange.Fields.Min = DR_0;
+    channel.DrRange.Fields.Max = DR_5;
+    for( uint8_t i = 3; i < SIM_NB_CHANNELS; i++ )
+    {
+        channel.Frequency = Frequencies[i];
+        status = LoRaMacChannelAdd( i, channel );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            Fail( "LoRaMacChannelAdd", status );
+        }
+    }
+    ProcessMac( );
+}
+
+static void PutUint32( uint8_t* buffer, uint32_t value )
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = ( value >> 8 ) & 0xFF;
+    buffer[2] = ( value >> 16 ) & 0xFF;
+    buffer[3] = ( value >> 24 ) & 0xFF;
+}
+
+/*!
+ * Builds the empty downlink acknowledging the last transmitted uplink
+ *
+ * \retval Size of the frame
+ */
+static uint8_t BuildAck( void )
+{
+    const HostRadioStatus_t* radio = HostRadioGetStatus( );
+    AES_CMAC_CTX ctx;
+    uint8_t b0[16] = { 0 };
+    uint8_t digest[16];
+    uint8_t size = 0;
+
+    AckFrame[size++] = SIM_MHDR_UNCONFIRMED_DOWN;
+    PutUint32( &AckFrame[size], REPLAY_DEV_ADDR );
+    size += 4;
+    AckFrame[size++] = SIM_FCTRL_ACK;
+    AckFrame[size++] = FCntDown & 0xFF;
+    AckFrame[size++] = ( FCntDown >> 8 ) & 0xFF;
+
+    b0[0] = 0x49;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    // ConfFCnt: counter of the acknowledged uplink, modulo 2^16
+    b0[1] = radio->TxBuffer[6];
+    b0[2] = radio->TxBuffer[7];
+#else
+    ( void )radio;
+#endif /* LORAMAC_VERSION */
+    b0[5] = 1;
+    PutUint32( &b0[6], REPLAY_DEV_ADDR );
+    PutUint32( &b0[10], FCntDown );
+    b0[15] = size;
+    AES_CMAC_Init( &ctx );
+    AES_CMAC_SetKey( &ctx, NwkSKey );
+    AES_CMAC_Update( &ctx, b0, sizeof( b0 ) );
+    AES_CMAC_Update( &ctx, AckFrame, size );
+    AES_CMAC_Final( digest, &ctx );
+    memcpy( &AckFrame[size], digest, 4 );
+    FCntDown++;
+    return size + 4;
+}
+
+static uint8_t GetChannel( uint32_t frequency )
+{
+    for( uint8_t i = 0; i < SIM_NB_CHANNELS; i++ )
+    {
+        if( Frequencies[i] == frequency )
+        {
+            return i;
+        }
+    }
+    Fail( "Unknown channel", ( int )( frequency / 1000 ) );
+    return 0;
+}
+
+/*!
+ * Sends a confirmed uplink and answers or drops the acknowledgement of each transmission
+ *
+ * \retval Number of transmissions of the uplink
+ */
+static uint8_t SendConfirmed( void )
+{
+    const HostRadioStatus_t* radio = HostRadioGetStatus( );
+    TimerTime_t limit = TimerGetCurrentTime( ) + SIM_MAX_WAIT;
+    uint32_t handledTx = radio->TxCount;
+    uint8_t nbTrans = 0;
+    McpsReq_t mcpsReq;
+    LoRaMacStatus_t status;
+
+    McpsConfirmReceived = false;
+    mcpsReq.Type = MCPS_CONFIRMED;
+    mcpsReq.Req.Confirmed.fPort = 2;
+    mcpsReq.Req.Confirmed.fBuffer = AppData;
+    mcpsReq.Req.Confirmed.fBufferSize = sizeof( AppData );
+    mcpsReq.Req.Confirmed.Datarate = DR_5;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01000300 ))
+    mcpsReq.Req.Confirmed.NbTrials = SIM_NB_TRANS;
+#endif /* LORAMAC_VERSION */
+    status = LoRaMacMcpsRequest( &mcpsReq, false );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcpsRequest", status );
+    }
+
+    ProcessMac( );
+    while( ( McpsConfirmReceived == false ) || ( LoRaMacIsBusy( ) == true ) )
+    {
+        // RX1 of a new transmission, on the uplink channel in EU868
+        if( ( radio->TxCount != handledTx ) && ( radio->State == RF_RX_RUNNING ) )
+        {
+            uint8_t channel = GetChannel( radio->Frequency );
+
+            handledTx = radio->TxCount;
+            nbTrans++;
+            Transmissions[channel]++;
+            if( ( rand( ) % 100 ) >= AckLossRates[channel] )
+            {
+                HostRadioReceive( AckFrame, BuildAck( ), -80, 5 );
+                ProcessMac( );
+                continue;
+            }
+        }
+        if( HostPlatformRunNextEvent( limit ) == false )
+        {
+            Fail( "Confirmed uplink", nbTrans );
+        }
+        ProcessMac( );
+    }
+    return nbTrans;
+}
+
+int main( int argc, char** argv )
+{
+    uint32_t uplinks = 1000;
+    uint32_t acknowledged = 0;
+    uint32_t retransmissions = 0;
+    uint32_t transmissions = 0;
+
+    if( argc > 1 )
+    {
+        uplinks = ( uint32_t )atoi( argv[1] );
+    }
+    srand( ( argc > 2 ) ? ( unsigned int )atoi( argv[2] ) : 1 );
+
+    SetupMac( );
+    for( uint32_t i = 0; i < uplinks; i++ )
+    {
+        uint8_t nbTrans = SendConfirmed( );
+
+        if( nbTrans == 0 )
+        {
+            Fail( "Uplink transmission", ( int )i );
+        }
+        retransmissions += nbTrans - 1;
+        if( AckReceived == true )
+        {
+            acknowledged++;
+        }
+    }
+
+    printf( "LoRaWAN 0x%08X, channel quality %s, %u confirmed uplinks, up to %d transmissions\n", LORAMAC_VERSION,
+            ( LORAMAC_CHANNEL_QUALITY_ENABLED == 1 ) ? "on" : "off", uplinks, SIM_NB_TRANS );
+    printf( "%-8s %10s %8s %8s\n", "channel", "frequency", "loss %", "tx %" );
+    for( uint8_t i = 0; i < SIM_NB_CHANNELS; i++ )
+    {
+        transmissions += Transmissions[i];
+    }
+    for( uint8_t i = 0; i < SIM_NB_CHANNELS; i++ )
+    {
+        printf( "%-8u %10u %8u %8.1f\n", i, Frequencies[i], AckLossRates[i], 100.0 * Transmissions[i] / transmissions );
+    }
+    printf( "acknowledged %u/%u, retransmissions per confirmed uplink %.3f\n", acknowledged, uplinks,
+            ( double )retransmissions / uplinks );
+    return 0;
+}
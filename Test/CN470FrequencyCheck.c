@@ -0,0 +1,238 @@
+/**
+  ******************************************************************************
+  * @file    CN470FrequencyCheck.c
+  * @author  MCD Application Team
+  * @brief   Checks the CN470 downlink frequencies of the four channel plans on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: CN470FrequencyCheck
+ *
+ * Compares the RX1 frequency of every channel of the four CN470 channel plans,
+ * 20 MHz and 26 MHz, type A and type B, with the formula of the regional
+ * parameters: first downlink frequency of the group plus 200 kHz per channel.
+ * Past RP002-1.0.0, it also configures the reception windows through
+ * RegionRxConfig after a join on each of the 20 common join channels, and
+ * after a channel plan restored from the NVM: the RX1 frequency set on the
+ * radio must be the one of the plan of the join channel, and the RX2 frequency
+ * the one of the plan for an OTAA end-device.
+ * It is built with and without REGION_CN470_FREQUENCY_TABLES_ENABLED and
+ * returns 1 on any mismatch.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Region.h"
+#include "RegionCommon.h"
+#include "RegionCN470.h"
+#include "RegionCN470A20.h"
+#include "RegionCN470B20.h"
+#include "RegionCN470A26.h"
+#include "RegionCN470B26.h"
+#include "HostPlatform.h"
+
+/*!
+ * Number of common join channels, 8 of the 20 MHz type A plan, 2 of the type B
+ * one, then 5 of each 26 MHz plan
+ */
+#define CHECK_NB_JOIN_CHANNELS                      20
+
+/*!
+ * Channel plan under check
+ */
+typedef struct sCheckedPlan
+{
+    const char* Name;
+    uint8_t NbChannels;
+    /*!
+     * First RX1 frequency of the channels 0 to 31, and of the channels 32 to 63
+     * for the 20 MHz plans. The 26 MHz plans have 24 downlink channels for 48
+     * uplink ones.
+     */
+    uint32_t FirstRx1Frequency[2];
+    uint32_t ( *GetRx1Frequency )( uint8_t channel );
+    uint32_t ( *GetRx2Frequency )( uint8_t joinChannelIndex, bool isOtaaDevice );
+}CheckedPlan_t;
+
+/*!
+ * The four plans, in the order of RegionCN470ChannelPlan_t past CHANNEL_PLAN_UNKNOWN
+ */
+static const CheckedPlan_t Plans[] =
+{
+    { "20 MHz A", 64, { 483900000, 490300000 }, RegionCN470A20GetRx1Frequency, RegionCN470A20GetRx2Frequency },
+    { "20 MHz B", 64, { 476900000, 496900000 }, RegionCN470B20GetRx1Frequency, RegionCN470B20GetRx2Frequency },
+    { "26 MHz A", 48, { 490100000, 490100000 }, RegionCN470A26GetRx1Frequency, RegionCN470A26GetRx2Frequency },
+    { "26 MHz B", 48, { 500100000, 500100000 }, RegionCN470B26GetRx1Frequency, RegionCN470B26GetRx2Frequency },
+};
+
+#define CHECK_NB_PLANS                              ( sizeof( Plans ) / sizeof( Plans[0] ) )
+
+static uint32_t Mismatches;
+
+static void Mismatch( const char* what, const CheckedPlan_t* plan, uint8_t channel, uint32_t frequency, uint32_t expected )
+{
+    if( Mismatches < 10 )
+    {
+        printf( "  %s, plan %s, channel %u: %u Hz, expected %u Hz\n", what, plan->Name, channel, frequency, expected );
+    }
+    Mismatches++;
+}
+
+/*!
+ * RX1 frequency of the regional parameters
+ */
+static uint32_t GetRx1Formula( const CheckedPlan_t* plan, uint8_t channel )
+{
+    if( plan->NbChannels == 48 )
+    {
+        return plan->FirstRx1Frequency[0] + ( ( channel % 24 ) * 200000 );
+    }
+    return plan->FirstRx1Frequency[channel / 32] + ( ( channel % 32 ) * 200000 );
+}
+
+static uint32_t CheckPlanFunctions( void )
+{
+    uint32_t checked = 0;
+
+    for( uint8_t p = 0; p < CHECK_NB_PLANS; p++ )
+    {
+        for( uint8_t channel = 0; channel < Plans[p].NbChannels; channel++ )
+        {
+            uint32_t frequency = Plans[p].GetRx1Frequency( channel );
+
+            if( frequency != GetRx1Formula( &Plans[p], channel ) )
+            {
+                Mismatch( "RX1", &Plans[p], channel, frequency, GetRx1Formula( &Plans[p], channel ) );
+            }
+            checked++;
+        }
+    }
+    return checked;
+}
+
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+static RegionNvmDataGroup1_t RegionGroup1;
+static RegionNvmDataGroup2_t RegionGroup2;
+static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
+
+/*!
+ * Plan of a common join channel
+ */
+static const CheckedPlan_t* GetJoinChannelPlan( uint8_t joinChannel )
+{
+    if( joinChannel < 8 )
+    {
+        return &Plans[0];
+    }
+    else if( joinChannel < 10 )
+    {
+        return &Plans[1];
+    }
+    else if( joinChannel < 15 )
+    {
+        return &Plans[2];
+    }
+    return &Plans[3];
+}
+
+/*!
+ * Configures a reception window of a joined OTAA end-device and returns the frequency set on the radio
+ */
+static uint32_t ConfigureRx( uint8_t channel, LoRaMacRxSlot_t rxSlot )
+{
+    RxConfigParams_t rxConfig = { 0 };
+    int8_t datarate;
+
+    rxConfig.Channel = channel;
+    rxConfig.Datarate = DR_0;
+    rxConfig.RxSlot = rxSlot;
+    rxConfig.NetworkActivation = ACTIVATION_TYPE_OTAA;
+    if( RegionRxConfig( LORAMAC_REGION_CN470, &rxConfig, &datarate ) == false )
+    {
+        fprintf( stderr, "RegionRxConfig failed on channel %u\n", channel );
+        exit( 2 );
+    }
+    return HostRadioGetStatus( )->Frequency;
+}
+
+static uint32_t CheckRxWindows( const CheckedPlan_t* plan, uint8_t joinChannel )
+{
+    uint32_t checked = 0;
+    uint32_t frequency;
+
+    for( uint8_t channel = 0; channel < plan->NbChannels; channel++ )
+    {
+        frequency = ConfigureRx( channel, RX_SLOT_WIN_1 );
+        if( frequency != GetRx1Formula( plan, channel ) )
+        {
+            Mismatch( "Region RX1", plan, channel, frequency, GetRx1Formula( plan, channel ) );
+        }
+        checked++;
+    }
+    frequency = ConfigureRx( 0, RX_SLOT_WIN_2 );
+    if( frequency != plan->GetRx2Frequency( joinChannel, true ) )
+    {
+        Mismatch( "Region RX2", plan, joinChannel, frequency, plan->GetRx2Frequency( joinChannel, true ) );
+    }
+    return checked + 1;
+}
+
+static uint32_t CheckRegion( void )
+{
+    InitDefaultsParams_t params;
+    ApplyCFListParams_t applyCFList = { 0 };
+    uint32_t checked = 0;
+
+    params.Type = INIT_TYPE_DEFAULTS;
+    params.NvmGroup1 = &RegionGroup1;
+    params.NvmGroup2 = &RegionGroup2;
+    params.Bands = &RegionBands;
+
+    // Plan identified from the join channel of the join-accept
+    for( uint8_t joinChannel = 0; joinChannel < CHECK_NB_JOIN_CHANNELS; joinChannel++ )
+    {
+        RegionInitDefaults( LORAMAC_REGION_CN470, &params );
+        applyCFList.JoinChannel = joinChannel;
+        RegionApplyCFList( LORAMAC_REGION_CN470, &applyCFList );
+        checked += CheckRxWindows( GetJoinChannelPlan( joinChannel ), joinChannel );
+    }
+
+    // Plan of a context restored from the NVM, as after a reset, changing from a join channel to the next one
+    for( uint8_t i = 0; i < CHECK_NB_JOIN_CHANNELS; i++ )
+    {
+        uint8_t joinChannel = ( i * 7 ) % CHECK_NB_JOIN_CHANNELS;
+
+        RegionGroup2.ChannelPlan = ( RegionCN470ChannelPlan_t )( ( GetJoinChannelPlan( joinChannel ) - Plans ) + 1 );
+        RegionGroup2.CommonJoinChannelIndex = joinChannel;
+        RegionGroup2.IsOtaaDevice = true;
+        checked += CheckRxWindows( GetJoinChannelPlan( joinChannel ), joinChannel );
+    }
+    return checked;
+}
+#endif /* REGION_VERSION */
+
+int main( int argc, char** argv )
+{
+    uint32_t checked;
+
+    HostPlatformInit( 1 );
+
+    checked = CheckPlanFunctions( );
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+    checked += CheckRegion( );
+#endif /* REGION_VERSION */
+
+    printf( "LoRaWAN 0x%08X, region 0x%08X, CN470 frequency tables %s: %u frequencies checked, %u mismatches\n",
+            LORAMAC_VERSION, REGION_VERSION, ( REGION_CN470_FREQUENCY_TABLES_ENABLED == 1 ) ? "on" : "off",
+            checked, Mismatches );
+    return ( Mismatches == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,473 @@
+/**
+  ******************************************************************************
+  * @file    ClassBDelayedTx.c
+  * @author  MCD Application Team
+  * @brief   Checks that an uplink delayed by the duty cycle is sent in Class B
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: ClassBDelayedTx <frames file>
+ *
+ * The frames file is written by "CorpusGen <version> classb". The end-device
+ * locks on the beacon, gets its unicast ping slots, one per second, and a
+ * multicast slot per beacon period, switches to Class B and sends uplinks
+ * with the duty cycle enabled until one of them is restricted. A delayed uplink is then requested shortly before the end of
+ * the duty cycle wait time. The check passes when it is transmitted when the
+ * wait time ends and confirmed without error.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "HostPlatform.h"
+#include "ReplayKeys.h"
+
+/*!
+ * Longest simulated time waited for the LoRaMac, in ms
+ */
+#define CHECK_MAX_WAIT                              ( 3600 * 1000 )
+
+/*!
+ * Maximum number of uplinks sent to exhaust the duty cycle credits of the band
+ */
+#define CHECK_MAX_UPLINKS                           100
+
+/*!
+ * Duty cycle wait time left when the delayed uplink is requested, in ms. Shorter than the ping period.
+ */
+#define CHECK_TX_WAIT                               20
+
+/*!
+ * Tolerated lateness of the delayed uplink, in ms
+ */
+#define CHECK_TX_TOLERANCE                          10
+
+static uint8_t Beacon[255];
+static uint8_t BeaconSize;
+static uint8_t PingSlotInfoAns[255];
+static uint8_t PingSlotInfoAnsSize;
+
+static uint8_t AppData[51];
+
+static bool ProcessPending;
+static bool McpsConfirmReceived;
+static LoRaMacEventInfoStatus_t McpsConfirmStatus;
+static LoRaMacEventInfoStatus_t BeaconAcquisitionStatus;
+static LoRaMacEventInfoStatus_t PingSlotInfoStatus;
+
+static uint8_t DevEui[8] = REPLAY_DEV_EUI;
+static uint8_t JoinEui[8] = REPLAY_JOIN_EUI;
+static uint8_t NwkKey[16] = REPLAY_NWK_KEY;
+static uint8_t AppKey[16] = REPLAY_APP_KEY;
+static uint8_t NwkSKey[16] = REPLAY_NWK_S_KEY;
+static uint8_t AppSKey[16] = REPLAY_APP_S_KEY;
+static uint8_t McNwkSKey[16] = REPLAY_MC_NWK_S_KEY;
+static uint8_t McAppSKey[16] = REPLAY_MC_APP_S_KEY;
+
+static void OnMcpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    McpsConfirmReceived = true;
+    McpsConfirmStatus = mcpsConfirm->Status;
+}
+
+static void OnMcpsIndication( McpsIndication_t* mcpsIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+    if( mlmeConfirm->MlmeRequest == MLME_BEACON_ACQUISITION )
+    {
+        BeaconAcquisitionStatus = mlmeConfirm->Status;
+    }
+    else if( mlmeConfirm->MlmeRequest == MLME_PING_SLOT_INFO )
+    {
+        PingSlotInfoStatus = mlmeConfirm->Status;
+    }
+}
+
+static void OnMlmeIndication( MlmeIndication_t* mlmeIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives =
+{
+    .MacMcpsConfirm = OnMcpsConfirm,
+    .MacMcpsIndication = OnMcpsIndication,
+    .MacMlmeConfirm = OnMlmeConfirm,
+    .MacMlmeIndication = OnMlmeIndication,
+};
+
+static LoRaMacCallback_t Callbacks =
+{
+    .MacProcessNotify = OnMacProcessNotify,
+};
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 1 );
+}
+
+static void SetMib( Mib_t type, MibRequestConfirm_t* mib )
+{
+    LoRaMacStatus_t status;
+
+    mib->Type = type;
+    status = LoRaMacMibSetRequestConfirm( mib );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        fprintf( stderr, "MIB %d ", type );
+        Fail( "LoRaMacMibSetRequestConfirm", status );
+    }
+}
+
+static void ProcessMac( void )
+{
+    while( ProcessPending == true )
+    {
+        ProcessPending = false;
+        LoRaMacProcess( );
+    }
+}
+
+/*!
+ * Runs the LoRaMac until the radio receives or the LoRaMac is idle
+ *
+ * \param [IN] forRx - Waits for a reception when true, else for the LoRaMac to be idle
+ *
+ * \retval true when the condition has been reached
+ */
+static bool RunMac( bool forRx )
+{
+    TimerTime_t limit = TimerGetCurrentTime( ) + CHECK_MAX_WAIT;
+
+    do
+    {
+        ProcessMac( );
+        if( ( forRx == true ) && ( HostRadioGetStatus( )->State == RF_RX_RUNNING ) )
+        {
+            return true;
+        }
+        if( ( forRx == false ) && ( LoRaMacIsBusy( ) == false ) )
+        {
+            return true;
+        }
+    } while( HostPlatformRunNextEvent( limit ) == true );
+    return false;
+}
+
+/*!
+ * Initializes the LoRaMac of the EU868 end-device, activated by personalization,
+ * with a Class B multicast group
+ */
+static void SetupMac( void )
+{
+    MibRequestConfirm_t mib;
+    McChannelParams_t mcChannel;
+    LoRaMacStatus_t status;
+    uint8_t mcStatus;
+
+    HostPlatformInit( 1 );
+
+    status = LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacInitialization", status );
+    }
+    mib.Param.DevEui = DevEui;
+    SetMib( MIB_DEV_EUI, &mib );
+    mib.Param.JoinEui = JoinEui;
+    SetMib( MIB_JOIN_EUI, &mib );
+    mib.Param.NwkKey = NwkKey;
+    SetMib( MIB_NWK_KEY, &mib );
+    mib.Param.AppKey = AppKey;
+    SetMib( MIB_APP_KEY, &mib );
+
+    status = LoRaMacStart( );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacStart", status );
+    }
+    LoRaMacTestSetDutyCycleOn( false );
+
+    mib.Param.NetID = REPLAY_NET_ID;
+    SetMib( MIB_NET_ID, &mib );
+    mib.Param.DevAddr = REPLAY_DEV_ADDR;
+    SetMib( MIB_DEV_ADDR, &mib );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    mib.Param.FNwkSIntKey = NwkSKey;
+    SetMib( MIB_F_NWK_S_INT_KEY, &mib );
+    mib.Param.SNwkSIntKey = NwkSKey;
+    SetMib( MIB_S_NWK_S_INT_KEY, &mib );
+    mib.Param.NwkSEncKey = NwkSKey;
+    SetMib( MIB_NWK_S_ENC_KEY, &mib );
+    mib.Param.AbpLrWanVersion.Value = 0x01010100;
+    SetMib( MIB_ABP_LORAWAN_VERSION, &mib );
+#else
+    mib.Param.NwkSKey = NwkSKey;
+    SetMib( MIB_NWK_S_KEY, &mib );
+#endif /* LORAMAC_VERSION */
+    mib.Param.AppSKey = AppSKey;
+    SetMib( MIB_APP_S_KEY, &mib );
+    mib.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+    SetMib( MIB_NETWORK_ACTIVATION, &mib );
+
+    // The Class B processing computes the slots of every multicast context, which
+    // needs a ping period: a division by 0 traps on the host
+    memset( &mcChannel, 0, sizeof( mcChannel ) );
+    mcChannel.IsEnabled = true;
+    mcChannel.GroupID = MULTICAST_0_ADDR;
+    mcChannel.Address = REPLAY_MC_ADDR;
+    mcChannel.McKeys.Session.McAppSKey = McAppSKey;
+    mcChannel.McKeys.Session.McNwkSKey = McNwkSKey;
+    mcChannel.FCountMin = 0;
+    mcChannel.FCountMax = UINT32_MAX;
+    mcChannel.RxParams.Class = CLASS_B;
+    mcChannel.RxParams.Params.ClassB.Frequency = 869525000;
+    mcChannel.RxParams.Params.ClassB.Datarate = DR_3;
+    mcChannel.RxParams.Params.ClassB.Periodicity = 7;
+    status = LoRaMacMcChannelSetup( &mcChannel );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcChannelSetup", status );
+    }
+    // Computes the ping period of the multicast context
+    status = LoRaMacMcChannelSetupRxParams( MULTICAST_0_ADDR, &mcChannel.RxParams, &mcStatus );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcChannelSetupRxParams", status );
+    }
+    ProcessMac( );
+}
+
+/*!
+ * Sends an unconfirmed uplink at DR_0
+ *
+ * \param [IN]  size              - Size of the application payload
+ * \param [IN]  allowDelayedTx    - Lets the LoRaMac delay the transmission for the duty cycle
+ * \param [OUT] dutyCycleWaitTime - Time the transmission is restricted by the duty cycle
+ *
+ * \retval Status of the request
+ */
+static LoRaMacStatus_t SendUplink( uint8_t size, bool allowDelayedTx, TimerTime_t* dutyCycleWaitTime )
+{
+    McpsReq_t mcpsReq;
+    LoRaMacStatus_t status;
+
+    McpsConfirmReceived = false;
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = 2;
+    mcpsReq.Req.Unconfirmed.fBuffer = AppData;
+    mcpsReq.Req.Unconfirmed.fBufferSize = size;
+    mcpsReq.Req.Unconfirmed.Datarate = DR_0;
+    status = LoRaMacMcpsRequest( &mcpsReq, allowDelayedTx );
+    *dutyCycleWaitTime = mcpsReq.ReqReturn.DutyCycleWaitTime;
+    return status;
+}
+
+static void AcquireBeacon( void )
+{
+    MlmeReq_t mlmeReq;
+    LoRaMacStatus_t status;
+
+    BeaconAcquisitionStatus = LORAMAC_EVENT_INFO_STATUS_ERROR;
+    mlmeReq.Type = MLME_BEACON_ACQUISITION;
+    status = LoRaMacMlmeRequest( &mlmeReq );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "MLME_BEACON_ACQUISITION", status );
+    }
+    if( RunMac( true ) == false )
+    {
+        Fail( "Beacon reception", 0 );
+    }
+    HostRadioReceive( Beacon, BeaconSize, -80, 5 );
+    ProcessMac( );
+    if( BeaconAcquisitionStatus != LORAMAC_EVENT_INFO_STATUS_OK )
+    {
+        Fail( "Beacon acquisition", BeaconAcquisitionStatus );
+    }
+}
+
+/*!
+ * Requests a ping slot every second and switches to Class B
+ */
+static void StartClassB( void )
+{
+    MlmeReq_t mlmeReq;
+    MibRequestConfirm_t mib;
+    LoRaMacStatus_t status;
+    TimerTime_t dutyCycleWaitTime;
+    uint32_t txCount = HostRadioGetStatus( )->TxCount;
+
+    PingSlotInfoStatus = LORAMAC_EVENT_INFO_STATUS_ERROR;
+    mlmeReq.Type = MLME_PING_SLOT_INFO;
+    mlmeReq.Req.PingSlotInfo.PingSlot.Value = 0;
+    mlmeReq.Req.PingSlotInfo.PingSlot.Fields.Periodicity = 0;
+    status = LoRaMacMlmeRequest( &mlmeReq );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "MLME_PING_SLOT_INFO", status );
+    }
+
+    // The PingSlotInfoReq is piggybacked on an uplink, answered in its RX1 window
+    status = SendUplink( 1, false, &dutyCycleWaitTime );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcpsRequest", status );
+    }
+    do
+    {
+        if( HostPlatformRunNextEvent( TimerGetCurrentTime( ) + CHECK_MAX_WAIT ) == false )
+        {
+            Fail( "PingSlotInfoReq uplink", 0 );
+        }
+        ProcessMac( );
+    } while( ( HostRadioGetStatus( )->TxCount == txCount ) || ( HostRadioGetStatus( )->State != RF_RX_RUNNING ) );
+    HostRadioReceive( PingSlotInfoAns, PingSlotInfoAnsSize, -60, 8 );
+    if( RunMac( false ) == false )
+    {
+        Fail( "PingSlotInfoReq uplink", 0 );
+    }
+    if( PingSlotInfoStatus != LORAMAC_EVENT_INFO_STATUS_OK )
+    {
+        Fail( "MLME_PING_SLOT_INFO", PingSlotInfoStatus );
+    }
+
+    mib.Param.Class = CLASS_B;
+    SetMib( MIB_DEVICE_CLASS, &mib );
+}
+
+static void LoadFrames( const char* path )
+{
+    FILE* file = fopen( path, "r" );
+    char kind[16];
+    char hex[2 * 255 + 1];
+    int expected;
+
+    if( file == NULL )
+    {
+        perror( path );
+        exit( 2 );
+    }
+    while( fscanf( file, "%15s %d %510s", kind, &expected, hex ) == 3 )
+    {
+        uint8_t* frame = ( strcmp( kind, "beacon" ) == 0 ) ? Beacon : PingSlotInfoAns;
+        uint8_t size = ( uint8_t )( strlen( hex ) / 2 );
+
+        for( uint8_t i = 0; i < size; i++ )
+        {
+            unsigned int byte;
+
+            sscanf( &hex[2 * i], "%2x", &byte );
+            frame[i] = ( uint8_t )byte;
+        }
+        if( frame == Beacon )
+        {
+            BeaconSize = size;
+        }
+        else
+        {
+            PingSlotInfoAnsSize = size;
+        }
+    }
+    fclose( file );
+    if( ( BeaconSize == 0 ) || ( PingSlotInfoAnsSize == 0 ) )
+    {
+        fprintf( stderr, "%s: beacon or PingSlotInfoAns missing\n", path );
+        exit( 2 );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    TimerTime_t dutyCycleWaitTime = 0;
+    TimerTime_t requestTime;
+    LoRaMacStatus_t status = LORAMAC_STATUS_OK;
+    uint32_t txCount;
+    uint16_t uplinks;
+    const HostRadioStatus_t* radio = HostRadioGetStatus( );
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <frames file>\n", argv[0] );
+        return 2;
+    }
+    LoadFrames( argv[1] );
+
+    SetupMac( );
+    AcquireBeacon( );
+    StartClassB( );
+
+    // Spend the duty cycle credits of the band until an uplink is restricted
+    LoRaMacTestSetDutyCycleOn( true );
+    for( uplinks = 0; uplinks < CHECK_MAX_UPLINKS; uplinks++ )
+    {
+        status = SendUplink( sizeof( AppData ), false, &dutyCycleWaitTime );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            break;
+        }
+        if( RunMac( false ) == false )
+        {
+            Fail( "Uplink", uplinks );
+        }
+    }
+    if( ( status != LORAMAC_STATUS_DUTYCYCLE_RESTRICTED ) || ( dutyCycleWaitTime <= CHECK_TX_WAIT ) )
+    {
+        Fail( "Duty cycle restriction", status );
+    }
+
+    // Request the uplink shortly before the credits are back: the next Class B
+    // slot is then after the end of the wait, where a coalesced timer would move it
+    requestTime = TimerGetCurrentTime( ) + dutyCycleWaitTime - CHECK_TX_WAIT;
+    while( TimerGetCurrentTime( ) < requestTime )
+    {
+        HostPlatformRunNextEvent( requestTime );
+        ProcessMac( );
+    }
+    txCount = radio->TxCount;
+    status = SendUplink( sizeof( AppData ), true, &dutyCycleWaitTime );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcpsRequest", status );
+    }
+    if( RunMac( false ) == false )
+    {
+        Fail( "Delayed uplink", 0 );
+    }
+
+    if( ( dutyCycleWaitTime == 0 ) || ( radio->TxCount == txCount ) || ( McpsConfirmReceived == false ) ||
+        ( McpsConfirmStatus != LORAMAC_EVENT_INFO_STATUS_OK ) )
+    {
+        fprintf( stderr, "Uplink delayed by %u ms not sent, status %d\n", ( unsigned int )dutyCycleWaitTime,
+                 McpsConfirmReceived ? ( int )McpsConfirmStatus : -1 );
+        return 1;
+    }
+    if( ( radio->LastTxTime - requestTime ) > ( dutyCycleWaitTime + CHECK_TX_TOLERANCE ) )
+    {
+        fprintf( stderr, "Uplink delayed by %u ms sent after %u ms\n", ( unsigned int )dutyCycleWaitTime,
+                 ( unsigned int )( radio->LastTxTime - requestTime ) );
+        return 1;
+    }
+    printf( "LoRaWAN 0x%08X, Class B uplink delayed by %u ms sent after %u ms\n", LORAMAC_VERSION,
+            ( unsigned int )dutyCycleWaitTime, ( unsigned int )( radio->LastTxTime - requestTime ) );
+    return 0;
+}
@@ -0,0 +1,508 @@
+/**
+  ******************************************************************************
+  * @file    CorpusGen.c
+  * @author  MCD Application Team
+  * @brief   Generates the downlink replay corpus of the LoRaMac receive benchmark
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: CorpusGen <LoRaWAN version> [data frames | classb]
+ *
+ * Writes one frame per line on the standard output:
+ *
+ *     <kind> <expected> <frame in hexadecimal>
+ *
+ * kind     : data, mcast, foreign, beacon, join or join915
+ * expected : 1 when the end-device must accept the frame, 0 when it must drop it
+ *
+ * The frames target the EU868 end-device of ReplayKeys.h, activated by
+ * personalization for the data frames. The downlink counters of each kind
+ * start at 0 and the join-accepts answer successive join requests, so the
+ * corpus is replayed in order on a freshly initialized LoRaMac. The join915
+ * join-accept, with a CFList of type 1, answers the first join request of
+ * the same end-device in the US915 region.
+ *
+ * With classb, only the frames of the ClassBDelayedTx check are written: a
+ * beacon and the PingSlotInfoAns answering the first uplink.
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lorawan_aes.h"
+#include "cmac.h"
+#include "ReplayKeys.h"
+
+/*!
+ * MAC header message types
+ */
+#define MTYPE_JOIN_REQUEST                          0x00
+#define MTYPE_JOIN_ACCEPT                           0x20
+#define MTYPE_UNCONFIRMED_UP                        0x40
+#define MTYPE_UNCONFIRMED_DOWN                      0x60
+#define MTYPE_CONFIRMED_DOWN                        0xA0
+#define MTYPE_REJOIN_REQUEST                        0xC0
+#define MTYPE_PROPRIETARY                           0xE0
+
+/*!
+ * Largest FOpts and FRMPayload length accepted at EU868 DR0
+ */
+#define CORPUS_MAX_PAYLOAD                          51
+
+/*!
+ * Number of frames of the other kinds
+ */
+#define CORPUS_MCAST_FRAMES                         16
+#define CORPUS_BEACONS                              8
+#define CORPUS_JOIN_ACCEPTS                         4
+
+static const uint8_t NwkKey[16] = REPLAY_NWK_KEY;
+static const uint8_t NwkSKey[16] = REPLAY_NWK_S_KEY;
+static const uint8_t AppSKey[16] = REPLAY_APP_S_KEY;
+static const uint8_t McNwkSKey[16] = REPLAY_MC_NWK_S_KEY;
+static const uint8_t McAppSKey[16] = REPLAY_MC_APP_S_KEY;
+static const uint8_t DevEui[8] = REPLAY_DEV_EUI;
+static const uint8_t JoinEui[8] = REPLAY_JOIN_EUI;
+static const uint16_t Us915CfListMask[5] = REPLAY_US915_CFLIST_MASK;
+
+/*!
+ * LoRaWAN version of the corpus
+ */
+static uint32_t Version;
+
+/*!
+ * Downlink MAC commands carried by the data frames, safe to apply in any order
+ */
+static const struct
+{
+    uint8_t Size;
+    uint8_t Payload[6];
+}MacCommands[] =
+{
+    { 1, { 0x06 } },                                // DevStatusReq
+    { 2, { 0x04, 0x00 } },                          // DutyCycleReq, no limitation
+    { 2, { 0x08, 0x01 } },                          // RXTimingSetupReq, 1 s
+    { 6, { 0x07, 0x03, 0x18, 0x4F, 0x84, 0x50 } },  // NewChannelReq, channel 3 at 867.1 MHz, DR0 to DR5
+    { 5, { 0x0A, 0x03, 0x18, 0x4F, 0x84 } },        // DlChannelReq, channel 3 at 867.1 MHz
+    { 3, { 0x02, 0x14, 0x01 } },                    // LinkCheckAns, margin 20 dB, 1 gateway
+};
+
+static void AesEncrypt( const uint8_t* key, const uint8_t* in, uint8_t* out )
+{
+    lorawan_aes_context aes;
+
+    lorawan_aes_set_key( key, 16, &aes );
+    lorawan_aes_encrypt( in, out, &aes );
+}
+
+static void AesDecrypt( const uint8_t* key, const uint8_t* in, uint8_t* out )
+{
+    lorawan_aes_context aes;
+
+    lorawan_aes_set_key( key, 16, &aes );
+    lorawan_aes_decrypt( in, out, &aes );
+}
+
+static uint32_t Cmac( const uint8_t* key, const uint8_t* header, uint8_t headerSize, const uint8_t* msg, uint16_t size )
+{
+    AES_CMAC_CTX ctx;
+    uint8_t digest[16];
+
+    AES_CMAC_Init( &ctx );
+    AES_CMAC_SetKey( &ctx, key );
+    AES_CMAC_Update( &ctx, header, headerSize );
+    AES_CMAC_Update( &ctx, msg, size );
+    AES_CMAC_Final( digest, &ctx );
+    return ( uint32_t )digest[0] | ( ( uint32_t )digest[1] << 8 ) | ( ( uint32_t )digest[2] << 16 ) | ( ( uint32_t )digest[3] << 24 );
+}
+
+static void PutUint32( uint8_t* buffer, uint32_t value )
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = ( value >> 8 ) & 0xFF;
+    buffer[2] = ( value >> 16 ) & 0xFF;
+    buffer[3] = ( value >> 24 ) & 0xFF;
+}
+
+/*!
+ * Encrypts a downlink FRMPayload, or FOpts when fOptsCounter is not 0
+ */
+static void Encrypt( const uint8_t* key, uint32_t address, uint32_t fCnt, uint8_t fOptsCounter, uint8_t* buffer, uint8_t size )
+{
+    uint8_t aBlock[16] = { 0 };
+    uint8_t sBlock[16];
+
+    aBlock[0] = 0x01;
+    aBlock[5] = 1;
+    PutUint32( &aBlock[6], address );
+    PutUint32( &aBlock[10], fCnt );
+    if( fOptsCounter != 0 )
+    {
+        aBlock[4] = fOptsCounter;
+    }
+    for( uint8_t offset = 0, ctr = 1; offset < size; offset += 16, ctr++ )
+    {
+        aBlock[15] = ( fOptsCounter != 0 ) ? 1 : ctr;
+        AesEncrypt( key, aBlock, sBlock );
+        for( uint8_t i = 0; ( i < 16 ) && ( offset + i < size ); i++ )
+        {
+            buffer[offset + i] ^= sBlock[i];
+        }
+    }
+}
+
+/*!
+ * Builds a data downlink
+ *
+ * \retval Size of the frame
+ */
+static uint8_t BuildData( uint8_t* frame, uint8_t mType, uint32_t address, uint32_t fCnt, bool multicast,
+                          const uint8_t* fOpts, uint8_t fOptsSize, int16_t port, const uint8_t* payload, uint8_t payloadSize )
+{
+    const uint8_t* micKey = multicast ? McNwkSKey : NwkSKey;
+    const uint8_t* encKey = multicast ? McAppSKey : ( ( port == 0 ) ? NwkSKey : AppSKey );
+    uint8_t size = 0;
+    uint8_t b0[16] = { 0 };
+
+    frame[size++] = mType;
+    PutUint32( &frame[size], address );
+    size += 4;
+    frame[size++] = fOptsSize;
+    frame[size++] = fCnt & 0xFF;
+    frame[size++] = ( fCnt >> 8 ) & 0xFF;
+    memcpy( &frame[size], fOpts, fOptsSize );
+    if( ( Version == 0x01010100 ) && ( multicast == false ) && ( fOptsSize > 0 ) )
+    {
+        // LoRaWAN 1.1.1 encrypts the FOpts with NwkSEncKey, with the counter of the frame type
+        Encrypt( NwkSKey, address, fCnt, ( port > 0 ) ? 2 : 1, &frame[size], fOptsSize );
+    }
+    size += fOptsSize;
+    if( port >= 0 )
+    {
+        frame[size++] = ( uint8_t )port;
+        memcpy( &frame[size], payload, payloadSize );
+        Encrypt( encKey, address, fCnt, 0, &frame[size], payloadSize );
+        size += payloadSize;
+    }
+
+    b0[0] = 0x49;
+    b0[5] = 1;
+    PutUint32( &b0[6], address );
+    PutUint32( &b0[10], fCnt );
+    b0[15] = size;
+    PutUint32( &frame[size], Cmac( micKey, b0, 16, frame, size ) );
+    return size + 4;
+}
+
+static uint16_t BeaconCrc( const uint8_t* buffer, uint16_t length )
+{
+    uint16_t crc = 0x0000;
+
+    for( uint16_t i = 0; i < length; i++ )
+    {
+        crc ^= ( uint16_t )buffer[i] << 8;
+        for( uint8_t j = 0; j < 8; j++ )
+        {
+            crc = ( crc & 0x8000 ) ? ( crc << 1 ) ^ 0x1021 : ( crc << 1 );
+        }
+    }
+    return crc;
+}
+
+/*!
+ * Builds an EU868 beacon
+ *
+ * \retval Size of the frame
+ */
+static uint8_t BuildBeacon( uint8_t* frame, uint32_t gpsTime, bool validCrc )
+{
+    // LoRaWAN 1.0.3 : | RFU1 (2) | Time | CRC1 | GwSpecific | CRC2 |
+    // Later         : | RFU1 (1) | Param | Time | CRC1 | GwSpecific | CRC2 |
+    // The Time field is at the same offset, Param is 0
+    uint8_t timeOffset = 2;
+    uint16_t crc;
+
+    memset( frame, 0, 17 );
+    PutUint32( &frame[timeOffset], gpsTime );
+    crc = BeaconCrc( frame, timeOffset + 4 );
+    frame[timeOffset + 4] = crc & 0xFF;
+    frame[timeOffset + 5] = ( crc >> 8 ) & 0xFF;
+    // GwSpecific: InfoDesc 0 with the gateway coordinates
+    frame[timeOffset + 7] = 0x12;
+    frame[timeOffset + 8] = 0x34;
+    frame[timeOffset + 9] = 0x56;
+    frame[timeOffset + 10] = 0x78;
+    frame[timeOffset + 11] = 0x9A;
+    frame[timeOffset + 12] = 0xBC;
+    crc = BeaconCrc( &frame[timeOffset + 6], 7 );
+    frame[timeOffset + 13] = crc & 0xFF;
+    frame[timeOffset + 14] = ( crc >> 8 ) & 0xFF;
+    if( validCrc == false )
+    {
+        frame[timeOffset + 4] ^= 0xFF;
+        frame[timeOffset + 13] ^= 0xFF;
+    }
+    return 17;
+}
+
+/*!
+ * CFList carried by a join-accept
+ */
+typedef enum eCfList
+{
+    CFLIST_NONE,
+    CFLIST_EU868_CHANNELS,
+    CFLIST_US915_CHANNELS_MASK,
+}CfList_t;
+
+/*!
+ * Builds a join-accept answering the join request with the given DevNonce
+ *
+ * \retval Size of the frame
+ */
+static uint8_t BuildJoinAccept( uint8_t* frame, uint32_t joinNonce, uint16_t devNonce, bool optNeg, uint8_t rx2Datarate,
+                                CfList_t cfList )
+{
+    uint8_t plain[33];
+    uint8_t size = 0;
+    uint32_t mic;
+
+    plain[size++] = MTYPE_JOIN_ACCEPT;
+    plain[size++] = joinNonce & 0xFF;
+    plain[size++] = ( joinNonce >> 8 ) & 0xFF;
+    plain[size++] = ( joinNonce >> 16 ) & 0xFF;
+    plain[size++] = REPLAY_NET_ID & 0xFF;
+    plain[size++] = ( REPLAY_NET_ID >> 8 ) & 0xFF;
+    plain[size++] = ( REPLAY_NET_ID >> 16 ) & 0xFF;
+    PutUint32( &plain[size], REPLAY_DEV_ADDR + joinNonce );
+    size += 4;
+    // DLSettings: RX1DRoffset 0
+    plain[size++] = ( optNeg ? 0x80 : 0x00 ) | rx2Datarate;
+    // RxDelay 1 s
+    plain[size++] = 0x01;
+    if( cfList == CFLIST_EU868_CHANNELS )
+    {
+        // EU868 CFList: channels 3 to 7 from 867.1 to 867.9 MHz and CFListType 0
+        for( uint32_t freq = 8671000; freq <= 8679000; freq += 2000 )
+        {
+            plain[size++] = freq & 0xFF;
+            plain[size++] = ( freq >> 8 ) & 0xFF;
+            plain[size++] = ( freq >> 16 ) & 0xFF;
+        }
+        plain[size++] = 0x00;
+    }
+    else if( cfList == CFLIST_US915_CHANNELS_MASK )
+    {
+        // US915 CFList: ChMask0 to ChMask4, RFU and CFListType 1
+        for( uint8_t i = 0; i < 5; i++ )
+        {
+            plain[size++] = Us915CfListMask[i] & 0xFF;
+            plain[size++] = ( Us915CfListMask[i] >> 8 ) & 0xFF;
+        }
+        memset( &plain[size], 0, 5 );
+        size += 5;
+        plain[size++] = 0x01;
+    }
+
+    if( optNeg == false )
+    {
+        mic = Cmac( NwkKey, NULL, 0, plain, size );
+    }
+    else
+    {
+        uint8_t header[11];
+        uint8_t compBase[16] = { 0 };
+        uint8_t jsIntKey[16];
+
+        compBase[0] = 0x06;
+        for( uint8_t i = 0; i < 8; i++ )
+        {
+            compBase[1 + i] = DevEui[7 - i];
+        }
+        AesEncrypt( NwkKey, compBase, jsIntKey );
+
+        header[0] = 0xFF;
+        for( uint8_t i = 0; i < 8; i++ )
+        {
+            header[1 + i] = JoinEui[7 - i];
+        }
+        header[9] = devNonce & 0xFF;
+        header[10] = ( devNonce >> 8 ) & 0xFF;
+        mic = Cmac( jsIntKey, header, sizeof( header ), plain, size );
+    }
+    PutUint32( &plain[size], mic );
+    size += 4;
+
+    // The end-device decrypts the join-accept with an AES encryption
+    frame[0] = plain[0];
+    for( uint8_t offset = 1; offset < size; offset += 16 )
+    {
+        AesDecrypt( NwkKey, &plain[offset], &frame[offset] );
+    }
+    return size;
+}
+
+static void PrintFrame( const char* kind, int expected, const uint8_t* frame, uint8_t size )
+{
+    printf( "%s %d ", kind, expected );
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        printf( "%02X", frame[i] );
+    }
+    printf( "\n" );
+}
+
+int main( int argc, char** argv )
+{
+    uint8_t frame[64];
+    uint8_t payload[CORPUS_MAX_PAYLOAD];
+    uint8_t fOpts[15];
+    uint8_t size;
+    uint32_t fCnt = 0;
+    int dataFrames = 64;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <LoRaWAN version> [data frames | classb]\n", argv[0] );
+        return 1;
+    }
+    Version = ( uint32_t )strtoul( argv[1], NULL, 0 );
+    if( ( Version != 0x01000300 ) && ( Version != 0x01000400 ) && ( Version != 0x01010100 ) )
+    {
+        fprintf( stderr, "unsupported LoRaWAN version %s\n", argv[1] );
+        return 1;
+    }
+    if( ( argc > 2 ) && ( strcmp( argv[2], "classb" ) == 0 ) )
+    {
+        size = BuildBeacon( frame, 1300000000, true );
+        PrintFrame( "beacon", 1, frame, size );
+        fOpts[0] = 0x10;    // PingSlotInfoAns
+        size = BuildData( frame, MTYPE_UNCONFIRMED_DOWN, REPLAY_DEV_ADDR, 0, false, fOpts, 1, -1, NULL, 0 );
+        PrintFrame( "data", 1, frame, size );
+        return 0;
+    }
+    if( argc > 2 )
+    {
+        dataFrames = atoi( argv[2] );
+    }
+    srand( 1 );
+
+    // Unicast data frames, with the counter of the frames which are not dropped
+    for( int i = 0; i < dataFrames; i++ )
+    {
+        uint8_t mType = ( ( i % 4 ) == 3 ) ? MTYPE_CONFIRMED_DOWN : MTYPE_UNCONFIRMED_DOWN;
+        uint8_t fOptsSize = 0;
+        uint8_t payloadSize = 0;
+        int16_t port;
+
+        for( uint8_t j = 0; j < sizeof( payload ); j++ )
+        {
+            payload[j] = ( uint8_t )rand( );
+        }
+        switch( i % 4 )
+        {
+            case 0:
+                // Application payload
+                port = 1 + ( rand( ) % 223 );
+                payloadSize = 1 + ( rand( ) % CORPUS_MAX_PAYLOAD );
+                break;
+            case 1:
+                // MAC commands in FOpts and application payload
+                for( uint8_t j = 0; j <= ( i / 4 ) % 3; j++ )
+                {
+                    uint8_t cmd = ( i / 4 + j ) % ( sizeof( MacCommands ) / sizeof( MacCommands[0] ) );
+
+                    memcpy( &fOpts[fOptsSize], MacCommands[cmd].Payload, MacCommands[cmd].Size );
+                    fOptsSize += MacCommands[cmd].Size;
+                }
+                port = 2;
+                payloadSize = rand( ) % ( CORPUS_MAX_PAYLOAD - fOptsSize );
+                break;
+            case 2:
+                // MAC commands in the FRMPayload
+                for( uint8_t j = 0; j <= ( i / 4 ) % 3; j++ )
+                {
+                    uint8_t cmd = ( i / 4 + j ) % ( sizeof( MacCommands ) / sizeof( MacCommands[0] ) );
+
+                    memcpy( &payload[payloadSize], MacCommands[cmd].Payload, MacCommands[cmd].Size );
+                    payloadSize += MacCommands[cmd].Size;
+                }
+                port = 0;
+                break;
+            default:
+                // Confirmed frame without payload
+                port = -1;
+                break;
+        }
+        size = BuildData( frame, mType, REPLAY_DEV_ADDR, fCnt++, false, fOpts, fOptsSize, port, payload, payloadSize );
+        PrintFrame( "data", 1, frame, size );
+    }
+
+    // Multicast frames of group 0
+    for( uint32_t i = 0; i < CORPUS_MCAST_FRAMES; i++ )
+    {
+        for( uint8_t j = 0; j < sizeof( payload ); j++ )
+        {
+            payload[j] = ( uint8_t )rand( );
+        }
+        size = BuildData( frame, MTYPE_UNCONFIRMED_DOWN, REPLAY_MC_ADDR, i, true, NULL, 0, 200, payload,
+                          1 + ( rand( ) % CORPUS_MAX_PAYLOAD ) );
+        PrintFrame( "mcast", 1, frame, size );
+    }
+
+    // Frames to drop: other devices, uplinks, bad MIC, replayed counter and multicast with FOpts
+    size = BuildData( frame, MTYPE_UNCONFIRMED_DOWN, REPLAY_DEV_ADDR + 1, fCnt, false, NULL, 0, 1, payload, 8 );
+    PrintFrame( "foreign", 0, frame, size );
+    size = BuildData( frame, MTYPE_CONFIRMED_DOWN, 0x01020304, fCnt, false, NULL, 0, 1, payload, 32 );
+    PrintFrame( "foreign", 0, frame, size );
+    size = BuildData( frame, MTYPE_UNCONFIRMED_UP, REPLAY_DEV_ADDR, fCnt, false, NULL, 0, 1, payload, 8 );
+    PrintFrame( "foreign", 0, frame, size );
+    size = BuildData( frame, MTYPE_UNCONFIRMED_DOWN, REPLAY_DEV_ADDR, fCnt, false, NULL, 0, 1, payload, 8 );
+    frame[size - 1] ^= 0x01;
+    PrintFrame( "foreign", 0, frame, size );
+    size = BuildData( frame, MTYPE_UNCONFIRMED_DOWN, REPLAY_DEV_ADDR, 0, false, NULL, 0, 1, payload, 8 );
+    PrintFrame( "foreign", 0, frame, size );
+    memcpy( fOpts, MacCommands[0].Payload, MacCommands[0].Size );
+    size = BuildData( frame, MTYPE_UNCONFIRMED_DOWN, REPLAY_MC_ADDR, CORPUS_MCAST_FRAMES, true, fOpts, MacCommands[0].Size, 200, payload, 8 );
+    PrintFrame( "foreign", 0, frame, size );
+    memset( frame, 0, 23 );
+    frame[0] = MTYPE_JOIN_REQUEST;
+    PrintFrame( "foreign", 0, frame, 23 );
+    frame[0] = MTYPE_REJOIN_REQUEST;
+    PrintFrame( "foreign", 0, frame, 19 );
+
+    // Beacons, every 128 s from an arbitrary GPS time, one with corrupted CRCs
+    for( uint32_t i = 0; i < CORPUS_BEACONS; i++ )
+    {
+        size = BuildBeacon( frame, 1300000000 + ( i * 128 ), i != ( CORPUS_BEACONS - 1 ) );
+        PrintFrame( "beacon", i != ( CORPUS_BEACONS - 1 ), frame, size );
+    }
+
+    // Join-accepts, one per join request of the end-device
+    for( uint32_t i = 0; i < CORPUS_JOIN_ACCEPTS; i++ )
+    {
+        bool optNeg = ( Version == 0x01010100 ) && ( ( i % 2 ) == 1 );
+
+        size = BuildJoinAccept( frame, i + 1, ( uint16_t )( i + 1 ), optNeg, 0, ( ( i % 2 ) == 0 ) ? CFLIST_EU868_CHANNELS : CFLIST_NONE );
+        PrintFrame( "join", 1, frame, size );
+    }
+    // A join-accept with a bad MIC
+    size = BuildJoinAccept( frame, CORPUS_JOIN_ACCEPTS + 1, CORPUS_JOIN_ACCEPTS + 1, false, 0, CFLIST_NONE );
+    frame[size - 1] ^= 0x01;
+    PrintFrame( "join", 0, frame, size );
+
+    // US915 join-accept with a channel mask, RX2 at DR8
+    size = BuildJoinAccept( frame, 1, 1, false, 8, CFLIST_US915_CHANNELS_MASK );
+    PrintFrame( "join915", 1, frame, size );
+    return 0;
+}
@@ -0,0 +1,287 @@
+/**
+  ******************************************************************************
+  * @file    DutyCycleSim.c
+  * @author  MCD Application Team
+  * @brief   Simulates 24 hours of duty cycled uplinks on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: DutyCycleSim <trace file>
+ *
+ * Drives the EU868 channel search of the region layer during 24 hours of
+ * simulated time, on the 3 default channels and 5 channels added in the other
+ * bands, as the LoRaMac does: join requests, then uplinks as soon as the duty
+ * cycle allows, with a random idle time and a datarate and a length changed
+ * from time to time, as the ADR and the application would, a duty cycle
+ * disabled for half an hour and a rejoin after 12 hours. One search in ten is
+ * a query of the availability only.
+ * Every search is written to the trace file: time, status, channel, time to
+ * wait, credits of the queries and ready bands. The traces of the full band
+ * synchronization and of REGION_DUTY_CYCLE_INCREMENTAL_ENABLED must be equal.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Region.h"
+#include "RegionCommon.h"
+#include "HostPlatform.h"
+
+/*!
+ * Simulated duration in ms
+ */
+#define SIM_DURATION                                ( 24 * 3600000U )
+
+/*!
+ * End of the first join in ms
+ */
+#define SIM_JOINED_AT                               ( 20 * 60000U )
+
+/*!
+ * Duty cycle disabled from SIM_DUTY_CYCLE_OFF_AT, for SIM_DUTY_CYCLE_OFF_DURATION ms
+ */
+#define SIM_DUTY_CYCLE_OFF_AT                       ( 6 * 3600000U )
+#define SIM_DUTY_CYCLE_OFF_DURATION                 ( 30 * 60000U )
+
+/*!
+ * Rejoin from SIM_REJOIN_AT, for SIM_REJOIN_DURATION ms
+ */
+#define SIM_REJOIN_AT                               ( 12 * 3600000U )
+#define SIM_REJOIN_DURATION                         ( 20 * 60000U )
+
+/*!
+ * Longest idle time after an uplink in ms
+ */
+#define SIM_MAX_IDLE                                5000
+
+/*!
+ * One search in SIM_UPLINK_CHANGE changes the datarate and the length of the uplinks
+ */
+#define SIM_UPLINK_CHANGE                           64
+
+/*!
+ * Length of the join requests
+ */
+#define SIM_JOIN_REQUEST_LENGTH                     23
+
+/*!
+ * Channels added to the defaults, one per band not covered by them
+ */
+static const uint32_t AddedChannels[] = { 867100000, 864100000, 868800000, 869525000, 869850000 };
+
+static RegionNvmDataGroup1_t RegionGroup1;
+static RegionNvmDataGroup2_t RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
+#endif /* REGION_VERSION */
+
+static uint32_t RandomState = 1;
+
+/*!
+ * Random numbers of the simulation, independent of the ones of the region
+ */
+static uint32_t SimRandom( uint32_t range )
+{
+    RandomState = ( RandomState * 1103515245U ) + 12345U;
+    return ( RandomState >> 8 ) % range;
+}
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 2 );
+}
+
+static Band_t* GetBands( void )
+{
+#if (defined( REGION_VERSION ) && ( REGION_VERSION == 0x01010003 ))
+    return RegionGroup1.Bands;
+#else
+    return RegionBands;
+#endif /* REGION_VERSION */
+}
+
+/*!
+ * Mask of the bands ready for transmission
+ */
+static uint8_t GetReadyBands( void )
+{
+    uint8_t ready = 0;
+
+    for( uint8_t i = 0; i < REGION_NVM_MAX_NB_BANDS; i++ )
+    {
+        if( GetBands( )[i].ReadyForTransmission == true )
+        {
+            ready |= 1 << i;
+        }
+    }
+    return ready;
+}
+
+static void SetupRegion( void )
+{
+    InitDefaultsParams_t params;
+    ChannelAddParams_t channelAdd;
+    ChannelParams_t channel = { 0 };
+    LoRaMacStatus_t status;
+
+    params.Type = INIT_TYPE_DEFAULTS;
+    params.NvmGroup1 = &RegionGroup1;
+    params.NvmGroup2 = &RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+    params.Bands = &RegionBands;
+#endif /* REGION_VERSION */
+    RegionInitDefaults( LORAMAC_REGION_EU868, &params );
+
+    channel.DrRange.Value = ( DR_5 << 4 ) | DR_0;
+    channelAdd.NewChannel = &channel;
+    for( uint8_t i = 0; i < ( sizeof( AddedChannels ) / sizeof( AddedChannels[0] ) ); i++ )
+    {
+        channel.Frequency = AddedChannels[i];
+        channelAdd.ChannelId = 3 + i;
+        status = RegionChannelAdd( LORAMAC_REGION_EU868, &channelAdd );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            Fail( "RegionChannelAdd", status );
+        }
+    }
+}
+
+/*!
+ * Sends the uplink on the channel found and returns its time on air
+ */
+static TimerTime_t SendUplink( uint8_t channel, int8_t datarate, uint16_t length, bool joined, SysTime_t elapsed )
+{
+    TxConfigParams_t txConfig;
+    SetBandTxDoneParams_t txDone;
+    TimerTime_t timeOnAir = 0;
+    int8_t txPower = 0;
+
+    txConfig.Channel = channel;
+    txConfig.Datarate = datarate;
+    txConfig.TxPower = 0;
+    txConfig.MaxEirp = 16;
+    txConfig.AntennaGain = 0;
+    txConfig.PktLen = length;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+    txConfig.NetworkActivation = ( joined == true ) ? ACTIVATION_TYPE_OTAA : ACTIVATION_TYPE_NONE;
+#endif /* REGION_VERSION */
+    if( RegionTxConfig( LORAMAC_REGION_EU868, &txConfig, &txPower, &timeOnAir ) == false )
+    {
+        Fail( "RegionTxConfig", datarate );
+    }
+    HostPlatformRunNextEvent( TimerGetCurrentTime( ) + timeOnAir );
+
+    txDone.Channel = channel;
+    txDone.Joined = joined;
+    txDone.LastTxDoneTime = TimerGetCurrentTime( );
+    txDone.LastTxAirTime = timeOnAir;
+    txDone.ElapsedTimeSinceStartUp = elapsed;
+    RegionSetBandTxDone( LORAMAC_REGION_EU868, &txDone );
+    return timeOnAir;
+}
+
+int main( int argc, char** argv )
+{
+    uint32_t searches = 0;
+    uint32_t uplinks = 0;
+    uint32_t restricted = 0;
+    uint32_t queries = 0;
+    uint64_t searchNs = 0;
+    TimerTime_t lastTxDone = 0;
+    int8_t datarate = DR_0;
+    uint16_t length = 13;
+    FILE* trace;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "Usage: %s <trace file>\n", argv[0] );
+        return 2;
+    }
+    trace = fopen( argv[1], "w" );
+    if( trace == NULL )
+    {
+        perror( argv[1] );
+        return 2;
+    }
+
+    // The clock starts at 1 ms, a null time is the never updated band
+    HostPlatformInit( 1 );
+    HostPlatformRunNextEvent( 1 );
+    SetupRegion( );
+
+    while( TimerGetCurrentTime( ) < SIM_DURATION )
+    {
+        TimerTime_t now = TimerGetCurrentTime( );
+        bool joined = ( now >= SIM_JOINED_AT ) &&
+                      ( ( now < SIM_REJOIN_AT ) || ( now >= ( SIM_REJOIN_AT + SIM_REJOIN_DURATION ) ) );
+        bool dutyCycleOn = ( now < SIM_DUTY_CYCLE_OFF_AT ) || ( now >= ( SIM_DUTY_CYCLE_OFF_AT + SIM_DUTY_CYCLE_OFF_DURATION ) );
+        NextChanParams_t nextChan = { 0 };
+        TimerTime_t aggregatedTimeOff = 0;
+        TimerTime_t time = 0;
+        uint8_t channel = 0;
+        uint32_t start;
+        LoRaMacStatus_t status;
+
+        if( SimRandom( SIM_UPLINK_CHANGE ) == 0 )
+        {
+            datarate = ( int8_t )SimRandom( DR_5 + 1 );
+            length = ( uint16_t )( 13 + SimRandom( 40 ) );
+        }
+        nextChan.AggrTimeOff = 0;
+        nextChan.LastAggrTx = lastTxDone;
+        nextChan.Datarate = datarate;
+        nextChan.Joined = joined;
+        nextChan.DutyCycleEnabled = dutyCycleOn;
+        nextChan.ElapsedTimeSinceStartUp = SysTimeFromMs( now );
+        nextChan.LastTxIsJoinRequest = !joined;
+        nextChan.PktLen = ( joined == true ) ? length : SIM_JOIN_REQUEST_LENGTH;
+        nextChan.QueryOnly = ( SimRandom( 10 ) == 0 );
+
+        start = HostPlatformGetTimestamp( );
+        status = RegionNextChannel( LORAMAC_REGION_EU868, &nextChan, &channel, &time, &aggregatedTimeOff );
+        searchNs += ( uint32_t )( HostPlatformGetTimestamp( ) - start );
+        searches++;
+
+        fprintf( trace, "%10u %c%c%c status %2d time %10u", now, ( joined == true ) ? 'J' : '-',
+                 ( dutyCycleOn == true ) ? 'D' : '-', ( nextChan.QueryOnly == true ) ? 'Q' : '-', status,
+                 ( status == LORAMAC_STATUS_OK ) ? 0 : time );
+        if( nextChan.QueryOnly == true )
+        {
+            fprintf( trace, " credits %10u ready %02x\n", nextChan.TimeCredits, GetReadyBands( ) );
+            queries++;
+            HostPlatformRunNextEvent( now + SimRandom( 1000 ) );
+            continue;
+        }
+        fprintf( trace, " channel %u ready %02x\n", ( status == LORAMAC_STATUS_OK ) ? channel : 0, GetReadyBands( ) );
+
+        if( status == LORAMAC_STATUS_OK )
+        {
+            SendUplink( channel, nextChan.Datarate, nextChan.PktLen, joined, nextChan.ElapsedTimeSinceStartUp );
+            lastTxDone = TimerGetCurrentTime( );
+            uplinks++;
+            HostPlatformRunNextEvent( lastTxDone + SimRandom( SIM_MAX_IDLE ) );
+        }
+        else
+        {
+            // Retry when the duty cycle allows it, at least once an hour
+            restricted++;
+            HostPlatformRunNextEvent( now + MIN( time, 3600000 ) + 1 + SimRandom( 100 ) );
+        }
+    }
+    fclose( trace );
+
+    printf( "LoRaWAN 0x%08X, region 0x%08X, incremental duty cycle %s: %u searches, %u uplinks, %u restricted, "
+            "%u queries, %u ns per search\n", LORAMAC_VERSION, REGION_VERSION,
+            ( REGION_DUTY_CYCLE_INCREMENTAL_ENABLED == 1 ) ? "on" : "off", searches, uplinks, restricted, queries,
+            ( uint32_t )( searchNs / searches ) );
+    return 0;
+}
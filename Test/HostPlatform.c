@@ -0,0 +1,596 @@
+/**
+  ******************************************************************************
+  * @file    HostPlatform.c
+  * @author  MCD Application Team
+  * @brief   Host timer server, system time and radio used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "systime.h"
+#include "HostPlatform.h"
+
+/*!
+ * Maximum number of timer objects created by the LoRaMac
+ */
+#define HOST_TIMER_MAX                              64
+
+/*!
+ * Timer objects created with UTIL_TIMER_Create
+ */
+static UTIL_TIMER_Object_t* Timers[HOST_TIMER_MAX];
+
+/*!
+ * Order in which the timers have been started, to run the timers expiring at
+ * the same time in the start order
+ */
+static uint32_t TimerStartOrder[HOST_TIMER_MAX];
+
+/*!
+ * Number of timer objects created
+ */
+static uint8_t TimerCount;
+
+/*!
+ * Number of timer starts
+ */
+static uint32_t TimerStarts;
+
+/*!
+ * Simulated time in ms
+ */
+static UTIL_TIMER_Time_t HostTime;
+
+/*!
+ * Offset of the system time set by SysTimeSet
+ */
+static SysTime_t SysTimeOffset;
+
+/*!
+ * Radio events of the LoRaMac
+ */
+static RadioEvents_t* HostRadioEvents;
+
+/*!
+ * Radio activity
+ */
+static HostRadioStatus_t HostRadio;
+
+/*!
+ * Maximum number of busy channels
+ */
+#define HOST_MAX_NB_BUSY_CHANNELS                   16
+
+/*!
+ * Channels found busy by the carrier sense
+ */
+static struct
+{
+    uint32_t Frequency;
+    uint16_t BusyPerMille;
+}HostBusyChannels[HOST_MAX_NB_BUSY_CHANNELS];
+
+static uint8_t HostNbBusyChannels;
+
+/*!
+ * Reception settings of the last SetRxConfig
+ */
+static struct
+{
+    RadioModems_t Modem;
+    uint32_t Bandwidth;
+    uint32_t Datarate;
+    uint16_t SymbTimeout;
+    bool RxContinuous;
+}HostRxConfig;
+
+/*!
+ * Transmission settings of the last SetTxConfig
+ */
+static HostRadioTxConfig_t HostTxConfig;
+
+/*!
+ * Ends the transmissions after their time on air
+ */
+static UTIL_TIMER_Object_t RadioTxTimer;
+
+/*!
+ * Ends the receptions in single mode after their timeout
+ */
+static UTIL_TIMER_Object_t RadioRxTimer;
+
+static int8_t FindTimer( UTIL_TIMER_Object_t *TimerObject )
+{
+    for( uint8_t i = 0; i < TimerCount; i++ )
+    {
+        if( Timers[i] == TimerObject )
+        {
+            return ( int8_t )i;
+        }
+    }
+    return -1;
+}
+
+UTIL_TIMER_Status_t UTIL_TIMER_Create( UTIL_TIMER_Object_t *TimerObject, uint32_t PeriodValue, UTIL_TIMER_Mode_t Mode,
+                                       void ( *Callback )( void * ), void *Argument )
+{
+    if( ( TimerObject == NULL ) || ( Callback == NULL ) )
+    {
+        return UTIL_TIMER_INVALID_PARAM;
+    }
+    if( FindTimer( TimerObject ) < 0 )
+    {
+        if( TimerCount >= HOST_TIMER_MAX )
+        {
+            return UTIL_TIMER_UNKNOWN_ERROR;
+        }
+        Timers[TimerCount++] = TimerObject;
+    }
+    memset( TimerObject, 0, sizeof( UTIL_TIMER_Object_t ) );
+    TimerObject->ReloadValue = PeriodValue;
+    TimerObject->Mode = Mode;
+    TimerObject->Callback = Callback;
+    TimerObject->argument = Argument;
+    return UTIL_TIMER_OK;
+}
+
+UTIL_TIMER_Status_t UTIL_TIMER_Start( UTIL_TIMER_Object_t *TimerObject )
+{
+    int8_t index = FindTimer( TimerObject );
+
+    if( index < 0 )
+    {
+        return UTIL_TIMER_INVALID_PARAM;
+    }
+    TimerObject->Timestamp = HostTime + TimerObject->ReloadValue;
+    TimerObject->IsRunning = 1;
+    TimerObject->IsReloadStopped = 0;
+    TimerStartOrder[index] = TimerStarts++;
+    return UTIL_TIMER_OK;
+}
+
+UTIL_TIMER_Status_t UTIL_TIMER_Stop( UTIL_TIMER_Object_t *TimerObject )
+{
+    if( TimerObject == NULL )
+    {
+        return UTIL_TIMER_INVALID_PARAM;
+    }
+    TimerObject->IsRunning = 0;
+    TimerObject->IsReloadStopped = 1;
+    return UTIL_TIMER_OK;
+}
+
+UTIL_TIMER_Status_t UTIL_TIMER_SetPeriod( UTIL_TIMER_Object_t *TimerObject, uint32_t NewPeriodValue )
+{
+    if( TimerObject == NULL )
+    {
+        return UTIL_TIMER_INVALID_PARAM;
+    }
+    TimerObject->ReloadValue = NewPeriodValue;
+    if( TimerObject->IsRunning != 0 )
+    {
+        // Same as the timer server: a running timer restarts with the new period
+        return UTIL_TIMER_Start( TimerObject );
+    }
+    return UTIL_TIMER_OK;
+}
+
+UTIL_TIMER_Status_t UTIL_TIMER_GetRemainingTime( UTIL_TIMER_Object_t *TimerObject, uint32_t *Time )
+{
+    if( ( TimerObject == NULL ) || ( Time == NULL ) || ( TimerObject->IsRunning == 0 ) )
+    {
+        return UTIL_TIMER_INVALID_PARAM;
+    }
+    *Time = TimerObject->Timestamp - HostTime;
+    return UTIL_TIMER_OK;
+}
+
+uint32_t UTIL_TIMER_IsRunning( UTIL_TIMER_Object_t *TimerObject )
+{
+    return ( TimerObject != NULL ) ? TimerObject->IsRunning : 0;
+}
+
+UTIL_TIMER_Time_t UTIL_TIMER_GetCurrentTime( void )
+{
+    return HostTime;
+}
+
+UTIL_TIMER_Time_t UTIL_TIMER_GetElapsedTime( UTIL_TIMER_Time_t past )
+{
+    return HostTime - past;
+}
+
+SysTime_t SysTimeAdd( SysTime_t a, SysTime_t b )
+{
+    SysTime_t c;
+
+    c.Seconds = a.Seconds + b.Seconds;
+    c.SubSeconds = a.SubSeconds + b.SubSeconds;
+    if( c.SubSeconds >= 1000 )
+    {
+        c.Seconds++;
+        c.SubSeconds -= 1000;
+    }
+    return c;
+}
+
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b )
+{
+    SysTime_t c;
+
+    c.Seconds = a.Seconds - b.Seconds;
+    c.SubSeconds = a.SubSeconds - b.SubSeconds;
+    if( c.SubSeconds < 0 )
+    {
+        c.Seconds--;
+        c.SubSeconds += 1000;
+    }
+    return c;
+}
+
+SysTime_t SysTimeGetMcuTime( void )
+{
+    SysTime_t mcuTime;
+
+    mcuTime.Seconds = HostTime / 1000;
+    mcuTime.SubSeconds = ( int16_t )( HostTime % 1000 );
+    return mcuTime;
+}
+
+void SysTimeSet( SysTime_t sysTime )
+{
+    SysTimeOffset = SysTimeSub( sysTime, SysTimeGetMcuTime( ) );
+}
+
+SysTime_t SysTimeGet( void )
+{
+    return SysTimeAdd( SysTimeGetMcuTime( ), SysTimeOffset );
+}
+
+uint32_t SysTimeToMs( SysTime_t sysTime )
+{
+    // Same as the STM32 utilities: the system time is converted to the timer time base
+    SysTime_t mcuTime = SysTimeSub( sysTime, SysTimeOffset );
+
+    return mcuTime.Seconds * 1000 + mcuTime.SubSeconds;
+}
+
+SysTime_t SysTimeFromMs( uint32_t timeMs )
+{
+    SysTime_t mcuTime;
+
+    mcuTime.Seconds = timeMs / 1000;
+    mcuTime.SubSeconds = ( int16_t )( timeMs % 1000 );
+    return SysTimeAdd( mcuTime, SysTimeOffset );
+}
+
+void HostPlatformInit( uint32_t seed )
+{
+    TimerCount = 0;
+    TimerStarts = 0;
+    HostTime = 0;
+    SysTimeOffset.Seconds = 0;
+    SysTimeOffset.SubSeconds = 0;
+    HostRadioEvents = NULL;
+    memset( &HostRadio, 0, sizeof( HostRadio ) );
+    memset( &HostRxConfig, 0, sizeof( HostRxConfig ) );
+    memset( &HostTxConfig, 0, sizeof( HostTxConfig ) );
+    HostNbBusyChannels = 0;
+    srand( seed );
+}
+
+bool HostPlatformRunNextEvent( TimerTime_t limit )
+{
+    int8_t next = -1;
+
+    for( uint8_t i = 0; i < TimerCount; i++ )
+    {
+        if( ( Timers[i]->IsRunning == 0 ) || ( ( int32_t )( Timers[i]->Timestamp - limit ) > 0 ) )
+        {
+            continue;
+        }
+        if( ( next < 0 ) ||
+            ( ( int32_t )( Timers[i]->Timestamp - Timers[next]->Timestamp ) < 0 ) ||
+            ( ( Timers[i]->Timestamp == Timers[next]->Timestamp ) && ( TimerStartOrder[i] < TimerStartOrder[next] ) ) )
+        {
+            next = ( int8_t )i;
+        }
+    }
+    if( next < 0 )
+    {
+        HostTime = limit;
+        return false;
+    }
+
+    UTIL_TIMER_Object_t* timer = Timers[next];
+
+    if( ( int32_t )( timer->Timestamp - HostTime ) > 0 )
+    {
+        HostTime = timer->Timestamp;
+    }
+    timer->IsRunning = 0;
+    if( timer->Mode == UTIL_TIMER_PERIODIC )
+    {
+        UTIL_TIMER_Start( timer );
+    }
+    timer->Callback( timer->argument );
+    return true;
+}
+
+uint32_t HostPlatformGetTimestamp( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( uint32_t )( ( uint64_t )now.tv_sec * 1000000000ULL + ( uint64_t )now.tv_nsec );
+}
+
+const HostRadioStatus_t* HostRadioGetStatus( void )
+{
+    return &HostRadio;
+}
+
+const HostRadioTxConfig_t* HostRadioGetTxConfig( void )
+{
+    return &HostTxConfig;
+}
+
+bool HostRadioSetChannelBusy( uint32_t frequency, uint16_t busyPerMille )
+{
+    uint8_t i = 0;
+
+    while( ( i < HostNbBusyChannels ) && ( HostBusyChannels[i].Frequency != frequency ) )
+    {
+        i++;
+    }
+    if( i == HOST_MAX_NB_BUSY_CHANNELS )
+    {
+        return false;
+    }
+    if( i == HostNbBusyChannels )
+    {
+        HostNbBusyChannels++;
+    }
+    HostBusyChannels[i].Frequency = frequency;
+    HostBusyChannels[i].BusyPerMille = busyPerMille;
+    return true;
+}
+
+bool HostRadioReceive( uint8_t* payload, uint16_t size, int16_t rssi, int8_t snr )
+{
+    if( HostRadio.State != RF_RX_RUNNING )
+    {
+        return false;
+    }
+    UTIL_TIMER_Stop( &RadioRxTimer );
+    if( HostRadio.RxContinuous == false )
+    {
+        HostRadio.State = RF_IDLE;
+    }
+    if( ( HostRadioEvents != NULL ) && ( HostRadioEvents->RxDone != NULL ) )
+    {
+        HostRadioEvents->RxDone( payload, size, rssi, snr );
+    }
+    return true;
+}
+
+/*!
+ * \brief LoRa symbol duration
+ *
+ * \param [IN] bandwidth - 0: 125 kHz, 1: 250 kHz, 2: 500 kHz
+ * \param [IN] datarate  - Spreading factor
+ *
+ * \retval Symbol duration in us
+ */
+static uint32_t LoRaSymbolTime( uint32_t bandwidth, uint32_t datarate )
+{
+    return ( ( uint32_t )1000 << datarate ) / ( 125 << ( bandwidth & 0x03 ) );
+}
+
+static uint32_t RadioTimeOnAir( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                                uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    if( modem == MODEM_FSK )
+    {
+        // Preamble, sync word, length, payload and CRC
+        return ( ( preambleLen + 3 + 1 + payloadLen + ( crcOn ? 2 : 0 ) ) * 8 * 1000 + datarate - 1 ) / datarate;
+    }
+
+    // Semtech AN1200.13 formula, low datarate optimize for SF11 and SF12 at 125 kHz
+    int32_t de = ( ( datarate >= 11 ) && ( bandwidth == 0 ) ) ? 1 : 0;
+    int32_t num = 8 * payloadLen - 4 * ( int32_t )datarate + 28 + ( crcOn ? 16 : 0 ) - ( fixLen ? 20 : 0 );
+    int32_t den = 4 * ( ( int32_t )datarate - 2 * de );
+    int32_t symbols = preambleLen + 4 + 8;
+
+    if( num > 0 )
+    {
+        symbols += ( ( num + den - 1 ) / den ) * ( coderate + 4 );
+    }
+    // Preamble and payload in us, the extra quarter symbol of the preamble is included
+    return ( symbols * LoRaSymbolTime( bandwidth, datarate ) + LoRaSymbolTime( bandwidth, datarate ) / 4 + 999 ) / 1000;
+}
+
+static void OnRadioTxTimerEvent( void* context )
+{
+    HostRadio.State = RF_IDLE;
+    if( ( HostRadioEvents != NULL ) && ( HostRadioEvents->TxDone != NULL ) )
+    {
+        HostRadioEvents->TxDone( );
+    }
+}
+
+static void OnRadioRxTimerEvent( void* context )
+{
+    HostRadio.State = RF_IDLE;
+    if( ( HostRadioEvents != NULL ) && ( HostRadioEvents->RxTimeout != NULL ) )
+    {
+        HostRadioEvents->RxTimeout( );
+    }
+}
+
+static void RadioInit( RadioEvents_t *events )
+{
+    HostRadioEvents = events;
+    HostRadio.State = RF_IDLE;
+    UTIL_TIMER_Create( &RadioTxTimer, 0, UTIL_TIMER_ONESHOT, OnRadioTxTimerEvent, NULL );
+    UTIL_TIMER_Create( &RadioRxTimer, 0, UTIL_TIMER_ONESHOT, OnRadioRxTimerEvent, NULL );
+}
+
+static RadioState_t RadioGetStatus( void )
+{
+    return HostRadio.State;
+}
+
+static void RadioSetModem( RadioModems_t modem )
+{
+}
+
+static void RadioSetChannel( uint32_t freq )
+{
+    HostRadio.Frequency = freq;
+}
+
+static bool RadioIsChannelFree( uint32_t freq, uint32_t rxBandwidth, int16_t rssiThresh, uint32_t maxCarrierSenseTime )
+{
+    HostRadio.CarrierSenseCount++;
+    // The carrier sense blocks for its whole duration
+    HostTime += maxCarrierSenseTime;
+    for( uint8_t i = 0; i < HostNbBusyChannels; i++ )
+    {
+        if( HostBusyChannels[i].Frequency == freq )
+        {
+            return ( uint32_t )( rand( ) % 1000 ) >= HostBusyChannels[i].BusyPerMille;
+        }
+    }
+    return true;
+}
+
+static uint32_t RadioRandom( void )
+{
+    return ( ( uint32_t )rand( ) << 16 ) ^ ( uint32_t )rand( );
+}
+
+static void RadioSetRxConfig( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                              uint32_t bandwidthAfc, uint16_t preambleLen, uint16_t symbTimeout, bool fixLen,
+                              uint8_t payloadLen, bool crcOn, bool freqHopOn, uint8_t hopPeriod,
+                              bool iqInverted, bool rxContinuous )
+{
+    HostRxConfig.Modem = modem;
+    HostRxConfig.Bandwidth = bandwidth;
+    HostRxConfig.Datarate = datarate;
+    HostRxConfig.SymbTimeout = symbTimeout;
+    HostRxConfig.RxContinuous = rxContinuous;
+}
+
+static void RadioSetTxConfig( RadioModems_t modem, int8_t power, uint32_t fdev, uint32_t bandwidth, uint32_t datarate,
+                              uint8_t coderate, uint16_t preambleLen, bool fixLen, bool crcOn, bool freqHopOn,
+                              uint8_t hopPeriod, bool iqInverted, uint32_t timeout )
+{
+    HostTxConfig.Modem = modem;
+    HostTxConfig.Bandwidth = bandwidth;
+    HostTxConfig.Datarate = datarate;
+    HostTxConfig.Coderate = coderate;
+    HostTxConfig.PreambleLen = preambleLen;
+    HostTxConfig.FixLen = fixLen;
+    HostTxConfig.CrcOn = crcOn;
+}
+
+static bool RadioCheckRfFrequency( uint32_t frequency )
+{
+    return true;
+}
+
+static void RadioSend( uint8_t *buffer, uint8_t size )
+{
+    memcpy( HostRadio.TxBuffer, buffer, size );
+    HostRadio.TxSize = size;
+    HostRadio.TxCount++;
+    HostRadio.LastTxTime = HostTime;
+    HostRadio.State = RF_TX_RUNNING;
+    UTIL_TIMER_Stop( &RadioRxTimer );
+    RadioTxTimer.ReloadValue = RadioTimeOnAir( HostTxConfig.Modem, HostTxConfig.Bandwidth, HostTxConfig.Datarate,
+                                               HostTxConfig.Coderate, HostTxConfig.PreambleLen, HostTxConfig.FixLen, size,
+                                               HostTxConfig.CrcOn );
+    UTIL_TIMER_Start( &RadioTxTimer );
+}
+
+static void RadioSleep( void )
+{
+    UTIL_TIMER_Stop( &RadioRxTimer );
+    HostRadio.State = RF_IDLE;
+    HostRadio.RxContinuous = false;
+}
+
+static void RadioRx( uint32_t timeout )
+{
+    HostRadio.RxCount++;
+    HostRadio.State = RF_RX_RUNNING;
+    HostRadio.RxContinuous = HostRxConfig.RxContinuous || ( timeout == 0 );
+    UTIL_TIMER_Stop( &RadioRxTimer );
+    if( HostRadio.RxContinuous == false )
+    {
+        uint32_t window = timeout;
+
+        if( HostRxConfig.Modem == MODEM_LORA )
+        {
+            // The single reception ends after the symbol timeout
+            window = ( HostRxConfig.SymbTimeout * LoRaSymbolTime( HostRxConfig.Bandwidth, HostRxConfig.Datarate ) + 999 ) / 1000;
+        }
+        RadioRxTimer.ReloadValue = ( window > 0 ) ? window : 1;
+        UTIL_TIMER_Start( &RadioRxTimer );
+    }
+}
+
+static void RadioSetTxContinuousWave( uint32_t freq, int8_t power, uint16_t time )
+{
+}
+
+static void RadioSetMaxPayloadLength( RadioModems_t modem, uint8_t max )
+{
+}
+
+static void RadioSetPublicNetwork( bool enable )
+{
+}
+
+static uint32_t RadioGetWakeupTime( void )
+{
+    return 1;
+}
+
+/*!
+ * Host radio, the functions not used by the LoRaMac are left NULL
+ */
+const struct Radio_s Radio =
+{
+    .Init = RadioInit,
+    .GetStatus = RadioGetStatus,
+    .SetModem = RadioSetModem,
+    .SetChannel = RadioSetChannel,
+    .IsChannelFree = RadioIsChannelFree,
+    .Random = RadioRandom,
+    .SetRxConfig = RadioSetRxConfig,
+    .SetTxConfig = RadioSetTxConfig,
+    .CheckRfFrequency = RadioCheckRfFrequency,
+    .TimeOnAir = RadioTimeOnAir,
+    .Send = RadioSend,
+    .Sleep = RadioSleep,
+    .Standby = RadioSleep,
+    .Rx = RadioRx,
+    .SetTxContinuousWave = RadioSetTxContinuousWave,
+    .SetMaxPayloadLength = RadioSetMaxPayloadLength,
+    .SetPublicNetwork = RadioSetPublicNetwork,
+    .GetWakeupTime = RadioGetWakeupTime,
+};
@@ -0,0 +1,188 @@
+/**
+  ******************************************************************************
+  * @file    HostPlatform.h
+  * @author  MCD Application Team
+  * @brief   Host timer server, system time and radio used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*!
+ * \defgroup  HOSTPLATFORM Host platform of the LoRaMac tests
+ *            The timers run on a simulated clock in ms which only advances when
+ *            the test calls \ref HostPlatformRunNextEvent. The radio does not
+ *            emit anything: a transmission ends after its time on air and a
+ *            reception ends with a timeout, unless the test hands a frame to
+ *            \ref HostRadioReceive while the reception is running. A carrier
+ *            sense finds the channel free, unless the test has made it busy
+ *            with \ref HostRadioSetChannelBusy.
+ * \{
+ */
+#ifndef __HOST_PLATFORM_H__
+#define __HOST_PLATFORM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+#include "radio.h"
+
+/*!
+ * Radio activity recorded by the host radio
+ */
+typedef struct sHostRadioStatus
+{
+    /*!
+     * Radio state
+     */
+    RadioState_t State;
+    /*!
+     * Set to true while a reception in continuous mode is running
+     */
+    bool RxContinuous;
+    /*!
+     * Frequency of the last channel set
+     */
+    uint32_t Frequency;
+    /*!
+     * Number of transmissions started with Radio.Send
+     */
+    uint32_t TxCount;
+    /*!
+     * Time of the last Radio.Send call
+     */
+    TimerTime_t LastTxTime;
+    /*!
+     * Number of receptions started with Radio.Rx
+     */
+    uint32_t RxCount;
+    /*!
+     * Number of carrier senses run with Radio.IsChannelFree
+     */
+    uint32_t CarrierSenseCount;
+    /*!
+     * Size of the last transmitted frame
+     */
+    uint8_t TxSize;
+    /*!
+     * Last transmitted frame
+     */
+    uint8_t TxBuffer[255];
+}HostRadioStatus_t;
+
+/*!
+ * Transmission settings of the last Radio.SetTxConfig
+ */
+typedef struct sHostRadioTxConfig
+{
+    /*!
+     * Modem
+     */
+    RadioModems_t Modem;
+    /*!
+     * Bandwidth index: 0: 125 kHz, 1: 250 kHz, 2: 500 kHz
+     */
+    uint32_t Bandwidth;
+    /*!
+     * Spreading factor for LoRa, bits per second for FSK
+     */
+    uint32_t Datarate;
+    /*!
+     * LoRa coding rate index
+     */
+    uint8_t Coderate;
+    /*!
+     * Preamble length, in symbols for LoRa, in bytes for FSK
+     */
+    uint16_t PreambleLen;
+    /*!
+     * Set to true for the fixed length frames
+     */
+    bool FixLen;
+    /*!
+     * Set to true when the payload CRC is sent
+     */
+    bool CrcOn;
+}HostRadioTxConfig_t;
+
+/*!
+ * \brief   Resets the simulated clock, the timers and the radio
+ *
+ * \param   [IN] seed - Seed of the radio random numbers
+ */
+void HostPlatformInit( uint32_t seed );
+
+/*!
+ * \brief   Runs the earliest timer expiring at or before the given time. The
+ *          simulated clock jumps to the expiry of the timer.
+ *
+ * \param   [IN] limit - Simulated time not to exceed in ms
+ *
+ * \retval  true when a timer callback has been run. Otherwise the clock is set
+ *          to limit and false is returned.
+ */
+bool HostPlatformRunNextEvent( TimerTime_t limit );
+
+/*!
+ * \brief   Monotonic timestamp of the profiling probes
+ *
+ * \retval  Timestamp in ns, wraps around every 4.29 s
+ */
+uint32_t HostPlatformGetTimestamp( void );
+
+/*!
+ * \brief   Gets the activity recorded by the host radio
+ *
+ * \retval  Radio status
+ */
+const HostRadioStatus_t* HostRadioGetStatus( void );
+
+/*!
+ * \brief   Gets the transmission settings of the last Radio.SetTxConfig
+ *
+ * \retval  Transmission settings
+ */
+const HostRadioTxConfig_t* HostRadioGetTxConfig( void );
+
+/*!
+ * \brief   Sets the probability that a carrier sense finds the channel busy.
+ *          Each carrier sense takes its maximum duration on the simulated clock.
+ *
+ * \param   [IN] frequency    - Channel frequency in Hz
+ * \param   [IN] busyPerMille - Probability in per mille, 0 for a channel always free
+ *
+ * \retval  false when too many channels are busy
+ */
+bool HostRadioSetChannelBusy( uint32_t frequency, uint16_t busyPerMille );
+
+/*!
+ * \brief   Ends the running reception with the given frame
+ *
+ * \param   [IN] payload - Received frame, it must stay valid until the LoRaMac has processed it
+ * \param   [IN] size    - Size of the frame
+ * \param   [IN] rssi    - RSSI of the frame
+ * \param   [IN] snr     - SNR of the frame
+ *
+ * \retval  true when a reception was running
+ */
+bool HostRadioReceive( uint8_t* payload, uint16_t size, int16_t rssi, int8_t snr );
+
+/*! \} defgroup HOSTPLATFORM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_PLATFORM_H__ */
@@ -0,0 +1,369 @@
+/**
+  ******************************************************************************
+  * @file    JoinSweepCheck.c
+  * @author  MCD Application Team
+  * @brief   Checks the join sweep of the US915 like regions on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: JoinSweepCheck [masks]
+ *
+ * Checks RegionBaseUSComputeNextJoinChannel in the sequential order against
+ * the walk of the sub-bands it replaces, on random remaining channel masks
+ * and group indexes, with the random generator seeded the same way: the
+ * status, the channel and the next index must be equal.
+ * Then plans join sweeps with each preferred sub-band and none: the order
+ * must be a permutation of the 8 sub-bands, starting with the preferred one,
+ * and a sweep on all the channels must probe one channel of each sub-band in
+ * that order per pass, up to the 64 125 kHz channels.
+ * Last, sends the join requests of US915 through RegionNextChannel: with
+ * REGION_JOIN_SWEEP_PLAN_ENABLED set by the build, the 500 kHz channel and
+ * the first 125 kHz one are in the preferred sub-band, and the sweep follows
+ * one planned order per pass; without, the sub-bands are probed in sequence.
+ * Returns 1 on any mismatch.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Region.h"
+#include "RegionCommon.h"
+#include "RegionBaseUS.h"
+#include "HostPlatform.h"
+
+/*!
+ * Number of 125 kHz channels and of sub-bands
+ */
+#define SWEEP_NB_125KHZ_CHANNELS                    64
+#define SWEEP_NB_SUB_BANDS                          8
+
+/*!
+ * Size of the channel masks of US915
+ */
+#define SWEEP_CHANNELS_MASK_SIZE                    6
+
+static RegionNvmDataGroup1_t RegionGroup1;
+static RegionNvmDataGroup2_t RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
+#endif /* REGION_VERSION */
+
+static uint32_t Mismatches;
+static uint32_t TotalMismatches;
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 2 );
+}
+
+static void Mismatch( const char* what, uint32_t a, uint32_t b )
+{
+    if( Mismatches < 10 )
+    {
+        printf( "  %s: %u, expected %u\n", what, a, b );
+    }
+    Mismatches++;
+    TotalMismatches++;
+}
+
+/*!
+ * Walk of the sub-bands in sequence, as RegionBaseUSComputeNext125kHzJoinChannel
+ * did before the sub-band orders
+ */
+static LoRaMacStatus_t ComputeNext125kHzJoinChannelSequence( uint16_t* channelsMaskRemaining,
+                                                             uint8_t* groupsCurrentIndex, uint8_t* newChannelIndex )
+{
+    uint16_t currentChannelMaskLeft;
+    uint8_t findAvailableChannelsIndex[8] = { 0 };
+    uint8_t availableChannels = 0;
+    uint8_t startIndex = *groupsCurrentIndex;
+
+    do
+    {
+        // For even numbers we need the 8 LSBs and for uneven the 8 MSBs
+        if( ( startIndex % 2 ) == 0 )
+        {
+            currentChannelMaskLeft = ( channelsMaskRemaining[startIndex / 2] & 0x00FF );
+        }
+        else
+        {
+            currentChannelMaskLeft = ( ( channelsMaskRemaining[startIndex / 2] >> 8 ) & 0x00FF );
+        }
+
+        availableChannels = 0;
+        for( uint8_t i = 0; i < 8; i++ )
+        {
+            if( ( currentChannelMaskLeft & ( 1 << i ) ) != 0 )
+            {
+                findAvailableChannelsIndex[availableChannels++] = i;
+            }
+        }
+
+        if( availableChannels > 0 )
+        {
+            *newChannelIndex = ( startIndex * 8 ) + findAvailableChannelsIndex[randr( 0, ( availableChannels - 1 ) )];
+        }
+
+        startIndex++;
+        if( startIndex > 7 )
+        {
+            startIndex = 0;
+        }
+    } while( ( availableChannels == 0 ) && ( startIndex != *groupsCurrentIndex ) );
+
+    if( availableChannels > 0 )
+    {
+        *groupsCurrentIndex = startIndex;
+        return LORAMAC_STATUS_OK;
+    }
+    return LORAMAC_STATUS_PARAMETER_INVALID;
+}
+
+static uint8_t GetSubBand( uint32_t subBandOrder, uint8_t position )
+{
+    return ( subBandOrder >> ( position * 4 ) ) & 0x0F;
+}
+
+/*!
+ * Compares the sequential order with the walk it replaces on random masks
+ */
+static void CheckSequentialOrder( uint32_t nbMasks )
+{
+    for( uint32_t m = 0; m < nbMasks; m++ )
+    {
+        uint16_t mask[SWEEP_CHANNELS_MASK_SIZE] = { 0 };
+        uint8_t index = ( uint8_t )( rand( ) % SWEEP_NB_SUB_BANDS );
+        uint8_t newIndex = index;
+        uint8_t oldIndex = index;
+        uint8_t newChannel = 0xFF;
+        uint8_t oldChannel = 0xFF;
+        uint32_t seed = ( uint32_t )rand( );
+        LoRaMacStatus_t newStatus;
+        LoRaMacStatus_t oldStatus;
+
+        // Sparse masks too, with whole sub-bands empty
+        for( uint8_t i = 0; i < 4; i++ )
+        {
+            mask[i] = ( uint16_t )( rand( ) & rand( ) & rand( ) );
+        }
+        if( ( m % 16 ) == 0 )
+        {
+            mask[m % 4] = 0;
+        }
+
+        srand1( seed );
+        newStatus = RegionBaseUSComputeNextJoinChannel( mask, REGION_BASE_US_JOIN_ORDER_SEQUENTIAL, &newIndex, &newChannel );
+        srand1( seed );
+        oldStatus = ComputeNext125kHzJoinChannelSequence( mask, &oldIndex, &oldChannel );
+
+        if( newStatus != oldStatus )
+        {
+            Mismatch( "sequential order status", newStatus, oldStatus );
+        }
+        else if( newStatus == LORAMAC_STATUS_OK )
+        {
+            if( newChannel != oldChannel )
+            {
+                Mismatch( "sequential order channel", newChannel, oldChannel );
+            }
+            if( newIndex != oldIndex )
+            {
+                Mismatch( "sequential order index", newIndex, oldIndex );
+            }
+        }
+    }
+}
+
+/*!
+ * Checks a planned order and a sweep on all the 125 kHz channels with it
+ */
+static void CheckPlannedSweep( uint8_t preferredSubBand )
+{
+    uint16_t mask[SWEEP_CHANNELS_MASK_SIZE] = { 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x00FF, 0x0000 };
+    uint8_t seen = 0;
+    uint8_t index = 0;
+    uint8_t channel;
+    uint32_t subBandOrder;
+
+    RegionBaseUSSetJoinPreferredSubBand( preferredSubBand );
+    subBandOrder = RegionBaseUSComputeJoinSweepOrder( );
+
+    for( uint8_t i = 0; i < SWEEP_NB_SUB_BANDS; i++ )
+    {
+        seen |= 1 << GetSubBand( subBandOrder, i );
+    }
+    if( ( seen != 0xFF ) || ( ( subBandOrder & 0x88888888 ) != 0 ) )
+    {
+        Mismatch( "planned order permutation", subBandOrder, preferredSubBand );
+        return;
+    }
+    if( ( preferredSubBand != 0 ) && ( GetSubBand( subBandOrder, 0 ) != ( preferredSubBand - 1 ) ) )
+    {
+        Mismatch( "planned order first sub-band", GetSubBand( subBandOrder, 0 ), preferredSubBand - 1 );
+    }
+    if( RegionBaseUSComputeNext500kHzJoinChannel( mask[4], subBandOrder ) != GetSubBand( subBandOrder, 0 ) )
+    {
+        Mismatch( "planned 500 kHz channel", RegionBaseUSComputeNext500kHzJoinChannel( mask[4], subBandOrder ),
+                  GetSubBand( subBandOrder, 0 ) );
+    }
+
+    for( uint8_t k = 0; k < SWEEP_NB_125KHZ_CHANNELS; k++ )
+    {
+        if( RegionBaseUSComputeNextJoinChannel( mask, subBandOrder, &index, &channel ) != LORAMAC_STATUS_OK )
+        {
+            Mismatch( "planned sweep status", k, SWEEP_NB_125KHZ_CHANNELS );
+            return;
+        }
+        if( ( channel / 8 ) != GetSubBand( subBandOrder, k % SWEEP_NB_SUB_BANDS ) )
+        {
+            Mismatch( "planned sweep sub-band", channel / 8, GetSubBand( subBandOrder, k % SWEEP_NB_SUB_BANDS ) );
+        }
+        if( ( mask[channel / 16] & ( 1 << ( channel % 16 ) ) ) == 0 )
+        {
+            Mismatch( "planned sweep channel probed twice", channel, k );
+        }
+        mask[channel / 16] &= ~( 1 << ( channel % 16 ) );
+    }
+    if( RegionBaseUSComputeNextJoinChannel( mask, subBandOrder, &index, &channel ) != LORAMAC_STATUS_PARAMETER_INVALID )
+    {
+        Mismatch( "planned sweep end", channel, SWEEP_NB_125KHZ_CHANNELS );
+    }
+}
+
+/*!
+ * Searches the channel of a US915 join request
+ */
+static uint8_t NextJoinChannel( int8_t datarate )
+{
+    NextChanParams_t nextChan = { 0 };
+    TimerTime_t aggregatedTimeOff = 0;
+    TimerTime_t time = 0;
+    uint8_t channel = 0;
+    LoRaMacStatus_t status;
+
+    nextChan.Datarate = datarate;
+    nextChan.Joined = false;
+    nextChan.DutyCycleEnabled = false;
+    nextChan.ElapsedTimeSinceStartUp = SysTimeFromMs( TimerGetCurrentTime( ) );
+    nextChan.PktLen = 23;
+    status = RegionNextChannel( LORAMAC_REGION_US915, &nextChan, &channel, &time, &aggregatedTimeOff );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "RegionNextChannel", status );
+    }
+    return channel;
+}
+
+/*!
+ * Checks the join requests of US915, one 500 kHz then the sweep of the 125 kHz channels
+ */
+static void CheckUS915Sweep( uint8_t preferredSubBand )
+{
+    InitDefaultsParams_t params;
+    uint8_t subBands[SWEEP_NB_SUB_BANDS] = { 0 };
+    uint8_t seen = 0;
+    uint8_t channel500kHz;
+    uint8_t channel;
+
+    params.Type = INIT_TYPE_DEFAULTS;
+    params.NvmGroup1 = &RegionGroup1;
+    params.NvmGroup2 = &RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+    params.Bands = &RegionBands;
+#endif /* REGION_VERSION */
+    RegionInitDefaults( LORAMAC_REGION_US915, &params );
+    RegionBaseUSSetJoinPreferredSubBand( preferredSubBand );
+
+    channel500kHz = NextJoinChannel( DR_4 );
+    for( uint8_t k = 0; k < SWEEP_NB_125KHZ_CHANNELS; k++ )
+    {
+        channel = NextJoinChannel( DR_0 );
+        if( k < SWEEP_NB_SUB_BANDS )
+        {
+            // The first pass gives the order of the sweep
+            subBands[k] = channel / 8;
+            seen |= 1 << subBands[k];
+        }
+        else if( ( channel / 8 ) != subBands[k % SWEEP_NB_SUB_BANDS] )
+        {
+            Mismatch( "US915 sweep sub-band", channel / 8, subBands[k % SWEEP_NB_SUB_BANDS] );
+        }
+    }
+    if( seen != 0xFF )
+    {
+        Mismatch( "US915 sweep sub-bands of the first pass", seen, 0xFF );
+    }
+
+#if (defined( REGION_JOIN_SWEEP_PLAN_ENABLED ) && ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ))
+    // The 500 kHz channel of the sweep is in its first sub-band, the preferred one
+    if( channel500kHz != ( 64 + subBands[0] ) )
+    {
+        Mismatch( "US915 500 kHz channel", channel500kHz, 64 + subBands[0] );
+    }
+    if( ( preferredSubBand != 0 ) && ( subBands[0] != ( preferredSubBand - 1 ) ) )
+    {
+        Mismatch( "US915 sweep first sub-band", subBands[0], preferredSubBand - 1 );
+    }
+#else
+    if( channel500kHz != 64 )
+    {
+        Mismatch( "US915 500 kHz channel", channel500kHz, 64 );
+    }
+    for( uint8_t i = 0; i < SWEEP_NB_SUB_BANDS; i++ )
+    {
+        if( subBands[i] != i )
+        {
+            Mismatch( "US915 sequential sweep sub-band", subBands[i], i );
+        }
+    }
+#endif /* REGION_JOIN_SWEEP_PLAN_ENABLED */
+}
+
+int main( int argc, char** argv )
+{
+    uint32_t nbMasks = 100000;
+
+    if( argc > 1 )
+    {
+        nbMasks = ( uint32_t )atoi( argv[1] );
+    }
+    if( nbMasks == 0 )
+    {
+        fprintf( stderr, "Usage: %s [masks]\n", argv[0] );
+        return 2;
+    }
+
+    HostPlatformInit( 1 );
+    printf( "LoRaWAN 0x%08X, join sweep plan %s\n", LORAMAC_VERSION,
+            ( REGION_JOIN_SWEEP_PLAN_ENABLED == 1 ) ? "on" : "off" );
+
+    CheckSequentialOrder( nbMasks );
+    printf( "sequential order on %u masks: %u mismatches\n", nbMasks, Mismatches );
+
+    Mismatches = 0;
+    for( uint8_t preferredSubBand = 0; preferredSubBand <= SWEEP_NB_SUB_BANDS; preferredSubBand++ )
+    {
+        for( uint8_t i = 0; i < 100; i++ )
+        {
+            CheckPlannedSweep( preferredSubBand );
+        }
+    }
+    printf( "planned sweeps with preferred sub-band 0 to 8: %u mismatches\n", Mismatches );
+
+    Mismatches = 0;
+    for( uint8_t preferredSubBand = 0; preferredSubBand <= SWEEP_NB_SUB_BANDS; preferredSubBand++ )
+    {
+        CheckUS915Sweep( preferredSubBand );
+    }
+    printf( "US915 join sweeps with preferred sub-band 0 to 8: %u mismatches\n", Mismatches );
+    return ( TotalMismatches == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    LbtSimulator.c
+  * @author  MCD Application Team
+  * @brief   Simulates the listen before talk on busy channels on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: LbtSimulator [uplinks]
+ *
+ * Sends uplinks through the channel search of AS923, operated in Japan, and
+ * of KR920, on 8 channels found busy by each carrier sense with their own
+ * probability. An uplink waits for a free channel: each carrier sense takes
+ * the carrier sense time of the region, and a search without free channel is
+ * retried after LBT_RETRY_DELAY. The uplink latency is the time from the
+ * first search to the transmission.
+ * Reports per region the carrier senses per uplink and the uplink latency,
+ * with LORAMAC_LBT_ADAPTIVE_ENABLED set by the build: busy history or
+ * random order of RegionCommonLbtFindFreeChannel.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Region.h"
+#include "RegionCommon.h"
+#include "HostPlatform.h"
+
+/*!
+ * Number of channels of the simulation
+ */
+#define LBT_NB_CHANNELS                             8
+
+/*!
+ * Delay before the next search when no free channel is found, in ms
+ */
+#define LBT_RETRY_DELAY                             1000
+
+/*!
+ * Idle time between the uplinks, in ms
+ */
+#define LBT_MIN_IDLE                                10000
+#define LBT_MAX_IDLE                                60000
+
+/*!
+ * Region under simulation, the channels after the default ones are added
+ */
+typedef struct sSimulatedRegion
+{
+    LoRaMacRegion_t Region;
+    const char* Name;
+    uint8_t NbDefaultChannels;
+    uint32_t Frequencies[LBT_NB_CHANNELS];
+}SimulatedRegion_t;
+
+static const SimulatedRegion_t Regions[] =
+{
+    { LORAMAC_REGION_AS923, "AS923 JP", 2,
+      { 923200000, 923400000, 920600000, 920800000, 921000000, 921200000, 921400000, 921600000 } },
+    { LORAMAC_REGION_KR920, "KR920", 3,
+      { 922100000, 922300000, 922500000, 920900000, 921100000, 921300000, 921500000, 921700000 } },
+};
+
+/*!
+ * Probability that a carrier sense finds the channel busy, per mille
+ */
+static const uint16_t BusyPerMille[LBT_NB_CHANNELS] = { 600, 900, 100, 800, 300, 950, 500, 200 };
+
+static RegionNvmDataGroup1_t RegionGroup1;
+static RegionNvmDataGroup2_t RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
+#endif /* REGION_VERSION */
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 2 );
+}
+
+static void SetupRegion( const SimulatedRegion_t* simulated )
+{
+    InitDefaultsParams_t params;
+    ChannelAddParams_t channelAdd;
+    ChannelParams_t channel = { 0 };
+    LoRaMacStatus_t status;
+
+    params.Type = INIT_TYPE_DEFAULTS;
+    params.NvmGroup1 = &RegionGroup1;
+    params.NvmGroup2 = &RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+    params.Bands = &RegionBands;
+#endif /* REGION_VERSION */
+    RegionInitDefaults( simulated->Region, &params );
+
+    channel.DrRange.Value = ( DR_5 << 4 ) | DR_0;
+    channelAdd.NewChannel = &channel;
+    for( uint8_t i = simulated->NbDefaultChannels; i < LBT_NB_CHANNELS; i++ )
+    {
+        channel.Frequency = simulated->Frequencies[i];
+        channelAdd.ChannelId = i;
+        status = RegionChannelAdd( simulated->Region, &channelAdd );
+        if( status != LORAMAC_STATUS_OK )
+        {
+            Fail( "RegionChannelAdd", status );
+        }
+    }
+    for( uint8_t i = 0; i < LBT_NB_CHANNELS; i++ )
+    {
+        HostRadioSetChannelBusy( simulated->Frequencies[i], BusyPerMille[i] );
+    }
+}
+
+static void SimulateRegion( const SimulatedRegion_t* simulated, uint32_t nbUplinks )
+{
+    uint32_t channelUplinks[LBT_NB_CHANNELS] = { 0 };
+    uint32_t noFreeChannel = 0;
+    uint64_t totalLatency = 0;
+    TimerTime_t maxLatency = 0;
+    uint32_t carrierSenses;
+
+    HostPlatformInit( 1 );
+    RegionCommonLbtReset( );
+    SetupRegion( simulated );
+
+    for( uint32_t u = 0; u < nbUplinks; u++ )
+    {
+        TimerTime_t request = TimerGetCurrentTime( );
+        TimerTime_t latency;
+        LoRaMacStatus_t status;
+        uint8_t channel = 0;
+
+        do
+        {
+            NextChanParams_t nextChan = { 0 };
+            TimerTime_t aggregatedTimeOff = 0;
+            TimerTime_t time = 0;
+
+            nextChan.Datarate = DR_2;
+            nextChan.Joined = true;
+            nextChan.DutyCycleEnabled = false;
+            nextChan.ElapsedTimeSinceStartUp = SysTimeFromMs( TimerGetCurrentTime( ) );
+            nextChan.PktLen = 20;
+            status = RegionNextChannel( simulated->Region, &nextChan, &channel, &time, &aggregatedTimeOff );
+            if( status == LORAMAC_STATUS_NO_FREE_CHANNEL_FOUND )
+            {
+                noFreeChannel++;
+                HostPlatformRunNextEvent( TimerGetCurrentTime( ) + LBT_RETRY_DELAY );
+            }
+            else if( status != LORAMAC_STATUS_OK )
+            {
+                Fail( "RegionNextChannel", status );
+            }
+        } while( status != LORAMAC_STATUS_OK );
+
+        latency = TimerGetCurrentTime( ) - request;
+        totalLatency += latency;
+        maxLatency = MAX( maxLatency, latency );
+        if( channel < LBT_NB_CHANNELS )
+        {
+            channelUplinks[channel]++;
+        }
+        HostPlatformRunNextEvent( TimerGetCurrentTime( ) + LBT_MIN_IDLE + ( rand( ) % ( LBT_MAX_IDLE - LBT_MIN_IDLE ) ) );
+    }
+    carrierSenses = HostRadioGetStatus( )->CarrierSenseCount;
+
+    printf( "%-8s %8u %12.2f %12.1f %10u %10u\n", simulated->Name, nbUplinks, ( double )carrierSenses / nbUplinks,
+            ( double )totalLatency / nbUplinks, maxLatency, noFreeChannel );
+    for( uint8_t i = 0; i < LBT_NB_CHANNELS; i++ )
+    {
+        printf( "  channel %u %9u Hz busy %5.1f %% %8u uplinks\n", i, simulated->Frequencies[i],
+                BusyPerMille[i] / 10.0, channelUplinks[i] );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    uint32_t nbUplinks = 1000;
+
+    if( argc > 1 )
+    {
+        nbUplinks = ( uint32_t )atoi( argv[1] );
+    }
+    if( nbUplinks == 0 )
+    {
+        fprintf( stderr, "Usage: %s [uplinks]\n", argv[0] );
+        return 2;
+    }
+
+    printf( "LoRaWAN 0x%08X, LBT channel order: %s\n", LORAMAC_VERSION,
+            ( LORAMAC_LBT_ADAPTIVE_ENABLED == 1 ) ? "least busy first" : "random" );
+    printf( "%-8s %8s %12s %12s %10s %10s\n", "region", "uplinks", "senses/up", "latency ms", "max ms", "no free" );
+    for( uint8_t i = 0; i < ( sizeof( Regions ) / sizeof( Regions[0] ) ); i++ )
+    {
+        SimulateRegion( &Regions[i], nbUplinks );
+    }
+    return 0;
+}
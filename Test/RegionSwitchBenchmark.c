@@ -0,0 +1,413 @@
+/**
+  ******************************************************************************
+  * @file    RegionSwitchBenchmark.c
+  * @author  MCD Application Team
+  * @brief   Measures the LoRaMac region switch on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: RegionSwitchBenchmark [iterations]
+ *
+ * Each iteration switches the region of a freshly initialized EU868
+ * end-device, activated by personalization, with an added channel and an
+ * uplink sent, to IN865 and back a few times.
+ * It checks that the session is kept: device address, uplink frame counter
+ * and session keys, and that the added channel is back with EU868.
+ * It reports the LORAMAC_PROFILING_REGION_SWITCH duration, in ns of host
+ * time, and the deepest stack usage of the switch to a region used for the
+ * first time and of the switch back to a region kept in a slot.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "LoRaMacProfiling.h"
+#include "HostPlatform.h"
+#include "ReplayKeys.h"
+
+/*!
+ * Number of switches back to a region kept in a slot, per iteration
+ */
+#define SWITCH_NB_RESTORES                          8
+
+/*!
+ * EU868 channel added before the switches
+ */
+#define SWITCH_ADDED_CHANNEL_ID                     3
+#define SWITCH_ADDED_CHANNEL_FREQUENCY              867100000
+
+/*!
+ * Longest time of the uplink sent before the switches in ms
+ */
+#define SWITCH_MAX_UPLINK_TIME                      10000
+
+/*!
+ * Kinds of region switches
+ */
+typedef enum eSwitchKind
+{
+    SWITCH_FIRST_USE,
+    SWITCH_RESTORE,
+    SWITCH_KIND_MAX
+}SwitchKind_t;
+
+static const char* const KindNames[SWITCH_KIND_MAX] = { "first", "restore" };
+
+/*!
+ * Results of a kind of region switch
+ */
+typedef struct sKindResults
+{
+    uint32_t Switches;
+    uint32_t Min;
+    uint32_t Max;
+    uint64_t Total;
+    uint32_t MaxStackDepth;
+}KindResults_t;
+
+static KindResults_t Results[SWITCH_KIND_MAX];
+
+/*!
+ * Session state the region switches must keep
+ */
+typedef struct sSessionState
+{
+    uint32_t DevAddr;
+    uint32_t FCntUp;
+    uint8_t NwkSKey[16];
+    uint8_t AppSKey[16];
+}SessionState_t;
+
+static SessionState_t Session;
+
+static bool ProcessPending;
+
+static bool McpsConfirmReceived;
+
+static uint8_t DevEui[8] = REPLAY_DEV_EUI;
+static uint8_t JoinEui[8] = REPLAY_JOIN_EUI;
+static uint8_t NwkKey[16] = REPLAY_NWK_KEY;
+static uint8_t AppKey[16] = REPLAY_APP_KEY;
+static uint8_t NwkSKey[16] = REPLAY_NWK_S_KEY;
+static uint8_t AppSKey[16] = REPLAY_APP_S_KEY;
+
+static void OnMcpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+    McpsConfirmReceived = true;
+}
+
+static void OnMcpsIndication( McpsIndication_t* mcpsIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+}
+
+static void OnMlmeIndication( MlmeIndication_t* mlmeIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives =
+{
+    .MacMcpsConfirm = OnMcpsConfirm,
+    .MacMcpsIndication = OnMcpsIndication,
+    .MacMlmeConfirm = OnMlmeConfirm,
+    .MacMlmeIndication = OnMlmeIndication,
+};
+
+static LoRaMacCallback_t Callbacks =
+{
+    .MacProcessNotify = OnMacProcessNotify,
+};
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 2 );
+}
+
+static void SetMib( Mib_t type, MibRequestConfirm_t* mib )
+{
+    LoRaMacStatus_t status;
+
+    mib->Type = type;
+    status = LoRaMacMibSetRequestConfirm( mib );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        fprintf( stderr, "MIB %d ", type );
+        Fail( "LoRaMacMibSetRequestConfirm", status );
+    }
+}
+
+static void ProcessMac( void )
+{
+    while( ProcessPending == true )
+    {
+        ProcessPending = false;
+        LoRaMacProcess( );
+    }
+}
+
+/*!
+ * Copies a session key from the secure element context
+ */
+static void GetSessionKey( SecureElementNvmData_t* secureElement, KeyIdentifier_t keyId, uint8_t* key )
+{
+    for( uint8_t i = 0; i < NUM_OF_KEYS; i++ )
+    {
+        if( secureElement->KeyList[i].KeyID == keyId )
+        {
+            memcpy( key, secureElement->KeyList[i].KeyValue, 16 );
+            return;
+        }
+    }
+    Fail( "Session key not found", keyId );
+}
+
+/*!
+ * Reads the session state from the LoRaMac contexts
+ */
+static void GetSession( SessionState_t* session )
+{
+    MibRequestConfirm_t mib;
+    LoRaMacNvmData_t* nvm;
+
+    memset( session, 0, sizeof( SessionState_t ) );
+    mib.Type = MIB_DEV_ADDR;
+    if( LoRaMacMibGetRequestConfirm( &mib ) != LORAMAC_STATUS_OK )
+    {
+        Fail( "MIB_DEV_ADDR", 0 );
+    }
+    session->DevAddr = mib.Param.DevAddr;
+
+    mib.Type = MIB_NVM_CTXS;
+    if( LoRaMacMibGetRequestConfirm( &mib ) != LORAMAC_STATUS_OK )
+    {
+        Fail( "MIB_NVM_CTXS", 0 );
+    }
+    nvm = ( LoRaMacNvmData_t* )mib.Param.Contexts;
+    session->FCntUp = nvm->Crypto.FCntList.FCntUp;
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    GetSessionKey( &nvm->SecureElement, F_NWK_S_INT_KEY, session->NwkSKey );
+#else
+    GetSessionKey( &nvm->SecureElement, NWK_S_KEY, session->NwkSKey );
+#endif /* LORAMAC_VERSION */
+    GetSessionKey( &nvm->SecureElement, APP_S_KEY, session->AppSKey );
+}
+
+/*!
+ * Sends an unconfirmed uplink, so that the frame counter is the one of a used session
+ */
+static void SendUplink( void )
+{
+    static uint8_t appData[] = { 0x01, 0x02, 0x03, 0x04 };
+    TimerTime_t limit = TimerGetCurrentTime( ) + SWITCH_MAX_UPLINK_TIME;
+    McpsReq_t mcpsReq;
+    LoRaMacStatus_t status;
+
+    McpsConfirmReceived = false;
+    mcpsReq.Type = MCPS_UNCONFIRMED;
+    mcpsReq.Req.Unconfirmed.fPort = 2;
+    mcpsReq.Req.Unconfirmed.fBuffer = appData;
+    mcpsReq.Req.Unconfirmed.fBufferSize = sizeof( appData );
+    mcpsReq.Req.Unconfirmed.Datarate = DR_5;
+    status = LoRaMacMcpsRequest( &mcpsReq, false );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcpsRequest", status );
+    }
+
+    ProcessMac( );
+    while( ( McpsConfirmReceived == false ) || ( LoRaMacIsBusy( ) == true ) )
+    {
+        if( HostPlatformRunNextEvent( limit ) == false )
+        {
+            Fail( "Uplink", 0 );
+        }
+        ProcessMac( );
+    }
+}
+
+/*!
+ * Initializes the LoRaMac of the EU868 end-device, activated by personalization,
+ * with an added channel, and sends an uplink
+ */
+static void SetupMac( void )
+{
+    MibRequestConfirm_t mib;
+    ChannelParams_t channel;
+    LoRaMacStatus_t status;
+
+    HostPlatformInit( 1 );
+    ProcessPending = false;
+
+    status = LoRaMacInitialization( &Primitives, &Callbacks, LORAMAC_REGION_EU868 );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacInitialization", status );
+    }
+    mib.Param.DevEui = DevEui;
+    SetMib( MIB_DEV_EUI, &mib );
+    mib.Param.JoinEui = JoinEui;
+    SetMib( MIB_JOIN_EUI, &mib );
+    mib.Param.NwkKey = NwkKey;
+    SetMib( MIB_NWK_KEY, &mib );
+    mib.Param.AppKey = AppKey;
+    SetMib( MIB_APP_KEY, &mib );
+
+    status = LoRaMacStart( );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacStart", status );
+    }
+    LoRaMacTestSetDutyCycleOn( false );
+
+    mib.Param.NetID = REPLAY_NET_ID;
+    SetMib( MIB_NET_ID, &mib );
+    mib.Param.DevAddr = REPLAY_DEV_ADDR;
+    SetMib( MIB_DEV_ADDR, &mib );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    mib.Param.FNwkSIntKey = NwkSKey;
+    SetMib( MIB_F_NWK_S_INT_KEY, &mib );
+    mib.Param.SNwkSIntKey = NwkSKey;
+    SetMib( MIB_S_NWK_S_INT_KEY, &mib );
+    mib.Param.NwkSEncKey = NwkSKey;
+    SetMib( MIB_NWK_S_ENC_KEY, &mib );
+    mib.Param.AbpLrWanVersion.Value = 0x01010100;
+    SetMib( MIB_ABP_LORAWAN_VERSION, &mib );
+#else
+    mib.Param.NwkSKey = NwkSKey;
+    SetMib( MIB_NWK_S_KEY, &mib );
+#endif /* LORAMAC_VERSION */
+    mib.Param.AppSKey = AppSKey;
+    SetMib( MIB_APP_S_KEY, &mib );
+    mib.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+    SetMib( MIB_NETWORK_ACTIVATION, &mib );
+
+    memset( &channel, 0, sizeof( channel ) );
+    channel.Frequency = SWITCH_ADDED_CHANNEL_FREQUENCY;
+    channel.DrRange.Fields.Min = DR_0;
+    channel.DrRange.Fields.Max = DR_5;
+    status = LoRaMacChannelAdd( SWITCH_ADDED_CHANNEL_ID, channel );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacChannelAdd", status );
+    }
+    ProcessMac( );
+
+    SendUplink( );
+    GetSession( &Session );
+    if( ( Session.FCntUp == 0 ) || ( memcmp( Session.NwkSKey, NwkSKey, 16 ) != 0 ) ||
+        ( memcmp( Session.AppSKey, AppSKey, 16 ) != 0 ) )
+    {
+        Fail( "Session of the uplink", Session.FCntUp );
+    }
+}
+
+/*!
+ * Switches the region, checks that the session is kept and records the measurement
+ *
+ * \param [IN] region - New region
+ * \param [IN] kind   - Kind of the switch
+ */
+static void SwitchRegion( LoRaMacRegion_t region, SwitchKind_t kind )
+{
+    KindResults_t* results = &Results[kind];
+    LoRaMacProfilingStats_t stats;
+    SessionState_t session;
+    MibRequestConfirm_t mib;
+    LoRaMacStatus_t status;
+
+    LoRaMacProfilingReset( );
+    status = LoRaMacRegionSwitch( region );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacRegionSwitch", status );
+    }
+    ProcessMac( );
+
+    // Device address, uplink frame counter and session keys
+    GetSession( &session );
+    if( ( session.DevAddr != REPLAY_DEV_ADDR ) || ( memcmp( &session, &Session, sizeof( SessionState_t ) ) != 0 ) )
+    {
+        Fail( "Session kept by the switch", region );
+    }
+
+    // The channel added to EU868 is kept in its slot
+    if( region == LORAMAC_REGION_EU868 )
+    {
+        mib.Type = MIB_CHANNELS;
+        if( ( LoRaMacMibGetRequestConfirm( &mib ) != LORAMAC_STATUS_OK ) ||
+            ( mib.Param.ChannelList[SWITCH_ADDED_CHANNEL_ID].Frequency != SWITCH_ADDED_CHANNEL_FREQUENCY ) )
+        {
+            Fail( "EU868 channel kept by the switch", region );
+        }
+    }
+
+    // The measurement of the switch is the only REGION_SWITCH one since the reset
+    if( ( LoRaMacProfilingGetStats( LORAMAC_PROFILING_REGION_SWITCH, &stats ) != LORAMAC_STATUS_OK ) || ( stats.Count == 0 ) )
+    {
+        Fail( "Switch not measured", region );
+    }
+    if( ( results->Switches == 0 ) || ( stats.Max < results->Min ) )
+    {
+        results->Min = stats.Max;
+    }
+    if( stats.Max > results->Max )
+    {
+        results->Max = stats.Max;
+    }
+    if( stats.MaxStackDepth > results->MaxStackDepth )
+    {
+        results->MaxStackDepth = stats.MaxStackDepth;
+    }
+    results->Total += stats.Max;
+    results->Switches++;
+}
+
+int main( int argc, char** argv )
+{
+    int iterations = 100;
+
+    if( argc > 1 )
+    {
+        iterations = atoi( argv[1] );
+    }
+
+    for( int i = 0; i < iterations; i++ )
+    {
+        SetupMac( );
+        SwitchRegion( LORAMAC_REGION_IN865, SWITCH_FIRST_USE );
+        for( uint8_t j = 0; j < SWITCH_NB_RESTORES; j++ )
+        {
+            SwitchRegion( ( ( j % 2 ) == 0 ) ? LORAMAC_REGION_EU868 : LORAMAC_REGION_IN865, SWITCH_RESTORE );
+        }
+    }
+
+    printf( "LoRaWAN 0x%08X, EU868 <-> IN865 x %d iterations, stack painted on %d bytes\n",
+            LORAMAC_VERSION, iterations, LORAMAC_PROFILING_STACK_PAINT_SIZE );
+    printf( "%-8s %8s %10s %10s %10s %8s\n", "switch", "count", "min ns", "mean ns", "max ns", "stack B" );
+    for( uint8_t k = 0; k < SWITCH_KIND_MAX; k++ )
+    {
+        printf( "%-8s %8u %10u %10u %10u %8u\n", KindNames[k], Results[k].Switches, Results[k].Min,
+                ( uint32_t )( Results[k].Total / Results[k].Switches ), Results[k].Max, Results[k].MaxStackDepth );
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file    ReplayKeys.h
+  * @author  MCD Application Team
+  * @brief   Identity and keys shared by the replay corpus generator and the benchmark
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __REPLAY_KEYS_H__
+#define __REPLAY_KEYS_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Device address of the activated end-device
+ */
+#define REPLAY_DEV_ADDR                             0x260B1234
+
+/*!
+ * Network identifier
+ */
+#define REPLAY_NET_ID                               0x000013
+
+/*!
+ * Multicast group address, group 0
+ */
+#define REPLAY_MC_ADDR                              0x260BAAAA
+
+/*!
+ * Device EUI, MSB first as in se-identity.h
+ */
+#define REPLAY_DEV_EUI                              { 0x00, 0x80, 0xE1, 0x15, 0x00, 0x00, 0x12, 0x34 }
+
+/*!
+ * Join EUI, MSB first as in se-identity.h
+ */
+#define REPLAY_JOIN_EUI                             { 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01 }
+
+/*!
+ * Root network key, also the application root key of the LoRaWAN 1.0.x
+ */
+#define REPLAY_NWK_KEY                              { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, \
+                                                      0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C }
+
+/*!
+ * Root application key
+ */
+#define REPLAY_APP_KEY                              { 0x3C, 0x4F, 0xCF, 0x09, 0x88, 0x15, 0xF7, 0xAB, \
+                                                      0xA6, 0xD2, 0xAE, 0x28, 0x16, 0x15, 0x7E, 0x2B }
+
+/*!
+ * Network session key. Used as FNwkSIntKey, SNwkSIntKey and NwkSEncKey by the LoRaWAN 1.1.x
+ */
+#define REPLAY_NWK_S_KEY                            { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, \
+                                                      0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00 }
+
+/*!
+ * Application session key
+ */
+#define REPLAY_APP_S_KEY                            { 0x0F, 0x1E, 0x2D, 0x3C, 0x4B, 0x5A, 0x69, 0x78, \
+                                                      0x87, 0x96, 0xA5, 0xB4, 0xC3, 0xD2, 0xE1, 0xF0 }
+
+/*!
+ * Multicast network session key, group 0
+ */
+#define REPLAY_MC_NWK_S_KEY                         { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, \
+                                                      0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF }
+
+/*!
+ * Multicast application session key, group 0
+ */
+#define REPLAY_MC_APP_S_KEY                         { 0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, \
+                                                      0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE, 0xBF }
+
+/*!
+ * US915 channel mask carried by the CFList of type 1 of the US915 join-accept:
+ * channels 8 to 15 and the 500 kHz channel 65, ChMask0 to ChMask4
+ */
+#define REPLAY_US915_CFLIST_MASK                    { 0xFF00, 0x0000, 0x0000, 0x0000, 0x0002 }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REPLAY_KEYS_H__ */
@@ -0,0 +1,521 @@
+/**
+  ******************************************************************************
+  * @file    RxBenchmark.c
+  * @author  MCD Application Team
+  * @brief   Replays a downlink corpus through the LoRaMac receive path on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: RxBenchmark <corpus file> [iterations]
+ *
+ * Each iteration replays the corpus written by CorpusGen on a freshly
+ * initialized LoRaMac, checks that every frame is accepted or dropped as
+ * expected and reports per kind of frame the LORAMAC_PROFILING_RX_TOTAL
+ * duration, in ns of host time, and the deepest stack usage of the
+ * reception processing. The end-device is in the EU868 region, except for
+ * the join915 join-accept, which must also apply the channel mask of its
+ * CFList.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LoRaMac.h"
+#include "LoRaMacTest.h"
+#include "LoRaMacProfiling.h"
+#include "HostPlatform.h"
+#include "ReplayKeys.h"
+
+/*!
+ * Maximum number of frames of the corpus
+ */
+#define CORPUS_MAX_ENTRIES                          512
+
+/*!
+ * Longest simulated time waited for the LoRaMac, in ms. Covers the join duty cycle back-off.
+ */
+#define BENCH_MAX_WAIT                              ( 4 * 3600 * 1000 )
+
+/*!
+ * Kinds of corpus frames
+ */
+typedef enum eCorpusKind
+{
+    CORPUS_DATA,
+    CORPUS_MCAST,
+    CORPUS_FOREIGN,
+    CORPUS_BEACON,
+    CORPUS_JOIN,
+    CORPUS_JOIN_US915,
+    CORPUS_KIND_MAX
+}CorpusKind_t;
+
+static const char* const KindNames[CORPUS_KIND_MAX] = { "data", "mcast", "foreign", "beacon", "join", "join915" };
+
+/*!
+ * Corpus frame
+ */
+typedef struct sCorpusEntry
+{
+    CorpusKind_t Kind;
+    bool Expected;
+    uint8_t Size;
+    uint8_t Frame[255];
+}CorpusEntry_t;
+
+/*!
+ * Results of a kind of frames
+ */
+typedef struct sKindResults
+{
+    uint32_t Frames;
+    uint32_t Mismatches;
+    uint32_t Min;
+    uint32_t Max;
+    uint64_t Total;
+    uint32_t MaxStackDepth;
+}KindResults_t;
+
+static CorpusEntry_t Corpus[CORPUS_MAX_ENTRIES];
+static uint16_t CorpusSize;
+static KindResults_t Results[CORPUS_KIND_MAX];
+
+/*!
+ * Frame handed to the LoRaMac, which decrypts it in place
+ */
+static uint8_t RxBuffer[255];
+
+static bool ProcessPending;
+static bool McpsIndicationOk;
+static bool JoinConfirmOk;
+static bool BeaconAcquisitionOk;
+
+static uint8_t DevEui[8] = REPLAY_DEV_EUI;
+static uint8_t JoinEui[8] = REPLAY_JOIN_EUI;
+static uint8_t NwkKey[16] = REPLAY_NWK_KEY;
+static uint8_t AppKey[16] = REPLAY_APP_KEY;
+static uint8_t NwkSKey[16] = REPLAY_NWK_S_KEY;
+static uint8_t AppSKey[16] = REPLAY_APP_S_KEY;
+static uint8_t McNwkSKey[16] = REPLAY_MC_NWK_S_KEY;
+static uint8_t McAppSKey[16] = REPLAY_MC_APP_S_KEY;
+static const uint16_t Us915CfListMask[5] = REPLAY_US915_CFLIST_MASK;
+
+static void OnMcpsConfirm( McpsConfirm_t* mcpsConfirm )
+{
+}
+
+static void OnMcpsIndication( McpsIndication_t* mcpsIndication, LoRaMacRxStatus_t* rxStatus )
+{
+    McpsIndicationOk = ( mcpsIndication->Status == LORAMAC_EVENT_INFO_STATUS_OK );
+}
+
+static void OnMlmeConfirm( MlmeConfirm_t* mlmeConfirm )
+{
+    if( mlmeConfirm->MlmeRequest == MLME_JOIN )
+    {
+        JoinConfirmOk = ( mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK );
+    }
+    else if( mlmeConfirm->MlmeRequest == MLME_BEACON_ACQUISITION )
+    {
+        BeaconAcquisitionOk = ( mlmeConfirm->Status == LORAMAC_EVENT_INFO_STATUS_OK );
+    }
+}
+
+static void OnMlmeIndication( MlmeIndication_t* mlmeIndication, LoRaMacRxStatus_t* rxStatus )
+{
+}
+
+static void OnMacProcessNotify( void )
+{
+    ProcessPending = true;
+}
+
+static LoRaMacPrimitives_t Primitives =
+{
+    .MacMcpsConfirm = OnMcpsConfirm,
+    .MacMcpsIndication = OnMcpsIndication,
+    .MacMlmeConfirm = OnMlmeConfirm,
+    .MacMlmeIndication = OnMlmeIndication,
+};
+
+static LoRaMacCallback_t Callbacks =
+{
+    .MacProcessNotify = OnMacProcessNotify,
+};
+
+static void Fail( const char* what, int status )
+{
+    fprintf( stderr, "%s failed with status %d\n", what, status );
+    exit( 2 );
+}
+
+static void SetMib( Mib_t type, MibRequestConfirm_t* mib )
+{
+    LoRaMacStatus_t status;
+
+    mib->Type = type;
+    status = LoRaMacMibSetRequestConfirm( mib );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        fprintf( stderr, "MIB %d ", type );
+        Fail( "LoRaMacMibSetRequestConfirm", status );
+    }
+}
+
+static void ProcessMac( void )
+{
+    while( ProcessPending == true )
+    {
+        ProcessPending = false;
+        LoRaMacProcess( );
+    }
+}
+
+/*!
+ * Runs the LoRaMac until the radio receives or the LoRaMac is idle
+ *
+ * \param [IN] forRx - Waits for a reception when true, else for the LoRaMac to be idle
+ *
+ * \retval true when the condition has been reached
+ */
+static bool RunMac( bool forRx )
+{
+    TimerTime_t limit = TimerGetCurrentTime( ) + BENCH_MAX_WAIT;
+
+    do
+    {
+        ProcessMac( );
+        if( ( forRx == true ) && ( HostRadioGetStatus( )->State == RF_RX_RUNNING ) )
+        {
+            return true;
+        }
+        if( ( forRx == false ) && ( LoRaMacIsBusy( ) == false ) )
+        {
+            return true;
+        }
+    } while( HostPlatformRunNextEvent( limit ) == true );
+    return false;
+}
+
+/*!
+ * Initializes the LoRaMac of the end-device, activated by personalization. In
+ * EU868, it also joins the multicast group of the corpus.
+ *
+ * \param [IN] region - Region of the end-device
+ */
+static void SetupMac( LoRaMacRegion_t region )
+{
+    MibRequestConfirm_t mib;
+    McChannelParams_t mcChannel;
+    LoRaMacStatus_t status;
+
+    HostPlatformInit( 1 );
+    ProcessPending = false;
+
+    status = LoRaMacInitialization( &Primitives, &Callbacks, region );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacInitialization", status );
+    }
+    mib.Param.DevEui = DevEui;
+    SetMib( MIB_DEV_EUI, &mib );
+    mib.Param.JoinEui = JoinEui;
+    SetMib( MIB_JOIN_EUI, &mib );
+    mib.Param.NwkKey = NwkKey;
+    SetMib( MIB_NWK_KEY, &mib );
+    mib.Param.AppKey = AppKey;
+    SetMib( MIB_APP_KEY, &mib );
+
+    status = LoRaMacStart( );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacStart", status );
+    }
+    LoRaMacTestSetDutyCycleOn( false );
+
+    mib.Param.NetID = REPLAY_NET_ID;
+    SetMib( MIB_NET_ID, &mib );
+    mib.Param.DevAddr = REPLAY_DEV_ADDR;
+    SetMib( MIB_DEV_ADDR, &mib );
+#if (defined( LORAMAC_VERSION ) && ( LORAMAC_VERSION == 0x01010100 ))
+    mib.Param.FNwkSIntKey = NwkSKey;
+    SetMib( MIB_F_NWK_S_INT_KEY, &mib );
+    mib.Param.SNwkSIntKey = NwkSKey;
+    SetMib( MIB_S_NWK_S_INT_KEY, &mib );
+    mib.Param.NwkSEncKey = NwkSKey;
+    SetMib( MIB_NWK_S_ENC_KEY, &mib );
+    mib.Param.AbpLrWanVersion.Value = 0x01010100;
+    SetMib( MIB_ABP_LORAWAN_VERSION, &mib );
+#else
+    mib.Param.NwkSKey = NwkSKey;
+    SetMib( MIB_NWK_S_KEY, &mib );
+#endif /* LORAMAC_VERSION */
+    mib.Param.AppSKey = AppSKey;
+    SetMib( MIB_APP_S_KEY, &mib );
+    mib.Param.NetworkActivation = ACTIVATION_TYPE_ABP;
+    SetMib( MIB_NETWORK_ACTIVATION, &mib );
+    if( region != LORAMAC_REGION_EU868 )
+    {
+        ProcessMac( );
+        return;
+    }
+
+    memset( &mcChannel, 0, sizeof( mcChannel ) );
+    mcChannel.IsEnabled = true;
+    mcChannel.GroupID = MULTICAST_0_ADDR;
+    mcChannel.Address = REPLAY_MC_ADDR;
+    mcChannel.McKeys.Session.McAppSKey = McAppSKey;
+    mcChannel.McKeys.Session.McNwkSKey = McNwkSKey;
+    mcChannel.FCountMin = 0;
+    mcChannel.FCountMax = UINT32_MAX;
+    mcChannel.RxParams.Class = CLASS_C;
+    mcChannel.RxParams.Params.ClassC.Frequency = 869525000;
+    mcChannel.RxParams.Params.ClassC.Datarate = DR_0;
+    status = LoRaMacMcChannelSetup( &mcChannel );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "LoRaMacMcChannelSetup", status );
+    }
+    ProcessMac( );
+}
+
+static bool ReplayDownlink( CorpusEntry_t* entry )
+{
+    McpsIndicationOk = false;
+    LoRaMacTestRxFrame( RxBuffer, entry->Size, -60, 8 );
+    ProcessMac( );
+    return McpsIndicationOk;
+}
+
+static bool ReplayBeacon( CorpusEntry_t* entry )
+{
+    MlmeReq_t mlmeReq;
+
+    BeaconAcquisitionOk = false;
+    mlmeReq.Type = MLME_BEACON_ACQUISITION;
+    // Busy while the acquisition of a previous corrupted beacon goes on
+    LoRaMacMlmeRequest( &mlmeReq );
+    if( RunMac( true ) == false )
+    {
+        Fail( "Beacon acquisition", 0 );
+    }
+    HostRadioReceive( RxBuffer, entry->Size, -80, 5 );
+    ProcessMac( );
+    return BeaconAcquisitionOk;
+}
+
+static bool ReplayJoinAccept( CorpusEntry_t* entry )
+{
+    MlmeReq_t mlmeReq;
+    LoRaMacStatus_t status;
+    uint32_t txCount = HostRadioGetStatus( )->TxCount;
+
+    JoinConfirmOk = false;
+    mlmeReq.Type = MLME_JOIN;
+    mlmeReq.Req.Join.Datarate = ( entry->Kind == CORPUS_JOIN_US915 ) ? DR_0 : DR_5;
+    mlmeReq.Req.Join.TxPower = TX_POWER_0;
+#if (defined( LORAMAC_VERSION ) && (( LORAMAC_VERSION == 0x01000400 ) || ( LORAMAC_VERSION == 0x01010100 )))
+    mlmeReq.Req.Join.NetworkActivation = ACTIVATION_TYPE_OTAA;
+#endif /* LORAMAC_VERSION */
+    status = LoRaMacMlmeRequest( &mlmeReq );
+    if( status != LORAMAC_STATUS_OK )
+    {
+        Fail( "MLME_JOIN", status );
+    }
+    // Wait for the RX1 window of the join request
+    do
+    {
+        if( HostPlatformRunNextEvent( TimerGetCurrentTime( ) + BENCH_MAX_WAIT ) == false )
+        {
+            Fail( "Join request", 0 );
+        }
+        ProcessMac( );
+    } while( ( HostRadioGetStatus( )->TxCount == txCount ) || ( HostRadioGetStatus( )->State != RF_RX_RUNNING ) );
+
+    HostRadioReceive( RxBuffer, entry->Size, -60, 8 );
+    // Complete the join procedure, up to the RX2 window when the join-accept is dropped
+    if( RunMac( false ) == false )
+    {
+        Fail( "Join procedure", 0 );
+    }
+    if( ( JoinConfirmOk == true ) && ( entry->Kind == CORPUS_JOIN_US915 ) )
+    {
+        MibRequestConfirm_t mib;
+
+        // The CFList of type 1 replaces the channel mask
+        mib.Type = MIB_CHANNELS_MASK;
+        if( ( LoRaMacMibGetRequestConfirm( &mib ) != LORAMAC_STATUS_OK ) ||
+            ( memcmp( mib.Param.ChannelsMask, Us915CfListMask, sizeof( Us915CfListMask ) ) != 0 ) )
+        {
+            return false;
+        }
+    }
+    return JoinConfirmOk;
+}
+
+static void ReplayCorpus( void )
+{
+    bool joinStarted = false;
+    bool joinUs915Started = false;
+
+    SetupMac( LORAMAC_REGION_EU868 );
+    for( uint16_t i = 0; i < CorpusSize; i++ )
+    {
+        CorpusEntry_t* entry = &Corpus[i];
+        KindResults_t* results = &Results[entry->Kind];
+        LoRaMacProfilingStats_t stats;
+        bool accepted;
+
+        if( ( entry->Kind == CORPUS_JOIN ) && ( joinStarted == false ) )
+        {
+            // The join-accepts answer the join requests of a device which never joined
+            SetupMac( LORAMAC_REGION_EU868 );
+            joinStarted = true;
+        }
+        if( ( entry->Kind == CORPUS_JOIN_US915 ) && ( joinUs915Started == false ) )
+        {
+            SetupMac( LORAMAC_REGION_US915 );
+            joinUs915Started = true;
+        }
+
+        memcpy( RxBuffer, entry->Frame, entry->Size );
+        LoRaMacProfilingReset( );
+        switch( entry->Kind )
+        {
+            case CORPUS_BEACON:
+                accepted = ReplayBeacon( entry );
+                break;
+            case CORPUS_JOIN:
+            case CORPUS_JOIN_US915:
+                accepted = ReplayJoinAccept( entry );
+                break;
+            default:
+                accepted = ReplayDownlink( entry );
+                break;
+        }
+
+        if( accepted != entry->Expected )
+        {
+            if( results->Mismatches == 0 )
+            {
+                fprintf( stderr, "%s frame %u %s instead of being %s\n", KindNames[entry->Kind], i,
+                         accepted ? "accepted" : "dropped", entry->Expected ? "accepted" : "dropped" );
+            }
+            results->Mismatches++;
+        }
+
+        // The measurement of the frame is the only RX_TOTAL one since the reset
+        if( ( LoRaMacProfilingGetStats( LORAMAC_PROFILING_RX_TOTAL, &stats ) != LORAMAC_STATUS_OK ) || ( stats.Count == 0 ) )
+        {
+            Fail( "Frame not measured", i );
+        }
+        if( ( results->Frames == 0 ) || ( stats.Max < results->Min ) )
+        {
+            results->Min = stats.Max;
+        }
+        if( stats.Max > results->Max )
+        {
+            results->Max = stats.Max;
+        }
+        if( stats.MaxStackDepth > results->MaxStackDepth )
+        {
+            results->MaxStackDepth = stats.MaxStackDepth;
+        }
+        results->Total += stats.Max;
+        results->Frames++;
+    }
+}
+
+static void LoadCorpus( const char* path )
+{
+    FILE* file = fopen( path, "r" );
+    char kind[16];
+    char hex[2 * 255 + 1];
+    int expected;
+
+    if( file == NULL )
+    {
+        perror( path );
+        exit( 2 );
+    }
+    while( fscanf( file, "%15s %d %510s", kind, &expected, hex ) == 3 )
+    {
+        CorpusEntry_t* entry = &Corpus[CorpusSize];
+        uint8_t k;
+
+        if( CorpusSize >= CORPUS_MAX_ENTRIES )
+        {
+            Fail( "Corpus too large", CorpusSize );
+        }
+        for( k = 0; k < CORPUS_KIND_MAX; k++ )
+        {
+            if( strcmp( kind, KindNames[k] ) == 0 )
+            {
+                break;
+            }
+        }
+        if( k == CORPUS_KIND_MAX )
+        {
+            Fail( "Unknown frame kind", CorpusSize );
+        }
+        entry->Kind = ( CorpusKind_t )k;
+        entry->Expected = ( expected != 0 );
+        entry->Size = ( uint8_t )( strlen( hex ) / 2 );
+        for( uint8_t i = 0; i < entry->Size; i++ )
+        {
+            unsigned int byte;
+
+            sscanf( &hex[2 * i], "%2x", &byte );
+            entry->Frame[i] = ( uint8_t )byte;
+        }
+        CorpusSize++;
+    }
+    fclose( file );
+}
+
+int main( int argc, char** argv )
+{
+    int iterations = 100;
+    uint32_t mismatches = 0;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <corpus file> [iterations]\n", argv[0] );
+        return 2;
+    }
+    if( argc > 2 )
+    {
+        iterations = atoi( argv[2] );
+    }
+    LoadCorpus( argv[1] );
+
+    for( int i = 0; i < iterations; i++ )
+    {
+        ReplayCorpus( );
+    }
+
+    printf( "LoRaWAN 0x%08X, %u frames x %d iterations, stack painted on %d bytes\n",
+            LORAMAC_VERSION, CorpusSize, iterations, LORAMAC_PROFILING_STACK_PAINT_SIZE );
+    printf( "%-8s %8s %10s %10s %10s %10s %8s\n", "kind", "frames", "mismatch", "min ns", "mean ns", "max ns", "stack B" );
+    for( uint8_t k = 0; k < CORPUS_KIND_MAX; k++ )
+    {
+        if( Results[k].Frames == 0 )
+        {
+            continue;
+        }
+        printf( "%-8s %8u %10u %10u %10u %10u %8u\n", KindNames[k], Results[k].Frames, Results[k].Mismatches,
+                Results[k].Min, ( uint32_t )( Results[k].Total / Results[k].Frames ), Results[k].Max,
+                Results[k].MaxStackDepth );
+        mismatches += Results[k].Mismatches;
+    }
+    return ( mismatches == 0 ) ? 0 : 1;
+}
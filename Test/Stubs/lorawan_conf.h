@@ -0,0 +1,174 @@
+/**
+  ******************************************************************************
+  * @file    lorawan_conf.h
+  * @author  MCD Application Team
+  * @brief   LoRaWAN middleware configuration of the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __TEST_LORAWAN_CONF_H__
+#define __TEST_LORAWAN_CONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*!
+ * The tests start from the template of the Conf directory and only change the settings below
+ */
+#include "lorawan_conf_template.h"
+
+#ifndef TEST_LORAMAC_SPECIFICATION_VERSION
+/*!
+ * LoRaWAN version under test, set by the Makefile
+ */
+#define TEST_LORAMAC_SPECIFICATION_VERSION          0x01000400
+#endif /* TEST_LORAMAC_SPECIFICATION_VERSION */
+
+#undef LORAMAC_SPECIFICATION_VERSION
+#define LORAMAC_SPECIFICATION_VERSION               TEST_LORAMAC_SPECIFICATION_VERSION
+
+#ifdef TEST_REGION_SWITCH
+/*!
+ * Second region and region switch of the switch benchmark, set by the Makefile
+ */
+#define REGION_IN865
+#undef LORAMAC_REGION_SWITCH_ENABLED
+#define LORAMAC_REGION_SWITCH_ENABLED               1
+#endif /* TEST_REGION_SWITCH */
+
+#ifdef TEST_ALL_REGIONS
+/*!
+ * All the regions, for the checks of the region layer, set by the Makefile
+ */
+#define REGION_AS923
+#define REGION_AU915
+#define REGION_CN470
+#define REGION_CN779
+#define REGION_EU433
+#define REGION_KR920
+#define REGION_IN865
+#define REGION_RU864
+#endif /* TEST_ALL_REGIONS */
+
+#ifdef TEST_TIME_ON_AIR_TABLE
+/*!
+ * Time on air table of the time on air check, set by the Makefile
+ */
+#undef REGION_TIME_ON_AIR_TABLE_ENABLED
+#define REGION_TIME_ON_AIR_TABLE_ENABLED            TEST_TIME_ON_AIR_TABLE
+#endif /* TEST_TIME_ON_AIR_TABLE */
+
+/*!
+ * Class B is needed to replay the beacons
+ */
+#undef LORAMAC_CLASSB_ENABLED
+#define LORAMAC_CLASSB_ENABLED                      1
+
+#ifndef RTC_TEMP_COEFFICIENT
+/*!
+ * Clock source calibration of the template, only defined there when Class B is enabled
+ */
+#define RTC_TEMP_COEFFICIENT                        ( -0.035 )
+#define RTC_TEMP_DEV_COEFFICIENT                    ( 0.0035 )
+#define RTC_TEMP_TURNOVER                           ( 25.0 )
+#define RTC_TEMP_DEV_TURNOVER                       ( 5.0 )
+#endif /* RTC_TEMP_COEFFICIENT */
+
+/*!
+ * Probes with a nanosecond timestamp and a painted stack
+ */
+#undef LORAMAC_PROFILING_ENABLED
+#define LORAMAC_PROFILING_ENABLED                   1
+
+#ifndef TEST_STACK_PAINT_SIZE
+/*!
+ * Painted stack size, set to 0 by the Makefile for the timing runs
+ */
+#define TEST_STACK_PAINT_SIZE                       4096
+#endif /* TEST_STACK_PAINT_SIZE */
+
+#undef LORAMAC_PROFILING_STACK_PAINT_SIZE
+#define LORAMAC_PROFILING_STACK_PAINT_SIZE          TEST_STACK_PAINT_SIZE
+
+/*!
+ * The x86-64 ABI lets leaf functions use 128 bytes below the stack pointer
+ */
+#define LORAMAC_PROFILING_STACK_GUARD_SIZE          256
+
+#ifdef TEST_TIMER_COALESCING_SLACK
+/*!
+ * Timer coalescing slack, set by the Makefile for the Class B check
+ */
+#undef LORAMAC_TIMER_COALESCING_SLACK
+#define LORAMAC_TIMER_COALESCING_SLACK              TEST_TIMER_COALESCING_SLACK
+#endif /* TEST_TIMER_COALESCING_SLACK */
+
+#ifdef TEST_CHANNEL_QUALITY
+/*!
+ * Channel quality records of the acknowledgement loss simulation, set by the Makefile
+ */
+#undef LORAMAC_CHANNEL_QUALITY_ENABLED
+#define LORAMAC_CHANNEL_QUALITY_ENABLED             TEST_CHANNEL_QUALITY
+#endif /* TEST_CHANNEL_QUALITY */
+
+#ifdef TEST_DUTY_CYCLE_INCREMENTAL
+/*!
+ * Band model of the duty cycle simulation, set by the Makefile
+ */
+#undef REGION_DUTY_CYCLE_INCREMENTAL_ENABLED
+#define REGION_DUTY_CYCLE_INCREMENTAL_ENABLED       TEST_DUTY_CYCLE_INCREMENTAL
+#endif /* TEST_DUTY_CYCLE_INCREMENTAL */
+
+#ifdef TEST_LBT_ADAPTIVE
+/*!
+ * Listen before talk of the LBT simulation, set by the Makefile: AS923 operated in Japan,
+ * with or without the busy history
+ */
+#undef REGION_AS923_DEFAULT_CHANNEL_PLAN
+#define REGION_AS923_DEFAULT_CHANNEL_PLAN           5 /* CHANNEL_PLAN_GROUP_AS923_1_JP( _CH24_CH38_LBT ) */
+#undef LORAMAC_LBT_ADAPTIVE_ENABLED
+#define LORAMAC_LBT_ADAPTIVE_ENABLED                TEST_LBT_ADAPTIVE
+#endif /* TEST_LBT_ADAPTIVE */
+
+#ifdef TEST_JOIN_SWEEP_PLAN
+/*!
+ * Planned join sweeps of the join sweep check, set by the Makefile
+ */
+#undef REGION_JOIN_SWEEP_PLAN_ENABLED
+#define REGION_JOIN_SWEEP_PLAN_ENABLED              TEST_JOIN_SWEEP_PLAN
+#endif /* TEST_JOIN_SWEEP_PLAN */
+
+#ifdef TEST_CN470_FREQUENCY_TABLES
+/*!
+ * CN470 frequency tables of the frequency check, set by the Makefile
+ */
+#undef REGION_CN470_FREQUENCY_TABLES_ENABLED
+#define REGION_CN470_FREQUENCY_TABLES_ENABLED       TEST_CN470_FREQUENCY_TABLES
+#endif /* TEST_CN470_FREQUENCY_TABLES */
+
+#define LORAMAC_PROFILING_GET_TIMESTAMP( )          HostPlatformGetTimestamp( )
+
+/*!
+ * \brief Monotonic timestamp of the profiling probes
+ *
+ * \retval Timestamp in ns, wraps around every 4.29 s
+ */
+uint32_t HostPlatformGetTimestamp( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEST_LORAWAN_CONF_H__ */
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    mw_log_conf.h
+  * @author  MCD Application Team
+  * @brief   Host trace configuration used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __MW_LOG_CONF_H__
+#define __MW_LOG_CONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TS_OFF                                      0
+#define TS_ON                                       1
+
+#define VLEVEL_OFF                                  0
+#define VLEVEL_L                                    1
+#define VLEVEL_M                                    2
+#define VLEVEL_H                                    3
+
+/*!
+ * Traces are disabled, they would dominate the measured durations
+ */
+#define MW_LOG( TS, VL, ... )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MW_LOG_CONF_H__ */
@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file    radio.h
+  * @author  MCD Application Team
+  * @brief   Radio driver API of the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __TEST_RADIO_H__
+#define __TEST_RADIO_H__
+
+/*!
+ * The tests use the template of the Conf directory as is
+ */
+#include "radio_template.h"
+
+#endif /* __TEST_RADIO_H__ */
@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    radio_ex.h
+  * @author  MCD Application Team
+  * @brief   Host radio driver extended types used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __RADIO_EX_H__
+#define __RADIO_EX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Generic modems, not used by the LoRaMac
+ */
+typedef enum
+{
+    GENERIC_FSK = 0,
+    GENERIC_LORA,
+    GENERIC_BPSK,
+    GENERIC_MSK,
+} GenericModems_t;
+
+/*!
+ * Generic RX configuration, not used by the LoRaMac
+ */
+typedef struct
+{
+    uint32_t Unused;
+} RxConfigGeneric_t;
+
+/*!
+ * Generic TX configuration, not used by the LoRaMac
+ */
+typedef struct
+{
+    uint32_t Unused;
+} TxConfigGeneric_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RADIO_EX_H__ */
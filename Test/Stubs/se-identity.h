@@ -0,0 +1,26 @@
+/**
+  ******************************************************************************
+  * @file    se-identity.h
+  * @author  MCD Application Team
+  * @brief   Secure element identity of the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __TEST_SE_IDENTITY_H__
+#define __TEST_SE_IDENTITY_H__
+
+/*!
+ * The tests use the template of the Conf directory as is
+ */
+#include "se-identity_template.h"
+
+#endif /* __TEST_SE_IDENTITY_H__ */
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    stm32_timer.h
+  * @author  MCD Application Team
+  * @brief   Host timer server interface used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __STM32_TIMER_H__
+#define __STM32_TIMER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*!
+ * Timer value
+ */
+typedef uint32_t UTIL_TIMER_Time_t;
+
+/*!
+ * Timer mode
+ */
+typedef enum
+{
+    UTIL_TIMER_ONESHOT  = 0,
+    UTIL_TIMER_PERIODIC = 1
+} UTIL_TIMER_Mode_t;
+
+/*!
+ * Timer operation status
+ */
+typedef enum
+{
+    UTIL_TIMER_OK            = 0,
+    UTIL_TIMER_INVALID_PARAM = 1,
+    UTIL_TIMER_HW_ERROR      = 2,
+    UTIL_TIMER_UNKNOWN_ERROR = 3
+} UTIL_TIMER_Status_t;
+
+/*!
+ * Timer object, same layout as the timer server of the STM32 utilities
+ */
+typedef struct TimerEvent_s
+{
+    uint32_t Timestamp;
+    uint32_t ReloadValue;
+    uint8_t IsPending;
+    uint8_t IsRunning;
+    uint8_t IsReloadStopped;
+    UTIL_TIMER_Mode_t Mode;
+    void ( *Callback )( void * );
+    void *argument;
+    struct TimerEvent_s *Next;
+} UTIL_TIMER_Object_t;
+
+UTIL_TIMER_Status_t UTIL_TIMER_Create( UTIL_TIMER_Object_t *TimerObject, uint32_t PeriodValue, UTIL_TIMER_Mode_t Mode,
+                                       void ( *Callback )( void * ), void *Argument );
+UTIL_TIMER_Status_t UTIL_TIMER_Start( UTIL_TIMER_Object_t *TimerObject );
+UTIL_TIMER_Status_t UTIL_TIMER_Stop( UTIL_TIMER_Object_t *TimerObject );
+UTIL_TIMER_Status_t UTIL_TIMER_SetPeriod( UTIL_TIMER_Object_t *TimerObject, uint32_t NewPeriodValue );
+UTIL_TIMER_Status_t UTIL_TIMER_GetRemainingTime( UTIL_TIMER_Object_t *TimerObject, uint32_t *Time );
+uint32_t UTIL_TIMER_IsRunning( UTIL_TIMER_Object_t *TimerObject );
+UTIL_TIMER_Time_t UTIL_TIMER_GetCurrentTime( void );
+UTIL_TIMER_Time_t UTIL_TIMER_GetElapsedTime( UTIL_TIMER_Time_t past );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32_TIMER_H__ */
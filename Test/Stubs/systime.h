@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    systime.h
+  * @author  MCD Application Team
+  * @brief   Host system time interface used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __SYSTIME_H__
+#define __SYSTIME_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*!
+ * Days, Hours, Minutes and seconds of systime.h
+ */
+#define TM_DAYS_IN_LEAP_YEAR                        ( ( uint32_t )  366U )
+#define TM_DAYS_IN_YEAR                             ( ( uint32_t )  365U )
+#define TM_SECONDS_IN_1DAY                          ( ( uint32_t )86400U )
+#define TM_SECONDS_IN_1HOUR                         ( ( uint32_t ) 3600U )
+#define TM_SECONDS_IN_1MINUTE                       ( ( uint32_t )   60U )
+#define TM_MINUTES_IN_1HOUR                         ( ( uint32_t )   60U )
+#define TM_HOURS_IN_1DAY                            ( ( uint32_t )   24U )
+
+/*!
+ * Number of seconds elapsed between Unix and GPS epoch
+ */
+#define UNIX_GPS_EPOCH_OFFSET                       315964800
+
+/*!
+ * System time
+ */
+typedef struct
+{
+    uint32_t Seconds;
+    int16_t SubSeconds;
+} SysTime_t;
+
+SysTime_t SysTimeAdd( SysTime_t a, SysTime_t b );
+SysTime_t SysTimeSub( SysTime_t a, SysTime_t b );
+void SysTimeSet( SysTime_t sysTime );
+SysTime_t SysTimeGet( void );
+SysTime_t SysTimeGetMcuTime( void );
+uint32_t SysTimeToMs( SysTime_t sysTime );
+SysTime_t SysTimeFromMs( uint32_t timeMs );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SYSTIME_H__ */
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    utilities_conf.h
+  * @author  MCD Application Team
+  * @brief   Host configuration of the utilities used by the LoRaMac tests
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#ifndef __UTILITIES_CONF_H__
+#define __UTILITIES_CONF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*!
+ * The host tests are single threaded, the radio and timer events are called from the test loop
+ */
+#define UTILS_ENTER_CRITICAL_SECTION( )
+#define UTILS_EXIT_CRITICAL_SECTION( )
+
+#define ALIGN( n )                                  __attribute__( ( aligned( n ) ) )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UTILITIES_CONF_H__ */
@@ -0,0 +1,336 @@
+/**
+  ******************************************************************************
+  * @file    TimeOnAirCheck.c
+  * @author  MCD Application Team
+  * @brief   Checks the time on air computed by the regions on the host
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2021 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/*
+ * Usage: TimeOnAirCheck
+ *
+ * Compares with the time on air formula of the SubGHz radio driver:
+ * - RegionCommonComputeTimeOnAirLoRa and RegionCommonComputeTimeOnAirFsk for
+ *   every bandwidth, spreading factor, coding rate, header mode, CRC setting
+ *   and payload length,
+ * - the time on air returned by RegionTxConfig, computed by
+ *   RegionCommonGetUplinkTimeOnAir, for the radio settings the region has just
+ *   set, for every region, every uplink datarate and every frame length up to
+ *   the maximum payload of the datarate. The regions are run twice, so that the
+ *   second run is served from the time on air table filled by the first one.
+ * Any mismatch fails the check.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Region.h"
+#include "RegionCommon.h"
+#include "HostPlatform.h"
+
+/*!
+ * MHDR, FHDR without options, FPort and MIC added to the MAC payload
+ */
+#define TOA_FRAME_OVERHEAD                          13
+
+/*!
+ * Number of runs over the regions
+ */
+#define TOA_NB_RUNS                                 2
+
+/*!
+ * Region under check, the names are the ones of LoRaMacRegion_t
+ */
+typedef struct sCheckedRegion
+{
+    LoRaMacRegion_t Region;
+    const char* Name;
+}CheckedRegion_t;
+
+static const CheckedRegion_t Regions[] =
+{
+    { LORAMAC_REGION_AS923, "AS923" },
+    { LORAMAC_REGION_AU915, "AU915" },
+    { LORAMAC_REGION_CN470, "CN470" },
+    { LORAMAC_REGION_CN779, "CN779" },
+    { LORAMAC_REGION_EU433, "EU433" },
+    { LORAMAC_REGION_EU868, "EU868" },
+    { LORAMAC_REGION_KR920, "KR920" },
+    { LORAMAC_REGION_IN865, "IN865" },
+    { LORAMAC_REGION_US915, "US915" },
+    { LORAMAC_REGION_RU864, "RU864" },
+};
+
+static RegionNvmDataGroup1_t RegionGroup1;
+static RegionNvmDataGroup2_t RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+static Band_t RegionBands[REGION_NVM_MAX_NB_BANDS];
+#endif /* REGION_VERSION */
+
+static uint32_t Mismatches;
+
+/*!
+ * RadioGetLoRaTimeOnAirNumerator of the SubGHz radio driver
+ */
+static uint32_t DriverLoRaTimeOnAirNumerator( uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                                              uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    int32_t crDenom = coderate + 4;
+    bool lowDatareOptimize = false;
+
+    // Ensure that the preamble length is at least 12 symbols when using SF5 or SF6
+    if( ( datarate == 5 ) || ( datarate == 6 ) )
+    {
+        if( preambleLen < 12 )
+        {
+            preambleLen = 12;
+        }
+    }
+
+    if( ( ( bandwidth == 0 ) && ( ( datarate == 11 ) || ( datarate == 12 ) ) ) ||
+        ( ( bandwidth == 1 ) && ( datarate == 12 ) ) )
+    {
+        lowDatareOptimize = true;
+    }
+
+    int32_t ceilDenominator;
+    int32_t ceilNumerator = ( payloadLen << 3 ) +
+                            ( crcOn ? 16 : 0 ) -
+                            ( 4 * datarate ) +
+                            ( fixLen ? 0 : 20 );
+
+    if( datarate <= 6 )
+    {
+        ceilDenominator = 4 * datarate;
+    }
+    else
+    {
+        ceilNumerator += 8;
+
+        if( lowDatareOptimize == true )
+        {
+            ceilDenominator = 4 * ( datarate - 2 );
+        }
+        else
+        {
+            ceilDenominator = 4 * datarate;
+        }
+    }
+
+    if( ceilNumerator < 0 )
+    {
+        ceilNumerator = 0;
+    }
+
+    // Perform integral ceil()
+    int32_t intermediate =
+        ( ( ceilNumerator + ceilDenominator - 1 ) / ceilDenominator ) * crDenom + preambleLen + 12;
+
+    if( datarate <= 6 )
+    {
+        intermediate += 2;
+    }
+
+    return ( uint32_t )( ( 4 * intermediate + 1 ) * ( 1 << ( datarate - 2 ) ) );
+}
+
+/*!
+ * RadioTimeOnAir of the SubGHz radio driver
+ */
+static uint32_t DriverTimeOnAir( RadioModems_t modem, uint32_t bandwidth, uint32_t datarate, uint8_t coderate,
+                                 uint16_t preambleLen, bool fixLen, uint8_t payloadLen, bool crcOn )
+{
+    const uint32_t bandwidthsInHz[] = { 125000, 250000, 500000 };
+    uint32_t numerator = 0;
+    uint32_t denominator = 1;
+
+    if( modem == MODEM_FSK )
+    {
+        numerator = 1000U * ( ( preambleLen << 3 ) + ( ( fixLen == 0 ) ? 8 : 0 ) + 24 +
+                              ( ( payloadLen + ( ( crcOn == 0 ) ? 0 : 2 ) ) << 3 ) );
+        denominator = datarate;
+    }
+    else
+    {
+        numerator = 1000U * DriverLoRaTimeOnAirNumerator( bandwidth, datarate, coderate, preambleLen, fixLen,
+                                                          payloadLen, crcOn );
+        denominator = bandwidthsInHz[bandwidth];
+    }
+    // Perform integral ceil()
+    return ( numerator + denominator - 1 ) / denominator;
+}
+
+static void Mismatch( const char* what, uint32_t expected, uint32_t actual )
+{
+    if( Mismatches < 20 )
+    {
+        fprintf( stderr, "%s: %u ms expected, %u ms computed\n", what, expected, actual );
+    }
+    Mismatches++;
+}
+
+/*!
+ * Checks the formulas of RegionCommon on the whole parameter space of the regions
+ */
+static uint32_t CheckFormulas( void )
+{
+    const uint32_t fskDatarates[] = { 50000 };
+    char what[96];
+    uint32_t checks = 0;
+
+    for( uint32_t bandwidth = 0; bandwidth <= 2; bandwidth++ )
+    {
+        for( uint32_t sf = 5; sf <= 12; sf++ )
+        {
+            for( uint8_t coderate = 1; coderate <= 4; coderate++ )
+            {
+                for( uint8_t mode = 0; mode < 4; mode++ )
+                {
+                    bool fixLen = ( mode & 0x01 ) != 0;
+                    bool crcOn = ( mode & 0x02 ) != 0;
+
+                    for( uint16_t len = 0; len <= 255; len++ )
+                    {
+                        uint32_t expected = DriverTimeOnAir( MODEM_LORA, bandwidth, sf, coderate, 8, fixLen, len, crcOn );
+                        uint32_t actual = RegionCommonComputeTimeOnAirLoRa( bandwidth, sf, coderate, 8, fixLen, len, crcOn );
+
+                        if( actual != expected )
+                        {
+                            snprintf( what, sizeof( what ), "LoRa BW%u SF%u CR4/%u fixLen %d crc %d %u bytes",
+                                      bandwidth, sf, coderate + 4, fixLen, crcOn, len );
+                            Mismatch( what, expected, actual );
+                        }
+                        checks++;
+                    }
+                }
+            }
+        }
+    }
+    for( uint8_t i = 0; i < ( sizeof( fskDatarates ) / sizeof( fskDatarates[0] ) ); i++ )
+    {
+        for( uint16_t len = 0; len <= 255; len++ )
+        {
+            uint32_t expected = DriverTimeOnAir( MODEM_FSK, 0, fskDatarates[i], 0, 5, false, len, true );
+            uint32_t actual = RegionCommonComputeTimeOnAirFsk( fskDatarates[i], 5, false, len, true );
+
+            if( actual != expected )
+            {
+                snprintf( what, sizeof( what ), "FSK %u bps %u bytes", fskDatarates[i], len );
+                Mismatch( what, expected, actual );
+            }
+            checks++;
+        }
+    }
+    return checks;
+}
+
+/*!
+ * Checks the uplink time on air of every datarate and frame length of a region
+ */
+static uint32_t CheckRegion( const CheckedRegion_t* checked )
+{
+    InitDefaultsParams_t params;
+    GetPhyParams_t getPhy;
+    PhyParam_t phyParam;
+    TxConfigParams_t txConfig;
+    VerifyParams_t verify;
+    char what[96];
+    uint32_t checks = 0;
+
+    params.Type = INIT_TYPE_DEFAULTS;
+    params.NvmGroup1 = &RegionGroup1;
+    params.NvmGroup2 = &RegionGroup2;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+    params.Bands = &RegionBands;
+#endif /* REGION_VERSION */
+    RegionInitDefaults( checked->Region, &params );
+
+    getPhy.UplinkDwellTime = 0;
+    getPhy.DownlinkDwellTime = 0;
+    verify.DatarateParams.UplinkDwellTime = 0;
+    verify.DatarateParams.DownlinkDwellTime = 0;
+
+    for( int8_t dr = DR_0; dr <= DR_15; dr++ )
+    {
+        uint16_t maxLen;
+
+        // Uplink datarates of the region only
+        verify.DatarateParams.Datarate = dr;
+        if( RegionVerify( checked->Region, &verify, PHY_TX_DR ) == false )
+        {
+            continue;
+        }
+
+        getPhy.Attribute = PHY_MAX_PAYLOAD;
+        getPhy.Datarate = dr;
+        phyParam = RegionGetPhyParam( checked->Region, &getPhy );
+        if( phyParam.Value == 0 )
+        {
+            // LR-FHSS datarate, not sent by the LoRa and FSK radio
+            continue;
+        }
+        maxLen = MIN( phyParam.Value + TOA_FRAME_OVERHEAD, 255 );
+
+        for( uint16_t len = 0; len <= maxLen; len++ )
+        {
+            const HostRadioTxConfig_t* radio = HostRadioGetTxConfig( );
+            TimerTime_t timeOnAir = 0;
+            int8_t txPower = 0;
+            uint32_t expected;
+
+            txConfig.Channel = 0;
+            txConfig.Datarate = dr;
+            txConfig.TxPower = 0;
+            txConfig.MaxEirp = 16;
+            txConfig.AntennaGain = 0;
+            txConfig.PktLen = len;
+#if (defined( REGION_VERSION ) && (( REGION_VERSION == 0x02010001 ) || ( REGION_VERSION == 0x02010003 )))
+            txConfig.NetworkActivation = ACTIVATION_TYPE_ABP;
+#endif /* REGION_VERSION */
+            if( RegionTxConfig( checked->Region, &txConfig, &txPower, &timeOnAir ) == false )
+            {
+                fprintf( stderr, "%s DR%d: RegionTxConfig failed\n", checked->Name, dr );
+                exit( 2 );
+            }
+
+            expected = DriverTimeOnAir( radio->Modem, radio->Bandwidth, radio->Datarate, radio->Coderate,
+                                        radio->PreambleLen, radio->FixLen, len, radio->CrcOn );
+            if( timeOnAir != expected )
+            {
+                snprintf( what, sizeof( what ), "%s DR%d %u bytes", checked->Name, dr, len );
+                Mismatch( what, expected, timeOnAir );
+            }
+            checks++;
+        }
+    }
+    return checks;
+}
+
+int main( int argc, char** argv )
+{
+    uint32_t formulaChecks;
+    uint32_t regionChecks = 0;
+
+    HostPlatformInit( 1 );
+
+    formulaChecks = CheckFormulas( );
+    for( uint8_t run = 0; run < TOA_NB_RUNS; run++ )
+    {
+        for( uint8_t i = 0; i < ( sizeof( Regions ) / sizeof( Regions[0] ) ); i++ )
+        {
+            regionChecks += CheckRegion( &Regions[i] );
+        }
+    }
+
+    printf( "LoRaWAN 0x%08X, time on air table %s: %u formula and %u region time on air checked, %u mismatches\n",
+            LORAMAC_VERSION, ( REGION_TIME_ON_AIR_TABLE_ENABLED == 1 ) ? "on" : "off",
+            formulaChecks, regionChecks, Mismatches );
+    return ( Mismatches == 0 ) ? 0 : 1;
+}
@@ -46,6 +46,16 @@ static const uint32_t reversedPolynom = 0xEDB88320;
 
 static uint32_t next = 1;
 
+/*!
+ * Bit position of a power of 2, indexed by the top 5 bits of its product with
+ * the de Bruijn sequence 0x077CB531
+ */
+static const uint8_t DeBruijnBitPosition[32] =
+{
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
 static int32_t rand1( void );
 
 static int32_t rand1( void )
@@ -105,6 +115,14 @@ int8_t Nibble2HexChar( uint8_t a )
     }
 }
 
+uint8_t LowestBitPosition( uint32_t value )
+{
+    // Isolate the lowest bit set
+    uint32_t lowestBit = value & ( ~value + 1 );
+
+    return DeBruijnBitPosition[( uint32_t )( lowestBit * 0x077CB531UL ) >> 27];
+}
+
 uint32_t Crc32( uint8_t *buffer, uint16_t length )
 {
     // CRC initial value
@@ -168,6 +168,14 @@ void memset1( uint8_t *dst, uint8_t value, uint16_t size );
  */
 int8_t Nibble2HexChar( uint8_t a );
 
+/*!
+ * \brief Gets the position of the lowest bit set of a word in constant time
+ *
+ * \param [in] value Word, not 0
+ * \retval position Position of the lowest bit set, 0 to 31
+ */
+uint8_t LowestBitPosition( uint32_t value );
+
 /*!
  * \brief Computes a CCITT 32 bits CRC
  *